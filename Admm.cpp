@@ -0,0 +1,508 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include <util/exceptions.h>
+#include "Admm.h"
+
+static const double Infinity = std::numeric_limits<double>::infinity();
+
+// regularization of P in the KKT matrix
+static const double Sigma = 1e-6;
+
+// over-relaxation parameter
+static const double Alpha = 1.6;
+
+// the initial step size
+static const double RhoInit = 0.1;
+
+// limits of the step size
+static const double RhoMin = 1e-6;
+static const double RhoMax = 1e6;
+
+// factor of the step size for equality rows
+static const double RhoEquality = 1e3;
+
+// adapt the step size only if it changes by more than this factor, since this
+// needs a new numeric factorization
+static const double RhoTolerance = 5;
+
+// number of iterations between checks of the termination criteria
+static const size_t CheckInterval = 10;
+
+// number of iterations between adaptations of the step size
+static const size_t RhoInterval = 50;
+
+// tolerance for the infeasibility certificates
+static const double InfeasibilityTolerance = 1e-5;
+
+Admm::Admm() :
+	_n(0),
+	_m(0),
+	_rho(RhoInit),
+	_factorized(false),
+	_epsAbs(1e-4),
+	_epsRel(1e-4),
+	_maxIterations(10000),
+	_iterations(0),
+	_timeout(0),
+	_interrupt(nullptr) {}
+
+void
+Admm::load(
+		const std::vector<double>&       q,
+		const std::vector<unsigned int>& pRows,
+		const std::vector<unsigned int>& pCols,
+		const std::vector<double>&       pValues,
+		const LinearConstraintMatrix&    a,
+		const std::vector<double>&       lower,
+		const std::vector<double>&       upper) {
+
+	if (pRows.size() != pCols.size() || pRows.size() != pValues.size())
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"got " << pRows.size() << " rows, " << pCols.size() << " columns, and "
+				<< pValues.size() << " values for P");
+
+	if (lower.size() != a.size() || upper.size() != a.size())
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"got " << lower.size() << " lower and " << upper.size() << " upper bounds for "
+				<< a.size() << " rows");
+
+	unsigned int n = q.size();
+	unsigned int m = a.size();
+
+	// keep the iterates to warm start, if the problem has the same size
+	if (n != _n || m != _m) {
+
+		_x.assign(n, 0.0);
+		_z.assign(m, 0.0);
+		_y.assign(m, 0.0);
+	}
+
+	_n = n;
+	_m = m;
+
+	_q       = q;
+	_pRows   = pRows;
+	_pCols   = pCols;
+	_pValues = pValues;
+
+	_aRowOffsets = a.getRowOffsets();
+	_aColumns    = a.getColumns();
+	_aValues     = a.getCoefficients();
+
+	_lower = lower;
+	_upper = upper;
+
+	_deltaX.resize(_n);
+	_deltaY.resize(_m);
+	_rhs.resize(_n + _m);
+	_ax.resize(_m);
+	_px.resize(_n);
+	_aty.resize(_n);
+
+	setupRho();
+	setupKkt();
+}
+
+void
+Admm::setIterates(const std::vector<double>& x, const std::vector<double>& y) {
+
+	if (x.size() != _n || y.size() != _m)
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"iterates of size " << x.size() << " and " << y.size() << " do not match problem of "
+				<< _n << " variables and " << _m << " rows");
+
+	_x = x;
+	_y = y;
+
+	// z is the projection of Ax on the bounds
+	multiplyA(_x, _z);
+	for (unsigned int i = 0; i < _m; i++)
+		_z[i] = std::min(std::max(_z[i], _lower[i]), _upper[i]);
+}
+
+void
+Admm::setRowBounds(unsigned int row, double lower, double upper) {
+
+	_lower[row] = lower;
+	_upper[row] = upper;
+
+	double rho = rowRho(row);
+
+	if (rho != _rhoRows[row]) {
+
+		_rhoRows[row] = rho;
+		_kktValues[_kktRhoPositions[row]] = -1.0/rho;
+		_factorized = false;
+	}
+}
+
+Admm::Status
+Admm::solve() {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	_iterations = 0;
+
+	if (!_factorized) {
+
+		if (!_ldl.factorize(_kktValues) || _ldl.numPositivePivots() != _n)
+			return NonConvex;
+
+		_factorized = true;
+	}
+
+	while (true) {
+
+		// solve the KKT system
+
+		for (unsigned int j = 0; j < _n; j++)
+			_rhs[j] = Sigma*_x[j] - _q[j];
+		for (unsigned int i = 0; i < _m; i++)
+			_rhs[_n + i] = _z[i] - _y[i]/_rhoRows[i];
+
+		_ldl.solve(_rhs);
+
+		// update the iterates, with over-relaxation
+
+		for (unsigned int j = 0; j < _n; j++) {
+
+			double x = Alpha*_rhs[j] + (1 - Alpha)*_x[j];
+			_deltaX[j] = x - _x[j];
+			_x[j] = x;
+		}
+
+		for (unsigned int i = 0; i < _m; i++) {
+
+			double zTilde = _z[i] + (_rhs[_n + i] - _y[i])/_rhoRows[i];
+			double zRelaxed = Alpha*zTilde + (1 - Alpha)*_z[i];
+			double z = std::min(std::max(zRelaxed + _y[i]/_rhoRows[i], _lower[i]), _upper[i]);
+			double y = _y[i] + _rhoRows[i]*(zRelaxed - z);
+
+			_deltaY[i] = y - _y[i];
+			_y[i] = y;
+			_z[i] = z;
+		}
+
+		_iterations++;
+
+		if (_iterations%CheckInterval != 0 && _iterations < _maxIterations)
+			continue;
+
+		double primal, dual, primalScale, dualScale;
+		computeResiduals(primal, dual, primalScale, dualScale);
+
+		if (primal <= _epsAbs + _epsRel*primalScale && dual <= _epsAbs + _epsRel*dualScale)
+			return Optimal;
+
+		if (isPrimalInfeasible())
+			return PrimalInfeasible;
+
+		if (isDualInfeasible())
+			return DualInfeasible;
+
+		if (_iterations >= _maxIterations)
+			return IterationLimit;
+
+		if (_timeout > 0) {
+
+			double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (elapsed > _timeout)
+				return TimeLimit;
+		}
+
+		if (_interrupt && *_interrupt)
+			return Interrupted;
+
+		// balance the primal and dual residuals
+		if (_iterations%RhoInterval == 0 && primal > 0 && dual > 0) {
+
+			double ratio =
+					(primal/std::max(primalScale, 1e-10))/
+					(dual/std::max(dualScale, 1e-10));
+			double rho = std::min(std::max(_rho*std::sqrt(ratio), RhoMin), RhoMax);
+
+			if (rho > _rho*RhoTolerance || rho < _rho/RhoTolerance) {
+
+				updateRho(rho);
+				if (!_ldl.factorize(_kktValues) || _ldl.numPositivePivots() != _n)
+					return NonConvex;
+			}
+		}
+	}
+}
+
+double
+Admm::getObjectiveValue() const {
+
+	std::vector<double> px(_n, 0.0);
+	multiplyP(_x, px);
+
+	double value = 0;
+	for (unsigned int j = 0; j < _n; j++)
+		value += 0.5*_x[j]*px[j] + _q[j]*_x[j];
+
+	return value;
+}
+
+void
+Admm::setupKkt() {
+
+	// P + sigma*I in the first n columns, A' and -1/rho in the others
+
+	std::vector<double> diagonal(_n, Sigma);
+	std::vector<size_t> counts(_n + _m + 1, 0);
+
+	for (size_t k = 0; k < _pValues.size(); k++) {
+
+		if (_pRows[k] > _pCols[k] || _pCols[k] >= _n)
+			UTIL_THROW_EXCEPTION(
+					UsageError,
+					"entry (" << _pRows[k] << ", " << _pCols[k] << ") is not in the upper triangle of P");
+
+		if (_pRows[k] == _pCols[k])
+			diagonal[_pRows[k]] += _pValues[k];
+		else
+			counts[_pCols[k] + 1]++;
+	}
+
+	for (unsigned int i = 0; i < _m; i++)
+		counts[_n + i + 1] = _aRowOffsets[i+1] - _aRowOffsets[i];
+
+	// one diagonal entry per column
+	_kktColOffsets.resize(_n + _m + 1);
+	_kktColOffsets[0] = 0;
+	for (unsigned int j = 0; j < _n + _m; j++)
+		_kktColOffsets[j+1] = _kktColOffsets[j] + counts[j+1] + 1;
+
+	_kktRows.resize(_kktColOffsets.back());
+	_kktValues.resize(_kktColOffsets.back());
+	_kktRhoPositions.resize(_m);
+
+	std::vector<size_t> next(_kktColOffsets.begin(), _kktColOffsets.end() - 1);
+
+	for (size_t k = 0; k < _pValues.size(); k++) {
+
+		if (_pRows[k] == _pCols[k])
+			continue;
+
+		size_t pos = next[_pCols[k]]++;
+		_kktRows[pos]   = _pRows[k];
+		_kktValues[pos] = _pValues[k];
+	}
+
+	for (unsigned int j = 0; j < _n; j++) {
+
+		size_t pos = next[j]++;
+		_kktRows[pos]   = j;
+		_kktValues[pos] = diagonal[j];
+	}
+
+	for (unsigned int i = 0; i < _m; i++) {
+
+		size_t pos = next[_n + i];
+
+		for (size_t k = _aRowOffsets[i]; k < _aRowOffsets[i+1]; k++, pos++) {
+
+			_kktRows[pos]   = _aColumns[k];
+			_kktValues[pos] = _aValues[k];
+		}
+
+		_kktRows[pos]   = _n + i;
+		_kktValues[pos] = -1.0/_rhoRows[i];
+		_kktRhoPositions[i] = pos;
+	}
+
+	if (!_ldl.hasPattern(_kktColOffsets, _kktRows))
+		_ldl.analyze(_n + _m, _kktColOffsets, _kktRows);
+
+	_factorized = false;
+}
+
+void
+Admm::setupRho() {
+
+	_rhoRows.resize(_m);
+
+	for (unsigned int i = 0; i < _m; i++)
+		_rhoRows[i] = rowRho(i);
+}
+
+double
+Admm::rowRho(unsigned int row) const {
+
+	if (_lower[row] == -Infinity && _upper[row] == Infinity)
+		return RhoMin;
+	else if (_lower[row] == _upper[row])
+		return RhoEquality*_rho;
+	else
+		return _rho;
+}
+
+void
+Admm::updateRho(double rho) {
+
+	_rho = rho;
+	setupRho();
+
+	for (unsigned int i = 0; i < _m; i++)
+		_kktValues[_kktRhoPositions[i]] = -1.0/_rhoRows[i];
+
+	_factorized = false;
+}
+
+void
+Admm::computeResiduals(
+		double& primal,
+		double& dual,
+		double& primalScale,
+		double& dualScale) {
+
+	multiplyA(_x, _ax);
+	std::fill(_px.begin(), _px.end(), 0.0);
+	multiplyP(_x, _px);
+	multiplyAt(_y, _aty);
+
+	primal = 0;
+	primalScale = 0;
+	for (unsigned int i = 0; i < _m; i++) {
+
+		primal = std::max(primal, std::fabs(_ax[i] - _z[i]));
+		primalScale = std::max(primalScale, std::max(std::fabs(_ax[i]), std::fabs(_z[i])));
+	}
+
+	dual = 0;
+	double pxNorm = 0, atyNorm = 0, qNorm = 0;
+	for (unsigned int j = 0; j < _n; j++) {
+
+		dual    = std::max(dual, std::fabs(_px[j] + _q[j] + _aty[j]));
+		pxNorm  = std::max(pxNorm, std::fabs(_px[j]));
+		atyNorm = std::max(atyNorm, std::fabs(_aty[j]));
+		qNorm   = std::max(qNorm, std::fabs(_q[j]));
+	}
+	dualScale = std::max(pxNorm, std::max(atyNorm, qNorm));
+}
+
+bool
+Admm::isPrimalInfeasible() {
+
+	// a certificate is a change dy of the duals with A'dy = 0 and
+	// u'max(dy, 0) + l'min(dy, 0) < 0
+
+	double norm = 0;
+	for (unsigned int i = 0; i < _m; i++)
+		norm = std::max(norm, std::fabs(_deltaY[i]));
+
+	if (norm < 1e-12)
+		return false;
+
+	double eps = InfeasibilityTolerance*norm;
+
+	double support = 0;
+	for (unsigned int i = 0; i < _m; i++) {
+
+		if (_deltaY[i] > eps) {
+
+			if (_upper[i] == Infinity)
+				return false;
+			support += _upper[i]*_deltaY[i];
+
+		} else if (_deltaY[i] < -eps) {
+
+			if (_lower[i] == -Infinity)
+				return false;
+			support += _lower[i]*_deltaY[i];
+		}
+	}
+
+	if (support >= -eps)
+		return false;
+
+	multiplyAt(_deltaY, _aty);
+	for (unsigned int j = 0; j < _n; j++)
+		if (std::fabs(_aty[j]) > eps)
+			return false;
+
+	return true;
+}
+
+bool
+Admm::isDualInfeasible() {
+
+	// a certificate is a change dx of the primals with Pdx = 0, q'dx < 0, and
+	// Adx within the recession cone of the bounds
+
+	double norm = 0;
+	for (unsigned int j = 0; j < _n; j++)
+		norm = std::max(norm, std::fabs(_deltaX[j]));
+
+	if (norm < 1e-12)
+		return false;
+
+	double eps = InfeasibilityTolerance*norm;
+
+	double descent = 0;
+	for (unsigned int j = 0; j < _n; j++)
+		descent += _q[j]*_deltaX[j];
+
+	if (descent >= -eps)
+		return false;
+
+	std::fill(_px.begin(), _px.end(), 0.0);
+	multiplyP(_deltaX, _px);
+	for (unsigned int j = 0; j < _n; j++)
+		if (std::fabs(_px[j]) > eps)
+			return false;
+
+	multiplyA(_deltaX, _ax);
+	for (unsigned int i = 0; i < _m; i++) {
+
+		if (_upper[i] != Infinity && _ax[i] > eps)
+			return false;
+		if (_lower[i] != -Infinity && _ax[i] < -eps)
+			return false;
+	}
+
+	return true;
+}
+
+void
+Admm::multiplyP(const std::vector<double>& x, std::vector<double>& y) const {
+
+	for (size_t k = 0; k < _pValues.size(); k++) {
+
+		unsigned int i = _pRows[k];
+		unsigned int j = _pCols[k];
+
+		y[i] += _pValues[k]*x[j];
+		if (i != j)
+			y[j] += _pValues[k]*x[i];
+	}
+}
+
+void
+Admm::multiplyA(const std::vector<double>& x, std::vector<double>& y) const {
+
+	for (unsigned int i = 0; i < _m; i++) {
+
+		double sum = 0;
+		for (size_t k = _aRowOffsets[i]; k < _aRowOffsets[i+1]; k++)
+			sum += _aValues[k]*x[_aColumns[k]];
+		y[i] = sum;
+	}
+}
+
+void
+Admm::multiplyAt(const std::vector<double>& x, std::vector<double>& y) const {
+
+	std::fill(y.begin(), y.end(), 0.0);
+
+	for (unsigned int i = 0; i < _m; i++)
+		for (size_t k = _aRowOffsets[i]; k < _aRowOffsets[i+1]; k++)
+			y[_aColumns[k]] += _aValues[k]*x[i];
+}
@@ -0,0 +1,239 @@
+#ifndef INFERENCE_ADMM_H__
+#define INFERENCE_ADMM_H__
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+#include "LinearConstraintMatrix.h"
+#include "SparseLdl.h"
+
+/**
+ * An operator splitting (ADMM) solver for convex quadratic programs
+ *
+ * min  1/2 x'Px + <q,x>
+ * s.t. l <= Ax <= u
+ *
+ * with P positive semidefinite and possibly infinite bounds l and u, following
+ * the OSQP method. Each iteration solves a linear system with the
+ * quasi-definite matrix
+ *
+ *   [ P + sigma*I        A'    ]
+ *   [      A       -diag(1/rho) ]
+ *
+ * which is factorized once by a sparse LDL^T. The factorization is kept as
+ * long as P, A, and rho do not change, and the symbolic analysis as long as
+ * their sparsity pattern does not change. The iterates are kept between
+ * solves, which warm starts the next solve after changes to q, l, or u.
+ */
+class Admm {
+
+public:
+
+	enum Status {
+
+		Optimal,
+		PrimalInfeasible,
+		DualInfeasible,
+		IterationLimit,
+		TimeLimit,
+		Interrupted,
+		NonConvex
+	};
+
+	Admm();
+
+	/**
+	 * Load a quadratic program. Keeps the symbolic factorization, if the
+	 * sparsity pattern did not change, and the iterates, if the size of the
+	 * problem did not change.
+	 *
+	 * @param q The linear costs.
+	 * @param pRows Rows of the upper triangle entries of P.
+	 * @param pCols Columns of the upper triangle entries of P, not smaller
+	 *              than the rows.
+	 * @param pValues Values of the upper triangle entries of P.
+	 * @param a The rows of A. Relations and values are ignored.
+	 * @param lower The lower bound of each row of A.
+	 * @param upper The upper bound of each row of A.
+	 */
+	void load(
+			const std::vector<double>&       q,
+			const std::vector<unsigned int>& pRows,
+			const std::vector<unsigned int>& pCols,
+			const std::vector<double>&       pValues,
+			const LinearConstraintMatrix&    a,
+			const std::vector<double>&       lower,
+			const std::vector<double>&       upper);
+
+	/**
+	 * Change the linear costs. Keeps the factorization.
+	 */
+	void setCosts(const std::vector<double>& q) { _q = q; }
+
+	/**
+	 * Change the linear cost of a single variable. Keeps the factorization.
+	 */
+	void setCost(unsigned int varNum, double cost) { _q[varNum] = cost; }
+
+	/**
+	 * Change the bounds of a row of A. Keeps the factorization, unless the
+	 * type of the bounds (equality, inequality, or free) changes.
+	 */
+	void setRowBounds(unsigned int row, double lower, double upper);
+
+	/**
+	 * Limit the time of subsequent calls to solve(), in seconds. 0 disables
+	 * the limit.
+	 */
+	void setTimeout(double timeout) { _timeout = timeout; }
+
+	/**
+	 * Stop subsequent calls to solve() with Interrupted as soon as the given
+	 * flag is set, e.g., by another thread. nullptr to not check a flag.
+	 */
+	void setInterrupt(const std::atomic<bool>* interrupt) { _interrupt = interrupt; }
+
+	/**
+	 * Set the absolute and relative tolerances for the primal and dual
+	 * residuals.
+	 */
+	void setTolerances(double absolute, double relative) { _epsAbs = absolute; _epsRel = relative; }
+
+	void setMaxIterations(size_t maxIterations) { _maxIterations = maxIterations; }
+
+	/**
+	 * Solve the quadratic program, starting from the current iterates.
+	 */
+	Status solve();
+
+	/**
+	 * Set the primal iterate x and the dual iterate y, e.g., to warm start
+	 * from a known solution.
+	 */
+	void setIterates(const std::vector<double>& x, const std::vector<double>& y);
+
+	unsigned int numVariables() const { return _n; }
+
+	unsigned int numRows() const { return _m; }
+
+	/**
+	 * @return The value of a variable after solve().
+	 */
+	double getValue(unsigned int varNum) const { return _x[varNum]; }
+
+	/**
+	 * @return The dual value of a row after solve().
+	 */
+	double getDualValue(unsigned int row) const { return _y[row]; }
+
+	/**
+	 * @return The value of the objective after solve().
+	 */
+	double getObjectiveValue() const;
+
+	/**
+	 * @return The number of iterations of the last call to solve().
+	 */
+	size_t getIterations() const { return _iterations; }
+
+private:
+
+	// set up the KKT matrix for the current P, A, and rho
+	void setupKkt();
+
+	// the step sizes for each row, depending on the type of its bounds
+	void setupRho();
+
+	// the step size for a row, depending on the type of its bounds
+	double rowRho(unsigned int row) const;
+
+	// refactorize after a change of rho
+	void updateRho(double rho);
+
+	// the infinity norms of the primal and dual residuals, and of the terms
+	// they are made of
+	void computeResiduals(
+			double& primal,
+			double& dual,
+			double& primalScale,
+			double& dualScale);
+
+	// does the last change of y certify primal infeasibility?
+	bool isPrimalInfeasible();
+
+	// does the last change of x certify dual infeasibility?
+	bool isDualInfeasible();
+
+	// y += Px, considering P symmetric
+	void multiplyP(const std::vector<double>& x, std::vector<double>& y) const;
+
+	// y = Ax
+	void multiplyA(const std::vector<double>& x, std::vector<double>& y) const;
+
+	// y = A'x
+	void multiplyAt(const std::vector<double>& x, std::vector<double>& y) const;
+
+	unsigned int _n;
+	unsigned int _m;
+
+	std::vector<double> _q;
+
+	// upper triangle of P
+	std::vector<unsigned int> _pRows;
+	std::vector<unsigned int> _pCols;
+	std::vector<double>       _pValues;
+
+	// A, row-wise
+	std::vector<size_t>       _aRowOffsets;
+	std::vector<unsigned int> _aColumns;
+	std::vector<double>       _aValues;
+
+	std::vector<double> _lower;
+	std::vector<double> _upper;
+
+	// step size
+	double              _rho;
+	std::vector<double> _rhoRows;
+
+	// the KKT matrix, upper triangle column-wise, and the positions of the
+	// -1/rho entries
+	std::vector<size_t>       _kktColOffsets;
+	std::vector<unsigned int> _kktRows;
+	std::vector<double>       _kktValues;
+	std::vector<size_t>       _kktRhoPositions;
+
+	SparseLdl _ldl;
+
+	// is the factorization up to date with P, A, and rho?
+	bool _factorized;
+
+	// iterates
+	std::vector<double> _x;
+	std::vector<double> _z;
+	std::vector<double> _y;
+
+	// the changes of x and y in the last iteration, to detect infeasibility
+	std::vector<double> _deltaX;
+	std::vector<double> _deltaY;
+
+	// work vectors
+	std::vector<double> _rhs;
+	std::vector<double> _ax;
+	std::vector<double> _px;
+	std::vector<double> _aty;
+
+	double _epsAbs;
+	double _epsRel;
+
+	size_t _maxIterations;
+
+	size_t _iterations;
+
+	double _timeout;
+
+	const std::atomic<bool>* _interrupt;
+};
+
+#endif // INFERENCE_ADMM_H__
+
@@ -0,0 +1,481 @@
+#include <algorithm>
+#include <limits>
+
+#include <boost/timer/timer.hpp>
+#include <boost/chrono.hpp>
+
+#include <util/Logger.h>
+#include <util/exceptions.h>
+#include "AdmmBackend.h"
+
+using namespace logger;
+
+LogChannel admmlog("admmlog", "[AdmmBackend] ");
+
+static const double Infinity = std::numeric_limits<double>::infinity();
+
+// the bounds of a row of the solver for a constraint
+static void
+rowBounds(Relation relation, double value, double& lower, double& upper) {
+
+	lower = (relation == LessEqual    ? -Infinity : value);
+	upper = (relation == GreaterEqual ?  Infinity : value);
+}
+
+AdmmBackend::AdmmBackend() :
+	_numVariables(0),
+	_sense(Minimize),
+	_constant(0),
+	_timeout(0),
+	_gap(-1),
+	_absoluteGap(false),
+	_verbose(false),
+	_dirty(true) {}
+
+void
+AdmmBackend::initialize(
+		unsigned int numVariables,
+		VariableType variableType) {
+
+	initialize(numVariables, variableType, std::map<unsigned int, VariableType>());
+}
+
+void
+AdmmBackend::initialize(
+		unsigned int                                numVariables,
+		VariableType                                defaultVariableType,
+		const std::map<unsigned int, VariableType>& specialVariableTypes) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	_numVariables = numVariables;
+
+	LOG_DEBUG(admmlog) << "creating " << _numVariables << " variables" << std::endl;
+
+	// solutions of a relaxation would be reported as optimal, integer and
+	// binary variables need a backend that branches
+	unsigned int numContinuous = 0;
+	for (auto& p : specialVariableTypes) {
+
+		if (p.first >= _numVariables)
+			continue;
+
+		if (p.second != Continuous)
+			UTIL_THROW_EXCEPTION(
+					UsageError,
+					"AdmmBackend supports continuous variables only, variable " << p.first << " is not continuous");
+
+		numContinuous++;
+	}
+
+	if (defaultVariableType != Continuous && numContinuous < _numVariables)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"AdmmBackend supports continuous variables only, use a mixed-integer backend for integer and binary variables");
+
+	_lower.assign(_numVariables, defaultLowerBound(Continuous));
+	_upper.assign(_numVariables, defaultUpperBound(Continuous));
+
+	_q.assign(_numVariables, 0.0);
+	_pRows.clear();
+	_pCols.clear();
+	_pValues.clear();
+	_constraints.clear();
+	_removed.clear();
+	_constant = 0;
+	_dirty = true;
+}
+
+void
+AdmmBackend::setObjective(const LinearObjective& objective) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	setObjective((QuadraticObjective)objective);
+}
+
+void
+AdmmBackend::setObjective(const QuadraticObjective& objective) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	_sense    = objective.getSense();
+	_constant = objective.getConstant();
+
+	// the solver minimizes, negate for maximization
+	double sign = (_sense == Minimize ? 1.0 : -1.0);
+
+	for (unsigned int i = 0; i < _numVariables; i++)
+		_q[i] = sign*objective.getCoefficients()[i];
+
+	// xQx = 1/2 x'Px for P_ii = 2q_ii and P_ij = P_ji = q_ij
+
+	const std::vector<unsigned int>& rows   = objective.getQuadraticRows();
+	const std::vector<unsigned int>& cols   = objective.getQuadraticColumns();
+	const std::vector<double>&       values = objective.getQuadraticValues();
+
+	std::vector<double> pValues(values.size());
+	for (size_t k = 0; k < values.size(); k++)
+		pValues[k] = sign*(rows[k] == cols[k] ? 2*values[k] : values[k]);
+
+	// keep the factorization, if only the linear costs changed
+	if (rows == _pRows && cols == _pCols && pValues == _pValues) {
+
+		if (!_dirty)
+			_admm.setCosts(_q);
+
+		return;
+	}
+
+	_pRows   = rows;
+	_pCols   = cols;
+	_pValues = pValues;
+	_dirty   = true;
+}
+
+void
+AdmmBackend::setObjectiveCoefficient(unsigned int varNum, double coef) {
+
+	double sign = (_sense == Minimize ? 1.0 : -1.0);
+
+	_q[varNum] = sign*coef;
+
+	if (!_dirty)
+		_admm.setCost(varNum, _q[varNum]);
+}
+
+void
+AdmmBackend::setVariableBounds(unsigned int varNum, double lower, double upper) {
+
+	_lower[varNum] = lower;
+	_upper[varNum] = upper;
+
+	if (_dirty)
+		return;
+
+	// variables without bounds have no row in the solver, adding one
+	// changes the sparsity pattern
+	if (_boundRows[varNum] >= 0)
+		_admm.setRowBounds(_boundRows[varNum], lower, upper);
+	else if (lower != -Infinity || upper != Infinity)
+		_dirty = true;
+}
+
+void
+AdmmBackend::setConstraints(const LinearConstraints& constraints) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	setConstraints(LinearConstraintMatrix(constraints));
+}
+
+void
+AdmmBackend::setConstraints(const LinearConstraintMatrix& constraints) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	LOG_DEBUG(admmlog) << "setting " << constraints.size() << " constraints" << std::endl;
+
+	_constraints = constraints;
+	_removed.assign(_constraints.size(), 0);
+	_dirty = true;
+}
+
+void
+AdmmBackend::addConstraint(const LinearConstraint& constraint) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	_constraints.add(constraint);
+	_removed.push_back(0);
+	_dirty = true;
+}
+
+void
+AdmmBackend::setConstraintValue(unsigned int constraint, double value) {
+
+	checkConstraint(constraint);
+
+	_constraints.setValue(constraint, value);
+
+	if (_dirty)
+		return;
+
+	double lower, upper;
+	rowBounds(_constraints.getRelations()[constraint], value, lower, upper);
+
+	_admm.setRowBounds(_rows[constraint], lower, upper);
+}
+
+void
+AdmmBackend::removeConstraints(const std::vector<unsigned int>& constraints) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	for (unsigned int constraint : constraints) {
+
+		checkConstraint(constraint);
+
+		_removed[constraint] = 1;
+
+		if (_dirty)
+			continue;
+
+		// a free row does not constrain the solution, it is dropped on the
+		// next load
+		_admm.setRowBounds(_rows[constraint], -Infinity, Infinity);
+		_rows[constraint] = -1;
+	}
+}
+
+void
+AdmmBackend::setStartSolution(const Solution& solution) {
+
+	unsigned int size = std::min(solution.size(), _numVariables);
+
+	_startVariables.resize(size);
+	for (unsigned int i = 0; i < size; i++)
+		_startVariables[i] = i;
+	_startValues.assign(solution.getVector().begin(), solution.getVector().begin() + size);
+}
+
+void
+AdmmBackend::setStartSolution(const std::map<unsigned int, double>& values) {
+
+	// the map is sorted, the last variable has the largest number
+	if (!values.empty() && values.rbegin()->first >= _numVariables)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"variable " << values.rbegin()->first << " does not exist");
+
+	_startVariables.clear();
+	_startValues.clear();
+	for (auto& p : values) {
+
+		_startVariables.push_back(p.first);
+		_startValues.push_back(p.second);
+	}
+}
+
+void
+AdmmBackend::setSeparator(const Separator& separator) {
+
+	if (separator)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"AdmmBackend does not support lazy constraints, use a RowGenerationSolver instead");
+}
+
+void
+AdmmBackend::setOptimalityGap(double gap, bool absolute) {
+
+	_gap = gap;
+	_absoluteGap = absolute;
+}
+
+bool
+AdmmBackend::solve(Solution& x, std::string& msg) {
+
+	SolveScope scope(*this);
+
+	double sign = (_sense == Minimize ? 1.0 : -1.0);
+
+	SolveStatistics& statistics = x.getStatistics();
+	statistics = SolveStatistics(_sense);
+	statistics.time[SolveStatistics::Build] = _buildTime;
+	_buildTime = SolveStatistics::Time();
+
+	// loading includes the factorization of the KKT system
+	SolveStatistics::Timer updateTimer(statistics.time[SolveStatistics::Update]);
+	load();
+	updateTimer.stop();
+
+	if (!_startVariables.empty()) {
+
+		// replace the primal iterate, keep the dual one
+
+		std::vector<double> primal(_numVariables);
+		std::vector<double> dual(_admm.numRows());
+
+		for (unsigned int i = 0; i < _numVariables; i++)
+			primal[i] = _admm.getValue(i);
+		for (unsigned int i = 0; i < _admm.numRows(); i++)
+			dual[i] = _admm.getDualValue(i);
+
+		for (size_t i = 0; i < _startVariables.size(); i++)
+			if (_startVariables[i] < _numVariables)
+				primal[_startVariables[i]] = _startValues[i];
+
+		_admm.setIterates(primal, dual);
+
+		// the start is used for this solve only
+		_startVariables.clear();
+		_startValues.clear();
+	}
+
+	if (_gap > 0) {
+
+		if (_absoluteGap)
+			_admm.setTolerances(_gap, 0);
+		else
+			_admm.setTolerances(0, _gap);
+
+		LOG_USER(admmlog)
+				<< "using " << (_absoluteGap ? "absolute" : "relative")
+				<< " tolerance of " << _gap << std::endl;
+	}
+
+	if (_timeout > 0)
+		LOG_USER(admmlog) << "using timeout of " << _timeout << "s for inference" << std::endl;
+
+	_admm.setTimeout(_timeout);
+	_admm.setInterrupt(getInterruptFlag());
+
+	SolveStatistics::Timer solveTimer(statistics.time[SolveStatistics::Solve]);
+
+	boost::timer::cpu_timer timer;
+	timer.start();
+
+	Admm::Status status = _admm.solve();
+
+	boost::chrono::nanoseconds ns(timer.elapsed().system + timer.elapsed().user);
+	double seconds = boost::chrono::duration<double>(ns).count();
+	x.setTime(seconds);
+
+	solveTimer.stop();
+	statistics.numIterations = _admm.getIterations();
+	statistics.peakMemory    = SolveStatistics::peakMemoryOfProcess();
+
+	if (_verbose) {
+
+		LOG_USER(admmlog) << "solved in " << _admm.getIterations() << " iterations" << std::endl;
+
+	} else {
+
+		LOG_DEBUG(admmlog) << "solved in " << _admm.getIterations() << " iterations" << std::endl;
+	}
+
+	if (status != Admm::Optimal) {
+
+		msg = "Optimal solution *NOT* found";
+
+		switch (status) {
+
+			case Admm::PrimalInfeasible:
+				msg += " (problem is infeasible)";
+				statistics.status    = SolveStatistics::Infeasible;
+				statistics.dualBound = sign*Infinity;
+				break;
+			case Admm::DualInfeasible:
+				msg += " (problem is unbounded)";
+				statistics.status = SolveStatistics::Unbounded;
+				break;
+			case Admm::TimeLimit:
+				msg += " (timeout)";
+				statistics.status = SolveStatistics::TimeLimit;
+				break;
+			case Admm::Interrupted:
+				msg += " (interrupted)";
+				statistics.status = SolveStatistics::Interrupted;
+				break;
+			case Admm::IterationLimit:
+				msg += " (iteration limit reached)";
+				statistics.status = SolveStatistics::IterationLimit;
+				break;
+			default:
+				msg += " (objective is not convex)";
+		}
+
+		return false;
+	}
+
+	msg = "Optimal solution found";
+
+	SolveStatistics::Timer extractionTimer(statistics.time[SolveStatistics::Extraction]);
+
+	// extract solution
+	x.resize(_numVariables);
+	for (unsigned int i = 0; i < _numVariables; i++)
+		x[i] = _admm.getValue(i);
+
+	x.setValue(sign*_admm.getObjectiveValue() + _constant);
+
+	extractionTimer.stop();
+
+	// converged within the tolerances
+	statistics.status      = SolveStatistics::Optimal;
+	statistics.primalBound = x.getValue();
+	statistics.dualBound   = x.getValue();
+
+	if (_progressCallback)
+		_progressCallback(Progress(x.getValue(), x.getValue(), timer.elapsed().wall*1e-9));
+
+	return true;
+}
+
+void
+AdmmBackend::load() {
+
+	if (!_dirty)
+		return;
+
+	LOG_ALL(admmlog) << "loading problem into solver" << std::endl;
+
+	// the constraints, followed by one row for each bounded variable
+
+	LinearConstraintMatrix rows;
+	rows.reserve(_constraints.size() + _numVariables, _constraints.numNonZeros() + _numVariables);
+
+	std::vector<double> lower;
+	std::vector<double> upper;
+
+	_rows.assign(_constraints.size(), -1);
+	_boundRows.assign(_numVariables, -1);
+
+	for (unsigned int i = 0; i < _constraints.size(); i++) {
+
+		if (_removed[i])
+			continue;
+
+		size_t offset = _constraints.getRowOffsets()[i];
+
+		_rows[i] = rows.size();
+
+		rows.addRow(
+				_constraints.numNonZeros(i),
+				_constraints.getColumns().data() + offset,
+				_constraints.getCoefficients().data() + offset,
+				_constraints.getRelations()[i],
+				_constraints.getValues()[i]);
+
+		double l, u;
+		rowBounds(_constraints.getRelations()[i], _constraints.getValues()[i], l, u);
+		lower.push_back(l);
+		upper.push_back(u);
+	}
+
+	double one = 1.0;
+	for (unsigned int j = 0; j < _numVariables; j++) {
+
+		if (_lower[j] == -Infinity && _upper[j] == Infinity)
+			continue;
+
+		_boundRows[j] = rows.size();
+
+		rows.addRow(1, &j, &one, Equal, 0);
+		lower.push_back(_lower[j]);
+		upper.push_back(_upper[j]);
+	}
+
+	_admm.load(_q, _pRows, _pCols, _pValues, rows, lower, upper);
+	_dirty = false;
+}
+
+void
+AdmmBackend::checkConstraint(unsigned int constraint) const {
+
+	if (constraint >= _constraints.size() || _removed[constraint])
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"constraint " << constraint << " does not exist");
+}
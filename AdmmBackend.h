@@ -0,0 +1,151 @@
+#ifndef INFERENCE_ADMM_BACKEND_H__
+#define INFERENCE_ADMM_BACKEND_H__
+
+#include <string>
+#include <vector>
+
+#include "Admm.h"
+#include "LinearConstraintMatrix.h"
+#include "QuadraticSolverBackend.h"
+
+/**
+ * Built-in convex quadratic program solver without external dependencies,
+ * based on an operator splitting method (see Admm). Solves
+ *
+ * min  <a,x> + xQx
+ * s.t. Ax  == b
+ *      Cx  <= d
+ *
+ * for continuous variables, with Q positive semidefinite (negative
+ * semidefinite for maximization). Only continuous variables are supported,
+ * initialize() throws a UsageError for integer and binary variables.
+ *
+ * The solution is accurate up to the optimality gap, which is used as the
+ * tolerance on the primal and dual residuals. This makes the backend suitable
+ * for large problems that need moderate accuracy: memory grows linearly with
+ * the number of non-zeros of Q and the constraints, plus the fill-in of the
+ * factorization.
+ *
+ * Start solutions replace the primal iterate of the previous solve, the dual
+ * iterate is kept. Lazy constraints are not supported, since the iterates
+ * satisfy the constraints only up to the tolerance.
+ */
+class AdmmBackend : public QuadraticSolverBackend {
+
+public:
+
+	AdmmBackend();
+
+	///////////////////////////////////
+	// solver backend implementation //
+	///////////////////////////////////
+
+	void initialize(
+			unsigned int numVariables,
+			VariableType variableType);
+
+	void initialize(
+			unsigned int                                numVariables,
+			VariableType                                defaultVariableType,
+			const std::map<unsigned int, VariableType>& specialVariableTypes);
+
+	void setObjective(const LinearObjective& objective);
+
+	void setObjective(const QuadraticObjective& objective);
+
+	void setConstraints(const LinearConstraints& constraints);
+
+	void setConstraints(const LinearConstraintMatrix& constraints);
+
+	using LinearSolverBackend::setConstraints;
+
+	void addConstraint(const LinearConstraint& constraint);
+
+	void setObjectiveCoefficient(unsigned int varNum, double coef);
+
+	void setVariableBounds(unsigned int varNum, double lower, double upper);
+
+	void setConstraintValue(unsigned int constraint, double value);
+
+	void removeConstraints(const std::vector<unsigned int>& constraints);
+
+	void setStartSolution(const Solution& solution);
+
+	void setStartSolution(const std::map<unsigned int, double>& values);
+
+	void setSeparator(const Separator& separator);
+
+	void setTimeout(double timeout) { _timeout = timeout; }
+
+	void setOptimalityGap(double gap, bool absolute=false);
+
+	void setNumThreads(unsigned int /*numThreads*/) {}
+
+	void setVerbose(bool verbose) { _verbose = verbose; }
+
+	void setProgressCallback(const ProgressCallback& callback) { _progressCallback = callback; }
+
+	bool solve(Solution& solution, std::string& message);
+
+private:
+
+	// the solver polls the interrupt flag
+	void interruptSolver() {}
+
+	// load the problem into the solver, if it changed since the last solve
+	void load();
+
+	void checkConstraint(unsigned int constraint) const;
+
+	unsigned int _numVariables;
+
+	std::vector<double> _lower;
+
+	std::vector<double> _upper;
+
+	// the linear costs and the upper triangle of P of the objective
+	// 1/2 x'Px + <q,x>
+	std::vector<double>       _q;
+	std::vector<unsigned int> _pRows;
+	std::vector<unsigned int> _pCols;
+	std::vector<double>       _pValues;
+
+	// all constraints since the last setConstraints(), including removed ones
+	LinearConstraintMatrix _constraints;
+
+	std::vector<char> _removed;
+
+	// the row of each constraint and of the bounds of each variable in the
+	// loaded problem, -1 if there is none
+	std::vector<int> _rows;
+	std::vector<int> _boundRows;
+
+	// the start values for the next solve
+	std::vector<unsigned int> _startVariables;
+	std::vector<double>       _startValues;
+
+	ProgressCallback _progressCallback;
+
+	Sense _sense;
+
+	double _constant;
+
+	double _timeout;
+
+	double _gap;
+
+	bool _absoluteGap;
+
+	bool _verbose;
+
+	Admm _admm;
+
+	// do we have to reload the problem into the solver?
+	bool _dirty;
+
+	// time spent in the calls that build the model since the last solve()
+	SolveStatistics::Time _buildTime;
+};
+
+#endif // INFERENCE_ADMM_BACKEND_H__
+
@@ -0,0 +1,189 @@
+#include <algorithm>
+
+#include "BackendTrace.h"
+
+static const char Magic[8] = { 'S', 'L', 'V', 'T', 'R', 'A', 'C', 'E' };
+
+// written in the byte order of the writer, to detect a different one
+static const uint32_t ByteOrderMarker = 0x01020304;
+
+struct Header {
+
+	char     magic[8];
+	uint32_t version;
+	uint32_t byteOrder;
+};
+
+struct RecordHeader {
+
+	uint8_t  call;
+	uint64_t size;
+	double   seconds;
+};
+
+static const char* CallNames[NumTraceCalls] = {
+
+	"initialize",
+	"setObjective",
+	"setObjective (quadratic)",
+	"setConstraints",
+	"addConstraint",
+	"setObjectiveCoefficient",
+	"setVariableBounds",
+	"setConstraintValue",
+	"removeConstraints",
+	"setStartSolution",
+	"setSeparator",
+	"setTimeout",
+	"setOptimalityGap",
+	"setNumThreads",
+	"setVerbose",
+	"solve"
+};
+
+const char*
+traceCallName(TraceCall call) {
+
+	if (call < 0 || call >= NumTraceCalls)
+		return "unknown";
+
+	return CallNames[call];
+}
+
+TraceWriter::TraceWriter(const std::string& filename) :
+	_out(filename.c_str(), std::ios::binary),
+	_filename(filename) {
+
+	if (!_out)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"can not create trace " << filename);
+
+	Header header;
+	std::memcpy(header.magic, Magic, sizeof(Magic));
+	header.version   = Version;
+	header.byteOrder = ByteOrderMarker;
+
+	_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void
+TraceWriter::write(TraceCall call, double seconds, const Record& record) {
+
+	// the fields one by one, without the padding of RecordHeader
+	uint8_t  c    = call;
+	uint64_t size = record._arguments.size();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_out.write(reinterpret_cast<const char*>(&c), sizeof(c));
+	_out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+	_out.write(reinterpret_cast<const char*>(&seconds), sizeof(seconds));
+	_out.write(record._arguments.data(), size);
+
+	if (!_out)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"could not write to trace " << _filename);
+}
+
+void
+TraceWriter::flush() {
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_out.flush();
+}
+
+TraceReader::TraceReader(const std::string& filename) :
+	_in(filename.c_str(), std::ios::binary),
+	_filename(filename),
+	_number(0),
+	_call(NumTraceCalls),
+	_seconds(0),
+	_position(0) {
+
+	if (!_in)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"can not open trace " << filename);
+
+	Header header;
+	_in.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	if (!_in || std::memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				filename << " is not a trace");
+
+	if (header.byteOrder != ByteOrderMarker)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				filename << " was written on a machine with a different byte order");
+
+	if (header.version != TraceWriter::Version)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				filename << " has version " << header.version << ", expected " << TraceWriter::Version);
+}
+
+bool
+TraceReader::next(bool readArguments) {
+
+	if (_call != NumTraceCalls)
+		_number++;
+
+	RecordHeader header;
+
+	_in.read(reinterpret_cast<char*>(&header.call), sizeof(header.call));
+	if (_in.gcount() == 0)
+		return false;
+
+	_in.read(reinterpret_cast<char*>(&header.size), sizeof(header.size));
+	_in.read(reinterpret_cast<char*>(&header.seconds), sizeof(header.seconds));
+
+	if (!_in)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				_filename << ": record " << _number << " is truncated");
+
+	if (header.call >= NumTraceCalls)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				_filename << ": record " << _number << " has an unknown call " << static_cast<int>(header.call));
+
+	_arguments.clear();
+
+	if (!readArguments) {
+
+		_in.seekg(header.size, std::ios::cur);
+
+		if (!_in)
+			UTIL_THROW_EXCEPTION(
+					IOError,
+					_filename << ": record " << _number << " is truncated");
+	}
+
+	// read large records in steps, to not allocate more than the file holds
+	const uint64_t step = 64*1024*1024;
+	for (uint64_t read = 0; readArguments && read < header.size; ) {
+
+		size_t size = std::min(step, header.size - read);
+
+		_arguments.resize(read + size);
+		_in.read(&_arguments[read], size);
+
+		if (!_in)
+			UTIL_THROW_EXCEPTION(
+					IOError,
+					_filename << ": record " << _number << " is truncated");
+
+		read += size;
+	}
+
+	_call     = static_cast<TraceCall>(header.call);
+	_seconds  = header.seconds;
+	_position = 0;
+
+	return true;
+}
@@ -0,0 +1,256 @@
+#ifndef INFERENCE_BACKEND_TRACE_H__
+#define INFERENCE_BACKEND_TRACE_H__
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <util/exceptions.h>
+
+/**
+ * The calls to a backend that are recorded in a trace, see RecordingBackend
+ * and TraceReplayer. The arguments of each call are stored in the given
+ * order, enums as int32, flags as uint8, and arrays without their size if
+ * it was stored before.
+ */
+enum TraceCall {
+
+	// uint32 numVariables, int32 defaultType, uint32 numSpecial,
+	// numSpecial x (uint32 variable, int32 type)
+	TraceInitialize,
+
+	// int32 sense, double constant, uint32 size, double coefficients[size]
+	TraceSetObjective,
+
+	// as TraceSetObjective, followed by uint64 numTerms, uint32 rows[],
+	// uint32 columns[], double values[]
+	TraceSetQuadraticObjective,
+
+	// uint8 TraceConstraintsType, uint32 numRows, uint64 numNonZeros, uint64
+	// rowOffsets[numRows+1], uint32 columns[], double coefficients[], int32
+	// relations[numRows], double values[numRows]
+	TraceSetConstraints,
+
+	// uint32 size, uint32 variables[], double coefficients[], int32 relation,
+	// double value
+	TraceAddConstraint,
+
+	// uint32 variable, double coefficient
+	TraceSetObjectiveCoefficient,
+
+	// uint32 variable, double lower, double upper
+	TraceSetVariableBounds,
+
+	// uint32 constraint, double value
+	TraceSetConstraintValue,
+
+	// uint32 size, uint32 constraints[]
+	TraceRemoveConstraints,
+
+	// uint8 whether a Solution was given, uint32 size, uint32 variables[],
+	// double values[]
+	TraceSetStartSolution,
+
+	// no arguments, separators can not be recorded
+	TraceSetSeparator,
+
+	// double timeout
+	TraceSetTimeout,
+
+	// double gap, uint8 absolute
+	TraceSetOptimalityGap,
+
+	// uint32 numThreads
+	TraceSetNumThreads,
+
+	// uint8 verbose
+	TraceSetVerbose,
+
+	// the result: uint8 solved, double value, uint32 size of the solution,
+	// uint32 length, char message[length]
+	TraceSolve,
+
+	NumTraceCalls
+};
+
+/**
+ * The overload of setConstraints() that was recorded.
+ */
+enum TraceConstraintsType {
+
+	TraceLinearConstraints,
+	TraceLinearConstraintMatrix,
+	TraceLinearConstraintMatrixView
+};
+
+/**
+ * @return The name of the backend method of a trace call.
+ */
+const char* traceCallName(TraceCall call);
+
+/**
+ * Writes a trace of backend calls to a file.
+ *
+ * A trace starts with a header (magic "SLVTRACE", format version, and byte
+ * order marker), followed by one record per call:
+ *
+ *   call       uint8
+ *   size       uint64, the number of bytes of the arguments
+ *   seconds    double, the wall time the call took
+ *   arguments  size bytes
+ *
+ * The arguments are the values of the call in binary, in the byte order of
+ * the writing machine. Records are written as a whole, calls from several
+ * threads are serialized.
+ */
+class TraceWriter {
+
+public:
+
+	/**
+	 * The version of the format written by this class.
+	 */
+	static const unsigned int Version = 1;
+
+	/**
+	 * Create a trace file. Throws an IOError if it can not be created.
+	 */
+	explicit TraceWriter(const std::string& filename);
+
+	/**
+	 * The arguments of a call, in the order of the backend method.
+	 */
+	class Record {
+
+	public:
+
+		template <typename T>
+		void put(const T& value) {
+
+			putArray(&value, 1);
+		}
+
+		template <typename T>
+		void putArray(const T* values, size_t size) {
+
+			const char* data = reinterpret_cast<const char*>(values);
+			_arguments.insert(_arguments.end(), data, data + size*sizeof(T));
+		}
+
+	private:
+
+		friend class TraceWriter;
+
+		std::vector<char> _arguments;
+	};
+
+	/**
+	 * Write the record of a call.
+	 */
+	void write(TraceCall call, double seconds, const Record& record);
+
+	/**
+	 * Flush the written records to the file.
+	 */
+	void flush();
+
+private:
+
+	std::ofstream _out;
+	std::string   _filename;
+	std::mutex    _mutex;
+};
+
+/**
+ * Reads the records of a trace written by TraceWriter one by one.
+ */
+class TraceReader {
+
+public:
+
+	/**
+	 * Open a trace file. Throws an IOError if it can not be opened or is not
+	 * a trace of this version.
+	 */
+	explicit TraceReader(const std::string& filename);
+
+	/**
+	 * Read the next record.
+	 *
+	 * @param readArguments
+	 *             If false, only the call and time of the record are read,
+	 *             and its arguments are skipped.
+	 *
+	 * @return false at the end of the trace.
+	 */
+	bool next(bool readArguments = true);
+
+	/**
+	 * @return The number of the current record, starting at 0.
+	 */
+	size_t getNumber() const { return _number; }
+
+	TraceCall getCall() const { return _call; }
+
+	/**
+	 * @return The wall time of the current call when it was recorded.
+	 */
+	double getSeconds() const { return _seconds; }
+
+	/**
+	 * Get the next argument of the current record. Throws an IOError if the
+	 * record has no more arguments.
+	 */
+	template <typename T>
+	T get() {
+
+		T value;
+		getArray(&value, 1);
+		return value;
+	}
+
+	template <typename T>
+	void getArray(T* values, size_t size) {
+
+		if (size*sizeof(T) > _arguments.size() - _position)
+			UTIL_THROW_EXCEPTION(
+					IOError,
+					_filename << ": record " << _number << " is too short");
+
+		if (size > 0)
+			std::memcpy(values, &_arguments[_position], size*sizeof(T));
+		_position += size*sizeof(T);
+	}
+
+	/**
+	 * Get the next size arguments of the current record.
+	 */
+	template <typename T>
+	std::vector<T> getVector(size_t size) {
+
+		if (size*sizeof(T) > _arguments.size() - _position)
+			UTIL_THROW_EXCEPTION(
+					IOError,
+					_filename << ": record " << _number << " is too short");
+
+		std::vector<T> values(size);
+		getArray(values.data(), size);
+		return values;
+	}
+
+private:
+
+	std::ifstream     _in;
+	std::string       _filename;
+	size_t            _number;
+	TraceCall         _call;
+	double            _seconds;
+	std::vector<char> _arguments;
+	size_t            _position;
+};
+
+#endif // INFERENCE_BACKEND_TRACE_H__
+
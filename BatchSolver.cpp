@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <thread>
+
+#include <util/Logger.h>
+#include "BatchSolver.h"
+#include "LinearObjective.h"
+#include "Parallel.h"
+#include "Timing.h"
+
+using namespace logger;
+
+LogChannel batchlog("batchlog", "[BatchSolver] ");
+
+BatchSolver::BatchSolver(const Parameter& parameter) :
+	_parameter(parameter) {}
+
+unsigned int
+BatchSolver::addProblem(const Problem& problem) {
+
+	if (problem.objective.size() != problem.numVariables)
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"objective has " << problem.objective.size() << " coefficients, expected " << problem.numVariables);
+
+	_problems.push_back(problem);
+
+	return _problems.size() - 1;
+}
+
+const std::vector<BatchSolver::Result>&
+BatchSolver::solve() {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	_results.assign(_problems.size(), Result());
+
+	unsigned int numWorkers = _parameter.numWorkers;
+	if (numWorkers == 0)
+		numWorkers = std::max(1u, std::thread::hardware_concurrency());
+	numWorkers = numLoopThreads(numWorkers, _problems.size(), 1);
+
+	// keep the backends of workers that are not needed this time
+	if (_workers.size() < numWorkers)
+		_workers.resize(numWorkers);
+
+	LOG_USER(batchlog)
+			<< "solving " << _problems.size() << " problems with "
+			<< numWorkers << " workers" << std::endl;
+
+	std::atomic<size_t> next(0);
+	std::vector<std::exception_ptr> errors(numWorkers);
+
+	auto work = [&](unsigned int t) {
+
+		try {
+
+			for (size_t i = next++; i < _problems.size(); i = next++)
+				solveProblem(_workers[t], _problems[i], _results[i]);
+
+		} catch (...) {
+
+			errors[t] = std::current_exception();
+			next = _problems.size();
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned int t = 1; t < numWorkers; t++)
+		workers.emplace_back(work, t);
+	work(0);
+	for (std::thread& worker : workers)
+		worker.join();
+
+	_problems.clear();
+
+	for (std::exception_ptr& error : errors)
+		if (error)
+			std::rethrow_exception(error);
+
+	_statistics = Statistics();
+	_statistics.numProblems = _results.size();
+	_statistics.time        = secondsSince(start);
+
+	for (const Result& result : _results) {
+
+		if (result.solved)
+			_statistics.numSolved++;
+
+		_statistics.meanTime += result.time;
+		_statistics.maxTime   = std::max(_statistics.maxTime, result.time);
+	}
+
+	if (_statistics.numProblems > 0)
+		_statistics.meanTime /= _statistics.numProblems;
+	if (_statistics.time > 0)
+		_statistics.problemsPerSecond = _statistics.numProblems/_statistics.time;
+
+	LOG_USER(batchlog)
+			<< "solved " << _statistics.numSolved << " of " << _statistics.numProblems
+			<< " problems in " << _statistics.time << "s ("
+			<< _statistics.problemsPerSecond << " problems/s, "
+			<< _statistics.meanTime << "s mean, "
+			<< _statistics.maxTime << "s max per problem)" << std::endl;
+
+	return _results;
+}
+
+void
+BatchSolver::solveProblem(Worker& worker, const Problem& problem, Result& result) const {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	unsigned int n = problem.numVariables;
+
+	std::shared_ptr<LinearSolverBackend> backend;
+
+	if (problem.objective.numQuadraticTerms() > 0) {
+
+		if (!worker.quadraticBackend)
+			worker.quadraticBackend = _factory.createQuadraticSolverBackend(_parameter.preference);
+
+		worker.quadraticBackend->initialize(n, problem.defaultVariableType, problem.specialVariableTypes);
+		worker.quadraticBackend->setObjective(problem.objective);
+		backend = worker.quadraticBackend;
+
+	} else {
+
+		if (!worker.linearBackend)
+			worker.linearBackend = _factory.createLinearSolverBackend(_parameter.preference);
+
+		LinearObjective objective(n);
+		objective.setSense(problem.objective.getSense());
+		objective.setConstant(problem.objective.getConstant());
+		for (unsigned int i = 0; i < n; i++)
+			objective.setCoefficient(i, problem.objective.getCoefficients()[i]);
+
+		worker.linearBackend->initialize(n, problem.defaultVariableType, problem.specialVariableTypes);
+		worker.linearBackend->setObjective(objective);
+		backend = worker.linearBackend;
+	}
+
+	// backends may create a new model in initialize() (e.g., Gurobi), so the
+	// parameters have to be set again for each problem
+	backend->setNumThreads(1);
+	backend->setVerbose(_parameter.verbose);
+	if (_parameter.timeout > 0)
+		backend->setTimeout(_parameter.timeout);
+	if (_parameter.gap > 0)
+		backend->setOptimalityGap(_parameter.gap, _parameter.absoluteGap);
+
+	backend->setConstraints(problem.constraints);
+
+	for (auto& p : problem.bounds)
+		backend->setVariableBounds(p.first, p.second.first, p.second.second);
+
+	result.solved = backend->solve(result.solution, result.message);
+	result.time   = secondsSince(start);
+}
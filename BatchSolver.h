@@ -0,0 +1,194 @@
+#ifndef INFERENCE_BATCH_SOLVER_H__
+#define INFERENCE_BATCH_SOLVER_H__
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "LinearConstraintMatrix.h"
+#include "LinearSolverBackend.h"
+#include "QuadraticObjective.h"
+#include "QuadraticSolverBackend.h"
+#include "Solution.h"
+#include "SolverFactory.h"
+#include "VariableType.h"
+
+/**
+ * Solves a queue of independent problems with a pool of backends that are
+ * reused from one problem to the next.
+ *
+ * Creating a backend can be much more expensive than solving a small problem,
+ * e.g., Gurobi loads an environment and SCIP includes all its plugins. The
+ * batch solver therefore keeps one backend per worker thread, which is
+ * re-initialized for each problem the worker takes from the queue, and kept
+ * for the following calls to solve().
+ *
+ * Problems without quadratic terms are solved with a linear backend, the
+ * others with a quadratic backend. The results are returned in the order in
+ * which the problems were added:
+ *
+ *   BatchSolver batch;
+ *   for (const BatchSolver::Problem& problem : problems)
+ *     batch.addProblem(problem);
+ *
+ *   const std::vector<BatchSolver::Result>& results = batch.solve();
+ *   std::cout << batch.getStatistics().problemsPerSecond << std::endl;
+ */
+class BatchSolver {
+
+public:
+
+	struct Parameter {
+
+		Parameter() :
+			preference(Any),
+			numWorkers(0),
+			timeout(0),
+			gap(0),
+			absoluteGap(false),
+			verbose(false) {}
+
+		// the backends to create for the pool
+		Preference preference;
+
+		// the number of problems solved at the same time, each with a
+		// single-threaded backend, 0 for all hardware threads
+		unsigned int numWorkers;
+
+		// the timeout in seconds for each problem, 0 for no timeout
+		double timeout;
+
+		// the optimality gap for each problem, see
+		// LinearSolverBackend::setOptimalityGap()
+		double gap;
+		bool   absoluteGap;
+
+		bool verbose;
+	};
+
+	/**
+	 * A problem of the batch.
+	 */
+	struct Problem {
+
+		Problem() :
+			numVariables(0),
+			defaultVariableType(Continuous) {}
+
+		unsigned int                         numVariables;
+		VariableType                         defaultVariableType;
+		std::map<unsigned int, VariableType> specialVariableTypes;
+
+		// the objective, linear or quadratic
+		QuadraticObjective objective;
+
+		LinearConstraintMatrix constraints;
+
+		// lower and upper bounds of variables that differ from the defaults
+		// of their types
+		std::map<unsigned int, std::pair<double, double>> bounds;
+	};
+
+	/**
+	 * The result of a problem of the batch.
+	 */
+	struct Result {
+
+		Result() :
+			solved(false),
+			time(0) {}
+
+		Solution    solution;
+		std::string message;
+		bool        solved;
+
+		// the wall time in seconds to set up and solve the problem
+		double time;
+	};
+
+	/**
+	 * Throughput of the last call to solve().
+	 */
+	struct Statistics {
+
+		Statistics() :
+			numProblems(0),
+			numSolved(0),
+			time(0),
+			problemsPerSecond(0),
+			meanTime(0),
+			maxTime(0) {}
+
+		unsigned int numProblems;
+
+		// the number of problems for which a solution was found
+		unsigned int numSolved;
+
+		// the wall time in seconds for the whole batch
+		double time;
+
+		double problemsPerSecond;
+
+		// the mean and maximal time per problem, see Result::time
+		double meanTime;
+		double maxTime;
+	};
+
+	BatchSolver(const Parameter& parameter = Parameter());
+
+	/**
+	 * Add a problem to the queue.
+	 *
+	 * @return The number of the problem in the results of the next solve().
+	 */
+	unsigned int addProblem(const Problem& problem);
+
+	/**
+	 * @return The number of problems in the queue.
+	 */
+	unsigned int size() const { return _problems.size(); }
+
+	/**
+	 * Solve all problems in the queue, and empty the queue.
+	 *
+	 * @return The results, in the order in which the problems were added.
+	 */
+	const std::vector<Result>& solve();
+
+	/**
+	 * @return The results of the last call to solve().
+	 */
+	const std::vector<Result>& getResults() const { return _results; }
+
+	/**
+	 * @return The throughput of the last call to solve().
+	 */
+	const Statistics& getStatistics() const { return _statistics; }
+
+private:
+
+	// the backends of a worker, created when first needed
+	struct Worker {
+
+		std::shared_ptr<LinearSolverBackend>    linearBackend;
+		std::shared_ptr<QuadraticSolverBackend> quadraticBackend;
+	};
+
+	// set up a problem in the backends of a worker and solve it
+	void solveProblem(Worker& worker, const Problem& problem, Result& result) const;
+
+	SolverFactory _factory;
+
+	Parameter _parameter;
+
+	std::vector<Problem> _problems;
+	std::vector<Result>  _results;
+	std::vector<Worker>  _workers;
+
+	Statistics _statistics;
+};
+
+#endif // INFERENCE_BATCH_SOLVER_H__
+
@@ -0,0 +1,554 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+#include "BranchAndBound.h"
+#include "Parallel.h"
+
+static const double Infinity = std::numeric_limits<double>::infinity();
+
+// values within this distance of an integer are considered integral
+static const double IntegralityTolerance = 1e-6;
+
+// minimal improvement of the objective for a node to be worth exploring
+static const double ObjectiveTolerance = 1e-6;
+
+// rows returned by the separator have to be violated by more than this
+static const double LazyTolerance = 1e-6;
+
+// the minimal time between two calls of the progress callback
+static const std::chrono::milliseconds ProgressInterval(100);
+
+BranchAndBound::BranchAndBound(
+		Simplex&                         relaxation,
+		const std::vector<unsigned int>& integerVariables) :
+	_relaxation(relaxation),
+	_integerVariables(integerVariables),
+	_numOpenNodes(0),
+	_numNodes(0),
+	_numIterations(0),
+	_remainingBound(Infinity),
+	_bound(-Infinity),
+	_timedOut(false),
+	_interrupted(false),
+	_failed(false),
+	_numLazyRows(0),
+	_startValue(Infinity),
+	_value(Infinity),
+	_numThreads(0),
+	_timeout(0),
+	_interrupt(nullptr),
+	_gap(0),
+	_absoluteGap(false) {}
+
+void
+BranchAndBound::setIncumbent(const std::vector<double>& solution, double value) {
+
+	_startSolution = solution;
+	_startValue    = value;
+}
+
+BranchAndBound::Status
+BranchAndBound::solve() {
+
+	_start = std::chrono::steady_clock::now();
+	_lastProgress = _start;
+
+	_solution = _startSolution;
+	_value    = _startValue;
+	_numNodes = 0;
+	_numIterations  = 0;
+	_remainingBound = Infinity;
+	_bound          = -Infinity;
+	_timedOut    = false;
+	_interrupted = false;
+	_failed      = false;
+
+	_lazyRows = LinearConstraintMatrix();
+	_numLazyRows = 0;
+
+	// the start has to satisfy the lazy constraints as well
+	if (_separator && hasSolution() && separate(_solution)) {
+
+		_solution.clear();
+		_value = Infinity;
+	}
+
+	// solve the root on the relaxation itself, to warm start the next solve
+
+	_relaxation.setTimeout(_timeout);
+	_relaxation.setInterrupt(_interrupt);
+	Simplex::Status status = _relaxation.solve();
+	_numNodes++;
+	_numIterations += _relaxation.getIterations();
+
+	switch (status) {
+
+		case Simplex::Optimal:
+			break;
+		case Simplex::Infeasible:
+			_bound = Infinity;
+			return Infeasible;
+		case Simplex::Unbounded:
+			return Unbounded;
+		case Simplex::TimeLimit:
+			return TimeLimit;
+		case Simplex::Interrupted:
+			return Interrupted;
+		default:
+			return NumericalFailure;
+	}
+
+	// the incumbent can not be improved by more than the gap
+	if (_relaxation.getObjectiveValue() >= cutoff()) {
+
+		_bound = std::min(_relaxation.getObjectiveValue(), _value.load());
+		return Optimal;
+	}
+
+	int varNum = branchingVariable(_relaxation);
+	if (varNum < 0 && !_separator) {
+
+		updateSolution(_relaxation);
+		_bound = _relaxation.getObjectiveValue();
+		return Optimal;
+	}
+
+	unsigned int n = _relaxation.numVariables();
+	_rootLower.resize(n);
+	_rootUpper.resize(n);
+	for (unsigned int i = 0; i < n; i++) {
+
+		_rootLower[i] = _relaxation.getLower(i);
+		_rootUpper[i] = _relaxation.getUpper(i);
+	}
+
+	unsigned int numWorkers = numLoopThreads(_numThreads, std::numeric_limits<size_t>::max(), 1);
+
+	_workers.clear();
+	for (unsigned int t = 0; t < numWorkers; t++)
+		_workers.emplace_back(new Worker(_relaxation));
+
+	if (varNum >= 0) {
+
+		// the children of the root go to the first worker, the others steal
+		branch(*_workers[0], _relaxation, std::vector<BoundChange>(), varNum);
+
+	} else {
+
+		// an integral root has to be checked for lazy constraints, which is
+		// done by processing it again on a copy
+		std::shared_ptr<Simplex::Basis> basis = std::make_shared<Simplex::Basis>();
+		_relaxation.getBasis(*basis);
+
+		Node root;
+		root.basis = basis;
+		root.bound = _relaxation.getObjectiveValue();
+
+		push(*_workers[0], std::move(root));
+	}
+
+	parallelForChunks(
+			numWorkers,
+			numWorkers,
+			1,
+			[this](unsigned int t, size_t, size_t) { work(t); });
+
+	// the optimum is the incumbent, or in one of the nodes that were not
+	// explored to the end
+	_bound = std::min(_value.load(), _remainingBound.load());
+	for (auto& worker : _workers)
+		for (const Node& node : worker->nodes)
+			_bound = std::min(_bound, node.bound);
+
+	_workers.clear();
+
+	if (_interrupted)
+		return Interrupted;
+	if (_timedOut)
+		return TimeLimit;
+	if (_failed)
+		return NumericalFailure;
+	if (!hasSolution())
+		return Infeasible;
+
+	return Optimal;
+}
+
+void
+BranchAndBound::work(unsigned int t) {
+
+	Node node;
+
+	while (!_timedOut && !_interrupted) {
+
+		if (!nextNode(t, node)) {
+
+			if (_numOpenNodes == 0)
+				return;
+
+			std::this_thread::yield();
+			continue;
+		}
+
+		process(*_workers[t], node);
+
+		_workers[t]->bound = Infinity;
+		reportProgress(false);
+
+		// children have been pushed already, so this reaches 0 only if the
+		// tree is exhausted
+		_numOpenNodes--;
+	}
+}
+
+bool
+BranchAndBound::nextNode(unsigned int t, Node& node) {
+
+	{
+		Worker& own = *_workers[t];
+		std::lock_guard<std::mutex> lock(own.mutex);
+
+		if (!own.nodes.empty()) {
+
+			node = std::move(own.nodes.back());
+			own.nodes.pop_back();
+			own.bound = node.bound;
+			return true;
+		}
+	}
+
+	for (unsigned int i = 1; i < _workers.size(); i++) {
+
+		Worker& victim = *_workers[(t + i)%_workers.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+
+		if (!victim.nodes.empty()) {
+
+			node = std::move(victim.nodes.front());
+			victim.nodes.pop_front();
+			_workers[t]->bound = node.bound;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void
+BranchAndBound::process(Worker& worker, const Node& node) {
+
+	if (node.bound >= cutoff()) {
+
+		addRemainingBound(node.bound);
+		return;
+	}
+
+	_numNodes++;
+
+	Simplex& simplex = worker.simplex;
+
+	// reset the bounds of the previous node, apply the ones of this node
+
+	for (unsigned int varNum : worker.changed)
+		simplex.setBounds(varNum, _rootLower[varNum], _rootUpper[varNum]);
+	worker.changed.clear();
+
+	for (const BoundChange& change : node.changes) {
+
+		simplex.setBounds(change.varNum, change.lower, change.upper);
+		worker.changed.push_back(change.varNum);
+	}
+
+	addLazyRows(worker);
+
+	simplex.setBasis(*node.basis);
+
+	std::vector<double> x;
+
+	while (true) {
+
+		simplex.setTimeout(remainingTime());
+
+		Simplex::Status status = simplex.solve();
+		_numIterations += simplex.getIterations();
+
+		if (status == Simplex::TimeLimit) {
+
+			_timedOut = true;
+			addRemainingBound(node.bound);
+			return;
+		}
+
+		if (status == Simplex::Interrupted) {
+
+			_interrupted = true;
+			addRemainingBound(node.bound);
+			return;
+		}
+
+		if (status == Simplex::Infeasible)
+			return;
+
+		if (status != Simplex::Optimal) {
+
+			// the subtree is lost, the result can not be proven optimal
+			_failed = true;
+			addRemainingBound(node.bound);
+			return;
+		}
+
+		if (simplex.getObjectiveValue() >= cutoff()) {
+
+			addRemainingBound(simplex.getObjectiveValue());
+			return;
+		}
+
+		int varNum = branchingVariable(simplex);
+		if (varNum >= 0) {
+
+			branch(worker, simplex, node.changes, varNum);
+			return;
+		}
+
+		if (_separator) {
+
+			getSolution(simplex, x);
+
+			// solve again with the violated rows, starting from the
+			// current basis
+			if (separate(x)) {
+
+				addLazyRows(worker);
+				continue;
+			}
+		}
+
+		updateSolution(simplex);
+		return;
+	}
+}
+
+void
+BranchAndBound::branch(
+		Worker&                         worker,
+		const Simplex&                  simplex,
+		const std::vector<BoundChange>& changes,
+		unsigned int                    varNum) {
+
+	double value = simplex.getValue(varNum);
+	double lower = simplex.getLower(varNum);
+	double upper = simplex.getUpper(varNum);
+	double bound = simplex.getObjectiveValue();
+
+	std::shared_ptr<Simplex::Basis> basis = std::make_shared<Simplex::Basis>();
+	simplex.getBasis(*basis);
+
+	// bounds of the children, which can be empty for non-integral bounds
+	double downUpper = std::floor(value);
+	double upLower   = std::ceil(value);
+
+	Node down;
+	down.changes = changes;
+	down.changes.push_back(BoundChange{varNum, lower, downUpper});
+	down.basis = basis;
+	down.bound = bound;
+
+	Node up;
+	up.changes = changes;
+	up.changes.push_back(BoundChange{varNum, upLower, upper});
+	up.basis = basis;
+	up.bound = bound;
+
+	// the child in the direction of rounding is pushed last, to be explored
+	// first
+	bool downFirst = (value - downUpper < 0.5);
+
+	if (downFirst && upLower <= upper)
+		push(worker, std::move(up));
+	if (downUpper >= lower)
+		push(worker, std::move(down));
+	if (!downFirst && upLower <= upper)
+		push(worker, std::move(up));
+}
+
+void
+BranchAndBound::addLazyRows(Worker& worker) {
+
+	if (worker.numLazyRows == _numLazyRows)
+		return;
+
+	std::lock_guard<std::mutex> lock(_lazyMutex);
+
+	const std::vector<size_t>& offsets = _lazyRows.getRowOffsets();
+
+	for (size_t i = worker.numLazyRows; i < _lazyRows.size(); i++)
+		worker.simplex.addRow(
+				offsets[i + 1] - offsets[i],
+				_lazyRows.getColumns().data() + offsets[i],
+				_lazyRows.getCoefficients().data() + offsets[i],
+				_lazyRows.getRelations()[i],
+				_lazyRows.getValues()[i]);
+
+	worker.numLazyRows = _lazyRows.size();
+}
+
+bool
+BranchAndBound::separate(const std::vector<double>& x) {
+
+	std::lock_guard<std::mutex> lock(_lazyMutex);
+
+	LinearConstraintMatrix rows;
+	_separator(x, rows);
+
+	// keep only rows that are violated, to not solve the same relaxation
+	// again
+	const std::vector<size_t>& offsets = rows.getRowOffsets();
+	size_t numRows = _lazyRows.size();
+
+	for (unsigned int i = 0; i < rows.size(); i++) {
+
+		double lhs = 0;
+		for (size_t j = offsets[i]; j < offsets[i + 1]; j++)
+			lhs += rows.getCoefficients()[j]*x[rows.getColumns()[j]];
+
+		if (LinearConstraint::violation(lhs, rows.getRelations()[i], rows.getValues()[i]) <= LazyTolerance)
+			continue;
+
+		_lazyRows.addRow(
+				offsets[i + 1] - offsets[i],
+				rows.getColumns().data() + offsets[i],
+				rows.getCoefficients().data() + offsets[i],
+				rows.getRelations()[i],
+				rows.getValues()[i]);
+	}
+
+	_numLazyRows = _lazyRows.size();
+
+	return _lazyRows.size() > numRows;
+}
+
+void
+BranchAndBound::getSolution(const Simplex& simplex, std::vector<double>& x) const {
+
+	x.resize(simplex.numVariables());
+	for (unsigned int i = 0; i < x.size(); i++)
+		x[i] = simplex.getValue(i);
+
+	for (unsigned int varNum : _integerVariables)
+		x[varNum] = std::round(x[varNum]);
+}
+
+void
+BranchAndBound::push(Worker& worker, Node&& node) {
+
+	_numOpenNodes++;
+
+	std::lock_guard<std::mutex> lock(worker.mutex);
+	worker.nodes.push_back(std::move(node));
+}
+
+int
+BranchAndBound::branchingVariable(const Simplex& simplex) const {
+
+	int    best = -1;
+	double bestFractionality = IntegralityTolerance;
+
+	for (unsigned int varNum : _integerVariables) {
+
+		double value = simplex.getValue(varNum);
+		double fractionality = std::fabs(value - std::round(value));
+
+		if (fractionality > bestFractionality) {
+
+			best = varNum;
+			bestFractionality = fractionality;
+		}
+	}
+
+	return best;
+}
+
+void
+BranchAndBound::updateSolution(const Simplex& simplex) {
+
+	double value = simplex.getObjectiveValue();
+
+	{
+		std::lock_guard<std::mutex> lock(_solutionMutex);
+
+		if (value >= _value)
+			return;
+
+		getSolution(simplex, _solution);
+
+		_value = value;
+	}
+
+	reportProgress(true);
+}
+
+void
+BranchAndBound::reportProgress(bool force) {
+
+	if (!_progressCallback)
+		return;
+
+	std::lock_guard<std::mutex> lock(_progressMutex);
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	if (!force && now - _lastProgress < ProgressInterval)
+		return;
+
+	_lastProgress = now;
+
+	// the optimum is in one of the open or processed nodes, or it is the
+	// incumbent
+	double incumbent = _value;
+	double bound     = incumbent;
+
+	for (auto& worker : _workers) {
+
+		bound = std::min(bound, worker->bound.load());
+
+		std::lock_guard<std::mutex> workerLock(worker->mutex);
+		for (const Node& node : worker->nodes)
+			bound = std::min(bound, node.bound);
+	}
+
+	_progressCallback(bound, incumbent);
+}
+
+double
+BranchAndBound::cutoff() const {
+
+	double value = _value;
+
+	if (value == Infinity)
+		return Infinity;
+
+	double gap = (_absoluteGap ? _gap : _gap*std::fabs(value));
+
+	return value - std::max(gap, ObjectiveTolerance);
+}
+
+void
+BranchAndBound::addRemainingBound(double bound) {
+
+	double current = _remainingBound;
+	while (bound < current && !_remainingBound.compare_exchange_weak(current, bound)) {}
+}
+
+double
+BranchAndBound::remainingTime() const {
+
+	if (_timeout <= 0)
+		return 0;
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+
+	// a tiny positive timeout, to not disable the limit by accident
+	return std::max(_timeout - elapsed, 1e-9);
+}
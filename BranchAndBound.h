@@ -0,0 +1,309 @@
+#ifndef INFERENCE_BRANCH_AND_BOUND_H__
+#define INFERENCE_BRANCH_AND_BOUND_H__
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "LinearConstraintMatrix.h"
+#include "Simplex.h"
+
+/**
+ * A parallel branch-and-bound for mixed integer linear programs, on top of the
+ * LP relaxation given as a loaded Simplex. Minimizes.
+ *
+ * The tree is explored depth-first by a pool of worker threads. Each worker
+ * owns a copy of the relaxation and a deque of open nodes: it takes nodes from
+ * the back of its own deque, idle workers steal from the front of the deques
+ * of others, i.e., the nodes closest to the root. Child nodes start the simplex
+ * from the optimal basis of their parent.
+ *
+ * Lazy constraints are found by a separator, which is called with every
+ * integral solution of a node relaxation. Violated rows go to a pool that is
+ * shared by all workers, and the node is solved again with them.
+ */
+class BranchAndBound {
+
+public:
+
+	/**
+	 * Adds rows violated by the given values of the structural variables to
+	 * the given matrix. Calls are serialized.
+	 */
+	typedef std::function<void(const std::vector<double>& x, LinearConstraintMatrix& rows)> Separator;
+
+	/**
+	 * Called with a lower bound on the optimal objective value and the value
+	 * of the best solution found so far (infinite if there is none), whenever
+	 * a better solution is found and at most every 100ms in between. Calls are
+	 * serialized.
+	 */
+	typedef std::function<void(double bound, double incumbent)> ProgressCallback;
+
+	enum Status {
+
+		Optimal,
+		Infeasible,
+		Unbounded,
+		TimeLimit,
+		Interrupted,
+		NumericalFailure
+	};
+
+	/**
+	 * @param relaxation
+	 *              The LP relaxation. The root node is solved on this simplex,
+	 *              such that the root basis is kept for the next solve.
+	 *
+	 * @param integerVariables
+	 *              The variables that have to be integral.
+	 */
+	BranchAndBound(
+			Simplex&                         relaxation,
+			const std::vector<unsigned int>& integerVariables);
+
+	/**
+	 * Set the number of worker threads, 0 to use all hardware threads.
+	 */
+	void setNumThreads(unsigned int numThreads) { _numThreads = numThreads; }
+
+	/**
+	 * Limit the wall-clock time of solve(), in seconds. 0 disables the limit.
+	 */
+	void setTimeout(double timeout) { _timeout = timeout; }
+
+	/**
+	 * Stop solve() with Interrupted as soon as the given flag is set, e.g., by
+	 * another thread. nullptr to not check a flag.
+	 */
+	void setInterrupt(const std::atomic<bool>* interrupt) { _interrupt = interrupt; }
+
+	/**
+	 * Stop as soon as the best solution is proven to be within this gap of
+	 * the optimum.
+	 */
+	void setOptimalityGap(double gap, bool absolute) { _gap = gap; _absoluteGap = absolute; }
+
+	/**
+	 * Set a known feasible solution as the first incumbent of the next
+	 * solve(), to prune nodes that can not improve on it from the beginning.
+	 *
+	 * @param solution
+	 *              Values of all structural variables, integral for the
+	 *              integer variables.
+	 *
+	 * @param value
+	 *              The objective value of the solution.
+	 */
+	void setIncumbent(const std::vector<double>& solution, double value);
+
+	/**
+	 * Set a separator for lazy constraints, or an empty one to solve without
+	 * lazy constraints. Rows found during a solve are not kept for the next
+	 * one.
+	 */
+	void setSeparator(const Separator& separator) { _separator = separator; }
+
+	/**
+	 * Set a callback to report the progress of solve(), or an empty one.
+	 */
+	void setProgressCallback(const ProgressCallback& callback) { _progressCallback = callback; }
+
+	Status solve();
+
+	/**
+	 * @return True, if solve() found a feasible solution. This can be the
+	 *         case even if solve() did not return Optimal.
+	 */
+	bool hasSolution() const { return !_solution.empty(); }
+
+	/**
+	 * @return The values of the structural variables of the best solution
+	 *         found.
+	 */
+	const std::vector<double>& getSolution() const { return _solution; }
+
+	/**
+	 * @return The objective value of the best solution found.
+	 */
+	double getObjectiveValue() const { return _value; }
+
+	/**
+	 * @return The number of nodes processed by the last call to solve().
+	 */
+	size_t getNumNodes() const { return _numNodes; }
+
+	/**
+	 * @return The number of simplex iterations of the last call to solve(),
+	 *         over all nodes.
+	 */
+	size_t getNumIterations() const { return _numIterations; }
+
+	/**
+	 * @return The lower bound on the optimal objective value proven by the
+	 *         last call to solve(), infinite if the problem is infeasible.
+	 */
+	double getBound() const { return _bound; }
+
+private:
+
+	struct BoundChange {
+
+		unsigned int varNum;
+		double       lower;
+		double       upper;
+	};
+
+	struct Node {
+
+		// all bound changes from the root to this node
+		std::vector<BoundChange> changes;
+
+		// the optimal basis of the parent
+		std::shared_ptr<const Simplex::Basis> basis;
+
+		// lower bound on the objective of this node
+		double bound;
+	};
+
+	struct Worker {
+
+		Worker(const Simplex& relaxation) :
+			simplex(relaxation),
+			bound(std::numeric_limits<double>::infinity()),
+			numLazyRows(0) {}
+
+		Simplex simplex;
+
+		// open nodes, the owner works on the back, thieves on the front
+		std::deque<Node> nodes;
+		std::mutex       mutex;
+
+		// the bound of the node in process, infinite if there is none
+		std::atomic<double> bound;
+
+		// variables with bounds changed by the last node
+		std::vector<unsigned int> changed;
+
+		// the number of rows of the lazy pool added to simplex
+		size_t numLazyRows;
+	};
+
+	// the main loop of worker thread t
+	void work(unsigned int t);
+
+	// get a node from the own deque or steal one from another worker
+	bool nextNode(unsigned int t, Node& node);
+
+	void process(Worker& worker, const Node& node);
+
+	// create the two children of a node with an optimal relaxation in simplex
+	void branch(
+			Worker&                         worker,
+			const Simplex&                  simplex,
+			const std::vector<BoundChange>& changes,
+			unsigned int                    varNum);
+
+	// add the rows of the lazy pool the simplex of a worker does not have yet
+	void addLazyRows(Worker& worker);
+
+	// call the separator with the given values of the structural variables,
+	// returns true if violated rows were added to the lazy pool
+	bool separate(const std::vector<double>& x);
+
+	// the values of the structural variables in simplex, with integer
+	// variables rounded
+	void getSolution(const Simplex& simplex, std::vector<double>& x) const;
+
+	// push a node to the deque of a worker
+	void push(Worker& worker, Node&& node);
+
+	// the integer variable with the most fractional value, -1 if all are
+	// integral
+	int branchingVariable(const Simplex& simplex) const;
+
+	// store a new solution, if it is better than the current one
+	void updateSolution(const Simplex& simplex);
+
+	// call the progress callback with the smallest bound of the open nodes,
+	// if forced or the last call was long enough ago
+	void reportProgress(bool force);
+
+	// nodes with a bound of at least this value can be pruned
+	double cutoff() const;
+
+	// lower the bound of the nodes that were not explored to the end
+	void addRemainingBound(double bound);
+
+	// seconds left until the timeout, or 0 if no timeout is set
+	double remainingTime() const;
+
+	Simplex& _relaxation;
+
+	std::vector<unsigned int> _integerVariables;
+
+	// the bounds of the variables at the root
+	std::vector<double> _rootLower;
+	std::vector<double> _rootUpper;
+
+	std::vector<std::unique_ptr<Worker>> _workers;
+
+	// number of nodes pushed and not yet processed
+	std::atomic<size_t> _numOpenNodes;
+
+	std::atomic<size_t> _numNodes;
+
+	std::atomic<size_t> _numIterations;
+
+	// the smallest bound of the nodes that were not explored to the end,
+	// because they were pruned by the cutoff or the solve stopped
+	std::atomic<double> _remainingBound;
+
+	double _bound;
+
+	std::atomic<bool> _timedOut;
+
+	std::atomic<bool> _interrupted;
+
+	std::atomic<bool> _failed;
+
+	Separator _separator;
+
+	ProgressCallback                      _progressCallback;
+	std::mutex                            _progressMutex;
+	std::chrono::steady_clock::time_point _lastProgress;
+
+	// the lazy rows found during the current solve
+	std::mutex             _lazyMutex;
+	LinearConstraintMatrix _lazyRows;
+	std::atomic<size_t>    _numLazyRows;
+
+	// the first incumbent for the next solve
+	std::vector<double> _startSolution;
+	double              _startValue;
+
+	// the best solution found so far
+	std::mutex          _solutionMutex;
+	std::vector<double> _solution;
+	std::atomic<double> _value;
+
+	unsigned int _numThreads;
+
+	double _timeout;
+
+	const std::atomic<bool>* _interrupt;
+
+	double _gap;
+
+	bool _absoluteGap;
+
+	std::chrono::steady_clock::time_point _start;
+};
+
+#endif // INFERENCE_BRANCH_AND_BOUND_H__
+
@@ -0,0 +1,409 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <boost/timer/timer.hpp>
+#include <boost/chrono.hpp>
+
+#include <util/Logger.h>
+#include "BranchAndBound.h"
+#include "BranchAndBoundBackend.h"
+
+using namespace logger;
+
+LogChannel bblog("bblog", "[BranchAndBoundBackend] ");
+
+// tolerance for start values outside of the bounds of a variable
+static const double BoundTolerance = 1e-9;
+
+// values within this distance of an integer are considered integral
+static const double IntegralityTolerance = 1e-6;
+
+BranchAndBoundBackend::BranchAndBoundBackend() :
+	_numVariables(0),
+	_sense(Minimize),
+	_constant(0),
+	_timeout(0),
+	_gap(0),
+	_absoluteGap(false),
+	_numThreads(0),
+	_verbose(false) {}
+
+void
+BranchAndBoundBackend::initialize(
+		unsigned int numVariables,
+		VariableType variableType) {
+
+	initialize(numVariables, variableType, std::map<unsigned int, VariableType>());
+}
+
+void
+BranchAndBoundBackend::initialize(
+		unsigned int                                numVariables,
+		VariableType                                defaultVariableType,
+		const std::map<unsigned int, VariableType>& specialVariableTypes) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	_numVariables = numVariables;
+
+	LOG_DEBUG(bblog) << "creating " << _numVariables << " variables" << std::endl;
+
+	std::vector<double> lower(_numVariables);
+	std::vector<double> upper(_numVariables);
+	_integerVariables.clear();
+
+	for (unsigned int i = 0; i < _numVariables; i++) {
+
+		VariableType type = defaultVariableType;
+		if (specialVariableTypes.count(i))
+			type = specialVariableTypes.at(i);
+
+		lower[i] = defaultLowerBound(type);
+		upper[i] = defaultUpperBound(type);
+
+		if (type != Continuous)
+			_integerVariables.push_back(i);
+	}
+
+	LOG_DEBUG(bblog) << _integerVariables.size() << " of them are integer" << std::endl;
+
+	_relaxation.initialize(lower, upper);
+	_constant = 0;
+}
+
+void
+BranchAndBoundBackend::setObjective(const LinearObjective& objective) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	_sense    = objective.getSense();
+	_constant = objective.getConstant();
+
+	// the branch-and-bound minimizes, negate for maximization
+	double sign = (_sense == Minimize ? 1.0 : -1.0);
+
+	for (unsigned int i = 0; i < _numVariables; i++)
+		_relaxation.setCost(i, sign*objective.getCoefficients()[i]);
+}
+
+void
+BranchAndBoundBackend::setObjectiveCoefficient(unsigned int varNum, double coef) {
+
+	double sign = (_sense == Minimize ? 1.0 : -1.0);
+
+	_relaxation.setCost(varNum, sign*coef);
+}
+
+void
+BranchAndBoundBackend::setVariableBounds(unsigned int varNum, double lower, double upper) {
+
+	_relaxation.setBounds(varNum, lower, upper);
+}
+
+void
+BranchAndBoundBackend::setConstraints(const LinearConstraints& constraints) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	setConstraints(LinearConstraintMatrix(constraints));
+}
+
+void
+BranchAndBoundBackend::setConstraints(const LinearConstraintMatrix& constraints) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	LOG_DEBUG(bblog) << "setting " << constraints.size() << " constraints" << std::endl;
+
+	_relaxation.setConstraints(constraints);
+}
+
+void
+BranchAndBoundBackend::addConstraint(const LinearConstraint& constraint) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	_relaxation.addConstraint(constraint);
+}
+
+void
+BranchAndBoundBackend::setConstraintValue(unsigned int constraint, double value) {
+
+	_relaxation.setConstraintValue(constraint, value);
+}
+
+void
+BranchAndBoundBackend::removeConstraints(const std::vector<unsigned int>& constraints) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	for (unsigned int constraint : constraints)
+		_relaxation.removeConstraint(constraint);
+}
+
+void
+BranchAndBoundBackend::setStartSolution(const Solution& solution) {
+
+	unsigned int size = std::min(solution.size(), _numVariables);
+
+	_startVariables.resize(size);
+	for (unsigned int i = 0; i < size; i++)
+		_startVariables[i] = i;
+	_startValues.assign(solution.getVector().begin(), solution.getVector().begin() + size);
+}
+
+void
+BranchAndBoundBackend::setStartSolution(const std::map<unsigned int, double>& values) {
+
+	// the map is sorted, the last variable has the largest number
+	if (!values.empty() && values.rbegin()->first >= _numVariables)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"variable " << values.rbegin()->first << " does not exist");
+
+	_startVariables.clear();
+	_startValues.clear();
+	for (auto& p : values) {
+
+		_startVariables.push_back(p.first);
+		_startValues.push_back(p.second);
+	}
+}
+
+void
+BranchAndBoundBackend::setOptimalityGap(double gap, bool absolute) {
+
+	_gap = gap;
+	_absoluteGap = absolute;
+}
+
+bool
+BranchAndBoundBackend::solve(Solution& x, std::string& msg) {
+
+	SolveScope scope(*this);
+
+	double sign = (_sense == Minimize ? 1.0 : -1.0);
+
+	SolveStatistics& statistics = x.getStatistics();
+	statistics = SolveStatistics(_sense);
+	statistics.time[SolveStatistics::Build] = _buildTime;
+	_buildTime = SolveStatistics::Time();
+
+	// the relaxation is loaded lazily
+	SolveStatistics::Timer updateTimer(statistics.time[SolveStatistics::Update]);
+
+	if (_relaxation.hasEmptyBounds()) {
+
+		x.setTime(0);
+		statistics.status    = SolveStatistics::Infeasible;
+		statistics.dualBound = sign*std::numeric_limits<double>::infinity();
+		statistics.peakMemory = SolveStatistics::peakMemoryOfProcess();
+		msg = "Optimal solution *NOT* found (problem is infeasible)";
+		return false;
+	}
+
+	Simplex& relaxation = _relaxation.getSimplex();
+	updateTimer.stop();
+
+	BranchAndBound branchAndBound(relaxation, _integerVariables);
+	branchAndBound.setNumThreads(_numThreads);
+	branchAndBound.setTimeout(_timeout);
+	branchAndBound.setInterrupt(getInterruptFlag());
+	branchAndBound.setOptimalityGap(_gap, _absoluteGap);
+
+	if (_separator)
+		branchAndBound.setSeparator(
+				[this](const std::vector<double>& values, LinearConstraintMatrix& rows) {
+
+					Solution candidate(_numVariables);
+					for (unsigned int i = 0; i < _numVariables; i++)
+						candidate[i] = values[i];
+
+					LinearConstraints violated;
+					_separator(candidate, violated);
+					rows.addAll(violated);
+				});
+
+	if (_timeout > 0)
+		LOG_USER(bblog) << "using timeout of " << _timeout << "s for inference" << std::endl;
+
+	SolveStatistics::Timer solveTimer(statistics.time[SolveStatistics::Solve]);
+
+	boost::timer::cpu_timer timer;
+	timer.start();
+
+	if (_progressCallback || _verbose)
+		branchAndBound.setProgressCallback(
+				[this, sign, &timer, &branchAndBound](double bound, double incumbent) {
+
+					Progress progress(
+							sign*incumbent + _constant,
+							sign*bound + _constant,
+							timer.elapsed().wall*1e-9);
+
+					if (_verbose)
+						LOG_USER(bblog)
+								<< branchAndBound.getNumNodes() << " nodes, incumbent " << progress.incumbent
+								<< ", bound " << progress.bound << ", gap " << progress.gap
+								<< ", " << progress.time << "s" << std::endl;
+
+					if (_progressCallback)
+						_progressCallback(progress);
+				});
+
+	if (!_startVariables.empty()) {
+
+		std::vector<double> start;
+		double value;
+
+		if (completeStart(start, value)) {
+
+			LOG_DEBUG(bblog) << "using start solution with value " << value << std::endl;
+			branchAndBound.setIncumbent(start, value);
+
+		} else {
+
+			LOG_DEBUG(bblog) << "start solution is infeasible" << std::endl;
+		}
+
+		// the start is used for this solve only
+		_startVariables.clear();
+		_startValues.clear();
+	}
+
+	BranchAndBound::Status status = branchAndBound.solve();
+
+	boost::chrono::nanoseconds ns(timer.elapsed().system + timer.elapsed().user);
+	double seconds = boost::chrono::duration<double>(ns).count();
+	x.setTime(seconds);
+
+	solveTimer.stop();
+	statistics.numNodes      = branchAndBound.getNumNodes();
+	statistics.numIterations = branchAndBound.getNumIterations();
+	statistics.dualBound     = sign*branchAndBound.getBound() + _constant;
+	statistics.peakMemory    = SolveStatistics::peakMemoryOfProcess();
+
+	if (_verbose) {
+
+		LOG_USER(bblog) << "processed " << branchAndBound.getNumNodes() << " nodes" << std::endl;
+
+	} else {
+
+		LOG_DEBUG(bblog) << "processed " << branchAndBound.getNumNodes() << " nodes" << std::endl;
+	}
+
+	if (status != BranchAndBound::Optimal) {
+
+		msg = "Optimal solution *NOT* found";
+
+		switch (status) {
+
+			case BranchAndBound::Infeasible:
+				msg += " (problem is infeasible)";
+				statistics.status = SolveStatistics::Infeasible;
+				return false;
+			case BranchAndBound::Unbounded:
+				msg += " (problem is unbounded)";
+				statistics.status = SolveStatistics::Unbounded;
+				return false;
+			case BranchAndBound::TimeLimit:
+				msg += " (timeout";
+				statistics.status = SolveStatistics::TimeLimit;
+				break;
+			case BranchAndBound::Interrupted:
+				msg += " (interrupted";
+				statistics.status = SolveStatistics::Interrupted;
+				break;
+			default:
+				msg += " (numerical difficulties";
+				statistics.status = SolveStatistics::NumericalFailure;
+		}
+
+		if (!branchAndBound.hasSolution()) {
+
+			msg += ", no feasible solution found)";
+			return false;
+		}
+
+		msg += ", feasible solution found)";
+
+	} else {
+
+		msg = "Optimal solution found";
+		statistics.status = SolveStatistics::Optimal;
+	}
+
+	SolveStatistics::Timer extractionTimer(statistics.time[SolveStatistics::Extraction]);
+
+	// extract solution
+
+	x.resize(_numVariables);
+	for (unsigned int i = 0; i < _numVariables; i++)
+		x[i] = branchAndBound.getSolution()[i];
+
+	x.setValue(sign*branchAndBound.getObjectiveValue() + _constant);
+
+	extractionTimer.stop();
+	statistics.primalBound = x.getValue();
+
+	if (_progressCallback && status == BranchAndBound::Optimal)
+		_progressCallback(Progress(x.getValue(), x.getValue(), timer.elapsed().wall*1e-9));
+
+	return true;
+}
+
+bool
+BranchAndBoundBackend::completeStart(std::vector<double>& solution, double& value) {
+
+	// without integer variables, the relaxation is the problem itself
+	if (_integerVariables.empty())
+		return false;
+
+	std::vector<char> isInteger(_numVariables, 0);
+	for (unsigned int varNum : _integerVariables)
+		isInteger[varNum] = 1;
+
+	// fix the integer variables with a start value, solve for the others
+
+	Simplex simplex(_relaxation.getSimplex());
+
+	for (size_t i = 0; i < _startVariables.size(); i++) {
+
+		unsigned int varNum = _startVariables[i];
+
+		if (varNum >= _numVariables || !isInteger[varNum])
+			continue;
+
+		double v = std::round(_startValues[i]);
+
+		if (v < simplex.getLower(varNum) - BoundTolerance || v > simplex.getUpper(varNum) + BoundTolerance)
+			return false;
+
+		simplex.setBounds(varNum, v, v);
+	}
+
+	simplex.setTimeout(_timeout);
+
+	if (simplex.solve() != Simplex::Optimal)
+		return false;
+
+	solution.resize(_numVariables);
+	for (unsigned int i = 0; i < _numVariables; i++)
+		solution[i] = simplex.getValue(i);
+
+	for (unsigned int varNum : _integerVariables) {
+
+		double v = std::round(solution[varNum]);
+
+		// integer variables without start value can be fractional
+		if (std::fabs(solution[varNum] - v) > IntegralityTolerance)
+			return false;
+
+		solution[varNum] = v;
+	}
+
+	value = simplex.getObjectiveValue();
+
+	return true;
+}
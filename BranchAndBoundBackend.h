@@ -0,0 +1,128 @@
+#ifndef INFERENCE_BRANCH_AND_BOUND_BACKEND_H__
+#define INFERENCE_BRANCH_AND_BOUND_BACKEND_H__
+
+#include <string>
+#include <vector>
+
+#include "LinearSolverBackend.h"
+#include "SimplexProblem.h"
+
+/**
+ * Built-in mixed integer linear program solver without external dependencies.
+ * Solves
+ *
+ * min  <a,x>
+ * s.t. Ax  == b
+ *      Cx  <= d
+ *      optionally: x_i \in {0,1} or x_i \in Z for all i
+ *
+ * by a parallel branch-and-bound (see BranchAndBound) on the LP relaxation
+ * solved by the built-in simplex. Problems without integer variables are
+ * solved as LPs, without branching.
+ *
+ * Start solutions are completed by fixing the integer variables to their
+ * rounded start values and solving the LP relaxation for the remaining
+ * variables. If this gives an integral solution, it is the first incumbent of
+ * the branch-and-bound.
+ */
+class BranchAndBoundBackend : public LinearSolverBackend {
+
+public:
+
+	BranchAndBoundBackend();
+
+	///////////////////////////////////
+	// solver backend implementation //
+	///////////////////////////////////
+
+	void initialize(
+			unsigned int numVariables,
+			VariableType variableType);
+
+	void initialize(
+			unsigned int                                numVariables,
+			VariableType                                defaultVariableType,
+			const std::map<unsigned int, VariableType>& specialVariableTypes);
+
+	void setObjective(const LinearObjective& objective);
+
+	void setConstraints(const LinearConstraints& constraints);
+
+	void setConstraints(const LinearConstraintMatrix& constraints);
+
+	using LinearSolverBackend::setConstraints;
+
+	void addConstraint(const LinearConstraint& constraint);
+
+	void setObjectiveCoefficient(unsigned int varNum, double coef);
+
+	void setVariableBounds(unsigned int varNum, double lower, double upper);
+
+	void setConstraintValue(unsigned int constraint, double value);
+
+	void removeConstraints(const std::vector<unsigned int>& constraints);
+
+	void setStartSolution(const Solution& solution);
+
+	void setStartSolution(const std::map<unsigned int, double>& values);
+
+	void setSeparator(const Separator& separator) { _separator = separator; }
+
+	void setTimeout(double timeout) { _timeout = timeout; }
+
+	void setOptimalityGap(double gap, bool absolute=false);
+
+	void setNumThreads(unsigned int numThreads) { _numThreads = numThreads; }
+
+	void setVerbose(bool verbose) { _verbose = verbose; }
+
+	void setProgressCallback(const ProgressCallback& callback) { _progressCallback = callback; }
+
+	bool solve(Solution& solution, std::string& message);
+
+private:
+
+	// the branch-and-bound polls the interrupt flag
+	void interruptSolver() {}
+
+	// complete the start values to a feasible solution of the loaded
+	// problem, returns false if that fails
+	bool completeStart(std::vector<double>& solution, double& value);
+
+	unsigned int _numVariables;
+
+	// the variables with integer or binary type
+	std::vector<unsigned int> _integerVariables;
+
+	// the start values for the next solve
+	std::vector<unsigned int> _startVariables;
+	std::vector<double>       _startValues;
+
+	Separator _separator;
+
+	ProgressCallback _progressCallback;
+
+	Sense _sense;
+
+	double _constant;
+
+	double _timeout;
+
+	double _gap;
+
+	bool _absoluteGap;
+
+	unsigned int _numThreads;
+
+	// log the progress of the branch-and-bound as user messages
+	bool _verbose;
+
+	// the LP relaxation, solved at the root of the branch-and-bound
+	SimplexProblem _relaxation;
+
+	// time spent in the calls that build the model since the last solve()
+	SolveStatistics::Time _buildTime;
+};
+
+#endif // INFERENCE_BRANCH_AND_BOUND_BACKEND_H__
+
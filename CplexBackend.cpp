@@ -4,6 +4,8 @@
 
 #ifdef HAVE_CPLEX
 
+#include <algorithm>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -19,6 +21,125 @@
 
 logger::LogChannel cplexlog("cplexlog", "[Cplex] ");
 
+// lazy constraints have to be violated by more than this to be added
+static const double LazyTolerance = 1e-6;
+
+/**
+ * Adds the lazy constraints violated by integer feasible solutions.
+ */
+class CplexLazyCallbackI : public IloCplex::LazyConstraintCallbackI {
+
+public:
+
+    CplexLazyCallbackI(
+            IloEnv                                env,
+            IloNumVarArray                        x,
+            const LinearSolverBackend::Separator& separator,
+            std::mutex&                           mutex) :
+        IloCplex::LazyConstraintCallbackI(env),
+        x_(x),
+        separator_(separator),
+        mutex_(mutex) {}
+
+    IloCplex::CallbackI* duplicateCallback() const {
+
+        return new (getEnv()) CplexLazyCallbackI(*this);
+    }
+
+    void main() {
+
+        IloNumArray values(getEnv());
+        getValues(values, x_);
+
+        Solution candidate(x_.getSize());
+        for (IloInt i = 0; i < x_.getSize(); i++)
+            candidate[i] = values[i];
+        values.end();
+
+        LinearConstraints violated;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            separator_(candidate, violated);
+        }
+
+        for (const LinearConstraint& constraint : violated) {
+
+            IloExpr linearExpr(getEnv());
+            for (auto& pair : constraint.getCoefficients())
+                linearExpr += pair.second*x_[pair.first];
+
+            double lower = (constraint.getRelation() == LessEqual    ? -IloInfinity : constraint.getValue());
+            double upper = (constraint.getRelation() == GreaterEqual ?  IloInfinity : constraint.getValue());
+
+            add(IloRange(getEnv(), lower, linearExpr, upper)).end();
+            linearExpr.end();
+        }
+    }
+
+private:
+
+    IloNumVarArray x_;
+    const LinearSolverBackend::Separator& separator_;
+    std::mutex& mutex_;
+};
+
+/**
+ * Reports the incumbent and bound of MIPs whenever one of them changes.
+ */
+class CplexProgressCallbackI : public IloCplex::MIPInfoCallbackI {
+
+public:
+
+    CplexProgressCallbackI(
+            IloEnv                                       env,
+            IloObjective                                 objective,
+            const LinearSolverBackend::ProgressCallback& callback,
+            std::mutex&                                  mutex) :
+        IloCplex::MIPInfoCallbackI(env),
+        objective_(objective),
+        callback_(callback),
+        mutex_(mutex),
+        lastIncumbent_(std::numeric_limits<double>::quiet_NaN()),
+        lastBound_(std::numeric_limits<double>::quiet_NaN()) {}
+
+    IloCplex::CallbackI* duplicateCallback() const {
+
+        return new (getEnv()) CplexProgressCallbackI(*this);
+    }
+
+    void main() {
+
+        const double infinity = std::numeric_limits<double>::infinity();
+
+        double incumbent;
+        if (hasIncumbent())
+            incumbent = getIncumbentObjValue();
+        else
+            incumbent = (objective_.getSense() == IloObjective::Minimize ? infinity : -infinity);
+
+        double bound = getBestObjValue();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (incumbent == lastIncumbent_ && bound == lastBound_)
+            return;
+
+        lastIncumbent_ = incumbent;
+        lastBound_     = bound;
+
+        callback_(LinearSolverBackend::Progress(incumbent, bound, getCplexTime() - getStartTime()));
+    }
+
+private:
+
+    IloObjective objective_;
+    const LinearSolverBackend::ProgressCallback& callback_;
+    std::mutex& mutex_;
+
+    double lastIncumbent_;
+    double lastBound_;
+};
+
 CplexBackend::CplexBackend(const Parameter& parameter) :
     _parameter(parameter),
     model_(env_),
@@ -26,10 +147,15 @@ CplexBackend::CplexBackend(const Parameter& parameter) :
     c_(env_),
     obj_(env_),
     sol_(env_),
+    cplex_(model_),
+    aborter_(env_),
+    _lazyRanges(env_),
     firstRun_(true),
     timeout_(0)
 {
     LOG_DEBUG(cplexlog) << "constructing cplex solver" << std::endl;
+
+    cplex_.use(aborter_);
 }
 
 CplexBackend::~CplexBackend() {
@@ -50,9 +176,12 @@ CplexBackend::initialize(
         VariableType                                defaultVariableType,
         const std::map<unsigned int, VariableType>& specialVariableTypes) {
 
+    SolveStatistics::Timer timer(_buildTime);
+
     _numVariables = numVariables;
 
-    // delete previous variables
+    // delete previous variables and the constraints on them
+    removeConstraints();
     x_.clear();
 
     // add new variables to the model
@@ -83,11 +212,15 @@ CplexBackend::initialize(
 void
 CplexBackend::setObjective(const LinearObjective& objective) {
 
+    SolveStatistics::Timer timer(_buildTime);
+
     setObjective((QuadraticObjective)objective);
 }
 
 void
 CplexBackend::setObjective(const QuadraticObjective& objective) {
+    SolveStatistics::Timer timer(_buildTime);
+
     try {
 
 
@@ -96,38 +229,44 @@ CplexBackend::setObjective(const QuadraticObjective& objective) {
        }
 
   
-        // set sense of objective
-        if (objective.getSense() == Minimize)
-            obj_ = IloMinimize(env_);
-        else
-            obj_ = IloMaximize(env_);
-        
+        // build the objective expression in one pass before creating the
+        // objective, instead of changing the objective term by term
+        IloExpr expr(env_);
 
         // set the constant value of the objective
-        obj_.setConstant(objective.getConstant());
+        expr.setConstant(objective.getConstant());
 
         LOG_DEBUG(cplexlog) << "setting linear coefficients" << std::endl;
 
+        IloNumArray linearCoefs(env_, _numVariables);
         for(size_t i = 0; i < _numVariables; i++)
         {
 			if (objective.getCoefficients()[i] == std::numeric_limits<double>::infinity())
-				obj_.setLinearCoef(x_[i], CPX_INFBOUND);
+				linearCoefs[i] = CPX_INFBOUND;
 			else
-				obj_.setLinearCoef(x_[i], objective.getCoefficients()[i]);
+				linearCoefs[i] = objective.getCoefficients()[i];
         }
+        expr.setLinearCoefs(x_, linearCoefs);
+        linearCoefs.end();
 
         // set the quadratic coefficients for all pairs of variables
         LOG_DEBUG(cplexlog) << "setting quadratic coefficients" << std::endl;
 
-        typedef std::map<std::pair<unsigned int, unsigned int>, double>::const_iterator QuadCoefIt;
-        for (QuadCoefIt i = objective.getQuadraticCoefficients().begin(); i != objective.getQuadraticCoefficients().end(); i++) {
+        const std::vector<unsigned int>& rows = objective.getQuadraticRows();
+        const std::vector<unsigned int>& cols = objective.getQuadraticColumns();
+        const std::vector<double>&       vals = objective.getQuadraticValues();
 
-            const std::pair<unsigned int, unsigned int>& variables = i->first;
-            float value = i->second;
+        for (size_t k = 0; k < vals.size(); k++)
+            expr.setQuadCoef(x_[rows[k]], x_[cols[k]], vals[k]);
+
+        // set sense of objective
+        if (objective.getSense() == Minimize)
+            obj_ = IloMinimize(env_, expr);
+        else
+            obj_ = IloMaximize(env_, expr);
+
+        expr.end();
 
-            if (value != 0)
-                obj_.setQuadCoef(x_[variables.first], x_[variables.second], value);
-        }
         if(true || firstRun_){
             model_.add(obj_);
             firstRun_ = false;
@@ -143,10 +282,10 @@ CplexBackend::setObjective(const QuadraticObjective& objective) {
 void
 CplexBackend::setConstraints(const LinearConstraints& constraints) {
 
+    SolveStatistics::Timer timer(_buildTime);
+
     // remove previous constraints
-    for (ConstraintVector::iterator constraint = _constraints.begin(); constraint != _constraints.end(); constraint++)
-        model_.remove(*constraint);
-    _constraints.clear();
+    removeConstraints();
 
     // allocate memory for new constraints
     _constraints.reserve(constraints.size());
@@ -170,14 +309,57 @@ CplexBackend::setConstraints(const LinearConstraints& constraints) {
     }
 }
 
+void
+CplexBackend::setConstraints(const LinearConstraintMatrix& constraints) {
+
+    SolveStatistics::Timer timer(_buildTime);
+
+    // remove previous constraints
+    removeConstraints();
+
+    // allocate memory for new constraints
+    _constraints.reserve(constraints.size());
+
+    try {
+        LOG_USER(cplexlog) << "setting " << constraints.size() << " constraints from matrix" << std::endl;
+
+        IloExtractableArray cplex_constraints(env_);
+        for (unsigned int i = 0; i < constraints.size(); i++) {
+            IloRange linearConstraint = createConstraint(constraints, i);
+            _constraints.push_back(linearConstraint);
+            cplex_constraints.add(linearConstraint);
+        }
+
+        // add all constraints as batch to the model
+        model_.add(cplex_constraints);
+
+    } catch (IloCplex::Exception e) {
+
+        LOG_ERROR(cplexlog) << "error: " << e.getMessage() << std::endl;
+    }
+}
+
+void
+CplexBackend::removeConstraints() {
+
+    for (ConstraintVector::iterator constraint = _constraints.begin(); constraint != _constraints.end(); constraint++)
+        if (constraint->getImpl() != 0)
+            model_.remove(*constraint);
+    _constraints.clear();
+}
+
 void
 CplexBackend::addConstraint(const LinearConstraint& constraint) {
 
+    SolveStatistics::Timer timer(_buildTime);
+
     try {
         LOG_ALL(cplexlog) << "adding a constraint" << std::endl;
 
         // add to the model
-        _constraints.push_back(model_.add(createConstraint(constraint)));
+        IloRange range = createConstraint(constraint);
+        model_.add(range);
+        _constraints.push_back(range);
 
     } catch (IloCplex::Exception e) {
 
@@ -185,6 +367,63 @@ CplexBackend::addConstraint(const LinearConstraint& constraint) {
     }
 }
 
+void
+CplexBackend::setObjectiveCoefficient(unsigned int varNum, double coef) {
+
+    obj_.setLinearCoef(x_[varNum], coef);
+}
+
+void
+CplexBackend::setVariableBounds(unsigned int varNum, double lower, double upper) {
+
+    x_[varNum].setBounds(std::max(lower, -IloInfinity), std::min(upper, IloInfinity));
+}
+
+void
+CplexBackend::setConstraintValue(unsigned int constraint, double value) {
+
+    IloRange& range = constraintRange(constraint);
+
+    // keep the relation of the constraint
+    if (range.getLB() == -IloInfinity)
+        range.setUB(value);
+    else if (range.getUB() == IloInfinity)
+        range.setLB(value);
+    else
+        range.setBounds(value, value);
+}
+
+void
+CplexBackend::removeConstraints(const std::vector<unsigned int>& constraints) {
+
+    SolveStatistics::Timer timer(_buildTime);
+
+    LOG_DEBUG(cplexlog) << "removing " << constraints.size() << " constraints" << std::endl;
+
+    IloExtractableArray ranges(env_);
+    for (unsigned int constraint : constraints) {
+
+        ranges.add(constraintRange(constraint));
+        _constraints[constraint] = IloRange();
+    }
+
+    // remove all constraints as batch from the model
+    model_.remove(ranges);
+    ranges.endElements();
+    ranges.end();
+}
+
+IloRange&
+CplexBackend::constraintRange(unsigned int constraint) {
+
+    if (constraint >= _constraints.size() || _constraints[constraint].getImpl() == 0)
+        UTIL_THROW_EXCEPTION(
+                UsageError,
+                "constraint " << constraint << " does not exist");
+
+    return _constraints[constraint];
+}
+
 IloRange
 CplexBackend::createConstraint(const LinearConstraint& constraint) {
 
@@ -199,28 +438,152 @@ CplexBackend::createConstraint(const LinearConstraint& constraint) {
         linearExpr.setLinearCoef(x_[pair->first], pair->second);
     }
 
+    return createRange(linearExpr, constraint.getRelation(), constraint.getValue());
+}
+
+IloRange
+CplexBackend::createConstraint(const LinearConstraintMatrix& constraints, unsigned int i) {
+
+    // create the lhs expression
+    IloExpr linearExpr(env_);
+
+    // set the coefficients directly from the CSR arrays
+    const std::vector<size_t>& offsets = constraints.getRowOffsets();
+    for (size_t j = offsets[i]; j < offsets[i+1]; j++)
+        linearExpr.setLinearCoef(x_[constraints.getColumns()[j]], constraints.getCoefficients()[j]);
+
+    return createRange(linearExpr, constraints.getRelations()[i], constraints.getValues()[i]);
+}
 
+IloRange
+CplexBackend::createRange(IloExpr& linearExpr, Relation relation, double value) {
 
-    switch(constraint.getRelation())
+    switch(relation)
     {
         case LessEqual:
-            return IloRange(env_, linearExpr, constraint.getValue());
+            return IloRange(env_, linearExpr, value);
             break;
         case GreaterEqual:
-            return IloRange(env_, constraint.getValue(), linearExpr);
+            return IloRange(env_, value, linearExpr);
             break;
         default:
         //case Equal:
-            return IloRange(env_,  constraint.getValue(), linearExpr, constraint.getValue());
+            return IloRange(env_,  value, linearExpr, value);
             break;
     }
 }
 
+void
+CplexBackend::setStartSolution(const Solution& solution) {
+
+    unsigned int size = std::min(solution.size(), _numVariables);
+
+    _startVariables.resize(size);
+    for (unsigned int i = 0; i < size; i++)
+        _startVariables[i] = i;
+    _startValues.assign(solution.getVector().begin(), solution.getVector().begin() + size);
+}
+
+void
+CplexBackend::setStartSolution(const std::map<unsigned int, double>& values) {
+
+    // the map is sorted, the last variable has the largest number
+    if (!values.empty() && values.rbegin()->first >= _numVariables)
+        UTIL_THROW_EXCEPTION(
+                UsageError,
+                "variable " << values.rbegin()->first << " does not exist");
+
+    _startVariables.clear();
+    _startValues.clear();
+    for (auto& p : values) {
+        _startVariables.push_back(p.first);
+        _startValues.push_back(p.second);
+    }
+}
+
+void
+CplexBackend::addMIPStart() {
+
+    // continuous problems are solved without a start
+    if (cplex_.isMIP()) {
+
+        LOG_DEBUG(cplexlog) << "adding MIP start for " << _startVariables.size() << " variables" << std::endl;
+
+        IloNumVarArray startVars(env_);
+        IloNumArray startVals(env_);
+        for (size_t i = 0; i < _startVariables.size(); i++) {
+            startVars.add(x_[_startVariables[i]]);
+            startVals.add(_startValues[i]);
+        }
+
+        // partial starts are completed by CPLEX
+        cplex_.addMIPStart(startVars, startVals);
+
+        startVars.end();
+        startVals.end();
+    }
+
+    // the start is used for this solve only
+    _startVariables.clear();
+    _startValues.clear();
+}
+
+void
+CplexBackend::setSeparator(const Separator& separator) {
+
+    _separator = separator;
+}
+
+bool
+CplexBackend::addLazyRanges() {
+
+    cplex_.getValues(sol_, x_);
+
+    Solution candidate(_numVariables);
+    for (unsigned int i = 0; i < _numVariables; i++)
+        candidate[i] = sol_[i];
+
+    LinearConstraints violated;
+    _separator(candidate, violated);
+
+    bool added = false;
+
+    for (const LinearConstraint& constraint : violated) {
+
+        if (!constraint.isViolated(candidate, LazyTolerance))
+            continue;
+
+        IloRange range = createConstraint(constraint);
+        model_.add(range);
+        _lazyRanges.add(range);
+        added = true;
+    }
+
+    return added;
+}
+
+void
+CplexBackend::removeLazyRanges() {
+
+    if (_lazyRanges.getSize() == 0)
+        return;
+
+    model_.remove(_lazyRanges);
+    _lazyRanges.endElements();
+    _lazyRanges.clear();
+}
+
 bool
 CplexBackend::solve(Solution& x,/* double& value, */ std::string& msg) {
 
+    SolveScope scope(*this);
+
+    SolveStatistics& statistics = x.getStatistics();
+    statistics = SolveStatistics(obj_.getSense() == IloObjective::Minimize ? Minimize : Maximize);
+    statistics.time[SolveStatistics::Build] = _buildTime;
+    _buildTime = SolveStatistics::Time();
+
     try {
-        cplex_ = IloCplex(model_);
         setVerbose(_parameter.verbose);
 
         setMIPGap(_parameter.mipGap, _parameter.absoluteGap);
@@ -235,21 +598,77 @@ CplexBackend::solve(Solution& x,/* double& value, */ std::string& msg) {
 		if (timeout_ > 0)
 			cplex_.setParam(IloCplex::TiLim, timeout_);
 
+        SolveStatistics::Timer updateTimer(statistics.time[SolveStatistics::Update]);
+
+        // the starts of previous solves are not used again
+        if (cplex_.getNMIPStarts() > 0)
+            cplex_.deleteMIPStarts(0, cplex_.getNMIPStarts());
+
+        if (!_startVariables.empty())
+            addMIPStart();
+
+        removeLazyRanges();
+
+        updateTimer.stop();
+
+        // CPLEX calls the lazy constraint callback for MIPs only
+        bool useCallback = (_separator && cplex_.isMIP());
+
+        IloCplex::Callback callback;
+        if (useCallback)
+            callback = cplex_.use(IloCplex::Callback(new (env_) CplexLazyCallbackI(env_, x_, _separator, _separatorMutex)));
+
+        bool useProgressCallback = (_progressCallback && cplex_.isMIP());
+
+        IloCplex::Callback progressCallback;
+        if (useProgressCallback)
+            progressCallback = cplex_.use(IloCplex::Callback(new (env_) CplexProgressCallbackI(env_, obj_, _progressCallback, _progressMutex)));
+
+        SolveStatistics::Timer solveTimer(statistics.time[SolveStatistics::Solve]);
+
 		boost::timer::cpu_timer timer;
 		timer.start();
 
-        if(!cplex_.solve()) {
+        // keep interrupts that arrived before the solve started
+        aborter_.clear();
+        if (interruptRequested())
+            aborter_.abort();
+
+        bool solved = cplex_.solve();
+        statistics.numIterations += cplex_.getNiterations();
+
+        while (solved && _separator && !useCallback && addLazyRanges()) {
+
+            solved = cplex_.solve();
+            statistics.numIterations += cplex_.getNiterations();
+        }
+
+        solveTimer.stop();
+
+        if (useCallback)
+            cplex_.remove(callback);
+
+        if (useProgressCallback)
+            cplex_.remove(progressCallback);
+
+        readStatistics(solved, statistics);
+
+        if(!solved) {
            LOG_USER(cplexlog) << "failed to optimize. " << cplex_.getStatus() << std::endl;
            msg = "Optimal solution *NOT* found";
            return false;
         }
-        else
+        else if (cplex_.getStatus() == IloAlgorithm::Optimal)
             msg = "Optimal solution found";
+        else
+            msg = "Optimal solution *NOT* found (feasible solution found)";
 
 		boost::chrono::nanoseconds ns(timer.elapsed().system + timer.elapsed().user);
 		double seconds = boost::chrono::duration<double>(ns).count();
 		x.setTime(seconds);
 
+        SolveStatistics::Timer extractionTimer(statistics.time[SolveStatistics::Extraction]);
+
         // extract solution
         cplex_.getValues(sol_, x_);
         x.resize(_numVariables);
@@ -259,8 +678,8 @@ CplexBackend::solve(Solution& x,/* double& value, */ std::string& msg) {
         // get current value of the objective
         const double value = cplex_.getObjValue();
         x.setValue(value);
-        model_.remove(obj_);
-        //cplex_.clearModel();
+
+        extractionTimer.stop();
 
     } catch (IloCplex::Exception& e) {
 
@@ -274,6 +693,65 @@ CplexBackend::solve(Solution& x,/* double& value, */ std::string& msg) {
     return true;
 }
 
+void
+CplexBackend::readStatistics(bool solved, SolveStatistics& statistics) {
+
+    switch (cplex_.getCplexStatus()) {
+
+        case IloCplex::Optimal:
+        case IloCplex::OptimalTol:
+            statistics.status = SolveStatistics::Optimal;
+            break;
+        case IloCplex::Infeasible:
+            statistics.status = SolveStatistics::Infeasible;
+            break;
+        case IloCplex::Unbounded:
+        case IloCplex::InfOrUnbd:
+            statistics.status = SolveStatistics::Unbounded;
+            break;
+        case IloCplex::AbortTimeLim:
+            statistics.status = SolveStatistics::TimeLimit;
+            break;
+        case IloCplex::AbortItLim:
+        case IloCplex::NodeLimFeas:
+        case IloCplex::NodeLimInfeas:
+            statistics.status = SolveStatistics::IterationLimit;
+            break;
+        case IloCplex::AbortUser:
+            statistics.status = SolveStatistics::Interrupted;
+            break;
+        case IloCplex::NumBest:
+            statistics.status = SolveStatistics::NumericalFailure;
+            break;
+        default:
+            statistics.status = SolveStatistics::Unknown;
+    }
+
+    statistics.peakMemory = SolveStatistics::peakMemoryOfProcess();
+
+    // nodes and the best bound are only defined for MIPs, and bounds only
+    // if the solve got far enough, leave them at their defaults otherwise
+    try {
+
+        if (solved)
+            statistics.primalBound = cplex_.getObjValue();
+
+        if (cplex_.isMIP()) {
+
+            statistics.numNodes  = cplex_.getNnodes();
+            statistics.dualBound = cplex_.getBestObjValue();
+
+        } else if (statistics.status == SolveStatistics::Optimal) {
+
+            statistics.dualBound = statistics.primalBound;
+        }
+
+    } catch (IloCplex::Exception& e) {
+
+        LOG_DEBUG(cplexlog) << "statistics not available: " << e.getMessage() << std::endl;
+    }
+}
+
 void
 CplexBackend::setMIPGap(double gap, bool absolute) {
 
@@ -5,6 +5,7 @@
 
 
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -30,6 +31,10 @@
  * inequality constraints and x is the solution vector. a is a real-valued
  * vector denoting the coefficients of the objective and Q a PSD matrix giving
  * the quadratic coefficients of the objective.
+ *
+ * Lazy constraints are added by a lazy constraint callback to MIPs, and
+ * between solves to continuous problems, for which CPLEX does not call the
+ * callback.
  */
 class CplexBackend : public QuadraticSolverBackend {
 
@@ -83,8 +88,26 @@ public:
 
     void setConstraints(const LinearConstraints& constraints);
 
+    void setConstraints(const LinearConstraintMatrix& constraints);
+
+    using LinearSolverBackend::setConstraints;
+
     void addConstraint(const LinearConstraint& constraint);
 
+    void setObjectiveCoefficient(unsigned int varNum, double coef);
+
+    void setVariableBounds(unsigned int varNum, double lower, double upper);
+
+    void setConstraintValue(unsigned int constraint, double value);
+
+    void removeConstraints(const std::vector<unsigned int>& constraints);
+
+    void setStartSolution(const Solution& solution);
+
+    void setStartSolution(const std::map<unsigned int, double>& values);
+
+    void setSeparator(const Separator& separator);
+
     void setTimeout(double timeout) { timeout_ = timeout; }
 
     void setOptimalityGap(double gap, bool absolute=false) {
@@ -95,6 +118,8 @@ public:
 
     void setNumThreads(unsigned int numThreads);
 
+    void setProgressCallback(const ProgressCallback& callback) { _progressCallback = callback; }
+
     bool solve(Solution& solution,/* double& value, */ std::string& message);
 
     std::string solve(Solution& solution) {
@@ -106,6 +131,8 @@ public:
 
 private:
 
+    void interruptSolver() { aborter_.abort(); }
+
     //////////////
     // internal //
     //////////////
@@ -119,6 +146,32 @@ private:
     // create a CPLEX constraint from a linear constraint
     IloRange createConstraint(const LinearConstraint &constraint);
 
+    // create a CPLEX constraint from a row of a constraint matrix
+    IloRange createConstraint(const LinearConstraintMatrix& constraints, unsigned int i);
+
+    // create a CPLEX range for the given expression, relation, and value
+    IloRange createRange(IloExpr& linearExpr, Relation relation, double value);
+
+    // remove all constraints from the model
+    void removeConstraints();
+
+    // the range of a constraint in the model
+    IloRange& constraintRange(unsigned int constraint);
+
+    // hand the start values to the current cplex_ as a MIP start
+    void addMIPStart();
+
+    // add the lazy constraints violated by the current solution of a
+    // continuous problem to the model, returns false if there are none
+    bool addLazyRanges();
+
+    // remove the ranges added by addLazyRanges() from the model
+    void removeLazyRanges();
+
+    // fill the status, nodes, iterations, bounds, and memory of the
+    // statistics after a solve
+    void readStatistics(bool solved, SolveStatistics& statistics);
+
     /**
      * Enable solver output.
      */
@@ -141,7 +194,8 @@ private:
     // a value by which to scale the objective
     double _scale;
 
-    // Objective, constraints and cplex environment:
+    // Objective, constraints and cplex environment. cplex_ is kept between
+    // solves, it follows changes of the model incrementally.
     IloEnv env_;
     IloModel model_;
     IloNumVarArray x_;
@@ -151,13 +205,37 @@ private:
     IloCplex cplex_;
     double constValue_;
 
-    typedef std::vector<IloExtractable> ConstraintVector;
+    // stops a running solve, used by interruptSolver()
+    IloCplex::Aborter aborter_;
+
+    // the constraints by their number, empty ranges for removed constraints
+    typedef std::vector<IloRange> ConstraintVector;
     ConstraintVector _constraints;
 
+    // the separator for lazy constraints, and a mutex to serialize calls
+    // from the callbacks of several threads
+    Separator _separator;
+    std::mutex _separatorMutex;
+
+    // the progress callback, and a mutex to serialize calls from the
+    // callbacks of several threads
+    ProgressCallback _progressCallback;
+    std::mutex _progressMutex;
+
+    // lazy constraints added to the model of a continuous problem
+    IloRangeArray _lazyRanges;
+
+    // the start values for the next solve
+    std::vector<unsigned int> _startVariables;
+    std::vector<double> _startValues;
+
     // are we in the first run
     bool firstRun_;
 
     double timeout_;
+
+    // time spent in the calls that build the model since the last solve()
+    SolveStatistics::Time _buildTime;
 };
 
 
@@ -0,0 +1,452 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <numeric>
+#include <thread>
+
+#include <util/Logger.h>
+#include "DecompositionSolver.h"
+#include "LinearObjective.h"
+#include "Parallel.h"
+#include "Timing.h"
+
+using namespace logger;
+
+LogChannel decomplog("decomplog", "[DecompositionSolver] ");
+
+// empty constraints can be violated by this much
+static const double FeasibilityTolerance = 1e-6;
+
+// the root of the set of x in a union-find forest, with path halving
+static unsigned int
+findRoot(std::vector<unsigned int>& parents, unsigned int x) {
+
+	while (parents[x] != x) {
+
+		parents[x] = parents[parents[x]];
+		x = parents[x];
+	}
+
+	return x;
+}
+
+static void
+unite(std::vector<unsigned int>& parents, std::vector<unsigned int>& sizes, unsigned int a, unsigned int b) {
+
+	a = findRoot(parents, a);
+	b = findRoot(parents, b);
+
+	if (a == b)
+		return;
+
+	if (sizes[a] < sizes[b])
+		std::swap(a, b);
+
+	parents[b] = a;
+	sizes[a] += sizes[b];
+}
+
+DecompositionSolver::DecompositionSolver(
+		unsigned int                                numVariables,
+		VariableType                                defaultVariableType,
+		const std::map<unsigned int, VariableType>& specialVariableTypes,
+		const Parameter&                            parameter) :
+	_parameter(parameter),
+	_numVariables(numVariables),
+	_types(numVariables, defaultVariableType),
+	_lower(numVariables),
+	_upper(numVariables),
+	_objective(numVariables) {
+
+	for (auto& p : specialVariableTypes)
+		if (p.first < _numVariables)
+			_types[p.first] = p.second;
+
+	for (unsigned int i = 0; i < _numVariables; i++) {
+
+		_lower[i] = defaultLowerBound(_types[i]);
+		_upper[i] = defaultUpperBound(_types[i]);
+	}
+}
+
+void
+DecompositionSolver::setVariableBounds(unsigned int varNum, double lower, double upper) {
+
+	if (varNum >= _numVariables)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"variable " << varNum << " does not exist");
+
+	_lower[varNum] = lower;
+	_upper[varNum] = upper;
+}
+
+void
+DecompositionSolver::setObjective(const QuadraticObjective& objective) {
+
+	if (objective.size() != _numVariables)
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"objective has " << objective.size() << " coefficients, expected " << _numVariables);
+
+	_objective = objective;
+}
+
+void
+DecompositionSolver::setConstraints(const LinearConstraintMatrix& constraints) {
+
+	_constraints = constraints;
+}
+
+bool
+DecompositionSolver::solve(Solution& solution, std::string& message) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	solution.resize(_numVariables);
+
+	// finding the components is the presolve, the components are solved in
+	// parallel, such that only the times of the whole are meaningful
+	SolveStatistics& statistics = solution.getStatistics();
+	statistics = SolveStatistics(_objective.getSense());
+
+	SolveStatistics::Timer presolveTimer(statistics.time[SolveStatistics::Presolve]);
+
+	if (!decompose(message)) {
+
+		statistics.status = SolveStatistics::Infeasible;
+		// no solution exists, which bounds the objective by infinity
+		statistics.dualBound = statistics.primalBound;
+		solution.setTime(secondsSince(start));
+		return false;
+	}
+
+	presolveTimer.stop();
+
+	LOG_USER(decomplog)
+			<< "solving " << _components.size() << " components of "
+			<< _numVariables << " variables" << std::endl;
+
+	// solve the largest components first, to not end with a large one on a
+	// single thread
+	std::vector<unsigned int> order(_components.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(
+			order.begin(),
+			order.end(),
+			[this](unsigned int a, unsigned int b) {
+				return _components[a].variables.size() > _components[b].variables.size();
+			});
+
+	unsigned int numThreads = _parameter.numThreads;
+	if (numThreads == 0)
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	unsigned int numWorkers = numLoopThreads(numThreads, _components.size(), 1);
+	unsigned int threadsPerComponent = std::max(1u, numThreads/numWorkers);
+
+	SolveStatistics::Timer solveTimer(statistics.time[SolveStatistics::Solve]);
+
+	std::atomic<size_t> next(0);
+	std::vector<std::exception_ptr> errors(numWorkers);
+
+	auto work = [&](unsigned int t) {
+
+		try {
+
+			for (size_t i = next++; i < order.size(); i = next++) {
+
+				Component& component = _components[order[i]];
+
+				double timeout = 0;
+				if (_parameter.timeout > 0) {
+
+					timeout = _parameter.timeout - secondsSince(start);
+
+					if (timeout <= 0) {
+
+						component.solved  = false;
+						component.message = "Optimal solution *NOT* found (timeout)";
+						component.solution.setStatistics(SolveStatistics(_objective.getSense()));
+						component.solution.getStatistics().status = SolveStatistics::TimeLimit;
+						continue;
+					}
+				}
+
+				solveComponent(component, threadsPerComponent, timeout);
+			}
+
+		} catch (...) {
+
+			errors[t] = std::current_exception();
+			next = order.size();
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned int t = 1; t < numWorkers; t++)
+		workers.emplace_back(work, t);
+	work(0);
+	for (std::thread& worker : workers)
+		worker.join();
+
+	for (std::exception_ptr& error : errors)
+		if (error)
+			std::rethrow_exception(error);
+
+	solveTimer.stop();
+
+	// merge the solutions
+
+	bool   optimal = true;
+	double value   = _objective.getConstant();
+
+	message = "Optimal solution found";
+
+	SolveStatistics::Timer extractionTimer(statistics.time[SolveStatistics::Extraction]);
+
+	statistics.status      = SolveStatistics::Optimal;
+	statistics.primalBound = _objective.getConstant();
+	statistics.dualBound   = _objective.getConstant();
+
+	for (unsigned int c = 0; c < _components.size(); c++) {
+
+		const Component& component = _components[c];
+		const SolveStatistics& componentStatistics = component.solution.getStatistics();
+
+		// the bounds of the components add up, since they share no variables
+		statistics.numNodes      += componentStatistics.numNodes;
+		statistics.numIterations += componentStatistics.numIterations;
+		statistics.primalBound   += componentStatistics.primalBound;
+		statistics.dualBound     += componentStatistics.dualBound;
+
+		if (!component.solved && optimal) {
+
+			optimal = false;
+			message = component.message;
+			statistics.status = componentStatistics.status;
+
+			LOG_USER(decomplog)
+					<< "component " << c << " of " << component.variables.size()
+					<< " variables: " << component.message << std::endl;
+		}
+
+		value += component.solution.getValue();
+
+		if (component.solution.size() < component.variables.size())
+			continue;
+
+		for (unsigned int i = 0; i < component.variables.size(); i++)
+			solution[component.variables[i]] = component.solution[i];
+	}
+
+	extractionTimer.stop();
+
+	statistics.peakMemory = SolveStatistics::peakMemoryOfProcess();
+
+	solution.setValue(value);
+	solution.setTime(secondsSince(start));
+
+	return optimal;
+}
+
+bool
+DecompositionSolver::decompose(std::string& message) {
+
+	_components.clear();
+
+	const std::vector<size_t>&       offsets = _constraints.getRowOffsets();
+	const std::vector<unsigned int>& columns = _constraints.getColumns();
+	const std::vector<double>&       coefs   = _constraints.getCoefficients();
+
+	std::vector<unsigned int> parents(_numVariables);
+	std::vector<unsigned int> sizes(_numVariables, 1);
+	std::iota(parents.begin(), parents.end(), 0);
+
+	// variables that appear in a constraint or a quadratic term
+	std::vector<char> used(_numVariables, 0);
+
+	for (unsigned int i = 0; i < _constraints.size(); i++) {
+
+		int first = -1;
+
+		for (size_t j = offsets[i]; j < offsets[i + 1]; j++) {
+
+			if (coefs[j] == 0)
+				continue;
+
+			used[columns[j]] = 1;
+
+			if (first < 0)
+				first = columns[j];
+			else
+				unite(parents, sizes, first, columns[j]);
+		}
+
+		// empty constraints don't belong to any component
+		if (first < 0) {
+
+			double violation = LinearConstraint::violation(0, _constraints.getRelations()[i], _constraints.getValues()[i]);
+
+			if (violation > FeasibilityTolerance) {
+
+				message = "Optimal solution *NOT* found (problem is infeasible)";
+				return false;
+			}
+		}
+	}
+
+	const std::vector<unsigned int>& quadraticRows    = _objective.getQuadraticRows();
+	const std::vector<unsigned int>& quadraticColumns = _objective.getQuadraticColumns();
+
+	for (size_t k = 0; k < _objective.numQuadraticTerms(); k++) {
+
+		used[quadraticRows[k]]    = 1;
+		used[quadraticColumns[k]] = 1;
+		unite(parents, sizes, quadraticRows[k], quadraticColumns[k]);
+	}
+
+	// number the components, unused variables all go to the last one
+
+	std::vector<int> componentOf(_numVariables, -1);
+	std::vector<unsigned int> localIndex(_numVariables);
+
+	unsigned int numComponents = 0;
+	for (unsigned int v = 0; v < _numVariables; v++)
+		if (used[v] && findRoot(parents, v) == v)
+			componentOf[v] = numComponents++;
+
+	bool hasUnused = (std::find(used.begin(), used.end(), 0) != used.end());
+
+	_components.resize(numComponents + (hasUnused ? 1 : 0));
+
+	for (unsigned int v = 0; v < _numVariables; v++) {
+
+		componentOf[v] = (used[v] ? componentOf[findRoot(parents, v)] : numComponents);
+
+		std::vector<unsigned int>& variables = _components[componentOf[v]].variables;
+		localIndex[v] = variables.size();
+		variables.push_back(v);
+	}
+
+	// create the sub-problems
+
+	for (Component& component : _components) {
+
+		component.objective = QuadraticObjective(component.variables.size());
+		component.objective.setSense(_objective.getSense());
+
+		for (unsigned int i = 0; i < component.variables.size(); i++)
+			component.objective.setCoefficient(i, _objective.getCoefficients()[component.variables[i]]);
+
+		component.solution = Solution();
+		component.solved   = false;
+		component.message.clear();
+	}
+
+	std::vector<std::vector<unsigned int>> rows(_components.size());
+	std::vector<std::vector<unsigned int>> cols(_components.size());
+	std::vector<std::vector<double>>       vals(_components.size());
+
+	for (size_t k = 0; k < _objective.numQuadraticTerms(); k++) {
+
+		unsigned int c = componentOf[quadraticRows[k]];
+
+		rows[c].push_back(localIndex[quadraticRows[k]]);
+		cols[c].push_back(localIndex[quadraticColumns[k]]);
+		vals[c].push_back(_objective.getQuadraticValues()[k]);
+	}
+
+	for (unsigned int c = 0; c < _components.size(); c++)
+		if (!rows[c].empty())
+			_components[c].objective.addQuadraticTerms(rows[c], cols[c], vals[c]);
+
+	std::vector<unsigned int> localColumns;
+	std::vector<double>       localCoefs;
+
+	for (unsigned int i = 0; i < _constraints.size(); i++) {
+
+		localColumns.clear();
+		localCoefs.clear();
+
+		int c = -1;
+
+		for (size_t j = offsets[i]; j < offsets[i + 1]; j++) {
+
+			if (coefs[j] == 0)
+				continue;
+
+			c = componentOf[columns[j]];
+			localColumns.push_back(localIndex[columns[j]]);
+			localCoefs.push_back(coefs[j]);
+		}
+
+		if (c < 0)
+			continue;
+
+		_components[c].constraints.addRow(
+				localColumns.size(),
+				localColumns.data(),
+				localCoefs.data(),
+				_constraints.getRelations()[i],
+				_constraints.getValues()[i]);
+	}
+
+	return true;
+}
+
+void
+DecompositionSolver::solveComponent(Component& component, unsigned int numThreads, double timeout) const {
+
+	unsigned int n = component.variables.size();
+
+	std::map<unsigned int, VariableType> types;
+	for (unsigned int i = 0; i < n; i++)
+		if (_types[component.variables[i]] != Continuous)
+			types[i] = _types[component.variables[i]];
+
+	std::shared_ptr<LinearSolverBackend> backend;
+
+	if (component.objective.numQuadraticTerms() > 0) {
+
+		std::shared_ptr<QuadraticSolverBackend> quadraticBackend =
+				_factory.createQuadraticSolverBackend(_parameter.preference);
+
+		quadraticBackend->initialize(n, Continuous, types);
+		quadraticBackend->setObjective(component.objective);
+		backend = quadraticBackend;
+
+	} else {
+
+		LinearObjective objective(n);
+		objective.setSense(component.objective.getSense());
+		for (unsigned int i = 0; i < n; i++)
+			objective.setCoefficient(i, component.objective.getCoefficients()[i]);
+
+		backend = _factory.createLinearSolverBackend(_parameter.preference);
+		backend->initialize(n, Continuous, types);
+		backend->setObjective(objective);
+	}
+
+	backend->setConstraints(component.constraints);
+
+	// set bounds that differ from the defaults of the variable types
+	for (unsigned int i = 0; i < n; i++) {
+
+		unsigned int v = component.variables[i];
+
+		if (!hasDefaultBounds(_types[v], _lower[v], _upper[v]))
+			backend->setVariableBounds(i, _lower[v], _upper[v]);
+	}
+
+	backend->setNumThreads(numThreads);
+	backend->setVerbose(_parameter.verbose);
+	if (timeout > 0)
+		backend->setTimeout(timeout);
+	if (_parameter.gap > 0)
+		backend->setOptimalityGap(_parameter.gap, _parameter.absoluteGap);
+
+	component.solved = backend->solve(component.solution, component.message);
+}
@@ -0,0 +1,156 @@
+#ifndef INFERENCE_DECOMPOSITION_SOLVER_H__
+#define INFERENCE_DECOMPOSITION_SOLVER_H__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "LinearConstraintMatrix.h"
+#include "LinearConstraints.h"
+#include "QuadraticObjective.h"
+#include "Solution.h"
+#include "SolverFactory.h"
+#include "VariableType.h"
+
+/**
+ * Solves problems that consist of independent sub-problems by solving each of
+ * them separately.
+ *
+ * Two variables belong to the same component if they appear together in a
+ * constraint or in a quadratic term of the objective. Each component is set up
+ * as a problem of its own in a backend created by the SolverFactory, and the
+ * components are solved concurrently. Variables that appear in no constraint
+ * and no quadratic term are collected in a single component.
+ *
+ * Components without quadratic terms are solved with a linear backend, the
+ * others with a quadratic backend.
+ */
+class DecompositionSolver {
+
+public:
+
+	struct Parameter {
+
+		Parameter() :
+			preference(Any),
+			numThreads(0),
+			timeout(0),
+			gap(0),
+			absoluteGap(false),
+			verbose(false) {}
+
+		// the backend to create for each component
+		Preference preference;
+
+		// the total number of threads, shared by the components solved at the
+		// same time, 0 for all hardware threads
+		unsigned int numThreads;
+
+		// the timeout in seconds for the whole solve, 0 for no timeout
+		double timeout;
+
+		// the optimality gap for each component, see
+		// LinearSolverBackend::setOptimalityGap()
+		double gap;
+		bool   absoluteGap;
+
+		bool verbose;
+	};
+
+	/**
+	 * @param numVariables
+	 *             The number of variables in the problem.
+	 *
+	 * @param defaultVariableType
+	 *             The default type of the variables.
+	 *
+	 * @param specialVariableTypes
+	 *             A map of variable numbers to variable types to override the
+	 *             default.
+	 */
+	DecompositionSolver(
+			unsigned int                                numVariables,
+			VariableType                                defaultVariableType,
+			const std::map<unsigned int, VariableType>& specialVariableTypes = std::map<unsigned int, VariableType>(),
+			const Parameter&                            parameter = Parameter());
+
+	/**
+	 * Change the bounds of a variable. Use infinite values for unbounded
+	 * variables.
+	 */
+	void setVariableBounds(unsigned int varNum, double lower, double upper);
+
+	/**
+	 * Set the objective, linear or quadratic.
+	 */
+	void setObjective(const QuadraticObjective& objective);
+
+	/**
+	 * Set the linear (in)equality constraints.
+	 */
+	void setConstraints(const LinearConstraintMatrix& constraints);
+
+	void setConstraints(const LinearConstraints& constraints) { setConstraints(LinearConstraintMatrix(constraints)); }
+
+	/**
+	 * Solve all components.
+	 *
+	 * @param solution
+	 *             A solution object to write the solution to. Its value is
+	 *             the sum of the values of the components.
+	 *
+	 * @param message
+	 *             A status message. If a component was not solved to
+	 *             optimality, the message of its backend.
+	 *
+	 * @return true, if the optimal solution was found for every component.
+	 */
+	bool solve(Solution& solution, std::string& message);
+
+	/**
+	 * @return The number of components found by the last call to solve().
+	 */
+	unsigned int getNumComponents() const { return _components.size(); }
+
+private:
+
+	struct Component {
+
+		// the variables of the original problem in this component
+		std::vector<unsigned int> variables;
+
+		QuadraticObjective     objective;
+		LinearConstraintMatrix constraints;
+
+		// the solution of the last solve
+		Solution    solution;
+		bool        solved;
+		std::string message;
+	};
+
+	// find the components and create their sub-problems, returns false if an
+	// empty constraint is violated
+	bool decompose(std::string& message);
+
+	// set up a backend for a component and solve it
+	void solveComponent(Component& component, unsigned int numThreads, double timeout) const;
+
+	SolverFactory _factory;
+
+	Parameter _parameter;
+
+	unsigned int _numVariables;
+
+	std::vector<VariableType> _types;
+
+	std::vector<double> _lower;
+	std::vector<double> _upper;
+
+	QuadraticObjective     _objective;
+	LinearConstraintMatrix _constraints;
+
+	std::vector<Component> _components;
+};
+
+#endif // INFERENCE_DECOMPOSITION_SOLVER_H__
+
@@ -4,6 +4,9 @@
 
 #ifdef HAVE_GUROBI
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <sstream>
 
 #include <util/Logger.h>
@@ -19,8 +22,13 @@ LogChannel gurobilog("gurobilog", "[GurobiBackend] ");
 GurobiBackend::GurobiBackend() :
 	_numVariables(0),
 	_numConstraints(0),
+	_lastIncumbent(0),
+	_lastBound(0),
+	_numLazyRows(0),
+	_rowsAdded(false),
 	_env(0),
 	_model(0),
+	_hasModelStart(false),
 	_timeout(0),
 	_gap(-1),
 	_absoluteGap(false) {
@@ -53,12 +61,20 @@ GurobiBackend::initialize(
 		VariableType                                defaultVariableType,
 		const std::map<unsigned int, VariableType>& specialVariableTypes) {
 
+	SolveStatistics::Timer timer(_buildTime);
+
 	// create a new model
 
 	if (_model) {
 		GRBfreemodel(_model);
 		_numConstraints = 0;
+		_numLazyRows = 0;
+		_constraintRows.clear();
+		_rowsAdded = false;
 	}
+	_start.clear();
+	_hasModelStart = false;
+
 	GRB_CHECK(GRBnewmodel(_env, &_model, NULL, 0, NULL, NULL, NULL, NULL, NULL));
 
 	// set parameters
@@ -107,12 +123,16 @@ GurobiBackend::initialize(
 void
 GurobiBackend::setObjective(const LinearObjective& objective) {
 
+	SolveStatistics::Timer timer(_buildTime);
+
 	setObjective((QuadraticObjective)objective);
 }
 
 void
 GurobiBackend::setObjective(const QuadraticObjective& objective) {
 
+	SolveStatistics::Timer timer(_buildTime);
+
 	// set sense of objective
 	if (objective.getSense() == Minimize) {
 		GRB_CHECK(GRBsetintattr(_model, GRB_INT_ATTR_MODELSENSE, +1));
@@ -137,21 +157,18 @@ GurobiBackend::setObjective(const QuadraticObjective& objective) {
 	// set the quadratic coefficients for all pairs of variables
 	LOG_DEBUG(gurobilog) << "setting quadratic coefficients" << std::endl;
 
-	for (auto& pair : objective.getQuadraticCoefficients()) {
-
-		const std::pair<unsigned int, unsigned int>& variables = pair.first;
-		float value = pair.second;
-
-		LOG_ALL(gurobilog) << "setting Q(" << variables.first << ", " << variables.second
-						   << ") to " << value << std::endl;
+	if (objective.numQuadraticTerms() > 0) {
 
-		if (value != 0) {
+		LOG_ALL(gurobilog) << "adding " << objective.numQuadraticTerms() << " quadratic terms" << std::endl;
 
-			int row = variables.first;
-			int col = variables.second;
-			double val = value;
-			GRB_CHECK(GRBaddqpterms(_model, 1, &row, &col, &val));
-		}
+		// hand all terms to Gurobi in one call, variable numbers are
+		// guaranteed to fit into int
+		GRB_CHECK(GRBaddqpterms(
+				_model,
+				objective.numQuadraticTerms(),
+				reinterpret_cast<int*>(const_cast<unsigned int*>(objective.getQuadraticRows().data())),
+				reinterpret_cast<int*>(const_cast<unsigned int*>(objective.getQuadraticColumns().data())),
+				const_cast<double*>(objective.getQuadraticValues().data())));
 	}
 
 	LOG_ALL(gurobilog) << "updating the model" << std::endl;
@@ -162,72 +179,267 @@ GurobiBackend::setObjective(const QuadraticObjective& objective) {
 void
 GurobiBackend::setConstraints(const LinearConstraints& constraints) {
 
-	// delete all previous constraints
+	SolveStatistics::Timer timer(_buildTime);
 
-	if (_numConstraints > 0) {
+	// convert into a CSR matrix first, to hand all constraints to Gurobi in
+	// a single call
+	setConstraints(LinearConstraintMatrix(constraints));
+}
 
-		int* constraintIndicies = new int[_numConstraints];
-		for (int i = 0; i < _numConstraints; i++)
-			constraintIndicies[i] = i;
-		GRB_CHECK(GRBdelconstrs(_model, _numConstraints, constraintIndicies));
+void
+GurobiBackend::setConstraints(const LinearConstraintMatrix& constraints) {
 
-		GRB_CHECK(GRBupdatemodel(_model));
-	}
+	SolveStatistics::Timer timer(_buildTime);
+
+	setConstraints(constraints.view());
+}
+
+void
+GurobiBackend::setConstraints(const LinearConstraintMatrixView& constraints) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	// delete all previous constraints
+	deleteConstraints();
 
 	LOG_DEBUG(gurobilog) << "setting " << constraints.size() << " constraints" << std::endl;
 
+	if (constraints.size() == 0)
+		return;
+
+	std::vector<char> senses(constraints.size());
+	for (unsigned int i = 0; i < constraints.size(); i++)
+		senses[i] = grbSense(constraints.relations[i]);
+
+	// Gurobi expects int indices, variable numbers are guaranteed to fit
+	GRB_CHECK(GRBXaddconstrs(
+			_model,
+			constraints.size(),
+			constraints.numNonZeros,
+			const_cast<size_t*>(constraints.rowOffsets),
+			reinterpret_cast<int*>(const_cast<unsigned int*>(constraints.columns)),
+			const_cast<double*>(constraints.coefficients),
+			senses.data(),
+			const_cast<double*>(constraints.values),
+			NULL /* optional names */));
+
 	_numConstraints = constraints.size();
-	unsigned int j = 0;
-	for (const LinearConstraint& constraint : constraints) {
 
-		if (j > 0)
-			if (j % 1000 == 0)
-				LOG_ALL(gurobilog) << "" << j << " constraints set so far" << std::endl;
+	_constraintRows.resize(_numConstraints);
+	for (unsigned int i = 0; i < _numConstraints; i++)
+		_constraintRows[i] = i;
 
-		addConstraint(constraint);
+	GRB_CHECK(GRBupdatemodel(_model));
+}
 
-		j++;
-	}
+void
+GurobiBackend::deleteConstraints() {
+
+	removeLazyRows();
+
+	_constraintRows.clear();
+
+	if (_numConstraints == 0)
+		return;
+
+	int* constraintIndicies = new int[_numConstraints];
+	for (int i = 0; i < _numConstraints; i++)
+		constraintIndicies[i] = i;
+	GRB_CHECK(GRBdelconstrs(_model, _numConstraints, constraintIndicies));
+	delete[] constraintIndicies;
+
+	_numConstraints = 0;
 
 	GRB_CHECK(GRBupdatemodel(_model));
 }
 
+char
+GurobiBackend::grbSense(Relation relation) {
+
+	return (relation == LessEqual ? GRB_LESS_EQUAL :
+			(relation == GreaterEqual ? GRB_GREATER_EQUAL :
+					GRB_EQUAL));
+}
+
 void
 GurobiBackend::addConstraint(const LinearConstraint& constraint) {
 
+	SolveStatistics::Timer timer(_buildTime);
+
+	// the new row has to follow the constraints
+	removeLazyRows();
+
 	int numNz = constraint.getCoefficients().size();
 
-	int*    inds = new int[numNz];
-	double* vals = new double[numNz];
+	_constraintInds.resize(numNz);
+	_constraintVals.resize(numNz);
 
 	// set the coefficients
 	int i = 0;
 	for (auto& pair : constraint.getCoefficients()) {
 
-		inds[i] = pair.first;
-		vals[i] = pair.second;
+		_constraintInds[i] = pair.first;
+		_constraintVals[i] = pair.second;
 		i++;
 	}
 
 	GRB_CHECK(GRBaddconstr(
 			_model,
 			numNz,
-			inds,
-			vals,
-			(constraint.getRelation() == LessEqual ? GRB_LESS_EQUAL :
-					(constraint.getRelation() == GreaterEqual ? GRB_GREATER_EQUAL :
-							GRB_EQUAL)),
+			_constraintInds.data(),
+			_constraintVals.data(),
+			grbSense(constraint.getRelation()),
 			constraint.getValue(),
 			NULL /* optional name */));
 
-	delete[] inds;
-	delete[] vals;
+	_constraintRows.push_back(_numConstraints);
+	_numConstraints++;
+
+	// the row can be accessed after the next update of the model
+	_rowsAdded = true;
+}
+
+void
+GurobiBackend::setObjectiveCoefficient(unsigned int varNum, double coef) {
+
+	GRB_CHECK(GRBsetdblattrelement(_model, GRB_DBL_ATTR_OBJ, varNum, coef));
+}
+
+void
+GurobiBackend::setVariableBounds(unsigned int varNum, double lower, double upper) {
+
+	GRB_CHECK(GRBsetdblattrelement(_model, GRB_DBL_ATTR_LB, varNum, std::max(lower, -GRB_INFINITY)));
+	GRB_CHECK(GRBsetdblattrelement(_model, GRB_DBL_ATTR_UB, varNum, std::min(upper,  GRB_INFINITY)));
+}
+
+void
+GurobiBackend::setConstraintValue(unsigned int constraint, double value) {
+
+	GRB_CHECK(GRBsetdblattrelement(_model, GRB_DBL_ATTR_RHS, constraintRow(constraint), value));
+}
+
+void
+GurobiBackend::removeConstraints(const std::vector<unsigned int>& constraints) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	std::vector<int> rows;
+	rows.reserve(constraints.size());
+	for (unsigned int constraint : constraints) {
+
+		rows.push_back(constraintRow(constraint));
+		_constraintRows[constraint] = -1;
+	}
+
+	LOG_DEBUG(gurobilog) << "removing " << rows.size() << " constraints" << std::endl;
+
+	GRB_CHECK(GRBdelconstrs(_model, rows.size(), rows.data()));
+	GRB_CHECK(GRBupdatemodel(_model));
+
+	_numConstraints -= rows.size();
+
+	// the remaining rows move up by the number of removed rows before them
+	std::sort(rows.begin(), rows.end());
+	for (int& row : _constraintRows)
+		if (row >= 0)
+			row -= std::upper_bound(rows.begin(), rows.end(), row) - rows.begin();
+}
+
+int
+GurobiBackend::constraintRow(unsigned int constraint) {
+
+	if (constraint >= _constraintRows.size() || _constraintRows[constraint] < 0)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"constraint " << constraint << " does not exist");
+
+	// rows added since the last update can not be accessed before, other
+	// changes can stay pending
+	if (_rowsAdded) {
+
+		GRB_CHECK(GRBupdatemodel(_model));
+		_rowsAdded = false;
+	}
+
+	return _constraintRows[constraint];
+}
+
+void
+GurobiBackend::setStartSolution(const Solution& solution) {
+
+	_start.assign(solution.getVector().begin(), solution.getVector().end());
+	_start.resize(_numVariables, GRB_UNDEFINED);
+}
+
+void
+GurobiBackend::setStartSolution(const std::map<unsigned int, double>& values) {
+
+	// the map is sorted, the last variable has the largest number
+	if (!values.empty() && values.rbegin()->first >= _numVariables)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"variable " << values.rbegin()->first << " does not exist");
+
+	_start.assign(_numVariables, GRB_UNDEFINED);
+	for (auto& p : values)
+		_start[p.first] = p.second;
 }
 
 bool
 GurobiBackend::solve(Solution& x, std::string& msg) {
 
+	SolveScope scope(*this);
+
+	int sense;
+	GRB_CHECK(GRBgetintattr(_model, GRB_INT_ATTR_MODELSENSE, &sense));
+
+	SolveStatistics& statistics = x.getStatistics();
+	statistics = SolveStatistics(sense == GRB_MINIMIZE ? Minimize : Maximize);
+	statistics.time[SolveStatistics::Build] = _buildTime;
+	_buildTime = SolveStatistics::Time();
+
+	// the start, removal of lazy rows, and pending changes of the model
+	SolveStatistics::Timer updateTimer(statistics.time[SolveStatistics::Update]);
+
+	if (!_start.empty()) {
+
+		LOG_DEBUG(gurobilog) << "setting MIP start" << std::endl;
+
+		GRB_CHECK(GRBsetdblattrarray(_model, GRB_DBL_ATTR_START, 0, _numVariables, _start.data()));
+
+		// the start is used for this solve only, and cleared in the model
+		// before the next one
+		_start.clear();
+		_hasModelStart = true;
+
+	} else if (_hasModelStart) {
+
+		std::vector<double> undefined(_numVariables, GRB_UNDEFINED);
+		GRB_CHECK(GRBsetdblattrarray(_model, GRB_DBL_ATTR_START, 0, _numVariables, undefined.data()));
+		_hasModelStart = false;
+	}
+
+	removeLazyRows();
+
 	GRB_CHECK(GRBupdatemodel(_model));
+	_rowsAdded = false;
+
+	updateTimer.stop();
+
+	// lazy constraints are added by a callback to MIPs, and between solves
+	// to LPs, for which Gurobi does not call the callback
+
+	int isMIP;
+	GRB_CHECK(GRBgetintattr(_model, GRB_INT_ATTR_IS_MIP, &isMIP));
+
+	bool useLazyCallback = (_separator && isMIP);
+
+	_lastIncumbent = std::numeric_limits<double>::quiet_NaN();
+	_lastBound     = std::numeric_limits<double>::quiet_NaN();
+
+	GRBenv* env = GRBgetenv(_model);
+	GRB_CHECK(GRBsetintparam(env, GRB_INT_PAR_LAZYCONSTRAINTS, useLazyCallback ? 1 : 0));
+	GRB_CHECK(GRBsetcallbackfunc(_model, callback, this));
 
 	if (_timeout > 0) {
 
@@ -249,17 +461,35 @@ GurobiBackend::solve(Solution& x, std::string& msg) {
 				<< " optimality gap of " << _gap << std::endl;
 	}
 
+	SolveStatistics::Timer solveTimer(statistics.time[SolveStatistics::Solve]);
+
 	boost::timer::cpu_timer timer;
 	timer.start();
 
 	GRB_CHECK(GRBoptimize(_model));
 
+	int status;
+	GRB_CHECK(GRBgetintattr(_model, GRB_INT_ATTR_STATUS, &status));
+
+	double iterations;
+	GRB_CHECK(GRBgetdblattr(_model, GRB_DBL_ATTR_ITERCOUNT, &iterations));
+	statistics.numIterations += iterations;
+
+	while (_separator && !isMIP && status == GRB_OPTIMAL && addLazyRows()) {
+
+		GRB_CHECK(GRBoptimize(_model));
+		GRB_CHECK(GRBgetintattr(_model, GRB_INT_ATTR_STATUS, &status));
+
+		GRB_CHECK(GRBgetdblattr(_model, GRB_DBL_ATTR_ITERCOUNT, &iterations));
+		statistics.numIterations += iterations;
+	}
+
 	boost::chrono::nanoseconds ns(timer.elapsed().system + timer.elapsed().user);
 	double seconds = boost::chrono::duration<double>(ns).count();
 	x.setTime(seconds);
 
-	int status;
-	GRB_CHECK(GRBgetintattr(_model, GRB_INT_ATTR_STATUS, &status));
+	solveTimer.stop();
+	readStatistics(status, isMIP, statistics);
 
 	if (status != GRB_OPTIMAL) {
 
@@ -267,9 +497,9 @@ GurobiBackend::solve(Solution& x, std::string& msg) {
 
 		// see if a feasible solution exists
 
-		if (status == GRB_TIME_LIMIT) {
+		if (status == GRB_TIME_LIMIT || status == GRB_INTERRUPTED) {
 
-			msg += " (timeout";
+			msg += (status == GRB_TIME_LIMIT ? " (timeout" : " (interrupted");
 
 			int numSolutions;
 			GRB_CHECK(GRBgetintattr(_model, GRB_INT_ATTR_SOLCOUNT, &numSolutions));
@@ -296,6 +526,8 @@ GurobiBackend::solve(Solution& x, std::string& msg) {
 		msg = "Optimal solution found";
 	}
 
+	SolveStatistics::Timer extractionTimer(statistics.time[SolveStatistics::Extraction]);
+
 	// extract solution
 
 	LOG_ALL(gurobilog) << "extracting solution for " << _numVariables << " variables" << std::endl;
@@ -314,6 +546,214 @@ GurobiBackend::solve(Solution& x, std::string& msg) {
 	return true;
 }
 
+void
+GurobiBackend::readStatistics(int status, bool isMIP, SolveStatistics& statistics) {
+
+	switch (status) {
+
+		case GRB_OPTIMAL:
+			statistics.status = SolveStatistics::Optimal;
+			break;
+		case GRB_INFEASIBLE:
+			statistics.status = SolveStatistics::Infeasible;
+			// the optimum is infinite in the direction of the sense
+			statistics.dualBound = -statistics.dualBound;
+			break;
+		case GRB_INF_OR_UNBD:
+		case GRB_UNBOUNDED:
+			statistics.status = SolveStatistics::Unbounded;
+			break;
+		case GRB_TIME_LIMIT:
+			statistics.status = SolveStatistics::TimeLimit;
+			break;
+		case GRB_ITERATION_LIMIT:
+		case GRB_NODE_LIMIT:
+			statistics.status = SolveStatistics::IterationLimit;
+			break;
+		case GRB_INTERRUPTED:
+			statistics.status = SolveStatistics::Interrupted;
+			break;
+		case GRB_NUMERIC:
+		case GRB_SUBOPTIMAL:
+			statistics.status = SolveStatistics::NumericalFailure;
+			break;
+		default:
+			statistics.status = SolveStatistics::Unknown;
+	}
+
+	int numSolutions;
+	GRB_CHECK(GRBgetintattr(_model, GRB_INT_ATTR_SOLCOUNT, &numSolutions));
+
+	if (numSolutions > 0)
+		GRB_CHECK(GRBgetdblattr(_model, GRB_DBL_ATTR_OBJVAL, &statistics.primalBound));
+
+	// nodes and bounds are only defined for MIPs, an optimal LP is its own
+	// bound
+	if (isMIP) {
+
+		double numNodes;
+		GRB_CHECK(GRBgetdblattr(_model, GRB_DBL_ATTR_NODECOUNT, &numNodes));
+		statistics.numNodes = numNodes;
+
+		// not available if the solve stopped before the root was solved
+		double bound;
+		if (status != GRB_INFEASIBLE && GRBgetdblattr(_model, GRB_DBL_ATTR_OBJBOUND, &bound) == 0)
+			statistics.dualBound = bound;
+
+	} else if (status == GRB_OPTIMAL) {
+
+		statistics.dualBound = statistics.primalBound;
+	}
+
+	statistics.peakMemory = SolveStatistics::peakMemoryOfProcess();
+}
+
+void
+GurobiBackend::setSeparator(const Separator& separator) {
+
+	_separator = separator;
+}
+
+int __stdcall
+GurobiBackend::callback(GRBmodel* model, void* cbdata, int where, void* usrdata) {
+
+	GurobiBackend* backend = static_cast<GurobiBackend*>(usrdata);
+
+	if (backend->interruptRequested())
+		GRBterminate(model);
+
+	if (where == GRB_CB_MIP && backend->_progressCallback)
+		return backend->reportProgress(cbdata);
+
+	if (where != GRB_CB_MIPSOL || !backend->_separator)
+		return 0;
+
+	Solution candidate(backend->_numVariables);
+	int error = GRBcbget(cbdata, where, GRB_CB_MIPSOL_SOL, &candidate[0]);
+	if (error)
+		return error;
+
+	LinearConstraints violated;
+	backend->_separator(candidate, violated);
+
+	std::vector<int>    inds;
+	std::vector<double> vals;
+
+	for (const LinearConstraint& constraint : violated) {
+
+		inds.clear();
+		vals.clear();
+		for (auto& pair : constraint.getCoefficients()) {
+
+			inds.push_back(pair.first);
+			vals.push_back(pair.second);
+		}
+
+		error = GRBcblazy(
+				cbdata,
+				inds.size(),
+				inds.data(),
+				vals.data(),
+				backend->grbSense(constraint.getRelation()),
+				constraint.getValue());
+		if (error)
+			return error;
+	}
+
+	return 0;
+}
+
+int
+GurobiBackend::reportProgress(void* cbdata) {
+
+	double incumbent, bound, runtime;
+
+	int error = GRBcbget(cbdata, GRB_CB_MIP, GRB_CB_MIP_OBJBST, &incumbent);
+	if (!error)
+		error = GRBcbget(cbdata, GRB_CB_MIP, GRB_CB_MIP_OBJBND, &bound);
+	if (!error)
+		error = GRBcbget(cbdata, GRB_CB_MIP, GRB_CB_RUNTIME, &runtime);
+	if (error)
+		return error;
+
+	if (incumbent == _lastIncumbent && bound == _lastBound)
+		return 0;
+
+	_lastIncumbent = incumbent;
+	_lastBound     = bound;
+
+	// gurobi uses GRB_INFINITY as long as there is no solution or bound
+	const double infinity = std::numeric_limits<double>::infinity();
+	if (std::fabs(incumbent) >= GRB_INFINITY)
+		incumbent = (incumbent > 0 ? infinity : -infinity);
+	if (std::fabs(bound) >= GRB_INFINITY)
+		bound = (bound > 0 ? infinity : -infinity);
+
+	_progressCallback(Progress(incumbent, bound, runtime));
+
+	return 0;
+}
+
+bool
+GurobiBackend::addLazyRows() {
+
+	Solution candidate(_numVariables);
+	GRB_CHECK(GRBgetdblattrarray(_model, GRB_DBL_ATTR_X, 0, _numVariables, &candidate[0]));
+
+	LinearConstraints violated;
+	_separator(candidate, violated);
+
+	double feasibilityTolerance;
+	GRB_CHECK(GRBgetdblparam(GRBgetenv(_model), GRB_DBL_PAR_FEASIBILITYTOL, &feasibilityTolerance));
+
+	unsigned int numLazyRows = _numLazyRows;
+
+	for (const LinearConstraint& constraint : violated) {
+
+		if (!constraint.isViolated(candidate, feasibilityTolerance))
+			continue;
+
+		_constraintInds.clear();
+		_constraintVals.clear();
+		for (auto& pair : constraint.getCoefficients()) {
+
+			_constraintInds.push_back(pair.first);
+			_constraintVals.push_back(pair.second);
+		}
+
+		GRB_CHECK(GRBaddconstr(
+				_model,
+				_constraintInds.size(),
+				_constraintInds.data(),
+				_constraintVals.data(),
+				grbSense(constraint.getRelation()),
+				constraint.getValue(),
+				NULL /* optional name */));
+
+		_numLazyRows++;
+	}
+
+	GRB_CHECK(GRBupdatemodel(_model));
+
+	return _numLazyRows > numLazyRows;
+}
+
+void
+GurobiBackend::removeLazyRows() {
+
+	if (_numLazyRows == 0)
+		return;
+
+	std::vector<int> rows(_numLazyRows);
+	for (unsigned int i = 0; i < _numLazyRows; i++)
+		rows[i] = _numConstraints + i;
+
+	GRB_CHECK(GRBdelconstrs(_model, rows.size(), rows.data()));
+	GRB_CHECK(GRBupdatemodel(_model));
+
+	_numLazyRows = 0;
+}
+
 void
 GurobiBackend::setMIPFocus(unsigned int focus) {
 
@@ -328,6 +768,15 @@ GurobiBackend::setNumThreads(unsigned int numThreads) {
 	GRB_CHECK(GRBsetintparam(modelenv, GRB_INT_PAR_THREADS, numThreads));
 }
 
+void
+GurobiBackend::interruptSolver() {
+
+	// Gurobi ignores this before GRBoptimize() started, the callback
+	// terminates solves that were interrupted before
+	if (_model)
+		GRBterminate(_model);
+}
+
 void
 GurobiBackend::setVerbose(bool verbose) {
 
@@ -4,6 +4,7 @@
 #ifdef HAVE_GUROBI
 
 #include <string>
+#include <vector>
 
 extern "C" {
 #include <gurobi_c.h>
@@ -58,8 +59,26 @@ public:
 
 	void setConstraints(const LinearConstraints& constraints);
 
+	void setConstraints(const LinearConstraintMatrix& constraints);
+
+	void setConstraints(const LinearConstraintMatrixView& constraints);
+
 	void addConstraint(const LinearConstraint& constraint);
 
+	void setObjectiveCoefficient(unsigned int varNum, double coef);
+
+	void setVariableBounds(unsigned int varNum, double lower, double upper);
+
+	void setConstraintValue(unsigned int constraint, double value);
+
+	void removeConstraints(const std::vector<unsigned int>& constraints);
+
+	void setStartSolution(const Solution& solution);
+
+	void setStartSolution(const std::map<unsigned int, double>& values);
+
+	void setSeparator(const Separator& separator);
+
 	void setTimeout(double timeout) { _timeout = timeout; }
 
 	void setOptimalityGap(double gap, bool absolute=false) {
@@ -70,6 +89,8 @@ public:
 
 	void setNumThreads(unsigned int numThreads);
 
+	void setProgressCallback(const ProgressCallback& callback) { _progressCallback = callback; }
+
 	bool solve(Solution& solution, std::string& message);
 
 	std::string solve(Solution& solution) {
@@ -88,6 +109,36 @@ private:
 	// dump the current problem to a file
 	void dumpProblem(std::string filename);
 
+	// remove all constraints from the model
+	void deleteConstraints();
+
+	// the row of a constraint in the model
+	int constraintRow(unsigned int constraint);
+
+	void interruptSolver();
+
+	// the callback that stops interrupted solves, adds lazy constraints to
+	// MIPs, and reports their progress
+	static int __stdcall callback(GRBmodel* model, void* cbdata, int where, void* usrdata);
+
+	// report the progress of a MIP from a callback, if it changed since the
+	// last report
+	int reportProgress(void* cbdata);
+
+	// fill the status, nodes, bounds, and memory of the statistics after a
+	// solve with the given Gurobi status
+	void readStatistics(int status, bool isMIP, SolveStatistics& statistics);
+
+	// add the lazy constraints violated by the current solution of an LP as
+	// rows after the constraints, returns false if there are none
+	bool addLazyRows();
+
+	// remove the rows added by addLazyRows()
+	void removeLazyRows();
+
+	// convert a relation into a Gurobi constraint sense
+	char grbSense(Relation relation);
+
 	// set the mpi focus
 	void setMIPFocus(unsigned int focus);
 
@@ -103,17 +154,49 @@ private:
 	// number of rows in A and C
 	unsigned int _numConstraints;
 
+	// the row of each constraint in the model, -1 for removed constraints
+	std::vector<int> _constraintRows;
+
+	Separator _separator;
+
+	ProgressCallback _progressCallback;
+
+	// the incumbent and bound of the last progress report
+	double _lastIncumbent;
+	double _lastBound;
+
+	// number of rows of lazy constraints after the constraints
+	unsigned int _numLazyRows;
+
+	// rows were added since the last update of the model
+	bool _rowsAdded;
+
 	// the GRB environment
 	GRBenv* _env;
 
 	// the GRB model containing the objective and constraints
 	GRBmodel* _model;
 
+	// buffers for the indices and values of a constraint, reused between
+	// calls to addConstraint
+	std::vector<int>    _constraintInds;
+	std::vector<double> _constraintVals;
+
+	// the start values of the variables for the next solve, GRB_UNDEFINED
+	// for variables without a start value, empty if no start was given
+	std::vector<double> _start;
+
+	// are start values set in the model from a previous solve?
+	bool _hasModelStart;
+
 	double _timeout;
 
 	double _gap;
 
 	bool _absoluteGap;
+
+	// time spent in the calls that build the model since the last solve()
+	SolveStatistics::Time _buildTime;
 };
 
 #endif // HAVE_GUROBI
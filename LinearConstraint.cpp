@@ -24,7 +24,7 @@ LinearConstraint::setRelation(Relation relation) {
 	_relation = relation;
 }
 
-bool LinearConstraint::isViolated(const Solution & solution){
+bool LinearConstraint::isViolated(const Solution & solution, double tolerance) const {
 
     double s = 0;
 
@@ -34,17 +34,9 @@ bool LinearConstraint::isViolated(const Solution & solution){
         const auto sol = solution[var];
         s+= coef*sol;
     }
-    if(_relation == LessEqual){
-        return s > _value;
-    }
-    else if(_relation == GreaterEqual){
-        return s < _value;
-    }
-    else{
-        return s != _value;
-    }
-}
 
+    return violation(s, _relation, _value) > tolerance;
+}
 
 void
 LinearConstraint::setValue(double value) {
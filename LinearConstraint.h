@@ -27,7 +27,25 @@ public:
 
 	double getValue() const;
 
-    bool isViolated(const Solution & solution);
+	/**
+	 * Check whether this constraint is violated by more than the given
+	 * tolerance in a solution.
+	 */
+	bool isViolated(const Solution& solution, double tolerance = 0) const;
+
+	/**
+	 * Get the amount by which a left hand side value violates a relation to a
+	 * right hand side value, or 0 if the relation holds.
+	 */
+	static double violation(double lhs, Relation relation, double rhs) {
+
+		if (relation == LessEqual)
+			return lhs > rhs ? lhs - rhs : 0;
+		else if (relation == GreaterEqual)
+			return lhs < rhs ? rhs - lhs : 0;
+		else
+			return lhs > rhs ? lhs - rhs : rhs - lhs;
+	}
 
 private:
 
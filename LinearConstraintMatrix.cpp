@@ -0,0 +1,199 @@
+#include "LinearConstraintMatrix.h"
+#include "Parallel.h"
+
+LinearConstraintMatrix::LinearConstraintMatrix() {
+
+	_rowOffsets.push_back(0);
+}
+
+LinearConstraintMatrix::LinearConstraintMatrix(const LinearConstraints& constraints) {
+
+	_rowOffsets.push_back(0);
+
+	size_t numNonZeros = 0;
+	for (const LinearConstraint& constraint : constraints)
+		numNonZeros += constraint.getCoefficients().size();
+
+	reserve(constraints.size(), numNonZeros);
+	addAll(constraints);
+}
+
+LinearConstraintMatrix::LinearConstraintMatrix(const LinearConstraintMatrixView& view) :
+	_rowOffsets(view.rowOffsets, view.rowOffsets + view.numRows + 1),
+	_columns(view.columns, view.columns + view.numNonZeros),
+	_coefs(view.coefficients, view.coefficients + view.numNonZeros),
+	_relations(view.relations, view.relations + view.numRows),
+	_values(view.values, view.values + view.numRows) {}
+
+LinearConstraintMatrixView
+LinearConstraintMatrix::view() const {
+
+	LinearConstraintMatrixView view;
+
+	view.numRows      = size();
+	view.numNonZeros  = numNonZeros();
+	view.rowOffsets   = _rowOffsets.data();
+	view.columns      = _columns.data();
+	view.coefficients = _coefs.data();
+	view.relations    = _relations.data();
+	view.values       = _values.data();
+
+	return view;
+}
+
+void
+LinearConstraintMatrix::reserve(size_t numConstraints, size_t numNonZeros) {
+
+	_rowOffsets.reserve(numConstraints + 1);
+	_relations.reserve(numConstraints);
+	_values.reserve(numConstraints);
+	_columns.reserve(numNonZeros);
+	_coefs.reserve(numNonZeros);
+}
+
+void
+LinearConstraintMatrix::clear() {
+
+	_rowOffsets.clear();
+	_rowOffsets.push_back(0);
+	_columns.clear();
+	_coefs.clear();
+	_relations.clear();
+	_values.clear();
+}
+
+void
+LinearConstraintMatrix::add(const LinearConstraint& constraint) {
+
+	for (auto& pair : constraint.getCoefficients()) {
+
+		_columns.push_back(pair.first);
+		_coefs.push_back(pair.second);
+	}
+
+	_rowOffsets.push_back(_columns.size());
+	_relations.push_back(constraint.getRelation());
+	_values.push_back(constraint.getValue());
+}
+
+void
+LinearConstraintMatrix::addAll(const LinearConstraints& constraints) {
+
+	for (const LinearConstraint& constraint : constraints)
+		add(constraint);
+}
+
+void
+LinearConstraintMatrix::addRow(
+		size_t              numNonZeros,
+		const unsigned int* varNums,
+		const double*       coefs,
+		Relation            relation,
+		double              value) {
+
+	for (size_t i = 0; i < numNonZeros; i++) {
+
+		if (coefs[i] == 0)
+			continue;
+
+		_columns.push_back(varNums[i]);
+		_coefs.push_back(coefs[i]);
+	}
+
+	_rowOffsets.push_back(_columns.size());
+	_relations.push_back(relation);
+	_values.push_back(value);
+}
+
+LinearConstraint
+LinearConstraintMatrix::getConstraint(unsigned int i) const {
+
+	LinearConstraint constraint;
+
+	for (size_t j = _rowOffsets[i]; j < _rowOffsets[i+1]; j++)
+		constraint.setCoefficient(_columns[j], _coefs[j]);
+
+	constraint.setRelation(_relations[i]);
+	constraint.setValue(_values[i]);
+
+	return constraint;
+}
+
+LinearConstraints
+LinearConstraintMatrix::toLinearConstraints() const {
+
+	LinearConstraints constraints(size());
+
+	for (unsigned int i = 0; i < size(); i++)
+		constraints[i] = getConstraint(i);
+
+	return constraints;
+}
+
+inline double
+LinearConstraintMatrix::lhs(size_t i, const double* x) const {
+
+	const unsigned int* columns = _columns.data();
+	const double*       coefs   = _coefs.data();
+
+	// independent partial sums, to let the compiler vectorize (gather and
+	// fused multiply-add) longer rows
+	double s0 = 0, s1 = 0;
+
+	size_t j   = _rowOffsets[i];
+	size_t end = _rowOffsets[i+1];
+
+	for (; j + 1 < end; j += 2) {
+
+		s0 += coefs[j]*x[columns[j]];
+		s1 += coefs[j+1]*x[columns[j+1]];
+	}
+
+	if (j < end)
+		s0 += coefs[j]*x[columns[j]];
+
+	return s0 + s1;
+}
+
+void
+LinearConstraintMatrix::multiply(
+		const Solution&      solution,
+		std::vector<double>& lhs,
+		unsigned int         numThreads) const {
+
+	lhs.resize(size());
+
+	const double* x = solution.getVector().data();
+
+	parallelForChunks(size(), numThreads, RowsPerThread, [&](unsigned int, size_t begin, size_t end) {
+
+		for (size_t i = begin; i < end; i++)
+			lhs[i] = this->lhs(i, x);
+	});
+}
+
+std::vector<ConstraintViolation>
+LinearConstraintMatrix::findViolated(
+		const Solution& solution,
+		double          tolerance,
+		unsigned int    numThreads) const {
+
+	std::vector<std::vector<ConstraintViolation>> violations(numLoopThreads(numThreads, size(), RowsPerThread));
+
+	const double* x = solution.getVector().data();
+
+	parallelForChunks(size(), numThreads, RowsPerThread, [&](unsigned int thread, size_t begin, size_t end) {
+
+		for (size_t i = begin; i < end; i++) {
+
+			double amount = LinearConstraint::violation(lhs(i, x), _relations[i], _values[i]);
+			if (amount > tolerance)
+				violations[thread].push_back(ConstraintViolation{static_cast<unsigned int>(i), amount});
+		}
+	});
+
+	for (unsigned int t = 1; t < violations.size(); t++)
+		violations[0].insert(violations[0].end(), violations[t].begin(), violations[t].end());
+
+	return violations[0];
+}
@@ -0,0 +1,208 @@
+#ifndef INFERENCE_LINEAR_CONSTRAINT_MATRIX_H__
+#define INFERENCE_LINEAR_CONSTRAINT_MATRIX_H__
+
+#include <vector>
+#include <cstddef>
+
+#include "LinearConstraints.h"
+#include "LinearConstraintMatrixView.h"
+#include "Relation.h"
+
+/**
+ * A set of linear constraints stored as a sparse matrix in compressed sparse
+ * row (CSR) format. The coefficients of constraint i are found at positions
+ * [getRowOffsets()[i], getRowOffsets()[i+1]) in getColumns() and
+ * getCoefficients().
+ *
+ * In contrast to LinearConstraints, which keeps one std::map per constraint,
+ * all constraints share five contiguous arrays. Use this representation for
+ * large sets of constraints.
+ */
+class LinearConstraintMatrix {
+
+public:
+
+	/**
+	 * Create an empty constraint matrix.
+	 */
+	LinearConstraintMatrix();
+
+	/**
+	 * Create a constraint matrix from a set of linear constraints.
+	 *
+	 * @param constraints The linear constraints to convert.
+	 */
+	explicit LinearConstraintMatrix(const LinearConstraints& constraints);
+
+	/**
+	 * Create a constraint matrix from a copy of the arrays of a view.
+	 *
+	 * @param view The constraint matrix to copy.
+	 */
+	explicit LinearConstraintMatrix(const LinearConstraintMatrixView& view);
+
+	/**
+	 * Reserve memory for the given number of constraints and non-zero
+	 * coefficients.
+	 */
+	void reserve(size_t numConstraints, size_t numNonZeros);
+
+	/**
+	 * Remove all constraints.
+	 */
+	void clear();
+
+	/**
+	 * Append a linear constraint.
+	 *
+	 * @param constraint The linear constraint to add.
+	 */
+	void add(const LinearConstraint& constraint);
+
+	/**
+	 * Append all constraints of a set of linear constraints.
+	 *
+	 * @param constraints The linear constraints to add.
+	 */
+	void addAll(const LinearConstraints& constraints);
+
+	/**
+	 * Append a constraint given as arrays of variable numbers and
+	 * coefficients. Variable numbers within one constraint have to be
+	 * distinct. Zero coefficients are skipped.
+	 *
+	 * @param numNonZeros The length of varNums and coefs.
+	 * @param varNums The variable numbers of the coefficients.
+	 * @param coefs The coefficients.
+	 * @param relation The relation of the constraint.
+	 * @param value The right hand side of the constraint.
+	 */
+	void addRow(
+			size_t              numNonZeros,
+			const unsigned int* varNums,
+			const double*       coefs,
+			Relation            relation,
+			double              value);
+
+	/**
+	 * Change the right hand side of constraint i.
+	 */
+	void setValue(unsigned int i, double value) { _values[i] = value; }
+
+	/**
+	 * @return The number of constraints (rows) in this matrix.
+	 */
+	unsigned int size() const { return _relations.size(); }
+
+	/**
+	 * @return The number of non-zero coefficients in this matrix.
+	 */
+	size_t numNonZeros() const { return _columns.size(); }
+
+	/**
+	 * @return The number of non-zero coefficients of constraint i.
+	 */
+	size_t numNonZeros(unsigned int i) const { return _rowOffsets[i+1] - _rowOffsets[i]; }
+
+	/**
+	 * @return size()+1 offsets into getColumns() and getCoefficients(), one
+	 * for the start of each constraint and one for the end of the last.
+	 */
+	const std::vector<size_t>& getRowOffsets() const { return _rowOffsets; }
+
+	/**
+	 * @return The variable numbers of all non-zero coefficients.
+	 */
+	const std::vector<unsigned int>& getColumns() const { return _columns; }
+
+	/**
+	 * @return The values of all non-zero coefficients.
+	 */
+	const std::vector<double>& getCoefficients() const { return _coefs; }
+
+	/**
+	 * @return The relation of each constraint.
+	 */
+	const std::vector<Relation>& getRelations() const { return _relations; }
+
+	/**
+	 * @return The right hand side of each constraint.
+	 */
+	const std::vector<double>& getValues() const { return _values; }
+
+	/**
+	 * @return A view of the arrays of this matrix, valid until the matrix is
+	 * changed.
+	 */
+	LinearConstraintMatrixView view() const;
+
+	/**
+	 * Get a single constraint as a LinearConstraint.
+	 *
+	 * @param i The number of the constraint.
+	 */
+	LinearConstraint getConstraint(unsigned int i) const;
+
+	/**
+	 * Convert this matrix back into a set of linear constraints.
+	 */
+	LinearConstraints toLinearConstraints() const;
+
+	/**
+	 * Compute the left hand side of each constraint for the given solution,
+	 * i.e., the product of this matrix with the solution vector.
+	 *
+	 * @param solution
+	 *             The solution to evaluate.
+	 *
+	 * @param lhs
+	 *             Will be resized to size() and filled with the left hand
+	 *             sides.
+	 *
+	 * @param numThreads
+	 *             The number of threads to use, 0 for all hardware threads.
+	 */
+	void multiply(
+			const Solution&      solution,
+			std::vector<double>& lhs,
+			unsigned int         numThreads = 0) const;
+
+	/**
+	 * Find all constraints that are violated by more than a tolerance in the
+	 * given solution. Rows are split evenly over the threads.
+	 *
+	 * @param solution
+	 *             The solution to check.
+	 *
+	 * @param tolerance
+	 *             The amount by which a constraint can be violated before it
+	 *             is reported.
+	 *
+	 * @param numThreads
+	 *             The number of threads to use, 0 for all hardware threads.
+	 *
+	 * @return The violated constraints, ordered by their number.
+	 */
+	std::vector<ConstraintViolation> findViolated(
+			const Solution& solution,
+			double          tolerance = 0,
+			unsigned int    numThreads = 0) const;
+
+private:
+
+	// the left hand side of constraint i
+	inline double lhs(size_t i, const double* x) const;
+
+	std::vector<size_t>       _rowOffsets;
+
+	std::vector<unsigned int> _columns;
+
+	std::vector<double>       _coefs;
+
+	std::vector<Relation>     _relations;
+
+	std::vector<double>       _values;
+};
+
+#endif // INFERENCE_LINEAR_CONSTRAINT_MATRIX_H__
+
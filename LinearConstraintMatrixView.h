@@ -0,0 +1,43 @@
+#ifndef INFERENCE_LINEAR_CONSTRAINT_MATRIX_VIEW_H__
+#define INFERENCE_LINEAR_CONSTRAINT_MATRIX_VIEW_H__
+
+#include <cstddef>
+
+#include "Relation.h"
+
+/**
+ * A read-only view of the arrays of a constraint matrix in compressed sparse
+ * row format, see LinearConstraintMatrix. The view does not own the arrays,
+ * which can belong to a LinearConstraintMatrix or to a memory-mapped file,
+ * see MappedModel.
+ */
+struct LinearConstraintMatrixView {
+
+	LinearConstraintMatrixView() :
+		numRows(0),
+		numNonZeros(0),
+		rowOffsets(0),
+		columns(0),
+		coefficients(0),
+		relations(0),
+		values(0) {}
+
+	unsigned int size() const { return numRows; }
+
+	unsigned int numRows;
+	size_t       numNonZeros;
+
+	// numRows+1 offsets into columns and coefficients
+	const size_t*       rowOffsets;
+
+	// numNonZeros variable numbers and coefficients
+	const unsigned int* columns;
+	const double*       coefficients;
+
+	// numRows relations and right hand sides
+	const Relation*     relations;
+	const double*       values;
+};
+
+#endif // INFERENCE_LINEAR_CONSTRAINT_MATRIX_VIEW_H__
+
@@ -1,30 +1,67 @@
+#include <algorithm>
+
 #include "LinearConstraints.h"
+#include "Parallel.h"
 
-LinearConstraints::LinearConstraints(size_t size) {
+LinearConstraints::LinearConstraints(size_t size) :
+	_indexVariables(false) {
 
 	_linearConstraints.resize(size);
 }
 
+void
+LinearConstraints::clear() {
+
+	_linearConstraints.clear();
+	_variableIndex.clear();
+}
+
 void
 LinearConstraints::add(const LinearConstraint& linearConstraint) {
 
 	_linearConstraints.push_back(linearConstraint);
+
+	if (_indexVariables)
+		indexConstraint(_linearConstraints.size() - 1);
 }
 
 void
 LinearConstraints::addAll(const LinearConstraints& linearConstraints) {
 
+	unsigned int first = _linearConstraints.size();
+
 	_linearConstraints.insert(_linearConstraints.end(), linearConstraints.begin(), linearConstraints.end());
+
+	if (_indexVariables)
+		for (unsigned int i = first; i < _linearConstraints.size(); i++)
+			indexConstraint(i);
 }
 
 std::vector<unsigned int>
-LinearConstraints::getConstraints(const std::vector<unsigned int>& variableIds) {
+LinearConstraints::getConstraints(const std::vector<unsigned int>& variableIds) const {
 
 	std::vector<unsigned int> indices;
 
+	if (_indexVariables) {
+
+		for (unsigned int v : variableIds)
+			if (v < _variableIndex.size())
+				indices.insert(indices.end(), _variableIndex[v].begin(), _variableIndex[v].end());
+
+		// constraints using more than one of the variables are listed several
+		// times
+		if (variableIds.size() > 1) {
+
+			std::sort(indices.begin(), indices.end());
+			indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+		}
+
+		return indices;
+	}
+
 	for (unsigned int i = 0; i < size(); i++) {
 
-		LinearConstraint& constraint = _linearConstraints[i];
+		const LinearConstraint& constraint = _linearConstraints[i];
 
 		for (unsigned int v : variableIds) {
 
@@ -38,3 +75,67 @@ LinearConstraints::getConstraints(const std::vector<unsigned int>& variableIds)
 
 	return indices;
 }
+
+void
+LinearConstraints::enableVariableIndex() {
+
+	_indexVariables = true;
+	_variableIndex.clear();
+
+	for (unsigned int i = 0; i < size(); i++)
+		indexConstraint(i);
+}
+
+void
+LinearConstraints::disableVariableIndex() {
+
+	_indexVariables = false;
+	std::vector<std::vector<unsigned int>>().swap(_variableIndex);
+}
+
+void
+LinearConstraints::indexConstraint(unsigned int i) {
+
+	const std::map<unsigned int, double>& coefs = _linearConstraints[i].getCoefficients();
+
+	if (coefs.empty())
+		return;
+
+	// coefficients are ordered by variable number
+	unsigned int maxVariable = coefs.rbegin()->first;
+	if (maxVariable >= _variableIndex.size())
+		_variableIndex.resize(maxVariable + 1);
+
+	for (auto& pair : coefs)
+		_variableIndex[pair.first].push_back(i);
+}
+
+std::vector<ConstraintViolation>
+LinearConstraints::findViolated(
+		const Solution& solution,
+		double          tolerance,
+		unsigned int    numThreads) const {
+
+	std::vector<std::vector<ConstraintViolation>> violations(numLoopThreads(numThreads, size(), RowsPerThread));
+
+	parallelForChunks(size(), numThreads, RowsPerThread, [&](unsigned int thread, size_t begin, size_t end) {
+
+		for (size_t i = begin; i < end; i++) {
+
+			const LinearConstraint& constraint = _linearConstraints[i];
+
+			double lhs = 0;
+			for (auto& pair : constraint.getCoefficients())
+				lhs += pair.second*solution[pair.first];
+
+			double amount = LinearConstraint::violation(lhs, constraint.getRelation(), constraint.getValue());
+			if (amount > tolerance)
+				violations[thread].push_back(ConstraintViolation{static_cast<unsigned int>(i), amount});
+		}
+	});
+
+	for (unsigned int t = 1; t < violations.size(); t++)
+		violations[0].insert(violations[0].end(), violations[t].begin(), violations[t].end());
+
+	return violations[0];
+}
@@ -3,6 +3,18 @@
 
 #include "LinearConstraint.h"
 
+/**
+ * A violated linear constraint, as reported by findViolated().
+ */
+struct ConstraintViolation {
+
+	// the number of the violated constraint
+	unsigned int constraint;
+
+	// the amount by which the constraint is violated
+	double amount;
+};
+
 class LinearConstraints {
 
 	typedef std::vector<LinearConstraint> linear_constraints_type;
@@ -26,7 +38,7 @@ public:
 	/**
 	 * Remove all constraints from this set of linear constraints.
 	 */
-	void clear() { _linearConstraints.clear(); }
+	void clear();
 
 	/**
 	 * Add a linear constraint.
@@ -61,13 +73,62 @@ public:
 
 	/**
 	 * Get a linst of indices of linear constraints that use the given 
-	 * variables.
+	 * variables. If the variable index is enabled, this takes time
+	 * proportional to the size of the result. Otherwise, all constraints are
+	 * scanned.
+	 */
+	std::vector<unsigned int> getConstraints(const std::vector<unsigned int>& variableIds) const;
+
+	/**
+	 * Build an index from variables to the constraints that use them, and
+	 * keep it up-to-date in subsequent calls to add() and addAll(). Changes to
+	 * constraints through operator[] or iterators are not tracked, call this
+	 * method again after such changes to rebuild the index.
+	 */
+	void enableVariableIndex();
+
+	/**
+	 * Remove the variable index and free its memory.
 	 */
-	std::vector<unsigned int> getConstraints(const std::vector<unsigned int>& variableIds);
+	void disableVariableIndex();
+
+	/**
+	 * @return true, if the variable index is enabled.
+	 */
+	bool hasVariableIndex() const { return _indexVariables; }
+
+	/**
+	 * Find all constraints that are violated by more than a tolerance in the
+	 * given solution. Constraints are checked in parallel.
+	 *
+	 * @param solution
+	 *             The solution to check.
+	 *
+	 * @param tolerance
+	 *             The amount by which a constraint can be violated before it
+	 *             is reported.
+	 *
+	 * @param numThreads
+	 *             The number of threads to use, 0 for all hardware threads.
+	 *
+	 * @return The violated constraints, ordered by their number.
+	 */
+	std::vector<ConstraintViolation> findViolated(
+			const Solution& solution,
+			double          tolerance = 0,
+			unsigned int    numThreads = 0) const;
 
 private:
 
 	linear_constraints_type _linearConstraints;
+
+	// add constraint i to the variable index
+	void indexConstraint(unsigned int i);
+
+	// for each variable, the numbers of the constraints that use it
+	std::vector<std::vector<unsigned int>> _variableIndex;
+
+	bool _indexVariables;
 };
 
 #endif // INFERENCE_LINEAR_CONSTRAINTS_H__
@@ -12,6 +12,8 @@ public:
 private:
 
 	using QuadraticObjective::setQuadraticCoefficient;
+
+	using QuadraticObjective::addQuadraticTerms;
 };
 
 #endif // INFERENCE_OBJECTIVE_H__
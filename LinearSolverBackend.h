@@ -1,9 +1,19 @@
 #ifndef INFERENCE_LINEAR_SOLVER_BACKEND_H__
 #define INFERENCE_LINEAR_SOLVER_BACKEND_H__
 
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+
 #include <util/exceptions.h>
 #include "LinearObjective.h"
 #include "LinearConstraints.h"
+#include "LinearConstraintMatrix.h"
 #include "Solution.h"
 #include "VariableType.h"
 
@@ -11,6 +21,65 @@ class LinearSolverBackend {
 
 public:
 
+	/**
+	 * A callback to find lazy constraints. Adds the constraints that are
+	 * violated by the given candidate solution to the given set.
+	 */
+	typedef std::function<void(const Solution& candidate, LinearConstraints& violated)> Separator;
+
+	/**
+	 * The state of a running solve, see setProgressCallback().
+	 */
+	struct Progress {
+
+		Progress(double incumbent_, double bound_, double time_) :
+			incumbent(incumbent_),
+			bound(bound_),
+			time(time_) {
+
+			double difference = std::fabs(incumbent - bound);
+
+			if (std::isinf(incumbent) || std::isinf(bound))
+				gap = std::numeric_limits<double>::infinity();
+			else if (difference == 0)
+				gap = 0;
+			else
+				gap = difference/std::fabs(incumbent);
+		}
+
+		// the objective value of the best solution found so far, infinite if
+		// there is none yet
+		double incumbent;
+
+		// the best known bound on the optimal objective value
+		double bound;
+
+		// the relative gap |incumbent - bound|/|incumbent|
+		double gap;
+
+		// wall-clock seconds since the start of the solve
+		double time;
+	};
+
+	typedef std::function<void(const Progress& progress)> ProgressCallback;
+
+	/**
+	 * The result of solveAsync().
+	 */
+	struct Result {
+
+		Solution solution;
+
+		std::string message;
+
+		// the return value of solve()
+		bool solved;
+	};
+
+	LinearSolverBackend() :
+		_solving(false),
+		_interruptRequested(false) {}
+
 	virtual ~LinearSolverBackend() {}
 
 	/**
@@ -57,6 +126,24 @@ public:
 	 */
 	virtual void setConstraints(const LinearConstraints& constraints) = 0;
 
+	/**
+	 * Set the linear (in)equality constraints from a constraint matrix in
+	 * compressed sparse row format.
+	 *
+	 * @param constraints A constraint matrix.
+	 */
+	virtual void setConstraints(const LinearConstraintMatrix& constraints) = 0;
+
+	/**
+	 * Set the linear (in)equality constraints from a view of a constraint
+	 * matrix, e.g., of a memory-mapped model, see MappedModel. The default
+	 * copies the arrays into a LinearConstraintMatrix, backends that can read
+	 * them directly override this.
+	 *
+	 * @param constraints A view of a constraint matrix.
+	 */
+	virtual void setConstraints(const LinearConstraintMatrixView& constraints) { setConstraints(LinearConstraintMatrix(constraints)); }
+
 	/**
 	 * Add a single constraint.
 	 *
@@ -64,6 +151,115 @@ public:
 	 */
 	virtual void addConstraint(const LinearConstraint& constraint) = 0;
 
+	/**
+	 * Change the coefficient of a single variable in the objective, without
+	 * setting the whole objective again.
+	 *
+	 * @param varNum The variable to change the coefficient for.
+	 * @param coef The new coefficient.
+	 */
+	virtual void setObjectiveCoefficient(unsigned int varNum, double coef) = 0;
+
+	/**
+	 * Change the bounds of a variable. Use infinite values for unbounded
+	 * variables.
+	 *
+	 * @param varNum The variable to change the bounds for.
+	 * @param lower The new lower bound.
+	 * @param upper The new upper bound.
+	 */
+	virtual void setVariableBounds(unsigned int varNum, double lower, double upper) = 0;
+
+	/**
+	 * Change the right hand side of a single constraint, without setting all
+	 * constraints again.
+	 *
+	 * Constraints are numbered in the order they were given to
+	 * setConstraints() and addConstraint(), starting from 0 with the last
+	 * call to setConstraints(). Numbers stay valid when other constraints are
+	 * removed.
+	 *
+	 * @param constraint The number of the constraint.
+	 * @param value The new right hand side.
+	 */
+	virtual void setConstraintValue(unsigned int constraint, double value) = 0;
+
+	/**
+	 * Remove constraints from the problem, without setting all constraints
+	 * again. See setConstraintValue() for the numbering of constraints.
+	 *
+	 * @param constraints The numbers of the constraints to remove.
+	 */
+	virtual void removeConstraints(const std::vector<unsigned int>& constraints) = 0;
+
+	/**
+	 * Set a start solution for the next call to solve(). Mixed integer
+	 * solvers use a feasible start as the first incumbent, which allows them
+	 * to prune the search from the beginning. Starts that turn out to be
+	 * infeasible are discarded by the solver.
+	 *
+	 * @param solution
+	 *             A value for each variable, e.g., the solution of a previous
+	 *             solve of a similar problem.
+	 */
+	virtual void setStartSolution(const Solution& solution) = 0;
+
+	/**
+	 * Set a partial start solution for the next call to solve(). The solver
+	 * tries to complete the given values to a feasible solution and uses it
+	 * as the first incumbent. Throws a UsageError for variables that do not
+	 * exist.
+	 *
+	 * @param values
+	 *             A map of variable numbers to their start values.
+	 */
+	virtual void setStartSolution(const std::map<unsigned int, double>& values) = 0;
+
+	/**
+	 * Set a separator for lazy constraints, i.e., constraints that belong to
+	 * the problem, but are too many to be set explicitly. During the solve,
+	 * the separator is called with every candidate solution that satisfies
+	 * all other constraints, including integrality. The violated constraints
+	 * it returns are added to the problem without restarting the search, a
+	 * candidate is accepted only if none are returned. Calls to the separator
+	 * are serialized.
+	 *
+	 * Lazy constraints found during a solve are not numbered and can not be
+	 * changed or removed.
+	 *
+	 * @param separator
+	 *             The separator, or an empty one to solve without lazy
+	 *             constraints.
+	 */
+	virtual void setSeparator(const Separator& separator) = 0;
+
+	/**
+	 * Set a pool of lazy constraints, see setSeparator(). Constraints of the
+	 * pool are added to the problem when a candidate solution violates them.
+	 *
+	 * @param pool
+	 *             The lazy constraints.
+	 *
+	 * @param numThreads
+	 *             The number of threads to check the pool with, 0 for all
+	 *             hardware threads.
+	 */
+	void setLazyConstraints(const LinearConstraintMatrix& pool, unsigned int numThreads = 0) {
+
+		std::shared_ptr<LinearConstraintMatrix> constraints = std::make_shared<LinearConstraintMatrix>(pool);
+
+		setSeparator([constraints, numThreads](const Solution& candidate, LinearConstraints& violated) {
+
+			for (const ConstraintViolation& v : constraints->findViolated(candidate, 1e-6, numThreads))
+				violated.add(constraints->getConstraint(v.constraint));
+		});
+	}
+
+	void setLazyConstraints(const LinearConstraints& pool, unsigned int numThreads = 0) {
+
+		setLazyConstraints(LinearConstraintMatrix(pool), numThreads);
+	}
+
 	/**
 	 * Set a timeout in seconds for subsequent solve calls.
 	 */
@@ -101,6 +297,38 @@ public:
 	 */
         virtual void setVerbose(bool verbose) = 0;
 
+	/**
+	 * Stop a call to solve() that is running on another thread, or that was
+	 * started by solveAsync(), as soon as possible. The interrupted solve()
+	 * returns as after a timeout, i.e., with the best solution found so far,
+	 * if any. An interrupt that arrives before the solver started is kept
+	 * until solve() returns. Has no effect if solve() is not running.
+	 */
+	void interrupt() {
+
+		std::lock_guard<std::mutex> lock(_solveMutex);
+
+		if (!_solving)
+			return;
+
+		_interruptRequested = true;
+		interruptSolver();
+	}
+
+	/**
+	 * Set a callback to be informed about the progress of subsequent calls to
+	 * solve(), e.g., to display it or to interrupt() a solve whose gap is
+	 * small enough. Mixed integer solvers call it when they find a better
+	 * solution and periodically in between, continuous solvers once with the
+	 * optimal solution.
+	 * The callback is called from the threads of the solver, calls are
+	 * serialized.
+	 *
+	 * @param callback
+	 *             The callback, or an empty one to not report progress.
+	 */
+	virtual void setProgressCallback(const ProgressCallback& callback) = 0;
+
 	/**
 	 * Solve the problem.
 	 *
@@ -110,6 +338,110 @@ public:
 	 * @return true, if the optimal value was found.
 	 */
 	virtual bool solve(Solution& solution, std::string& message) = 0;
+
+	/**
+	 * Solve the problem on another thread. No other method must be called
+	 * until the returned future is ready, except interrupt(), which stops the
+	 * solve early.
+	 */
+	std::future<Result> solveAsync() {
+
+		// the solve counts as running from now on, such that interrupts that
+		// arrive before the thread started are not lost
+		beginSolve();
+
+		try {
+
+			return std::async(std::launch::async, [this]() {
+
+				SolveScope scope(*this, true);
+
+				Result result;
+				result.solved = solve(result.solution, result.message);
+				return result;
+			});
+
+		} catch (...) {
+
+			endSolve();
+			throw;
+		}
+	}
+
+protected:
+
+	/**
+	 * Marks a call to solve(). Implementations of solve() create one before
+	 * they set up the solver, interrupt() has no effect outside of it.
+	 */
+	class SolveScope {
+
+	public:
+
+		SolveScope(LinearSolverBackend& backend, bool started = false) :
+			_backend(backend),
+			_outermost(started || backend.beginSolve()) {}
+
+		~SolveScope() { if (_outermost) _backend.endSolve(); }
+
+	private:
+
+		LinearSolverBackend& _backend;
+
+		// false for a solve() called by solveAsync(), which ends the solve
+		bool _outermost;
+	};
+
+	/**
+	 * Forward an interrupt() to the solver. Called only between the start
+	 * and the end of a SolveScope, possibly before the solver started.
+	 * Therefore, implementations have to check interruptRequested() once
+	 * their solver is running, e.g., from a callback.
+	 */
+	virtual void interruptSolver() = 0;
+
+	/**
+	 * @return True if the current solve was interrupted.
+	 */
+	bool interruptRequested() const { return _interruptRequested; }
+
+	/**
+	 * @return The flag behind interruptRequested(), for solvers that poll it.
+	 */
+	const std::atomic<bool>* getInterruptFlag() const { return &_interruptRequested; }
+
+private:
+
+	// start a solve and reset the interrupt, returns false if a solve was
+	// already started
+	bool beginSolve() {
+
+		std::lock_guard<std::mutex> lock(_solveMutex);
+
+		if (_solving)
+			return false;
+
+		_solving = true;
+		_interruptRequested = false;
+
+		return true;
+	}
+
+	// end a solve and drop its interrupt
+	void endSolve() {
+
+		std::lock_guard<std::mutex> lock(_solveMutex);
+
+		_solving = false;
+		_interruptRequested = false;
+	}
+
+	// protects the start and end of solves against interrupts
+	std::mutex _solveMutex;
+
+	bool _solving;
+
+	std::atomic<bool> _interruptRequested;
 };
 
 class LinearSolverBackendException : public Exception {};
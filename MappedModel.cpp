@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <util/Logger.h>
+#include "LinearObjective.h"
+#include "MappedModel.h"
+
+using namespace logger;
+
+LogChannel mappedmodellog("mappedmodellog", "[MappedModel] ");
+
+static const char Magic[8] = { 'S', 'L', 'V', 'M', 'O', 'D', 'E', 'L' };
+
+// written in the byte order of the writer, to detect a different one
+static const uint32_t ByteOrderMarker = 0x01020304;
+
+// the sections of the file, in this order
+enum Section {
+
+	VariableTypes,
+	Coefficients,
+	QuadraticRows,
+	QuadraticColumns,
+	QuadraticValues,
+	RowOffsets,
+	Columns,
+	ConstraintCoefficients,
+	Relations,
+	Values,
+	NumSections
+};
+
+struct Header {
+
+	char     magic[8];
+	uint32_t version;
+	uint32_t byteOrder;
+	int32_t  sense;
+	uint32_t reserved;
+	uint64_t numVariables;
+	uint64_t numQuadraticTerms;
+	uint64_t numConstraints;
+	uint64_t numNonZeros;
+	double   constant;
+
+	// the byte offsets of the sections from the start of the file
+	uint64_t offsets[NumSections];
+};
+
+// the arrays are mapped as the types used by the solvers, which have to have
+// the same size as the types in the file
+static_assert(sizeof(double) == 8, "doubles have to be 64 bit");
+static_assert(sizeof(unsigned int) == sizeof(uint32_t), "unsigned ints have to be 32 bit");
+static_assert(sizeof(VariableType) == sizeof(int32_t), "variable types have to be 32 bit");
+static_assert(sizeof(Relation) == sizeof(int32_t), "relations have to be 32 bit");
+
+// sections start at multiples of this
+static const size_t Alignment = 8;
+
+static size_t
+align(size_t offset) {
+
+	return (offset + Alignment - 1)/Alignment*Alignment;
+}
+
+// the size in bytes of each section
+static void
+sectionSizes(const Header& header, uint64_t* sizes) {
+
+	sizes[VariableTypes]          = header.numVariables*sizeof(int32_t);
+	sizes[Coefficients]           = header.numVariables*sizeof(double);
+	sizes[QuadraticRows]          = header.numQuadraticTerms*sizeof(uint32_t);
+	sizes[QuadraticColumns]       = header.numQuadraticTerms*sizeof(uint32_t);
+	sizes[QuadraticValues]        = header.numQuadraticTerms*sizeof(double);
+	sizes[RowOffsets]             = (header.numConstraints + 1)*sizeof(uint64_t);
+	sizes[Columns]                = header.numNonZeros*sizeof(uint32_t);
+	sizes[ConstraintCoefficients] = header.numNonZeros*sizeof(double);
+	sizes[Relations]              = header.numConstraints*sizeof(int32_t);
+	sizes[Values]                 = header.numConstraints*sizeof(double);
+}
+
+// check the contents of the sections of a mapped file in one pass, returns
+// an error message or an empty string
+static std::string
+checkSections(const char* data, const Header& header) {
+
+	const int32_t*  types      = reinterpret_cast<const int32_t*>(data + header.offsets[VariableTypes]);
+	const uint32_t* qRows      = reinterpret_cast<const uint32_t*>(data + header.offsets[QuadraticRows]);
+	const uint32_t* qCols      = reinterpret_cast<const uint32_t*>(data + header.offsets[QuadraticColumns]);
+	const uint64_t* rowOffsets = reinterpret_cast<const uint64_t*>(data + header.offsets[RowOffsets]);
+	const uint32_t* columns    = reinterpret_cast<const uint32_t*>(data + header.offsets[Columns]);
+	const int32_t*  relations  = reinterpret_cast<const int32_t*>(data + header.offsets[Relations]);
+
+	uint64_t n = header.numVariables;
+
+	for (uint64_t i = 0; i < n; i++)
+		if (types[i] < Continuous || types[i] > Binary)
+			return "has an invalid type for variable " + std::to_string(i);
+
+	// sorted upper triangular triplets
+	for (uint64_t k = 0; k < header.numQuadraticTerms; k++) {
+
+		if (qRows[k] >= n || qCols[k] >= n || qRows[k] > qCols[k])
+			return "has an invalid quadratic term " + std::to_string(k);
+
+		if (k > 0 && (qRows[k] < qRows[k-1] || (qRows[k] == qRows[k-1] && qCols[k] <= qCols[k-1])))
+			return "has unsorted quadratic terms";
+	}
+
+	if (rowOffsets[0] != 0 || rowOffsets[header.numConstraints] != header.numNonZeros)
+		return "has inconsistent constraint offsets";
+
+	for (uint64_t r = 0; r < header.numConstraints; r++) {
+
+		if (rowOffsets[r + 1] < rowOffsets[r])
+			return "has inconsistent constraint offsets";
+
+		if (relations[r] < LessEqual || relations[r] > GreaterEqual)
+			return "has an invalid relation for constraint " + std::to_string(r);
+	}
+
+	for (uint64_t k = 0; k < header.numNonZeros; k++)
+		if (columns[k] >= n)
+			return "has an invalid variable in constraint coefficient " + std::to_string(k);
+
+	return "";
+}
+
+template <typename T>
+static void
+writeSection(std::ofstream& out, const T* data, size_t size, uint64_t offset) {
+
+	// pad up to the start of the section
+	static const char zeros[Alignment] = {};
+	out.write(zeros, offset - out.tellp());
+
+	out.write(reinterpret_cast<const char*>(data), size*sizeof(T));
+}
+
+void
+MappedModel::write(
+		const std::string&                          filename,
+		unsigned int                                numVariables,
+		VariableType                                defaultVariableType,
+		const std::map<unsigned int, VariableType>& specialVariableTypes,
+		const QuadraticObjective&                   objective,
+		const LinearConstraintMatrix&               constraints) {
+
+	if (objective.size() != numVariables)
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"objective has " << objective.size() << " coefficients, expected " << numVariables);
+
+	std::vector<VariableType> types(numVariables, defaultVariableType);
+	for (auto& p : specialVariableTypes)
+		if (p.first < numVariables)
+			types[p.first] = p.second;
+
+	std::vector<uint64_t> rowOffsets(constraints.getRowOffsets().begin(), constraints.getRowOffsets().end());
+
+	Header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, Magic, sizeof(Magic));
+	header.version           = Version;
+	header.byteOrder         = ByteOrderMarker;
+	header.sense             = objective.getSense();
+	header.numVariables      = numVariables;
+	header.numQuadraticTerms = objective.numQuadraticTerms();
+	header.numConstraints    = constraints.size();
+	header.numNonZeros       = constraints.numNonZeros();
+	header.constant          = objective.getConstant();
+
+	uint64_t sizes[NumSections];
+	sectionSizes(header, sizes);
+
+	uint64_t offset = align(sizeof(Header));
+	for (int s = 0; s < NumSections; s++) {
+
+		header.offsets[s] = offset;
+		offset = align(offset + sizes[s]);
+	}
+
+	std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+	if (!out)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"can not open " << filename << " for writing");
+
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	writeSection(out, types.data(),                              numVariables,                  header.offsets[VariableTypes]);
+	writeSection(out, objective.getCoefficients().data(),        numVariables,                  header.offsets[Coefficients]);
+	writeSection(out, objective.getQuadraticRows().data(),       header.numQuadraticTerms,      header.offsets[QuadraticRows]);
+	writeSection(out, objective.getQuadraticColumns().data(),    header.numQuadraticTerms,      header.offsets[QuadraticColumns]);
+	writeSection(out, objective.getQuadraticValues().data(),     header.numQuadraticTerms,      header.offsets[QuadraticValues]);
+	writeSection(out, rowOffsets.data(),                         rowOffsets.size(),             header.offsets[RowOffsets]);
+	writeSection(out, constraints.getColumns().data(),           constraints.numNonZeros(),     header.offsets[Columns]);
+	writeSection(out, constraints.getCoefficients().data(),      constraints.numNonZeros(),     header.offsets[ConstraintCoefficients]);
+	writeSection(out, constraints.getRelations().data(),         constraints.size(),            header.offsets[Relations]);
+	writeSection(out, constraints.getValues().data(),            constraints.size(),            header.offsets[Values]);
+
+	if (!out)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"could not write " << filename);
+
+	LOG_DEBUG(mappedmodellog)
+			<< "wrote " << numVariables << " variables and "
+			<< constraints.size() << " constraints to " << filename << std::endl;
+}
+
+MappedModel::MappedModel(const std::string& filename) :
+	_data(0),
+	_size(0) {
+
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"can not open " << filename << ": " << std::strerror(errno));
+
+	struct stat status;
+	if (fstat(fd, &status) != 0) {
+
+		close(fd);
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"can not stat " << filename << ": " << std::strerror(errno));
+	}
+
+	_size = status.st_size;
+
+	if (_size < sizeof(Header)) {
+
+		close(fd);
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				filename << " is not a model file");
+	}
+
+	_data = mmap(0, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+	int mapError = errno;
+
+	// the mapping keeps its own reference to the file
+	close(fd);
+
+	if (_data == MAP_FAILED) {
+
+		_data = 0;
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"can not map " << filename << ": " << std::strerror(mapError));
+	}
+
+	const char*   data   = static_cast<const char*>(_data);
+	const Header& header = *reinterpret_cast<const Header*>(data);
+
+	std::string error;
+
+	if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+		error = "is not a model file";
+	else if (header.byteOrder != ByteOrderMarker)
+		error = "was written on a machine with a different byte order";
+	else if (header.version != Version)
+		error = "has unsupported version " + std::to_string(header.version);
+	else if (header.numVariables > std::numeric_limits<unsigned int>::max() ||
+	         header.numConstraints > std::numeric_limits<unsigned int>::max())
+		error = "has too many variables or constraints";
+	else if (header.numQuadraticTerms > _size || header.numNonZeros > _size)
+		error = "is truncated or corrupt";
+
+	// every section has to be aligned and inside the file
+	uint64_t sizes[NumSections];
+	sectionSizes(header, sizes);
+	for (int s = 0; s < NumSections && error.empty(); s++)
+		if (header.offsets[s] % Alignment != 0 ||
+		    header.offsets[s] > _size ||
+		    sizes[s] > _size - header.offsets[s])
+			error = "is truncated or corrupt";
+
+	// the contents have to be valid, such that the arrays can be used
+	// without further checks
+	if (error.empty())
+		error = checkSections(data, header);
+
+	if (!error.empty()) {
+
+		munmap(_data, _size);
+		_data = 0;
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				filename << " " << error);
+	}
+
+	_numVariables      = header.numVariables;
+	_numQuadraticTerms = header.numQuadraticTerms;
+	_sense             = (header.sense == Maximize ? Maximize : Minimize);
+	_constant          = header.constant;
+
+	_variableTypes    = reinterpret_cast<const VariableType*>(data + header.offsets[VariableTypes]);
+	_coefficients     = reinterpret_cast<const double*>(data + header.offsets[Coefficients]);
+	_quadraticRows    = reinterpret_cast<const unsigned int*>(data + header.offsets[QuadraticRows]);
+	_quadraticColumns = reinterpret_cast<const unsigned int*>(data + header.offsets[QuadraticColumns]);
+	_quadraticValues  = reinterpret_cast<const double*>(data + header.offsets[QuadraticValues]);
+
+	// size_t is 64 bit on all platforms we map files on, otherwise the
+	// offsets would have to be copied
+	static_assert(sizeof(size_t) == sizeof(uint64_t), "size_t has to be 64 bit");
+
+	_constraints.numRows      = header.numConstraints;
+	_constraints.numNonZeros  = header.numNonZeros;
+	_constraints.rowOffsets   = reinterpret_cast<const size_t*>(data + header.offsets[RowOffsets]);
+	_constraints.columns      = reinterpret_cast<const unsigned int*>(data + header.offsets[Columns]);
+	_constraints.coefficients = reinterpret_cast<const double*>(data + header.offsets[ConstraintCoefficients]);
+	_constraints.relations    = reinterpret_cast<const Relation*>(data + header.offsets[Relations]);
+	_constraints.values       = reinterpret_cast<const double*>(data + header.offsets[Values]);
+
+	LOG_DEBUG(mappedmodellog)
+			<< "mapped " << _numVariables << " variables and "
+			<< _constraints.numRows << " constraints from " << filename << std::endl;
+}
+
+MappedModel::~MappedModel() {
+
+	if (_data != 0)
+		munmap(_data, _size);
+}
+
+QuadraticObjective
+MappedModel::getObjective() const {
+
+	QuadraticObjective objective(_numVariables);
+	objective.setSense(_sense);
+	objective.setConstant(_constant);
+
+	for (unsigned int i = 0; i < _numVariables; i++)
+		objective.setCoefficient(i, _coefficients[i]);
+
+	if (_numQuadraticTerms > 0)
+		objective.addQuadraticTerms(
+				std::vector<unsigned int>(_quadraticRows, _quadraticRows + _numQuadraticTerms),
+				std::vector<unsigned int>(_quadraticColumns, _quadraticColumns + _numQuadraticTerms),
+				std::vector<double>(_quadraticValues, _quadraticValues + _numQuadraticTerms));
+
+	return objective;
+}
+
+void
+MappedModel::setUp(LinearSolverBackend& backend) const {
+
+	if (_numQuadraticTerms > 0)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"the objective is quadratic, use a QuadraticSolverBackend");
+
+	LinearObjective objective(_numVariables);
+	objective.setSense(_sense);
+	objective.setConstant(_constant);
+	for (unsigned int i = 0; i < _numVariables; i++)
+		objective.setCoefficient(i, _coefficients[i]);
+
+	initializeVariables(backend);
+	backend.setObjective(objective);
+	backend.setConstraints(_constraints);
+}
+
+void
+MappedModel::setUp(QuadraticSolverBackend& backend) const {
+
+	initializeVariables(backend);
+	backend.setObjective(getObjective());
+	backend.setConstraints(_constraints);
+}
+
+void
+MappedModel::initializeVariables(LinearSolverBackend& backend) const {
+
+	// use the most frequent type as the default
+	unsigned int counts[3] = { 0, 0, 0 };
+	for (unsigned int i = 0; i < _numVariables; i++)
+		counts[_variableTypes[i]]++;
+
+	VariableType defaultType = static_cast<VariableType>(std::max_element(counts, counts + 3) - counts);
+
+	std::map<unsigned int, VariableType> specialTypes;
+	for (unsigned int i = 0; i < _numVariables; i++)
+		if (_variableTypes[i] != defaultType)
+			specialTypes[i] = _variableTypes[i];
+
+	backend.initialize(_numVariables, defaultType, specialTypes);
+}
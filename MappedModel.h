@@ -0,0 +1,179 @@
+#ifndef INFERENCE_MAPPED_MODEL_H__
+#define INFERENCE_MAPPED_MODEL_H__
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include "LinearConstraintMatrix.h"
+#include "LinearConstraintMatrixView.h"
+#include "LinearConstraints.h"
+#include "LinearSolverBackend.h"
+#include "QuadraticObjective.h"
+#include "QuadraticSolverBackend.h"
+#include "Sense.h"
+#include "VariableType.h"
+
+/**
+ * A whole problem in a binary file that is memory-mapped for reading, to
+ * load it without parsing or copying.
+ *
+ * The file starts with a header (magic "SLVMODEL", format version, byte
+ * order marker, sizes, sense, and constant of the objective), followed by
+ * one 8-byte aligned section for each of the arrays:
+ *
+ *   variable types            int32  x numVariables
+ *   linear objective          double x numVariables
+ *   quadratic rows            uint32 x numQuadraticTerms
+ *   quadratic columns         uint32 x numQuadraticTerms
+ *   quadratic values          double x numQuadraticTerms
+ *   constraint row offsets    uint64 x (numConstraints + 1)
+ *   constraint columns        uint32 x numNonZeros
+ *   constraint coefficients   double x numNonZeros
+ *   constraint relations      int32  x numConstraints
+ *   constraint values         double x numConstraints
+ *
+ * The arrays are written in the byte order of the writing machine, which
+ * has to match the one of the reading machine. The accessors of a mapped
+ * model point directly into the mapped file:
+ *
+ *   MappedModel::write("problem.model", n, Binary, types, objective, constraints);
+ *
+ *   MappedModel model("problem.model");
+ *   model.setUp(*backend);
+ *   backend->solve(solution, message);
+ */
+class MappedModel {
+
+public:
+
+	/**
+	 * The version of the format written by write().
+	 */
+	static const unsigned int Version = 1;
+
+	/**
+	 * Write a problem to a file.
+	 *
+	 * @param filename
+	 *             The file to write.
+	 *
+	 * @param numVariables
+	 *             The number of variables in the problem.
+	 *
+	 * @param defaultVariableType
+	 *             The default type of the variables.
+	 *
+	 * @param specialVariableTypes
+	 *             A map of variable numbers to variable types to override the
+	 *             default.
+	 *
+	 * @param objective
+	 *             The objective, linear or quadratic.
+	 *
+	 * @param constraints
+	 *             The linear constraints.
+	 */
+	static void write(
+			const std::string&                          filename,
+			unsigned int                                numVariables,
+			VariableType                                defaultVariableType,
+			const std::map<unsigned int, VariableType>& specialVariableTypes,
+			const QuadraticObjective&                   objective,
+			const LinearConstraintMatrix&               constraints);
+
+	static void write(
+			const std::string&                          filename,
+			unsigned int                                numVariables,
+			VariableType                                defaultVariableType,
+			const std::map<unsigned int, VariableType>& specialVariableTypes,
+			const QuadraticObjective&                   objective,
+			const LinearConstraints&                    constraints) {
+
+		write(filename, numVariables, defaultVariableType, specialVariableTypes, objective, LinearConstraintMatrix(constraints));
+	}
+
+	/**
+	 * Map a file written by write(). Throws an IOError if the file can not be
+	 * mapped or is not a valid model file of this version. The contents are
+	 * checked once, in time linear in the size of the file.
+	 */
+	explicit MappedModel(const std::string& filename);
+
+	~MappedModel();
+
+	MappedModel(const MappedModel&) = delete;
+	MappedModel& operator=(const MappedModel&) = delete;
+
+	unsigned int getNumVariables() const { return _numVariables; }
+
+	/**
+	 * @return The type of each variable.
+	 */
+	const VariableType* getVariableTypes() const { return _variableTypes; }
+
+	Sense getSense() const { return _sense; }
+
+	double getConstant() const { return _constant; }
+
+	/**
+	 * @return The linear coefficient of each variable in the objective.
+	 */
+	const double* getCoefficients() const { return _coefficients; }
+
+	/**
+	 * The quadratic terms of the objective, as sorted upper triangular
+	 * triplets, see QuadraticObjective::getQuadraticRows().
+	 */
+	size_t numQuadraticTerms() const { return _numQuadraticTerms; }
+	const unsigned int* getQuadraticRows() const { return _quadraticRows; }
+	const unsigned int* getQuadraticColumns() const { return _quadraticColumns; }
+	const double* getQuadraticValues() const { return _quadraticValues; }
+
+	/**
+	 * @return A view of the constraints in the mapped file, valid as long as
+	 * this model exists.
+	 */
+	const LinearConstraintMatrixView& getConstraints() const { return _constraints; }
+
+	/**
+	 * @return A copy of the objective.
+	 */
+	QuadraticObjective getObjective() const;
+
+	/**
+	 * Initialize a backend with the mapped problem. The constraints are
+	 * passed to the backend as a view of the mapped file. Throws a
+	 * UsageError if the objective has quadratic terms.
+	 */
+	void setUp(LinearSolverBackend& backend) const;
+
+	/**
+	 * Initialize a quadratic backend with the mapped problem.
+	 */
+	void setUp(QuadraticSolverBackend& backend) const;
+
+private:
+
+	// initialize a backend with the types of the variables
+	void initializeVariables(LinearSolverBackend& backend) const;
+
+	void*  _data;
+	size_t _size;
+
+	unsigned int _numVariables;
+	size_t       _numQuadraticTerms;
+	Sense        _sense;
+	double       _constant;
+
+	const VariableType* _variableTypes;
+	const double*       _coefficients;
+	const unsigned int* _quadraticRows;
+	const unsigned int* _quadraticColumns;
+	const double*       _quadraticValues;
+
+	LinearConstraintMatrixView _constraints;
+};
+
+#endif // INFERENCE_MAPPED_MODEL_H__
+
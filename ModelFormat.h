@@ -0,0 +1,45 @@
+#ifndef INFERENCE_MODEL_FORMAT_H__
+#define INFERENCE_MODEL_FORMAT_H__
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+#include <util/exceptions.h>
+
+/**
+ * Text formats for models, see ModelReader and ModelWriter.
+ */
+enum ModelFormat {
+
+	// free MPS, fields separated by whitespace
+	Mps,
+
+	// CPLEX LP
+	Lp
+};
+
+/**
+ * Get the format of a model file from its extension, ".mps" or ".lp" in any
+ * case.
+ */
+inline ModelFormat
+modelFormatFromFilename(const std::string& filename) {
+
+	std::string::size_type dot = filename.rfind('.');
+
+	std::string extension = (dot == std::string::npos ? "" : filename.substr(dot + 1));
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+	if (extension == "mps")
+		return Mps;
+	if (extension == "lp")
+		return Lp;
+
+	UTIL_THROW_EXCEPTION(
+			UsageError,
+			"can not tell the format of " << filename << " from its extension, expected .mps or .lp");
+}
+
+#endif // INFERENCE_MODEL_FORMAT_H__
+
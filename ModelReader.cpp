@@ -0,0 +1,1345 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include <boost/timer/timer.hpp>
+#include <boost/chrono.hpp>
+
+#include <util/Logger.h>
+#include "LinearObjective.h"
+#include "ModelReader.h"
+
+using namespace logger;
+
+LogChannel modelreaderlog("modelreaderlog", "[ModelReader] ");
+
+static const double Infinity = std::numeric_limits<double>::infinity();
+
+// values beyond this mean infinity in MPS and LP files
+static const double FileInfinity = 1e30;
+
+static double
+fileValue(double value) {
+
+	if (value >= FileInfinity)
+		return Infinity;
+	if (value <= -FileInfinity)
+		return -Infinity;
+	return value;
+}
+
+ModelReader::ModelReader(unsigned int numThreads, size_t chunkSize) :
+	_numThreads(numThreads),
+	_chunkSize(chunkSize),
+	_sense(Minimize),
+	_constant(0) {}
+
+void
+ModelReader::read(const std::string& filename) {
+
+	ModelFormat format = modelFormatFromFilename(filename);
+
+	std::ifstream in(filename.c_str(), std::ios::binary);
+	if (!in)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"can not open " << filename);
+
+	_filename = filename;
+
+	read(in, format);
+}
+
+void
+ModelReader::read(std::istream& in, ModelFormat format) {
+
+	boost::timer::cpu_timer timer;
+	timer.start();
+
+	if (_filename.empty())
+		_filename = "<stream>";
+
+	clear();
+
+	ModelTokenizer tokenizer(in, format, _numThreads, _chunkSize);
+
+	try {
+
+		if (format == Mps)
+			readMps(tokenizer);
+		else
+			readLp(tokenizer);
+
+	} catch (...) {
+
+		_filename.clear();
+		throw;
+	}
+
+	finishObjective();
+
+	LOG_USER(modelreaderlog)
+			<< "read " << getNumVariables() << " variables and "
+			<< _constraints.size() << " constraints from " << _filename
+			<< " in " << timer.elapsed().wall*1e-9 << "s" << std::endl;
+
+	_filename.clear();
+}
+
+void
+ModelReader::clear() {
+
+	_name.clear();
+	_variables.clear();
+	_types.clear();
+	_lower.clear();
+	_upper.clear();
+	_sense    = Minimize;
+	_constant = 0;
+	_linear.clear();
+	_quadraticRows.clear();
+	_quadraticCols.clear();
+	_quadraticValues.clear();
+	_constraintNames.clear();
+	_constraints.clear();
+	_rowColumns.clear();
+	_rowCoefs.clear();
+	_rowPositions.clear();
+}
+
+unsigned int
+ModelReader::variable(const Token& name) {
+
+	unsigned int v = _variables.find(name);
+	if (v != NameIndex::None)
+		return v;
+
+	v = _variables.add(name);
+
+	// variables are non-negative by default in both formats
+	_types.push_back(Continuous);
+	_lower.push_back(0);
+	_upper.push_back(Infinity);
+	_linear.push_back(0);
+	_rowPositions.push_back(-1);
+
+	return v;
+}
+
+unsigned int
+ModelReader::existingVariable(const Token& name, const Line& line) const {
+
+	unsigned int v = _variables.find(name);
+	if (v == NameIndex::None)
+		error(line, "unknown variable " + name.str());
+
+	return v;
+}
+
+void
+ModelReader::addCoefficient(unsigned int variable, double coef) {
+
+	if (_rowPositions[variable] >= 0) {
+
+		_rowCoefs[_rowPositions[variable]] += coef;
+		return;
+	}
+
+	_rowPositions[variable] = _rowColumns.size();
+	_rowColumns.push_back(variable);
+	_rowCoefs.push_back(coef);
+}
+
+void
+ModelReader::addRow(const std::string& name, Relation relation, double value) {
+
+	_constraints.addRow(_rowColumns.size(), _rowColumns.data(), _rowCoefs.data(), relation, value);
+	_constraintNames.push_back(name);
+
+	for (unsigned int v : _rowColumns)
+		_rowPositions[v] = -1;
+
+	_rowColumns.clear();
+	_rowCoefs.clear();
+}
+
+void
+ModelReader::finishObjective() {
+
+	_objective = QuadraticObjective(getNumVariables());
+	_objective.setSense(_sense);
+	_objective.setConstant(_constant);
+
+	for (unsigned int i = 0; i < getNumVariables(); i++)
+		_objective.setCoefficient(i, _linear[i]);
+
+	if (!_quadraticValues.empty())
+		_objective.addQuadraticTerms(_quadraticRows, _quadraticCols, _quadraticValues);
+
+	std::vector<double>().swap(_linear);
+	std::vector<unsigned int>().swap(_quadraticRows);
+	std::vector<unsigned int>().swap(_quadraticCols);
+	std::vector<double>().swap(_quadraticValues);
+}
+
+void
+ModelReader::error(const Line& line, const std::string& message) const {
+
+	UTIL_THROW_EXCEPTION(
+			IOError,
+			_filename << ":" << line.number << ": " << message);
+}
+
+const unsigned int ModelReader::NameIndex::None;
+
+void
+ModelReader::NameIndex::clear() {
+
+	_names.clear();
+	_hashes.clear();
+	_slots.clear();
+}
+
+unsigned int
+ModelReader::NameIndex::find(const Token& name) const {
+
+	if (_slots.empty())
+		return None;
+
+	size_t h    = hash(name.begin, name.length);
+	size_t mask = _slots.size() - 1;
+
+	for (size_t s = h & mask; ; s = (s + 1) & mask) {
+
+		unsigned int i = _slots[s];
+
+		if (i == None)
+			return None;
+
+		if (_hashes[i] == h &&
+		    _names[i].size() == name.length &&
+		    _names[i].compare(0, name.length, name.begin, name.length) == 0)
+			return i;
+	}
+}
+
+unsigned int
+ModelReader::NameIndex::add(const Token& name) {
+
+	// keep the table at most half full
+	if (2*(_names.size() + 1) > _slots.size())
+		grow();
+
+	unsigned int i = _names.size();
+	size_t       h = hash(name.begin, name.length);
+
+	_names.push_back(name.str());
+	_hashes.push_back(h);
+
+	size_t mask = _slots.size() - 1;
+	size_t s    = h & mask;
+	while (_slots[s] != None)
+		s = (s + 1) & mask;
+	_slots[s] = i;
+
+	return i;
+}
+
+size_t
+ModelReader::NameIndex::hash(const char* s, size_t length) {
+
+	// FNV-1a
+	uint64_t h = 14695981039346656037ull;
+	for (size_t i = 0; i < length; i++) {
+
+		h ^= static_cast<unsigned char>(s[i]);
+		h *= 1099511628211ull;
+	}
+
+	return h ^ (h >> 32);
+}
+
+void
+ModelReader::NameIndex::grow() {
+
+	_slots.assign(std::max<size_t>(64, 2*_slots.size()), None);
+
+	size_t mask = _slots.size() - 1;
+	for (unsigned int i = 0; i < _names.size(); i++) {
+
+		size_t s = _hashes[i] & mask;
+		while (_slots[s] != None)
+			s = (s + 1) & mask;
+		_slots[s] = i;
+	}
+}
+
+////////////////
+// MPS format //
+////////////////
+
+namespace {
+
+enum MpsSection {
+
+	MpsNone,
+	MpsObjSense,
+	MpsRows,
+	MpsColumns,
+	MpsRhs,
+	MpsRanges,
+	MpsBounds,
+	MpsQuadObj,
+	MpsQMatrix,
+	MpsEnd
+};
+
+// the row number of the objective, and of other free rows, which are ignored
+const int ObjectiveRow = -1;
+const int FreeRow      = -2;
+
+} // namespace
+
+void
+ModelReader::readMps(ModelTokenizer& tokenizer) {
+
+	MpsSection section = MpsNone;
+
+	// the names of all rows, and for each the number of its constraint, or
+	// ObjectiveRow or FreeRow
+	NameIndex        rowIndex;
+	std::vector<int> rowNumbers;
+
+	std::vector<std::string> rowNames;
+	std::vector<Relation>    rowRelations;
+	std::vector<double>      rowValues;
+	std::vector<double>      rowRanges;
+	bool                     hasObjectiveRow = false;
+
+	// the coefficients of the constraints, as listed by column
+	std::vector<unsigned int> tripletRows;
+	std::vector<unsigned int> tripletCols;
+	std::vector<double>       tripletValues;
+
+	// variables with an explicit lower bound, see UP below
+	std::vector<char> lowerSet;
+
+	bool integerMarker = false;
+
+	std::string  lastColumn;
+	unsigned int lastVariable = 0;
+
+	Line line;
+
+	auto value = [&](const Token& token) {
+
+		if (!token.isNumber)
+			error(line, "expected a number, got " + token.str());
+		return token.number;
+	};
+
+	auto row = [&](const Token& token) {
+
+		unsigned int i = rowIndex.find(token);
+		if (i == NameIndex::None)
+			error(line, "unknown row " + token.str());
+		return rowNumbers[i];
+	};
+
+	auto sense = [&](const Token& token) {
+
+		if (token.equalsNoCase("max") || token.equalsNoCase("maximize") || token.equalsNoCase("maximise"))
+			_sense = Maximize;
+		else if (token.equalsNoCase("min") || token.equalsNoCase("minimize") || token.equalsNoCase("minimise"))
+			_sense = Minimize;
+		else
+			error(line, "unknown objective sense " + token.str());
+	};
+
+	while (section != MpsEnd && tokenizer.next(line)) {
+
+		const Token* t = line.tokens;
+		size_t       n = line.size;
+
+		// section headers start in the first column
+		if (!line.indented) {
+
+			bool header = true;
+
+			if (t[0] == "NAME")
+				_name = (n > 1 ? t[1].str() : "");
+			else if (t[0] == "OBJSENSE") {
+				if (n > 1)
+					sense(t[1]);
+				section = (n > 1 ? MpsNone : MpsObjSense);
+			} else if (t[0] == "ROWS")
+				section = MpsRows;
+			else if (t[0] == "COLUMNS")
+				section = MpsColumns;
+			else if (t[0] == "RHS" && n == 1)
+				section = MpsRhs;
+			else if (t[0] == "RANGES" && n == 1)
+				section = MpsRanges;
+			else if (t[0] == "BOUNDS" && n == 1)
+				section = MpsBounds;
+			else if (t[0] == "QUADOBJ")
+				section = MpsQuadObj;
+			else if (t[0] == "QMATRIX")
+				section = MpsQMatrix;
+			else if (t[0] == "QSECTION") {
+				if (n < 2 || rowIndex.find(t[1]) == NameIndex::None || rowNumbers[rowIndex.find(t[1])] != ObjectiveRow)
+					error(line, "quadratic constraints are not supported");
+				section = MpsQMatrix;
+			} else if (t[0] == "ENDATA")
+				section = MpsEnd;
+			else if (t[0] == "SOS" || t[0] == "QCMATRIX" || t[0] == "INDICATORS" || t[0] == "GENCONS" || t[0] == "PWLOBJ")
+				error(line, "section " + t[0].str() + " is not supported");
+			else
+				header = false;
+
+			if (header)
+				continue;
+		}
+
+		switch (section) {
+
+			case MpsObjSense:
+
+				sense(t[0]);
+				break;
+
+			case MpsRows: {
+
+				if (n != 2)
+					error(line, "expected a row type and name");
+
+				if (rowIndex.find(t[1]) != NameIndex::None)
+					error(line, "duplicate row " + t[1].str());
+
+				rowIndex.add(t[1]);
+
+				if (t[0].equalsNoCase("n")) {
+
+					rowNumbers.push_back(hasObjectiveRow ? FreeRow : ObjectiveRow);
+					hasObjectiveRow = true;
+					break;
+				}
+
+				Relation relation;
+				if (t[0].equalsNoCase("l"))
+					relation = LessEqual;
+				else if (t[0].equalsNoCase("g"))
+					relation = GreaterEqual;
+				else if (t[0].equalsNoCase("e"))
+					relation = Equal;
+				else
+					error(line, "unknown row type " + t[0].str());
+
+				rowNumbers.push_back(rowNames.size());
+				rowNames.push_back(t[1].str());
+				rowRelations.push_back(relation);
+				rowValues.push_back(0);
+				rowRanges.push_back(0);
+
+				break;
+			}
+
+			case MpsColumns: {
+
+				if (n >= 3 && t[1] == "'MARKER'") {
+
+					if (t[2] == "'INTORG'")
+						integerMarker = true;
+					else if (t[2] == "'INTEND'")
+						integerMarker = false;
+					else
+						error(line, "unknown marker " + t[2].str());
+					break;
+				}
+
+				if (n != 3 && n != 5)
+					error(line, "expected a column name and one or two rows with values");
+
+				// columns are usually listed in one block of lines
+				if (t[0].length != lastColumn.size() || lastColumn.compare(0, std::string::npos, t[0].begin, t[0].length) != 0) {
+
+					lastColumn   = t[0].str();
+					lastVariable = variable(t[0]);
+					lowerSet.resize(getNumVariables(), 0);
+
+					if (integerMarker)
+						_types[lastVariable] = Integer;
+				}
+
+				for (size_t i = 1; i + 1 < n; i += 2) {
+
+					int    r = row(t[i]);
+					double v = value(t[i + 1]);
+
+					if (r == ObjectiveRow) {
+
+						_linear[lastVariable] += v;
+
+					} else if (r != FreeRow) {
+
+						tripletRows.push_back(r);
+						tripletCols.push_back(lastVariable);
+						tripletValues.push_back(v);
+					}
+				}
+
+				break;
+			}
+
+			case MpsRhs:
+			case MpsRanges: {
+
+				if (n < 2 || n > 5)
+					error(line, "expected one or two rows with values");
+
+				// the first column is the optional name of the vector
+				for (size_t i = n%2; i + 1 < n; i += 2) {
+
+					int    r = row(t[i]);
+					double v = value(t[i + 1]);
+
+					if (section == MpsRhs) {
+
+						// the right hand side of the objective is its
+						// negated constant
+						if (r == ObjectiveRow)
+							_constant = -v;
+						else if (r != FreeRow)
+							rowValues[r] = v;
+
+					} else if (r >= 0) {
+
+						rowRanges[r] = v;
+					}
+				}
+
+				break;
+			}
+
+			case MpsBounds: {
+
+				const Token& type = t[0];
+
+				bool hasValue =
+						type.equalsNoCase("up") || type.equalsNoCase("lo") ||
+						type.equalsNoCase("fx") || type.equalsNoCase("li") ||
+						type.equalsNoCase("ui");
+
+				if (type.equalsNoCase("sc"))
+					error(line, "semi-continuous variables are not supported");
+
+				// the name of the bound vector is optional, binaries can have
+				// a value
+				size_t column;
+				if (hasValue) {
+
+					if (n != 3 && n != 4)
+						error(line, "expected a bound type, column, and value");
+					column = n - 2;
+
+				} else {
+
+					if (n < 2 || n > 4)
+						error(line, "expected a bound type and column");
+
+					if (n == 2)
+						column = 1;
+					else if (n == 3)
+						column = (type.equalsNoCase("bv") && t[2].isNumber ? 1 : 2);
+					else
+						column = 2;
+				}
+
+				unsigned int i = existingVariable(t[column], line);
+				double       v = (hasValue ? fileValue(value(t[column + 1])) : 0);
+
+				lowerSet.resize(getNumVariables(), 0);
+
+				if (type.equalsNoCase("up") || type.equalsNoCase("ui")) {
+
+					_upper[i] = v;
+
+					// a negative upper bound on a variable with the default
+					// lower bound of 0 makes it unbounded from below
+					if (v < 0 && !lowerSet[i] && _lower[i] == 0) {
+
+						LOG_DEBUG(modelreaderlog)
+								<< "negative upper bound of " << _variables.names()[i]
+								<< ", setting its lower bound to -inf" << std::endl;
+						_lower[i] = -Infinity;
+					}
+
+					if (type.equalsNoCase("ui"))
+						_types[i] = Integer;
+
+				} else if (type.equalsNoCase("lo") || type.equalsNoCase("li")) {
+
+					_lower[i] = v;
+					lowerSet[i] = 1;
+
+					if (type.equalsNoCase("li"))
+						_types[i] = Integer;
+
+				} else if (type.equalsNoCase("fx")) {
+
+					_lower[i] = v;
+					_upper[i] = v;
+					lowerSet[i] = 1;
+
+				} else if (type.equalsNoCase("fr")) {
+
+					_lower[i] = -Infinity;
+					_upper[i] =  Infinity;
+					lowerSet[i] = 1;
+
+				} else if (type.equalsNoCase("mi")) {
+
+					_lower[i] = -Infinity;
+					lowerSet[i] = 1;
+
+				} else if (type.equalsNoCase("pl")) {
+
+					_upper[i] = Infinity;
+
+				} else if (type.equalsNoCase("bv")) {
+
+					_types[i] = Binary;
+					_lower[i] = 0;
+					_upper[i] = 1;
+					lowerSet[i] = 1;
+
+				} else {
+
+					error(line, "unknown bound type " + type.str());
+				}
+
+				break;
+			}
+
+			case MpsQuadObj:
+			case MpsQMatrix: {
+
+				if (n != 3)
+					error(line, "expected two columns and a value");
+
+				unsigned int i = existingVariable(t[0], line);
+				unsigned int j = existingVariable(t[1], line);
+				double       v = value(t[2]);
+
+				// the objective is 1/2 x'Qx, QUADOBJ lists only one triangle
+				// of Q, QMATRIX all of it
+				if (section == MpsQuadObj && i != j)
+					v *= 2;
+
+				_quadraticRows.push_back(i);
+				_quadraticCols.push_back(j);
+				_quadraticValues.push_back(0.5*v);
+
+				break;
+			}
+
+			default:
+
+				error(line, "unexpected line outside of a section");
+		}
+	}
+
+	if (section != MpsEnd)
+		LOG_USER(modelreaderlog) << "missing ENDATA in " << _filename << std::endl;
+
+	// sort the coefficients into rows, keeping the order of the columns
+
+	unsigned int numRows = rowNames.size();
+
+	std::vector<size_t> offsets(numRows + 1, 0);
+	for (unsigned int r : tripletRows)
+		offsets[r + 1]++;
+	for (unsigned int r = 0; r < numRows; r++)
+		offsets[r + 1] += offsets[r];
+
+	std::vector<unsigned int> columns(tripletCols.size());
+	std::vector<double>       coefs(tripletCols.size());
+	{
+		std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+		for (size_t k = 0; k < tripletRows.size(); k++) {
+
+			size_t pos = next[tripletRows[k]]++;
+			columns[pos] = tripletCols[k];
+			coefs[pos]   = tripletValues[k];
+		}
+	}
+
+	std::vector<unsigned int>().swap(tripletRows);
+	std::vector<unsigned int>().swap(tripletCols);
+	std::vector<double>().swap(tripletValues);
+
+	auto addMatrixRow = [&](unsigned int r, const std::string& name, Relation relation, double value) {
+
+		for (size_t k = offsets[r]; k < offsets[r + 1]; k++)
+			addCoefficient(columns[k], coefs[k]);
+
+		addRow(name, relation, value);
+	};
+
+	_constraints.reserve(numRows, columns.size());
+
+	// a range turns a row into lower <= ax <= upper, which is the row itself
+	// and a second row added after all others
+
+	for (unsigned int r = 0; r < numRows; r++) {
+
+		Relation relation = rowRelations[r];
+		double   range    = rowRanges[r];
+
+		if (relation == Equal && range != 0)
+			relation = (range > 0 ? GreaterEqual : LessEqual);
+
+		addMatrixRow(r, rowNames[r], relation, rowValues[r]);
+	}
+
+	for (unsigned int r = 0; r < numRows; r++) {
+
+		double range = rowRanges[r];
+
+		if (range == 0)
+			continue;
+
+		Relation relation = rowRelations[r];
+		double   value    = rowValues[r];
+
+		if (relation == GreaterEqual || (relation == Equal && range > 0))
+			addMatrixRow(r, rowNames[r] + "_range", LessEqual, value + std::fabs(range));
+		else
+			addMatrixRow(r, rowNames[r] + "_range", GreaterEqual, value - std::fabs(range));
+	}
+}
+
+///////////////
+// LP format //
+///////////////
+
+namespace {
+
+enum LpSection {
+
+	LpNone,
+	LpObjective,
+	LpConstraints,
+	LpBounds,
+	LpGenerals,
+	LpBinaries,
+	LpEnd
+};
+
+/**
+ * Reads the tokens of an LP file one by one, across lines. Tokens are valid
+ * until the next call to peek().
+ */
+class LpCursor {
+
+public:
+
+	typedef ModelTokenizer::Token Token;
+	typedef ModelTokenizer::Line  Line;
+
+	LpCursor(ModelTokenizer& tokenizer) :
+		_tokenizer(tokenizer),
+		_pos(0) {
+
+		_line.size   = 0;
+		_line.number = 0;
+	}
+
+	// whether there are more tokens
+	bool more() { return fill(); }
+
+	// the current token
+	const Token& peek() { fill(); return _line.tokens[_pos]; }
+
+	// the token k positions after the current one on the same line, or 0
+	const Token* peek(size_t k) { fill(); return (_pos + k < _line.size ? &_line.tokens[_pos + k] : 0); }
+
+	void skip() { _pos++; }
+
+	// whether the current token is the first of its line
+	bool atLineStart() { fill(); return _pos == 0; }
+
+	// the line of the current token
+	const Line& line() { fill(); return _line; }
+
+private:
+
+	bool fill() {
+
+		while (_pos >= _line.size) {
+
+			if (!_tokenizer.next(_line))
+				return false;
+			_pos = 0;
+		}
+
+		return true;
+	}
+
+	ModelTokenizer& _tokenizer;
+	Line            _line;
+	size_t          _pos;
+};
+
+bool
+isRelation(const ModelTokenizer::Token& token) {
+
+	return token.length > 0 && (token.begin[0] == '<' || token.begin[0] == '>' || token.begin[0] == '=');
+}
+
+Relation
+relation(const ModelTokenizer::Token& token) {
+
+	if (token.begin[0] == '<' || (token.length == 2 && token.begin[1] == '<'))
+		return LessEqual;
+	if (token.begin[0] == '>' || (token.length == 2 && token.begin[1] == '>'))
+		return GreaterEqual;
+	return Equal;
+}
+
+// the relation for the swapped sides
+Relation
+swapped(Relation relation) {
+
+	return (relation == LessEqual ? GreaterEqual : (relation == GreaterEqual ? LessEqual : Equal));
+}
+
+bool
+isName(const ModelTokenizer::Token& token) {
+
+	char c = token.begin[0];
+
+	return
+			!token.isNumber &&
+			c != '<' && c != '>' && c != '=' &&
+			c != '+' && c != '-' && c != ':' &&
+			c != '[' && c != ']' && c != '^' &&
+			c != '*' && c != '/';
+}
+
+bool
+isInfinity(const ModelTokenizer::Token& token) {
+
+	return token.equalsNoCase("inf") || token.equalsNoCase("infinity");
+}
+
+// the section started at the cursor, and the number of its tokens
+LpSection
+sectionKeyword(LpCursor& cursor, size_t& length, Sense& sense) {
+
+	if (!cursor.atLineStart())
+		return LpNone;
+
+	const ModelTokenizer::Token& t    = cursor.peek();
+	const ModelTokenizer::Token* next = cursor.peek(1);
+
+	length = 1;
+
+	if (t.equalsNoCase("maximize") || t.equalsNoCase("maximise") || t.equalsNoCase("maximum") || t.equalsNoCase("max")) {
+
+		sense = Maximize;
+		return LpObjective;
+	}
+
+	if (t.equalsNoCase("minimize") || t.equalsNoCase("minimise") || t.equalsNoCase("minimum") || t.equalsNoCase("min")) {
+
+		sense = Minimize;
+		return LpObjective;
+	}
+
+	if ((t.equalsNoCase("subject") && next && next->equalsNoCase("to")) ||
+	    (t.equalsNoCase("such") && next && next->equalsNoCase("that"))) {
+
+		length = 2;
+		return LpConstraints;
+	}
+
+	if (t.equalsNoCase("st") || t.equalsNoCase("s.t.") || t.equalsNoCase("st."))
+		return LpConstraints;
+
+	if (t.equalsNoCase("bounds") || t.equalsNoCase("bound"))
+		return LpBounds;
+
+	if (t.equalsNoCase("generals") || t.equalsNoCase("general") || t.equalsNoCase("gen") || t.equalsNoCase("integers"))
+		return LpGenerals;
+
+	if (t.equalsNoCase("binaries") || t.equalsNoCase("binary") || t.equalsNoCase("bin"))
+		return LpBinaries;
+
+	if (t.equalsNoCase("end"))
+		return LpEnd;
+
+	return LpNone;
+}
+
+} // namespace
+
+void
+ModelReader::readLp(ModelTokenizer& tokenizer) {
+
+	LpCursor cursor(tokenizer);
+
+	LpSection section = LpNone;
+	Sense     sense   = Minimize;
+	size_t    length;
+
+	// the constant of an expression being read
+	double constant;
+
+	// the line of the current token, for error messages
+	auto line = [&]() { return cursor.line(); };
+
+	auto expect = [&](bool condition, const std::string& message) {
+
+		if (!condition)
+			error(line(), message);
+	};
+
+	// a section keyword at the cursor
+	auto atSection = [&]() {
+
+		Sense s;
+		size_t l;
+		return sectionKeyword(cursor, l, s) != LpNone;
+	};
+
+	// a label "name:" at the cursor
+	auto atLabel = [&]() {
+
+		const Token* colon = cursor.peek(1);
+		return isName(cursor.peek()) && colon && *colon == ":";
+	};
+
+	// read a label, if there is one
+	auto label = [&]() {
+
+		std::string name;
+		if (cursor.more() && atLabel()) {
+
+			name = cursor.peek().str();
+			cursor.skip();
+			cursor.skip();
+		}
+		return name;
+	};
+
+	// read a signed number or infinity
+	auto number = [&]() {
+
+		double sign = 1;
+		while (cursor.more() && (cursor.peek() == "+" || cursor.peek() == "-")) {
+
+			if (cursor.peek() == "-")
+				sign = -sign;
+			cursor.skip();
+		}
+
+		expect(cursor.more(), "unexpected end of file");
+
+		const Token& t = cursor.peek();
+		double value;
+		if (t.isNumber)
+			value = fileValue(t.number);
+		else if (isInfinity(t))
+			value = Infinity;
+		else
+			error(line(), "expected a number, got " + t.str());
+
+		cursor.skip();
+		return sign*value;
+	};
+
+	// read a linear expression into the objective or into _rowColumns and
+	// _rowCoefs with the given factor, and its constant, quadratic terms in
+	// brackets are added to the objective, an expression that ends a
+	// statement stops at the end of its line, returns the number of terms
+	auto expression = [&](bool objective, bool endsStatement, double factor) {
+
+		constant = 0;
+		size_t lineNumber = 0;
+		size_t numTerms   = 0;
+
+		while (cursor.more()) {
+
+			if (endsStatement && lineNumber != 0 && cursor.line().number != lineNumber)
+				break;
+			if (atSection() || isRelation(cursor.peek()) || atLabel())
+				break;
+
+			lineNumber = cursor.line().number;
+			numTerms++;
+
+			double sign = 1;
+			while (cursor.more() && (cursor.peek() == "+" || cursor.peek() == "-")) {
+
+				if (cursor.peek() == "-")
+					sign = -sign;
+				cursor.skip();
+			}
+
+			expect(cursor.more(), "unexpected end of file");
+
+			if (cursor.peek() == "[") {
+
+				expect(objective, "quadratic constraints are not supported");
+				cursor.skip();
+
+				size_t first = _quadraticValues.size();
+
+				while (true) {
+
+					expect(cursor.more(), "unexpected end of file");
+					if (cursor.peek() == "]")
+						break;
+
+					double termSign = 1;
+					while (cursor.peek() == "+" || cursor.peek() == "-") {
+
+						if (cursor.peek() == "-")
+							termSign = -termSign;
+						cursor.skip();
+					}
+
+					double coef = 1;
+					if (cursor.peek().isNumber) {
+
+						coef = cursor.peek().number;
+						cursor.skip();
+					}
+
+					expect(isName(cursor.peek()), "expected a variable, got " + cursor.peek().str());
+					unsigned int i = variable(cursor.peek());
+					cursor.skip();
+
+					unsigned int j;
+					if (cursor.peek() == "^") {
+
+						cursor.skip();
+						expect(cursor.peek().isNumber && cursor.peek().number == 2, "expected ^ 2");
+						cursor.skip();
+						j = i;
+
+					} else {
+
+						expect(cursor.peek() == "*", "expected ^ or *, got " + cursor.peek().str());
+						cursor.skip();
+						expect(isName(cursor.peek()), "expected a variable, got " + cursor.peek().str());
+						j = variable(cursor.peek());
+						cursor.skip();
+					}
+
+					_quadraticRows.push_back(i);
+					_quadraticCols.push_back(j);
+					_quadraticValues.push_back(sign*termSign*coef);
+				}
+
+				// skip the ]
+				cursor.skip();
+
+				// the objective has the form [ x'Qx ] / 2
+				if (cursor.more() && cursor.peek() == "/") {
+
+					cursor.skip();
+					expect(cursor.more() && cursor.peek().isNumber, "expected a number after /");
+					double divisor = cursor.peek().number;
+					cursor.skip();
+
+					for (size_t k = first; k < _quadraticValues.size(); k++)
+						_quadraticValues[k] /= divisor;
+				}
+
+				continue;
+			}
+
+			if (isInfinity(cursor.peek())) {
+
+				constant += sign*Infinity;
+				cursor.skip();
+				continue;
+			}
+
+			double coef    = 1;
+			bool   hasCoef = false;
+			if (cursor.peek().isNumber) {
+
+				coef    = cursor.peek().number;
+				hasCoef = true;
+				cursor.skip();
+			}
+
+			// a variable follows on the same line, otherwise this is a
+			// constant
+			if (cursor.more() && isName(cursor.peek()) && !atSection() && !atLabel() &&
+			    (!hasCoef || cursor.line().number == lineNumber)) {
+
+				unsigned int v = variable(cursor.peek());
+				cursor.skip();
+
+				if (objective)
+					_linear[v] += sign*coef;
+				else
+					addCoefficient(v, factor*sign*coef);
+
+			} else {
+
+				expect(hasCoef, "expected a term, got " + (cursor.more() ? cursor.peek().str() : std::string("end of file")));
+				constant += sign*coef;
+			}
+		}
+
+		return numTerms;
+	};
+
+	while (cursor.more() && section != LpEnd) {
+
+		Sense     s;
+		LpSection next = sectionKeyword(cursor, length, s);
+
+		if (next != LpNone) {
+
+			if (next == LpObjective)
+				sense = s;
+
+			for (size_t i = 0; i < length; i++)
+				cursor.skip();
+
+			section = next;
+			continue;
+		}
+
+		switch (section) {
+
+			case LpNone:
+
+				error(line(), "expected Minimize or Maximize, got " + cursor.peek().str());
+
+			case LpObjective: {
+
+				label();
+				expression(true, false, 1);
+				_constant += constant;
+
+				expect(!cursor.more() || !isRelation(cursor.peek()), "unexpected relation in the objective");
+
+				break;
+			}
+
+			case LpConstraints: {
+
+				std::string name = label();
+				if (name.empty())
+					name = "R" + std::to_string(_constraints.size() + 1);
+
+				// lhs rel rhs [rel rhs], the lhs of a range is a constant
+				expression(false, false, 1);
+				double lhs = constant;
+
+				expect(cursor.more() && isRelation(cursor.peek()), "expected a relation");
+				Relation first = relation(cursor.peek());
+				cursor.skip();
+
+				if (_rowColumns.empty()) {
+
+					// lhs rel ax [rel rhs]
+					expression(false, true, 1);
+					expect(!_rowColumns.empty(), "constraint without variables");
+					double middle = constant;
+
+					if (cursor.more() && isRelation(cursor.peek()) && !cursor.atLineStart()) {
+
+						Relation second = relation(cursor.peek());
+						cursor.skip();
+						double rhs = number();
+
+						std::vector<unsigned int> columns = _rowColumns;
+						std::vector<double>       coefs   = _rowCoefs;
+
+						addRow(name, swapped(first), lhs - middle);
+
+						for (size_t k = 0; k < columns.size(); k++)
+							addCoefficient(columns[k], coefs[k]);
+						addRow(name + "_range", second, rhs - middle);
+
+					} else {
+
+						addRow(name, swapped(first), lhs - middle);
+					}
+
+				} else {
+
+					// ax rel rhs, variables on the rhs are moved to the lhs
+					expect(expression(false, true, -1) > 0, "expected a right hand side");
+					addRow(name, first, constant - lhs);
+				}
+
+				break;
+			}
+
+			case LpBounds: {
+
+				// x free, x rel b, b rel x, b rel x rel b
+				if (isName(cursor.peek()) && !isInfinity(cursor.peek())) {
+
+					unsigned int v = variable(cursor.peek());
+					cursor.skip();
+
+					expect(cursor.more(), "unexpected end of file");
+
+					if (cursor.peek().equalsNoCase("free")) {
+
+						cursor.skip();
+						_lower[v] = -Infinity;
+						_upper[v] =  Infinity;
+						break;
+					}
+
+					expect(isRelation(cursor.peek()), "expected a relation or free");
+					Relation r = relation(cursor.peek());
+					cursor.skip();
+					double b = number();
+
+					if (r != GreaterEqual)
+						_upper[v] = b;
+					if (r != LessEqual)
+						_lower[v] = b;
+
+					break;
+				}
+
+				double b = number();
+
+				expect(cursor.more() && isRelation(cursor.peek()), "expected a relation");
+				Relation r = swapped(relation(cursor.peek()));
+				cursor.skip();
+
+				expect(cursor.more() && isName(cursor.peek()), "expected a variable");
+				unsigned int v = variable(cursor.peek());
+				cursor.skip();
+
+				if (r != GreaterEqual)
+					_upper[v] = b;
+				if (r != LessEqual)
+					_lower[v] = b;
+
+				if (cursor.more() && isRelation(cursor.peek()) && !cursor.atLineStart()) {
+
+					r = relation(cursor.peek());
+					cursor.skip();
+					b = number();
+
+					if (r != GreaterEqual)
+						_upper[v] = b;
+					if (r != LessEqual)
+						_lower[v] = b;
+				}
+
+				break;
+			}
+
+			case LpGenerals:
+			case LpBinaries: {
+
+				expect(isName(cursor.peek()), "expected a variable, got " + cursor.peek().str());
+				unsigned int v = variable(cursor.peek());
+				cursor.skip();
+
+				if (section == LpGenerals) {
+
+					_types[v] = Integer;
+
+				} else {
+
+					_types[v] = Binary;
+					_lower[v] = 0;
+					_upper[v] = 1;
+				}
+
+				break;
+			}
+
+			default:
+
+				break;
+		}
+	}
+
+	if (section != LpEnd)
+		LOG_USER(modelreaderlog) << "missing End in " << _filename << std::endl;
+
+	_sense = sense;
+}
+
+//////////////////////
+// backend creation //
+//////////////////////
+
+void
+ModelReader::setUp(LinearSolverBackend& backend) const {
+
+	if (_objective.numQuadraticTerms() > 0)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"the objective is quadratic, use a QuadraticSolverBackend");
+
+	LinearObjective objective(getNumVariables());
+	objective.setSense(_objective.getSense());
+	objective.setConstant(_objective.getConstant());
+	for (unsigned int i = 0; i < getNumVariables(); i++)
+		objective.setCoefficient(i, _objective.getCoefficients()[i]);
+
+	initializeVariables(backend);
+	backend.setObjective(objective);
+	setUpConstraints(backend);
+}
+
+void
+ModelReader::setUp(QuadraticSolverBackend& backend) const {
+
+	initializeVariables(backend);
+	backend.setObjective(_objective);
+	setUpConstraints(backend);
+}
+
+void
+ModelReader::initializeVariables(LinearSolverBackend& backend) const {
+
+	// use the most frequent type as the default
+	unsigned int counts[3] = { 0, 0, 0 };
+	for (VariableType type : _types)
+		counts[type]++;
+
+	VariableType defaultType = static_cast<VariableType>(std::max_element(counts, counts + 3) - counts);
+
+	std::map<unsigned int, VariableType> specialTypes;
+	for (unsigned int i = 0; i < getNumVariables(); i++)
+		if (_types[i] != defaultType)
+			specialTypes[i] = _types[i];
+
+	backend.initialize(getNumVariables(), defaultType, specialTypes);
+}
+
+void
+ModelReader::setUpConstraints(LinearSolverBackend& backend) const {
+
+	backend.setConstraints(_constraints);
+
+	// set bounds that differ from the defaults of the variable types
+	for (unsigned int i = 0; i < getNumVariables(); i++) {
+
+		if (!hasDefaultBounds(_types[i], _lower[i], _upper[i]))
+			backend.setVariableBounds(i, _lower[i], _upper[i]);
+	}
+}
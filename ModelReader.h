@@ -0,0 +1,211 @@
+#ifndef INFERENCE_MODEL_READER_H__
+#define INFERENCE_MODEL_READER_H__
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "LinearConstraintMatrix.h"
+#include "LinearSolverBackend.h"
+#include "ModelFormat.h"
+#include "ModelTokenizer.h"
+#include "QuadraticObjective.h"
+#include "QuadraticSolverBackend.h"
+#include "VariableType.h"
+
+/**
+ * Reads models in MPS or LP format into the types of this library.
+ *
+ * The file is read in chunks by a ModelTokenizer, and constraints are added
+ * to a LinearConstraintMatrix as they are read. Apart from the model itself,
+ * only one chunk of the file is kept in memory. MPS files list the
+ * constraint matrix by columns, their coefficients are collected as
+ * triplets and sorted into rows at the end.
+ *
+ * Supported are linear constraints, linear and quadratic objectives,
+ * bounds, and integer and binary variables. MPS files are read in free
+ * format, with the sections NAME, OBJSENSE, ROWS, COLUMNS (with integer
+ * markers), RHS, RANGES, BOUNDS, QUADOBJ, QMATRIX, and ENDATA. LP files are
+ * read in CPLEX LP format, with the sections for the objective, Subject To,
+ * Bounds, Generals, Binaries, and End.
+ *
+ * The bounds follow the conventions of the file formats, i.e., variables
+ * are non-negative unless their bounds say otherwise:
+ *
+ *   ModelReader reader;
+ *   reader.read("problem.mps");
+ *   reader.setUp(*backend);
+ */
+class ModelReader {
+
+public:
+
+	/**
+	 * @param numThreads
+	 *             The number of threads to tokenize the file, 0 for all
+	 *             hardware threads.
+	 *
+	 * @param chunkSize
+	 *             The number of bytes to read at once.
+	 */
+	ModelReader(
+			unsigned int numThreads = 0,
+			size_t       chunkSize = ModelTokenizer::DefaultChunkSize);
+
+	/**
+	 * Read a model from a file, the format is taken from the extension.
+	 * Throws an IOError if the file can not be read or parsed.
+	 */
+	void read(const std::string& filename);
+
+	/**
+	 * Read a model from a stream.
+	 */
+	void read(std::istream& in, ModelFormat format);
+
+	/**
+	 * @return The name of the problem, if the file gives one.
+	 */
+	const std::string& getName() const { return _name; }
+
+	unsigned int getNumVariables() const { return _variables.size(); }
+
+	const std::vector<std::string>& getVariableNames() const { return _variables.names(); }
+
+	const std::vector<VariableType>& getVariableTypes() const { return _types; }
+
+	const std::vector<double>& getLowerBounds() const { return _lower; }
+
+	const std::vector<double>& getUpperBounds() const { return _upper; }
+
+	const QuadraticObjective& getObjective() const { return _objective; }
+
+	const std::vector<std::string>& getConstraintNames() const { return _constraintNames; }
+
+	const LinearConstraintMatrix& getConstraints() const { return _constraints; }
+
+	/**
+	 * Initialize a backend with the model that was read. Throws a UsageError
+	 * if the objective has quadratic terms.
+	 */
+	void setUp(LinearSolverBackend& backend) const;
+
+	/**
+	 * Initialize a quadratic backend with the model that was read.
+	 */
+	void setUp(QuadraticSolverBackend& backend) const;
+
+private:
+
+	typedef ModelTokenizer::Token Token;
+	typedef ModelTokenizer::Line  Line;
+
+	/**
+	 * Maps names to numbers in the order they were added. Names are looked
+	 * up with the characters of a token, without copying them into a
+	 * string.
+	 */
+	class NameIndex {
+
+	public:
+
+		static const unsigned int None = static_cast<unsigned int>(-1);
+
+		/**
+		 * @return The number of a name, or None.
+		 */
+		unsigned int find(const Token& name) const;
+
+		/**
+		 * Add a name that is not in the index yet.
+		 *
+		 * @return The number of the name.
+		 */
+		unsigned int add(const Token& name);
+
+		const std::vector<std::string>& names() const { return _names; }
+
+		unsigned int size() const { return _names.size(); }
+
+		void clear();
+
+	private:
+
+		static size_t hash(const char* s, size_t length);
+
+		void grow();
+
+		std::vector<std::string> _names;
+		std::vector<size_t>      _hashes;
+
+		// open addressing with linear probing, the numbers of the names or
+		// None
+		std::vector<unsigned int> _slots;
+	};
+
+	void clear();
+
+	void readMps(ModelTokenizer& tokenizer);
+
+	void readLp(ModelTokenizer& tokenizer);
+
+	// the number of a variable, added if it does not exist
+	unsigned int variable(const Token& name);
+
+	// the number of an existing variable
+	unsigned int existingVariable(const Token& name, const Line& line) const;
+
+	// add a coefficient to the row being read, summing coefficients of the
+	// same variable
+	void addCoefficient(unsigned int variable, double coef);
+
+	// add a row from the coefficients in _rowColumns and _rowCoefs
+	void addRow(const std::string& name, Relation relation, double value);
+
+	// create the objective from _linear and the quadratic terms
+	void finishObjective();
+
+	// initialize a backend with the types and bounds of the variables and
+	// the constraints
+	void initializeVariables(LinearSolverBackend& backend) const;
+
+	void setUpConstraints(LinearSolverBackend& backend) const;
+
+	// throw an IOError for the given line
+	[[noreturn]] void error(const Line& line, const std::string& message) const;
+
+	unsigned int _numThreads;
+	size_t       _chunkSize;
+
+	std::string _name;
+
+	NameIndex _variables;
+
+	std::vector<VariableType> _types;
+	std::vector<double>       _lower;
+	std::vector<double>       _upper;
+
+	Sense                     _sense;
+	double                    _constant;
+	std::vector<double>       _linear;
+	std::vector<unsigned int> _quadraticRows;
+	std::vector<unsigned int> _quadraticCols;
+	std::vector<double>       _quadraticValues;
+
+	QuadraticObjective _objective;
+
+	std::vector<std::string> _constraintNames;
+	LinearConstraintMatrix   _constraints;
+
+	// the coefficients of the row being read, and the position of each
+	// variable in them
+	std::vector<unsigned int> _rowColumns;
+	std::vector<double>       _rowCoefs;
+	std::vector<int>          _rowPositions;
+
+	// the name of the file being read, for error messages
+	std::string _filename;
+};
+
+#endif // INFERENCE_MODEL_READER_H__
+
@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include "ModelTokenizer.h"
+#include "Parallel.h"
+
+// the minimal number of bytes to tokenize per thread
+static const size_t BytesPerThread = 1024*1024;
+
+static inline bool
+isSpace(char c) {
+
+	return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+static inline bool
+isDigit(char c) {
+
+	return c >= '0' && c <= '9';
+}
+
+// characters that end a name in LP files
+static inline bool
+isLpOperator(char c) {
+
+	return
+			c == '<' || c == '>' || c == '=' ||
+			c == '+' || c == '-' || c == ':' ||
+			c == '[' || c == ']' || c == '^' ||
+			c == '*' || c == '\\';
+}
+
+bool
+ModelTokenizer::Token::equalsNoCase(const char* s) const {
+
+	for (unsigned int i = 0; i < length; i++, s++)
+		if (*s == 0 || std::tolower(static_cast<unsigned char>(begin[i])) != *s)
+			return false;
+
+	return *s == 0;
+}
+
+ModelTokenizer::ModelTokenizer(
+		std::istream& in,
+		ModelFormat   format,
+		unsigned int  numThreads,
+		size_t        chunkSize) :
+	_in(in),
+	_format(format),
+	_numThreads(numThreads),
+	_chunkSize(std::max<size_t>(chunkSize, 1)),
+	_size(0),
+	_end(0),
+	_part(0),
+	_line(0),
+	_firstLine(0) {}
+
+bool
+ModelTokenizer::next(Line& line) {
+
+	while (true) {
+
+		for (; _part < _parts.size(); _part++, _line = 0) {
+
+			const Part& part = _parts[_part];
+
+			if (_line == part.lineOffsets.size())
+				continue;
+
+			size_t begin = part.lineOffsets[_line];
+			size_t end   = (_line + 1 < part.lineOffsets.size() ? part.lineOffsets[_line + 1] : part.tokens.size());
+
+			line.tokens   = &part.tokens[begin];
+			line.size     = end - begin;
+			line.indented = part.lineIndented[_line];
+			line.number   = _partFirstLines[_part] + part.lineNumbers[_line];
+
+			_line++;
+
+			return true;
+		}
+
+		if (!readChunk())
+			return false;
+	}
+}
+
+bool
+ModelTokenizer::readChunk() {
+
+	// keep the incomplete last line of the previous chunk
+	size_t size = _size - _end;
+	if (size > 0)
+		std::copy(_buffer.begin() + _end, _buffer.begin() + _size, _buffer.begin());
+
+	size_t end;
+
+	while (true) {
+
+		// one more byte to terminate the last token
+		_buffer.resize(size + _chunkSize + 1);
+
+		_in.read(&_buffer[size], _chunkSize);
+		size += _in.gcount();
+
+		if (!_in) {
+
+			end = size;
+			break;
+		}
+
+		// find the end of the last complete line, read more if there is
+		// none
+		end = size;
+		while (end > 0 && _buffer[end - 1] != '\n')
+			end--;
+
+		if (end > 0)
+			break;
+	}
+
+	_buffer[size] = 0;
+	_size = size;
+	_end  = end;
+
+	if (end == 0)
+		return false;
+
+	// split the chunk at line ends, one part per thread
+
+	unsigned int numParts = numLoopThreads(_numThreads, end, BytesPerThread);
+
+	std::vector<size_t> bounds(numParts + 1);
+	bounds[0]        = 0;
+	bounds[numParts] = end;
+	for (unsigned int t = 1; t < numParts; t++) {
+
+		size_t b = std::max(bounds[t - 1], t*end/numParts);
+		while (b < end && _buffer[b - 1] != '\n')
+			b++;
+		bounds[t] = b;
+	}
+
+	_parts.resize(numParts);
+
+	parallelForChunks(numParts, numParts, 1, [&](unsigned int, size_t begin, size_t stop) {
+
+		for (size_t t = begin; t < stop; t++)
+			tokenize(&_buffer[0] + bounds[t], &_buffer[0] + bounds[t + 1], _parts[t]);
+	});
+
+	_partFirstLines.resize(numParts);
+	for (unsigned int t = 0; t < numParts; t++) {
+
+		_partFirstLines[t] = _firstLine;
+		_firstLine += _parts[t].numLines;
+	}
+
+	_part = 0;
+	_line = 0;
+
+	return true;
+}
+
+void
+ModelTokenizer::tokenize(const char* begin, const char* end, Part& part) const {
+
+	part.tokens.clear();
+	part.lineOffsets.clear();
+	part.lineIndented.clear();
+	part.lineNumbers.clear();
+	part.numLines = 0;
+
+	if (_format == Mps)
+		tokenizeMps(begin, end, part);
+	else
+		tokenizeLp(begin, end, part);
+}
+
+void
+ModelTokenizer::tokenizeMps(const char* begin, const char* end, Part& part) const {
+
+	for (const char* p = begin; p < end; ) {
+
+		const char* lineEnd = std::find(p, end, '\n');
+		part.numLines++;
+
+		size_t first = part.tokens.size();
+
+		// comment lines start with a '*'
+		if (*p != '*') {
+
+			for (const char* q = p; q < lineEnd; ) {
+
+				while (q < lineEnd && isSpace(*q))
+					q++;
+
+				const char* s = q;
+				while (q < lineEnd && !isSpace(*q))
+					q++;
+
+				if (s < q)
+					addToken(s, q, part);
+			}
+		}
+
+		if (part.tokens.size() > first) {
+
+			part.lineOffsets.push_back(first);
+			part.lineIndented.push_back(isSpace(*p));
+			part.lineNumbers.push_back(part.numLines);
+		}
+
+		p = lineEnd + 1;
+	}
+}
+
+void
+ModelTokenizer::tokenizeLp(const char* begin, const char* end, Part& part) const {
+
+	for (const char* p = begin; p < end; ) {
+
+		const char* lineEnd = std::find(p, end, '\n');
+		part.numLines++;
+
+		size_t first = part.tokens.size();
+
+		for (const char* q = p; q < lineEnd; ) {
+
+			char c = *q;
+			const char* s = q;
+
+			if (isSpace(c)) {
+
+				q++;
+				continue;
+			}
+
+			// comments start with a '\'
+			if (c == '\\')
+				break;
+
+			if (c == '<' || c == '>' || c == '=') {
+
+				// <=, >=, =<, =>
+				q++;
+				if (q < lineEnd && (*q == '=' || (c == '=' && (*q == '<' || *q == '>'))))
+					q++;
+
+			} else if (isLpOperator(c) || c == '/') {
+
+				q++;
+
+			} else if (isDigit(c) || (c == '.' && q + 1 < lineEnd && isDigit(q[1]))) {
+
+				while (q < lineEnd && (isDigit(*q) || *q == '.'))
+					q++;
+
+				// an exponent
+				if (q < lineEnd && (*q == 'e' || *q == 'E')) {
+
+					const char* e = q + 1;
+					if (e < lineEnd && (*e == '+' || *e == '-'))
+						e++;
+
+					if (e < lineEnd && isDigit(*e)) {
+
+						q = e;
+						while (q < lineEnd && isDigit(*q))
+							q++;
+					}
+				}
+
+			} else {
+
+				// a name, which can contain '/'
+				while (q < lineEnd && !isSpace(*q) && !isLpOperator(*q))
+					q++;
+			}
+
+			addToken(s, q, part);
+		}
+
+		if (part.tokens.size() > first) {
+
+			part.lineOffsets.push_back(first);
+			part.lineIndented.push_back(isSpace(*p));
+			part.lineNumbers.push_back(part.numLines);
+		}
+
+		p = lineEnd + 1;
+	}
+}
+
+void
+ModelTokenizer::addToken(const char* begin, const char* end, Part& part) const {
+
+	Token token;
+	token.begin    = begin;
+	token.length   = end - begin;
+	token.isNumber = false;
+	token.number   = 0;
+
+	char c = *begin;
+	if (isDigit(c) || c == '.' || c == '+' || c == '-') {
+
+		// the token is followed by whitespace, an operator, or the
+		// terminating 0 of the buffer, which ends the number
+		char* numberEnd;
+		token.number = std::strtod(begin, &numberEnd);
+
+		// strtod can read past the token, e.g., in "0x1" of an LP file
+		if (numberEnd > end) {
+
+			std::string s(begin, end);
+			token.number = std::strtod(s.c_str(), &numberEnd);
+			numberEnd = const_cast<char*>(begin) + (numberEnd - s.c_str());
+		}
+
+		token.isNumber = (numberEnd == end);
+	}
+
+	part.tokens.push_back(token);
+}
@@ -0,0 +1,142 @@
+#ifndef INFERENCE_MODEL_TOKENIZER_H__
+#define INFERENCE_MODEL_TOKENIZER_H__
+
+#include <cstring>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "ModelFormat.h"
+
+/**
+ * Splits a model file into lines of tokens, for ModelReader.
+ *
+ * The input is read in chunks of whole lines. The lines of a chunk are split
+ * between threads, which find the tokens and convert numbers at the same
+ * time. Only one chunk is kept in memory, the tokens of a line are valid
+ * until the next call to next().
+ *
+ * In MPS files, tokens are separated by whitespace, and lines starting with
+ * '*' are comments. In LP files, the operators <= >= = < > + - : [ ] ^ * and
+ * a leading / are tokens of their own, numbers end where a name starts, and
+ * comments start with '\'.
+ */
+class ModelTokenizer {
+
+public:
+
+	struct Token {
+
+		const char*  begin;
+		unsigned int length;
+
+		// whether the whole token is a number, and its value
+		bool   isNumber;
+		double number;
+
+		std::string str() const { return std::string(begin, length); }
+
+		bool operator==(const char* s) const { return std::strlen(s) == length && std::strncmp(begin, s, length) == 0; }
+		bool operator!=(const char* s) const { return !(*this == s); }
+
+		/**
+		 * Compare to a lower case string, ignoring the case of the token.
+		 */
+		bool equalsNoCase(const char* s) const;
+	};
+
+	struct Line {
+
+		const Token* tokens;
+		size_t       size;
+
+		// the line starts with whitespace
+		bool indented;
+
+		// the number of the line in the input, starting at 1
+		size_t number;
+	};
+
+	static const size_t DefaultChunkSize = 16*1024*1024;
+
+	/**
+	 * @param in
+	 *             The stream to read from.
+	 *
+	 * @param format
+	 *             The format of the input.
+	 *
+	 * @param numThreads
+	 *             The number of threads to tokenize a chunk, 0 for all
+	 *             hardware threads.
+	 *
+	 * @param chunkSize
+	 *             The number of bytes to read at once. Longer lines are read
+	 *             as a whole.
+	 */
+	ModelTokenizer(
+			std::istream& in,
+			ModelFormat   format,
+			unsigned int  numThreads = 0,
+			size_t        chunkSize = DefaultChunkSize);
+
+	/**
+	 * Get the next line with at least one token.
+	 *
+	 * @return false, if there are no more lines.
+	 */
+	bool next(Line& line);
+
+private:
+
+	// the tokens of a part of a chunk
+	struct Part {
+
+		std::vector<Token> tokens;
+
+		// for each line, the offset of its first token, whether it is
+		// indented, and its number within the part
+		std::vector<size_t> lineOffsets;
+		std::vector<char>   lineIndented;
+		std::vector<size_t> lineNumbers;
+
+		// the number of lines in this part, including empty ones
+		size_t numLines;
+	};
+
+	// read the next chunk and tokenize it, returns false at the end of the
+	// input
+	bool readChunk();
+
+	void tokenize(const char* begin, const char* end, Part& part) const;
+
+	void tokenizeMps(const char* begin, const char* end, Part& part) const;
+
+	void tokenizeLp(const char* begin, const char* end, Part& part) const;
+
+	void addToken(const char* begin, const char* end, Part& part) const;
+
+	std::istream& _in;
+	ModelFormat   _format;
+	unsigned int  _numThreads;
+	size_t        _chunkSize;
+
+	// the current chunk, the lines in [0, _end) are tokenized, the rest up
+	// to _size is the start of an incomplete line
+	std::vector<char> _buffer;
+	size_t            _size;
+	size_t            _end;
+
+	std::vector<Part> _parts;
+
+	// the next line to return
+	size_t _part;
+	size_t _line;
+
+	// the number of lines before the current chunk
+	size_t _firstLine;
+	std::vector<size_t> _partFirstLines;
+};
+
+#endif // INFERENCE_MODEL_TOKENIZER_H__
+
@@ -0,0 +1,510 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <util/exceptions.h>
+#include "ModelWriter.h"
+
+static const double Infinity = std::numeric_limits<double>::infinity();
+
+// the value for infinity in MPS files
+static const double FileInfinity = 1e30;
+
+// lines of LP files are wrapped after this many characters
+static const size_t MaxLineLength = 250;
+
+struct ModelWriter::Model {
+
+	unsigned int              numVariables;
+	std::vector<VariableType> types;
+	std::vector<double>       lower;
+	std::vector<double>       upper;
+
+	const QuadraticObjective&  objective;
+	LinearConstraintMatrixView constraints;
+
+	Model(const QuadraticObjective& objective_) : objective(objective_) {}
+
+	// binary variables with bounds other than [0,1] are written as integers
+	bool isBinary(unsigned int i) const { return types[i] == Binary && lower[i] == 0 && upper[i] == 1; }
+	bool isInteger(unsigned int i) const { return types[i] != Continuous && !isBinary(i); }
+};
+
+// print a number with as few digits as needed to read back the same value
+static const char*
+number(double value, char* buffer) {
+
+	std::sprintf(buffer, "%.15g", value);
+	if (std::strtod(buffer, 0) != value)
+		std::sprintf(buffer, "%.17g", value);
+
+	return buffer;
+}
+
+void
+ModelWriter::write(
+		const std::string&                          filename,
+		unsigned int                                numVariables,
+		VariableType                                defaultVariableType,
+		const std::map<unsigned int, VariableType>& specialVariableTypes,
+		const QuadraticObjective&                   objective,
+		const LinearConstraintMatrix&               constraints,
+		const Bounds&                               bounds) {
+
+	ModelFormat format = modelFormatFromFilename(filename);
+
+	std::ofstream out(filename.c_str(), std::ios::binary);
+	if (!out)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"can not open " << filename << " for writing");
+
+	write(out, format, numVariables, defaultVariableType, specialVariableTypes, objective, constraints, bounds);
+
+	out.close();
+	if (!out)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"could not write " << filename);
+}
+
+void
+ModelWriter::write(
+		std::ostream&                               out,
+		ModelFormat                                 format,
+		unsigned int                                numVariables,
+		VariableType                                defaultVariableType,
+		const std::map<unsigned int, VariableType>& specialVariableTypes,
+		const QuadraticObjective&                   objective,
+		const LinearConstraintMatrix&               constraints,
+		const Bounds&                               bounds) {
+
+	if (objective.size() != numVariables)
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"objective has " << objective.size() << " coefficients, expected " << numVariables);
+
+	Model model(objective);
+	model.numVariables = numVariables;
+	model.constraints  = constraints.view();
+
+	model.types.resize(numVariables, defaultVariableType);
+	for (auto& p : specialVariableTypes)
+		if (p.first < numVariables)
+			model.types[p.first] = p.second;
+
+	model.lower.resize(numVariables);
+	model.upper.resize(numVariables);
+	for (unsigned int i = 0; i < numVariables; i++) {
+
+		model.lower[i] = defaultLowerBound(model.types[i]);
+		model.upper[i] = defaultUpperBound(model.types[i]);
+	}
+
+	for (auto& p : bounds) {
+
+		if (p.first >= numVariables)
+			UTIL_THROW_EXCEPTION(
+					UsageError,
+					"bounds given for variable " << p.first << ", but there are only " << numVariables << " variables");
+
+		model.lower[p.first] = p.second.first;
+		model.upper[p.first] = p.second.second;
+	}
+
+	if (format == Mps)
+		writeMps(out, model);
+	else
+		writeLp(out, model);
+
+	if (!out)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"could not write the model");
+}
+
+///////////////
+// LP format //
+///////////////
+
+namespace {
+
+/**
+ * Writes the terms of an expression in an LP file, starting a new line when
+ * the current one gets too long.
+ */
+class LpLine {
+
+public:
+
+	LpLine(std::ostream& out) :
+		_out(out),
+		_length(0) {}
+
+	void add(const char* s) {
+
+		size_t length = std::strlen(s);
+
+		if (_length > 0 && _length + length + 1 > MaxLineLength) {
+
+			_out << "\n";
+			_length = 0;
+		}
+
+		_out << ' ' << s;
+		_length += length + 1;
+	}
+
+	// add a term "+ coef name", omitting a coefficient of one
+	void addTerm(double coef, const char* name, bool first = false) {
+
+		char buffer[64];
+
+		const char* sign = (coef < 0 ? "-" : (first ? "" : "+"));
+		coef = std::fabs(coef);
+
+		// names can be of any length, the term is assembled in a buffer that
+		// is reused between calls
+		_term = sign;
+		if (*sign)
+			_term += ' ';
+		if (coef != 1) {
+
+			_term += number(coef, buffer);
+			_term += ' ';
+		}
+		_term += name;
+
+		add(_term.c_str());
+	}
+
+	void end() {
+
+		_out << "\n";
+		_length = 0;
+	}
+
+private:
+
+	std::ostream& _out;
+	size_t        _length;
+	std::string   _term;
+};
+
+} // namespace
+
+void
+ModelWriter::writeLp(std::ostream& out, const Model& model) {
+
+	char buffer[64];
+	char name[32];
+	char other[32];
+
+	const QuadraticObjective&         objective   = model.objective;
+	const LinearConstraintMatrixView& constraints = model.constraints;
+
+	out << "\\ " << model.numVariables << " variables, " << constraints.size() << " constraints\n";
+	out << (objective.getSense() == Maximize ? "Maximize" : "Minimize") << "\n";
+
+	LpLine line(out);
+
+	line.add("obj:");
+
+	// readers number variables in the order they first appear, all
+	// variables are listed in the objective, with zero coefficients where
+	// needed, to keep their order and to declare variables that appear
+	// nowhere else
+	bool first = true;
+	for (unsigned int i = 0; i < model.numVariables; i++) {
+
+		std::sprintf(name, "x%u", i);
+		line.addTerm(objective.getCoefficients()[i], name, first);
+		first = false;
+	}
+
+	if (objective.getConstant() != 0 || first) {
+
+		double constant = objective.getConstant();
+		if (constant < 0 || !first)
+			line.add(constant < 0 ? "-" : "+");
+		line.add(number(std::fabs(constant), buffer));
+	}
+
+	// quadratic terms are written as [ x'Qx ] / 2
+	if (objective.numQuadraticTerms() > 0) {
+
+		const std::vector<unsigned int>& rows   = objective.getQuadraticRows();
+		const std::vector<unsigned int>& cols   = objective.getQuadraticColumns();
+		const std::vector<double>&       values = objective.getQuadraticValues();
+
+		line.add("+ [");
+
+		for (size_t k = 0; k < values.size(); k++) {
+
+			char term[80];
+			std::sprintf(name, "x%u", rows[k]);
+			std::sprintf(other, "x%u", cols[k]);
+
+			if (rows[k] == cols[k])
+				std::snprintf(term, sizeof(term), "%s ^ 2", name);
+			else
+				std::snprintf(term, sizeof(term), "%s * %s", name, other);
+
+			line.addTerm(2*values[k], term, k == 0);
+		}
+
+		line.add("] / 2");
+	}
+
+	line.end();
+
+	out << "Subject To\n";
+
+	for (unsigned int r = 0; r < constraints.size(); r++) {
+
+		std::sprintf(name, "c%u:", r);
+		line.add(name);
+
+		size_t begin = constraints.rowOffsets[r];
+		size_t end   = constraints.rowOffsets[r + 1];
+
+		// rows without coefficients still need a variable
+		if (begin == end && model.numVariables > 0)
+			line.add("0 x0");
+
+		for (size_t k = begin; k < end; k++) {
+
+			std::sprintf(name, "x%u", constraints.columns[k]);
+			line.addTerm(constraints.coefficients[k], name, k == begin);
+		}
+
+		Relation relation = constraints.relations[r];
+		line.add(relation == LessEqual ? "<=" : (relation == GreaterEqual ? ">=" : "="));
+
+		double value = constraints.values[r];
+		if (std::isinf(value))
+			line.add(value < 0 ? "-inf" : "inf");
+		else
+			line.add(number(value, buffer));
+
+		line.end();
+	}
+
+	// the default bounds in LP files are [0, inf)
+
+	out << "Bounds\n";
+
+	for (unsigned int i = 0; i < model.numVariables; i++) {
+
+		if (model.isBinary(i))
+			continue;
+
+		double lower = model.lower[i];
+		double upper = model.upper[i];
+
+		if (lower == 0 && upper == Infinity)
+			continue;
+
+		out << " ";
+
+		if (lower == -Infinity && upper == Infinity)
+			out << "x" << i << " free";
+		else if (lower == upper)
+			out << "x" << i << " = " << number(lower, buffer);
+		else if (upper == Infinity)
+			out << "x" << i << " >= " << number(lower, buffer);
+		else if (lower == -Infinity)
+			out << "-inf <= x" << i << " <= " << number(upper, buffer);
+		else {
+			out << number(lower, buffer) << " <= x" << i;
+			out << " <= " << number(upper, buffer);
+		}
+
+		out << "\n";
+	}
+
+	for (int section = 0; section < 2; section++) {
+
+		bool integers = (section == 0);
+		bool empty    = true;
+
+		for (unsigned int i = 0; i < model.numVariables; i++) {
+
+			if (integers ? !model.isInteger(i) : !model.isBinary(i))
+				continue;
+
+			if (empty)
+				out << (integers ? "Generals" : "Binaries") << "\n";
+			empty = false;
+
+			std::sprintf(name, "x%u", i);
+			line.add(name);
+		}
+
+		if (!empty)
+			line.end();
+	}
+
+	out << "End\n";
+}
+
+////////////////
+// MPS format //
+////////////////
+
+static const char*
+mpsNumber(double value, char* buffer) {
+
+	if (std::isinf(value))
+		value = (value < 0 ? -FileInfinity : FileInfinity);
+
+	return number(value, buffer);
+}
+
+void
+ModelWriter::writeMps(std::ostream& out, const Model& model) {
+
+	char buffer[64];
+
+	const QuadraticObjective&         objective   = model.objective;
+	const LinearConstraintMatrixView& constraints = model.constraints;
+
+	unsigned int n = model.numVariables;
+	unsigned int m = constraints.size();
+
+	out << "NAME          model\n";
+
+	if (objective.getSense() == Maximize)
+		out << "OBJSENSE\n    MAX\n";
+
+	out << "ROWS\n";
+	out << " N  obj\n";
+	for (unsigned int r = 0; r < m; r++) {
+
+		Relation relation = constraints.relations[r];
+		out << " " << (relation == LessEqual ? "L" : (relation == GreaterEqual ? "G" : "E")) << "  c" << r << "\n";
+	}
+
+	// MPS lists the coefficients by columns, transpose the matrix
+
+	std::vector<size_t> offsets(n + 1, 0);
+	for (size_t k = 0; k < constraints.numNonZeros; k++)
+		offsets[constraints.columns[k] + 1]++;
+	for (unsigned int i = 0; i < n; i++)
+		offsets[i + 1] += offsets[i];
+
+	std::vector<unsigned int> rows(constraints.numNonZeros);
+	std::vector<double>       coefs(constraints.numNonZeros);
+	{
+		std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+		for (unsigned int r = 0; r < m; r++)
+			for (size_t k = constraints.rowOffsets[r]; k < constraints.rowOffsets[r + 1]; k++) {
+
+				size_t pos = next[constraints.columns[k]]++;
+				rows[pos]  = r;
+				coefs[pos] = constraints.coefficients[k];
+			}
+	}
+
+	out << "COLUMNS\n";
+
+	bool integerMarker = false;
+	unsigned int numMarkers = 0;
+
+	for (unsigned int i = 0; i < n; i++) {
+
+		bool integer = (model.types[i] != Continuous);
+
+		if (integer != integerMarker) {
+
+			out << "    MARKER" << numMarkers++ << "  'MARKER'  " << (integer ? "'INTORG'" : "'INTEND'") << "\n";
+			integerMarker = integer;
+		}
+
+		double coef = objective.getCoefficients()[i];
+
+		// columns without coefficients are listed with a zero in the
+		// objective
+		if (coef != 0 || offsets[i] == offsets[i + 1])
+			out << "    x" << i << "  obj  " << number(coef, buffer) << "\n";
+
+		for (size_t k = offsets[i]; k < offsets[i + 1]; k++)
+			out << "    x" << i << "  c" << rows[k] << "  " << number(coefs[k], buffer) << "\n";
+	}
+
+	if (integerMarker)
+		out << "    MARKER" << numMarkers++ << "  'MARKER'  'INTEND'\n";
+
+	std::vector<unsigned int>().swap(rows);
+	std::vector<double>().swap(coefs);
+
+	out << "RHS\n";
+
+	// the right hand side of the objective is its negated constant
+	if (objective.getConstant() != 0)
+		out << "    RHS  obj  " << number(-objective.getConstant(), buffer) << "\n";
+
+	for (unsigned int r = 0; r < m; r++)
+		if (constraints.values[r] != 0)
+			out << "    RHS  c" << r << "  " << mpsNumber(constraints.values[r], buffer) << "\n";
+
+	// the default bounds in MPS files are [0, inf)
+
+	out << "BOUNDS\n";
+
+	for (unsigned int i = 0; i < n; i++) {
+
+		double lower = model.lower[i];
+		double upper = model.upper[i];
+
+		if (model.isBinary(i)) {
+
+			out << " BV BND  x" << i << "\n";
+			continue;
+		}
+
+		if (lower == -Infinity && upper == Infinity) {
+
+			out << " FR BND  x" << i << "\n";
+			continue;
+		}
+
+		if (lower == upper) {
+
+			out << " FX BND  x" << i << "  " << number(lower, buffer) << "\n";
+			continue;
+		}
+
+		// a negative upper bound alone makes the lower bound -inf
+		if (lower == -Infinity)
+			out << " MI BND  x" << i << "\n";
+		else if (lower != 0 || upper < 0)
+			out << " LO BND  x" << i << "  " << number(lower, buffer) << "\n";
+
+		if (upper != Infinity)
+			out << " UP BND  x" << i << "  " << number(upper, buffer) << "\n";
+	}
+
+	// the objective is 1/2 x'Qx, with the upper triangle of Q
+	if (objective.numQuadraticTerms() > 0) {
+
+		const std::vector<unsigned int>& qrows   = objective.getQuadraticRows();
+		const std::vector<unsigned int>& qcols   = objective.getQuadraticColumns();
+		const std::vector<double>&       qvalues = objective.getQuadraticValues();
+
+		out << "QUADOBJ\n";
+
+		for (size_t k = 0; k < qvalues.size(); k++) {
+
+			double value = (qrows[k] == qcols[k] ? 2*qvalues[k] : qvalues[k]);
+			out << "    x" << qrows[k] << "  x" << qcols[k] << "  " << number(value, buffer) << "\n";
+		}
+	}
+
+	out << "ENDATA\n";
+}
@@ -0,0 +1,108 @@
+#ifndef INFERENCE_MODEL_WRITER_H__
+#define INFERENCE_MODEL_WRITER_H__
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "LinearConstraintMatrix.h"
+#include "LinearConstraints.h"
+#include "ModelFormat.h"
+#include "QuadraticObjective.h"
+#include "VariableType.h"
+
+/**
+ * Writes models in MPS or LP format, to be read by ModelReader or other
+ * solvers.
+ *
+ * Variables are named x0, x1, ..., constraints c0, c1, ..., and the
+ * objective obj. The bounds of the variables follow the conventions of this
+ * library, i.e., binary variables are in [0,1] and all other variables are
+ * free unless given other bounds, and are written explicitly where they
+ * differ from the conventions of the file format.
+ *
+ * LP files are written row by row. MPS files list the constraint matrix by
+ * columns, which needs a transposed copy of the indices and coefficients of
+ * the matrix:
+ *
+ *   ModelWriter::write("problem.lp", n, Binary, types, objective, constraints);
+ */
+class ModelWriter {
+
+public:
+
+	typedef std::map<unsigned int, std::pair<double, double>> Bounds;
+
+	/**
+	 * Write a problem to a file, the format is taken from the extension.
+	 * Throws an IOError if the file can not be written.
+	 *
+	 * @param filename
+	 *             The file to write.
+	 *
+	 * @param numVariables
+	 *             The number of variables in the problem.
+	 *
+	 * @param defaultVariableType
+	 *             The default type of the variables.
+	 *
+	 * @param specialVariableTypes
+	 *             A map of variable numbers to variable types to override the
+	 *             default.
+	 *
+	 * @param objective
+	 *             The objective, linear or quadratic.
+	 *
+	 * @param constraints
+	 *             The linear constraints.
+	 *
+	 * @param bounds
+	 *             Lower and upper bounds of variables that differ from the
+	 *             defaults of their types.
+	 */
+	static void write(
+			const std::string&                          filename,
+			unsigned int                                numVariables,
+			VariableType                                defaultVariableType,
+			const std::map<unsigned int, VariableType>& specialVariableTypes,
+			const QuadraticObjective&                   objective,
+			const LinearConstraintMatrix&               constraints,
+			const Bounds&                               bounds = Bounds());
+
+	static void write(
+			const std::string&                          filename,
+			unsigned int                                numVariables,
+			VariableType                                defaultVariableType,
+			const std::map<unsigned int, VariableType>& specialVariableTypes,
+			const QuadraticObjective&                   objective,
+			const LinearConstraints&                    constraints,
+			const Bounds&                               bounds = Bounds()) {
+
+		write(filename, numVariables, defaultVariableType, specialVariableTypes, objective, LinearConstraintMatrix(constraints), bounds);
+	}
+
+	/**
+	 * Write a problem to a stream in the given format.
+	 */
+	static void write(
+			std::ostream&                               out,
+			ModelFormat                                 format,
+			unsigned int                                numVariables,
+			VariableType                                defaultVariableType,
+			const std::map<unsigned int, VariableType>& specialVariableTypes,
+			const QuadraticObjective&                   objective,
+			const LinearConstraintMatrix&               constraints,
+			const Bounds&                               bounds = Bounds());
+
+private:
+
+	struct Model;
+
+	static void writeLp(std::ostream& out, const Model& model);
+
+	static void writeMps(std::ostream& out, const Model& model);
+};
+
+#endif // INFERENCE_MODEL_WRITER_H__
+
@@ -0,0 +1,64 @@
+#ifndef INFERENCE_PARALLEL_H__
+#define INFERENCE_PARALLEL_H__
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// the minimal number of constraint rows to process per thread, shared by
+// the constraint containers
+static const size_t RowsPerThread = 10000;
+
+/**
+ * Get the number of threads to use for a parallel loop.
+ *
+ * @param numThreads
+ *             The requested number of threads, 0 to use all hardware threads.
+ *
+ * @param size
+ *             The number of items to process.
+ *
+ * @param grainSize
+ *             The minimal number of items worth a thread of its own.
+ */
+inline unsigned int
+numLoopThreads(unsigned int numThreads, size_t size, size_t grainSize) {
+
+	if (numThreads == 0)
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	size_t maxThreads = std::max<size_t>(1, size/std::max<size_t>(1, grainSize));
+
+	return std::min<size_t>(numThreads, maxThreads);
+}
+
+/**
+ * Split the range [0, size) into contiguous chunks and call f(thread, begin,
+ * end) for each chunk on its own thread. The calling thread processes the
+ * first chunk.
+ *
+ * @return The number of chunks (threads) used, chunk t covers
+ *         [t*size/n, (t+1)*size/n).
+ */
+template <typename F>
+unsigned int
+parallelForChunks(size_t size, unsigned int numThreads, size_t grainSize, F f) {
+
+	unsigned int n = numLoopThreads(numThreads, size, grainSize);
+
+	std::vector<std::thread> threads;
+	threads.reserve(n - 1);
+
+	for (unsigned int t = 1; t < n; t++)
+		threads.emplace_back(f, t, t*size/n, (t + 1)*size/n);
+
+	f(0u, size_t(0), size/n);
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	return n;
+}
+
+#endif // INFERENCE_PARALLEL_H__
+
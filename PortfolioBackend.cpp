@@ -0,0 +1,361 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <limits>
+#include <thread>
+
+#include <boost/timer/timer.hpp>
+#include <boost/chrono.hpp>
+
+#include <util/Logger.h>
+#include "PortfolioBackend.h"
+
+using namespace logger;
+
+LogChannel portfoliolog("portfoliolog", "[PortfolioBackend] ");
+
+// the message of backends that found the optimal solution
+static const std::string OptimalMessage = "Optimal solution found";
+
+// the interval in which interrupts are checked
+static const std::chrono::milliseconds PollInterval(10);
+
+PortfolioBackend::PortfolioBackend() :
+	_sense(Minimize),
+	_numThreads(0),
+	_separatorMutex(std::make_shared<std::mutex>()),
+	_progressState(std::make_shared<ProgressState>()),
+	_winner(-1) {}
+
+void
+PortfolioBackend::addBackend(std::shared_ptr<LinearSolverBackend> backend) {
+
+	_backends.push_back(backend);
+}
+
+void
+PortfolioBackend::initialize(
+		unsigned int numVariables,
+		VariableType variableType) {
+
+	initialize(numVariables, variableType, std::map<unsigned int, VariableType>());
+}
+
+void
+PortfolioBackend::initialize(
+		unsigned int                                numVariables,
+		VariableType                                defaultVariableType,
+		const std::map<unsigned int, VariableType>& specialVariableTypes) {
+
+	if (_backends.empty())
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"no backends were added to the portfolio");
+
+	for (auto& backend : _backends)
+		backend->initialize(numVariables, defaultVariableType, specialVariableTypes);
+}
+
+void
+PortfolioBackend::setObjective(const LinearObjective& objective) {
+
+	_sense = objective.getSense();
+
+	for (auto& backend : _backends)
+		backend->setObjective(objective);
+}
+
+void
+PortfolioBackend::setConstraints(const LinearConstraints& constraints) {
+
+	for (auto& backend : _backends)
+		backend->setConstraints(constraints);
+}
+
+void
+PortfolioBackend::setConstraints(const LinearConstraintMatrix& constraints) {
+
+	for (auto& backend : _backends)
+		backend->setConstraints(constraints);
+}
+
+void
+PortfolioBackend::setConstraints(const LinearConstraintMatrixView& constraints) {
+
+	for (auto& backend : _backends)
+		backend->setConstraints(constraints);
+}
+
+void
+PortfolioBackend::addConstraint(const LinearConstraint& constraint) {
+
+	for (auto& backend : _backends)
+		backend->addConstraint(constraint);
+}
+
+void
+PortfolioBackend::setObjectiveCoefficient(unsigned int varNum, double coef) {
+
+	for (auto& backend : _backends)
+		backend->setObjectiveCoefficient(varNum, coef);
+}
+
+void
+PortfolioBackend::setVariableBounds(unsigned int varNum, double lower, double upper) {
+
+	for (auto& backend : _backends)
+		backend->setVariableBounds(varNum, lower, upper);
+}
+
+void
+PortfolioBackend::setConstraintValue(unsigned int constraint, double value) {
+
+	for (auto& backend : _backends)
+		backend->setConstraintValue(constraint, value);
+}
+
+void
+PortfolioBackend::removeConstraints(const std::vector<unsigned int>& constraints) {
+
+	for (auto& backend : _backends)
+		backend->removeConstraints(constraints);
+}
+
+void
+PortfolioBackend::setStartSolution(const Solution& solution) {
+
+	for (auto& backend : _backends)
+		backend->setStartSolution(solution);
+}
+
+void
+PortfolioBackend::setStartSolution(const std::map<unsigned int, double>& values) {
+
+	for (auto& backend : _backends)
+		backend->setStartSolution(values);
+}
+
+void
+PortfolioBackend::setSeparator(const Separator& separator) {
+
+	Separator serialized;
+
+	if (separator) {
+
+		std::shared_ptr<std::mutex> mutex = _separatorMutex;
+
+		serialized = [separator, mutex](const Solution& candidate, LinearConstraints& violated) {
+
+			std::lock_guard<std::mutex> lock(*mutex);
+			separator(candidate, violated);
+		};
+	}
+
+	for (auto& backend : _backends)
+		backend->setSeparator(serialized);
+}
+
+void
+PortfolioBackend::setProgressCallback(const ProgressCallback& callback) {
+
+	for (unsigned int i = 0; i < _backends.size(); i++) {
+
+		if (!callback) {
+
+			_backends[i]->setProgressCallback(ProgressCallback());
+			continue;
+		}
+
+		std::shared_ptr<ProgressState> state = _progressState;
+
+		_backends[i]->setProgressCallback([callback, state, i](const Progress& progress) {
+
+			std::lock_guard<std::mutex> lock(state->mutex);
+
+			state->progress[i] = progress;
+
+			// the best incumbent and the best bound of all backends
+			double incumbent = state->progress[0].incumbent;
+			double bound     = state->progress[0].bound;
+			for (const Progress& p : state->progress) {
+
+				if (state->sign*p.incumbent < state->sign*incumbent)
+					incumbent = p.incumbent;
+				if (state->sign*p.bound > state->sign*bound)
+					bound = p.bound;
+			}
+
+			callback(Progress(incumbent, bound, progress.time));
+		});
+	}
+}
+
+void
+PortfolioBackend::setTimeout(double timeout) {
+
+	for (auto& backend : _backends)
+		backend->setTimeout(timeout);
+}
+
+void
+PortfolioBackend::setOptimalityGap(double gap, bool absolute) {
+
+	for (auto& backend : _backends)
+		backend->setOptimalityGap(gap, absolute);
+}
+
+void
+PortfolioBackend::setVerbose(bool verbose) {
+
+	for (auto& backend : _backends)
+		backend->setVerbose(verbose);
+}
+
+bool
+PortfolioBackend::solve(Solution& x, std::string& msg) {
+
+	if (_backends.empty())
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"no backends were added to the portfolio");
+
+	SolveScope scope(*this);
+
+	_winner = -1;
+
+	// no backend has a solution or a bound yet
+	{
+		std::lock_guard<std::mutex> lock(_progressState->mutex);
+
+		double infinity = std::numeric_limits<double>::infinity();
+
+		_progressState->sign = (_sense == Minimize ? 1.0 : -1.0);
+		_progressState->progress.assign(
+				_backends.size(),
+				Progress(_progressState->sign*infinity, -_progressState->sign*infinity, 0));
+	}
+
+	// split the threads between the backends, the first ones get the
+	// remainder
+
+	unsigned int numThreads = _numThreads;
+	if (numThreads == 0)
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	unsigned int numRunning = std::min<size_t>(numThreads, _backends.size());
+
+	for (unsigned int i = 0; i < numRunning; i++)
+		_backends[i]->setNumThreads(numThreads/numRunning + (i < numThreads%numRunning ? 1 : 0));
+
+	LOG_USER(portfoliolog)
+			<< "running " << numRunning << " of " << _backends.size()
+			<< " backends on " << numThreads << " threads" << std::endl;
+
+	boost::timer::cpu_timer timer;
+	timer.start();
+
+	std::vector<Solution>           solutions(numRunning);
+	std::vector<std::string>        messages(numRunning);
+	std::vector<char>               solved(numRunning, 0);
+	std::vector<char>               finished(numRunning, 0);
+	std::vector<std::exception_ptr> errors(numRunning);
+
+	std::mutex              mutex;
+	std::condition_variable changed;
+	unsigned int            numFinished = 0;
+	int                     optimal = -1;
+
+	// start the backends before the threads that wait for them, such that
+	// interrupts reach backends whose solver did not start, yet
+	std::vector<std::future<Result>> futures;
+	for (unsigned int i = 0; i < numRunning; i++)
+		futures.push_back(_backends[i]->solveAsync());
+
+	std::vector<std::thread> threads;
+	for (unsigned int i = 0; i < numRunning; i++)
+		threads.emplace_back([&, i]() {
+
+			bool success = false;
+
+			try {
+
+				Result result = futures[i].get();
+
+				solutions[i] = result.solution;
+				messages[i]  = result.message;
+				success      = result.solved;
+
+			} catch (...) {
+
+				errors[i] = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+
+			solved[i]   = success;
+			finished[i] = 1;
+			numFinished++;
+
+			if (success && messages[i] == OptimalMessage && optimal < 0)
+				optimal = i;
+
+			changed.notify_all();
+		});
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		// wait for the first optimal solution
+		while (numFinished < numRunning && optimal < 0 && !interruptRequested())
+			changed.wait_for(lock, PollInterval);
+
+		// interrupt the others
+		for (unsigned int i = 0; i < numRunning; i++)
+			if (!finished[i])
+				_backends[i]->interrupt();
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	boost::chrono::nanoseconds ns(timer.elapsed().system + timer.elapsed().user);
+	double seconds = boost::chrono::duration<double>(ns).count();
+
+	// take the optimal solution, or the best feasible one
+
+	_winner = optimal;
+
+	if (_winner < 0) {
+
+		double sign = (_sense == Minimize ? 1.0 : -1.0);
+
+		for (unsigned int i = 0; i < numRunning; i++)
+			if (solved[i] && (_winner < 0 || sign*solutions[i].getValue() < sign*solutions[_winner].getValue()))
+				_winner = i;
+	}
+
+	if (_winner < 0) {
+
+		for (std::exception_ptr& error : errors)
+			if (error)
+				std::rethrow_exception(error);
+
+		x.setStatistics(solutions[0].getStatistics());
+		x.setTime(seconds);
+		msg = messages[0];
+		return false;
+	}
+
+	LOG_USER(portfoliolog)
+			<< "using the solution of backend " << _winner << ": "
+			<< messages[_winner] << std::endl;
+
+	// the solution carries the statistics of the winner
+	x = solutions[_winner];
+	x.setTime(seconds);
+	msg = messages[_winner];
+
+	return true;
+}
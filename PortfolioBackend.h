@@ -0,0 +1,138 @@
+#ifndef INFERENCE_PORTFOLIO_BACKEND_H__
+#define INFERENCE_PORTFOLIO_BACKEND_H__
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "LinearSolverBackend.h"
+#include "Sense.h"
+
+/**
+ * A backend that solves the same problem with several backends at the same
+ * time, and returns the result of the first one to prove optimality.
+ *
+ * All changes to the problem are forwarded to each backend of the portfolio.
+ * On solve(), every backend is run on a thread of its own. As soon as one of
+ * them finds the optimal solution, the others are interrupted. If none of
+ * them does, e.g., because of a timeout, the best solution found by any of
+ * them is returned.
+ *
+ * The backends can be of different types, or of the same type with
+ * different parameters:
+ *
+ *   CplexBackend::Parameter feasibility;
+ *   feasibility.mipFocus = 1;
+ *
+ *   PortfolioBackend portfolio;
+ *   portfolio.addBackend(std::make_shared<GurobiBackend>());
+ *   portfolio.addBackend(std::make_shared<CplexBackend>(feasibility));
+ *   portfolio.addBackend(std::make_shared<ScipBackend>());
+ *   portfolio.setNumThreads(16);
+ */
+class PortfolioBackend : public LinearSolverBackend {
+
+public:
+
+	PortfolioBackend();
+
+	/**
+	 * Add a backend to the portfolio. Has to be called before initialize().
+	 * If there are less threads than backends, only the backends added first
+	 * are run.
+	 */
+	void addBackend(std::shared_ptr<LinearSolverBackend> backend);
+
+	/**
+	 * @return The number of the backend whose solution was returned by the
+	 *         last call to solve(), in the order they were added, or -1 if
+	 *         none found a solution.
+	 */
+	int getWinner() const { return _winner; }
+
+	///////////////////////////////////
+	// solver backend implementation //
+	///////////////////////////////////
+
+	void initialize(
+			unsigned int numVariables,
+			VariableType variableType);
+
+	void initialize(
+			unsigned int                                numVariables,
+			VariableType                                defaultVariableType,
+			const std::map<unsigned int, VariableType>& specialVariableTypes);
+
+	void setObjective(const LinearObjective& objective);
+
+	void setConstraints(const LinearConstraints& constraints);
+
+	void setConstraints(const LinearConstraintMatrix& constraints);
+
+	void setConstraints(const LinearConstraintMatrixView& constraints);
+
+	void addConstraint(const LinearConstraint& constraint);
+
+	void setObjectiveCoefficient(unsigned int varNum, double coef);
+
+	void setVariableBounds(unsigned int varNum, double lower, double upper);
+
+	void setConstraintValue(unsigned int constraint, double value);
+
+	void removeConstraints(const std::vector<unsigned int>& constraints);
+
+	void setStartSolution(const Solution& solution);
+
+	void setStartSolution(const std::map<unsigned int, double>& values);
+
+	void setSeparator(const Separator& separator);
+
+	void setTimeout(double timeout);
+
+	void setOptimalityGap(double gap, bool absolute=false);
+
+	/**
+	 * Set the number of threads for the whole portfolio, which are split
+	 * between the backends. 0 uses all hardware threads.
+	 */
+	void setNumThreads(unsigned int numThreads) { _numThreads = numThreads; }
+
+	void setVerbose(bool verbose);
+
+	/**
+	 * Set a callback that receives the best incumbent and the best bound over
+	 * all backends of the portfolio.
+	 */
+	void setProgressCallback(const ProgressCallback& callback);
+
+	bool solve(Solution& solution, std::string& message);
+
+private:
+
+	// solve() polls the interrupt flag and forwards it to the backends
+	void interruptSolver() {}
+
+	std::vector<std::shared_ptr<LinearSolverBackend>> _backends;
+
+	Sense _sense;
+
+	unsigned int _numThreads;
+
+	// serializes calls to the separator from the backends
+	std::shared_ptr<std::mutex> _separatorMutex;
+
+	// the last progress of each backend, to combine them
+	struct ProgressState {
+
+		std::mutex            mutex;
+		std::vector<Progress> progress;
+		double                sign;
+	};
+	std::shared_ptr<ProgressState> _progressState;
+
+	int _winner;
+};
+
+#endif // INFERENCE_PORTFOLIO_BACKEND_H__
+
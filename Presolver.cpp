@@ -0,0 +1,659 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <util/Logger.h>
+#include <util/exceptions.h>
+#include "LinearObjective.h"
+#include "Presolver.h"
+
+using namespace logger;
+
+LogChannel presolvelog("presolvelog", "[Presolver] ");
+
+static const double Infinity = std::numeric_limits<double>::infinity();
+
+// rows can be violated by this much before the problem is infeasible
+static const double FeasibilityTolerance = 1e-6;
+
+// rows are redundant if they can be violated by at most this much
+static const double RedundancyTolerance = 1e-9;
+
+// values within this distance of an integer are considered integral
+static const double IntegralityTolerance = 1e-6;
+
+// variables with bounds closer than this are fixed
+static const double FixTolerance = 1e-9;
+
+// bounds from activities are only applied if they improve by more than this
+// (relative to the bound), to not spend passes on tiny improvements
+static const double MinBoundImprovement = 1e-3;
+
+// bounds from activities larger than this are considered numerically useless
+static const double MaxBound = 1e9;
+
+// the maximal number of passes over the rows
+static const unsigned int MaxPasses = 20;
+
+Presolver::Presolver(
+		unsigned int                                numVariables,
+		VariableType                                defaultVariableType,
+		const std::map<unsigned int, VariableType>& specialVariableTypes) :
+	_numVariables(numVariables),
+	_types(numVariables, defaultVariableType),
+	_lower(numVariables),
+	_upper(numVariables),
+	_fixed(numVariables, 0) {
+
+	for (auto& p : specialVariableTypes)
+		if (p.first < _numVariables)
+			_types[p.first] = p.second;
+
+	for (unsigned int i = 0; i < _numVariables; i++) {
+
+		_lower[i] = defaultLowerBound(_types[i]);
+		_upper[i] = defaultUpperBound(_types[i]);
+	}
+}
+
+void
+Presolver::setVariableBounds(unsigned int varNum, double lower, double upper) {
+
+	if (varNum >= _numVariables)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"variable " << varNum << " does not exist");
+
+	_lower[varNum] = lower;
+	_upper[varNum] = upper;
+}
+
+Presolver::Status
+Presolver::presolve(const QuadraticObjective& objective, const LinearConstraintMatrix& constraints) {
+
+	if (objective.size() != _numVariables)
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"objective has " << objective.size() << " coefficients, expected " << _numVariables);
+
+	// the rows as ranges lower <= <a,x> <= upper
+
+	const std::vector<size_t>& offsets = constraints.getRowOffsets();
+
+	_rows.resize(constraints.size());
+	for (unsigned int i = 0; i < constraints.size(); i++) {
+
+		Row& row = _rows[i];
+
+		for (size_t j = offsets[i]; j < offsets[i + 1]; j++) {
+
+			if (constraints.getCoefficients()[j] == 0)
+				continue;
+
+			row.columns.push_back(constraints.getColumns()[j]);
+			row.coefs.push_back(constraints.getCoefficients()[j]);
+		}
+
+		Relation relation = constraints.getRelations()[i];
+		double   value    = constraints.getValues()[i];
+
+		row.lower   = (relation == LessEqual    ? -Infinity : value);
+		row.upper   = (relation == GreaterEqual ?  Infinity : value);
+		row.removed = false;
+	}
+
+	// apply the user bounds, rounded for integers, and fix variables
+
+	for (unsigned int i = 0; i < _numVariables; i++) {
+
+		bool changed;
+		double lower = _lower[i];
+		double upper = _upper[i];
+		_lower[i] = -Infinity;
+		_upper[i] =  Infinity;
+
+		if (!tightenBounds(i, lower, upper, changed))
+			return Infeasible;
+	}
+
+	bool changed = true;
+	for (unsigned int pass = 0; changed && pass < MaxPasses; pass++) {
+
+		changed = false;
+
+		removeFixedColumns();
+
+		if (!removeSmallRows(changed))
+			return Infeasible;
+
+		if (!propagateActivities(changed))
+			return Infeasible;
+	}
+
+	// variables fixed in the last pass can leave empty and singleton rows
+	do {
+
+		changed = false;
+
+		removeFixedColumns();
+
+		if (!removeSmallRows(changed))
+			return Infeasible;
+
+	} while (changed);
+
+	if (!mergeDuplicateRows())
+		return Infeasible;
+
+	if (!fixEmptyColumns(objective))
+		return Unbounded;
+
+	buildReduced(objective);
+
+	LOG_DEBUG(presolvelog)
+			<< "reduced " << _numVariables << " variables and "
+			<< constraints.size() << " constraints to "
+			<< getNumVariables() << " variables and "
+			<< _reducedConstraints.size() << " constraints" << std::endl;
+
+	return Reduced;
+}
+
+void
+Presolver::removeFixedColumns() {
+
+	for (Row& row : _rows) {
+
+		if (row.removed)
+			continue;
+
+		double offset = 0;
+		size_t k = 0;
+
+		for (size_t j = 0; j < row.columns.size(); j++) {
+
+			unsigned int varNum = row.columns[j];
+
+			if (_fixed[varNum]) {
+
+				offset += row.coefs[j]*_lower[varNum];
+				continue;
+			}
+
+			row.columns[k] = varNum;
+			row.coefs[k]   = row.coefs[j];
+			k++;
+		}
+
+		if (k == row.columns.size())
+			continue;
+
+		row.columns.resize(k);
+		row.coefs.resize(k);
+		row.lower -= offset;
+		row.upper -= offset;
+	}
+}
+
+bool
+Presolver::removeSmallRows(bool& changed) {
+
+	for (Row& row : _rows) {
+
+		if (row.removed || row.columns.size() > 1)
+			continue;
+
+		if (row.columns.empty()) {
+
+			if (row.lower > FeasibilityTolerance || row.upper < -FeasibilityTolerance)
+				return false;
+
+		} else {
+
+			// a*x in [lower, upper]
+			double a = row.coefs[0];
+			double lower = (a > 0 ? row.lower : row.upper)/a;
+			double upper = (a > 0 ? row.upper : row.lower)/a;
+
+			if (!tightenBounds(row.columns[0], lower, upper, changed))
+				return false;
+		}
+
+		row.removed = true;
+		changed = true;
+	}
+
+	return true;
+}
+
+bool
+Presolver::propagateActivities(bool& changed) {
+
+	for (Row& row : _rows) {
+
+		if (row.removed)
+			continue;
+
+		size_t n = row.columns.size();
+
+		// the minimal and maximal activity of the row, without infinite
+		// contributions, which are counted separately
+		double minActivity = 0;
+		double maxActivity = 0;
+		unsigned int numMinInfinite = 0;
+		unsigned int numMaxInfinite = 0;
+
+		for (size_t j = 0; j < n; j++) {
+
+			double a = row.coefs[j];
+			double l = _lower[row.columns[j]];
+			double u = _upper[row.columns[j]];
+
+			double minBound = (a > 0 ? l : u);
+			double maxBound = (a > 0 ? u : l);
+
+			if (std::isinf(minBound))
+				numMinInfinite++;
+			else
+				minActivity += a*minBound;
+
+			if (std::isinf(maxBound))
+				numMaxInfinite++;
+			else
+				maxActivity += a*maxBound;
+		}
+
+		if (numMinInfinite == 0 && minActivity > row.upper + FeasibilityTolerance*(1 + std::fabs(row.upper)))
+			return false;
+		if (numMaxInfinite == 0 && maxActivity < row.lower - FeasibilityTolerance*(1 + std::fabs(row.lower)))
+			return false;
+
+		bool lowerRedundant = (row.lower == -Infinity || (numMinInfinite == 0 && minActivity >= row.lower - RedundancyTolerance));
+		bool upperRedundant = (row.upper ==  Infinity || (numMaxInfinite == 0 && maxActivity <= row.upper + RedundancyTolerance));
+
+		if (lowerRedundant && upperRedundant) {
+
+			row.removed = true;
+			changed = true;
+			continue;
+		}
+
+		// a_j*x_j <= upper - (minimal activity of the other variables), and
+		// a_j*x_j >= lower - (maximal activity of the other variables)
+
+		for (size_t j = 0; j < n; j++) {
+
+			unsigned int varNum = row.columns[j];
+			double a = row.coefs[j];
+			double l = _lower[varNum];
+			double u = _upper[varNum];
+
+			double minBound = (a > 0 ? l : u);
+			double maxBound = (a > 0 ? u : l);
+
+			double newLower = -Infinity;
+			double newUpper =  Infinity;
+
+			if (!std::isinf(row.upper)) {
+
+				double rest = Infinity;
+				if (numMinInfinite == 0)
+					rest = minActivity - a*minBound;
+				else if (numMinInfinite == 1 && std::isinf(minBound))
+					rest = minActivity;
+
+				if (!std::isinf(rest)) {
+
+					double bound = (row.upper - rest)/a;
+					if (a > 0)
+						newUpper = bound;
+					else
+						newLower = bound;
+				}
+			}
+
+			if (!std::isinf(row.lower)) {
+
+				double rest = Infinity;
+				if (numMaxInfinite == 0)
+					rest = maxActivity - a*maxBound;
+				else if (numMaxInfinite == 1 && std::isinf(maxBound))
+					rest = maxActivity;
+
+				if (!std::isinf(rest)) {
+
+					double bound = (row.lower - rest)/a;
+					if (a > 0)
+						newLower = std::max(newLower, bound);
+					else
+						newUpper = std::min(newUpper, bound);
+				}
+			}
+
+			// apply only significant and numerically sound improvements
+			bool integer = (_types[varNum] != Continuous);
+
+			if (std::fabs(newLower) > MaxBound ||
+			    (!integer && newLower <= l + MinBoundImprovement*(1 + std::fabs(newLower))))
+				newLower = -Infinity;
+			if (std::fabs(newUpper) > MaxBound ||
+			    (!integer && newUpper >= u - MinBoundImprovement*(1 + std::fabs(newUpper))))
+				newUpper = Infinity;
+
+			if (!tightenBounds(varNum, newLower, newUpper, changed))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+bool
+Presolver::mergeDuplicateRows() {
+
+	// the rows scaled such that their first coefficient is 1, by their
+	// sorted columns and scaled coefficients
+	std::map<std::pair<std::vector<unsigned int>, std::vector<double>>, Row*> rows;
+
+	std::vector<std::pair<unsigned int, double>> entries;
+
+	for (Row& row : _rows) {
+
+		if (row.removed)
+			continue;
+
+		entries.clear();
+		for (size_t j = 0; j < row.columns.size(); j++)
+			entries.push_back(std::make_pair(row.columns[j], row.coefs[j]));
+		std::sort(entries.begin(), entries.end());
+
+		double scale = 1.0/entries[0].second;
+
+		for (size_t j = 0; j < entries.size(); j++) {
+
+			row.columns[j] = entries[j].first;
+			row.coefs[j]   = entries[j].second*scale;
+		}
+
+		double lower = (scale > 0 ? row.lower : row.upper)*scale;
+		double upper = (scale > 0 ? row.upper : row.lower)*scale;
+		row.lower = lower;
+		row.upper = upper;
+
+		auto key = std::make_pair(row.columns, row.coefs);
+		auto it = rows.find(key);
+
+		if (it == rows.end()) {
+
+			rows[key] = &row;
+			continue;
+		}
+
+		Row& first = *it->second;
+
+		first.lower = std::max(first.lower, row.lower);
+		first.upper = std::min(first.upper, row.upper);
+
+		if (first.lower > first.upper + FeasibilityTolerance*(1 + std::fabs(first.upper)))
+			return false;
+
+		if (first.lower > first.upper)
+			first.lower = first.upper;
+
+		row.removed = true;
+	}
+
+	return true;
+}
+
+bool
+Presolver::fixEmptyColumns(const QuadraticObjective& objective) {
+
+	std::vector<char> used(_numVariables, 0);
+
+	for (const Row& row : _rows)
+		if (!row.removed)
+			for (unsigned int varNum : row.columns)
+				used[varNum] = 1;
+
+	for (size_t k = 0; k < objective.numQuadraticTerms(); k++) {
+
+		used[objective.getQuadraticRows()[k]]    = 1;
+		used[objective.getQuadraticColumns()[k]] = 1;
+	}
+
+	double sign = (objective.getSense() == Minimize ? 1.0 : -1.0);
+
+	for (unsigned int i = 0; i < _numVariables; i++) {
+
+		if (used[i] || _fixed[i])
+			continue;
+
+		// the variable only contributes its cost, move it to the best bound
+		double cost = sign*objective.getCoefficients()[i];
+		double value;
+
+		if (cost > 0)
+			value = _lower[i];
+		else if (cost < 0)
+			value = _upper[i];
+		else
+			value = std::min(std::max(0.0, _lower[i]), _upper[i]);
+
+		if (std::isinf(value))
+			return false;
+
+		_lower[i] = value;
+		_upper[i] = value;
+		_fixed[i] = 1;
+	}
+
+	return true;
+}
+
+bool
+Presolver::tightenBounds(unsigned int varNum, double lower, double upper, bool& changed) {
+
+	if (_types[varNum] != Continuous) {
+
+		lower = std::ceil(lower - IntegralityTolerance);
+		upper = std::floor(upper + IntegralityTolerance);
+	}
+
+	if (lower > _lower[varNum]) {
+
+		_lower[varNum] = lower;
+		changed = true;
+	}
+
+	if (upper < _upper[varNum]) {
+
+		_upper[varNum] = upper;
+		changed = true;
+	}
+
+	double& l = _lower[varNum];
+	double& u = _upper[varNum];
+
+	if (l > u + FeasibilityTolerance*(1 + std::fabs(u)))
+		return false;
+
+	if (!_fixed[varNum] && u - l <= FixTolerance) {
+
+		u = l = std::min(l, u);
+		_fixed[varNum] = 1;
+		changed = true;
+	}
+
+	return true;
+}
+
+void
+Presolver::buildReduced(const QuadraticObjective& objective) {
+
+	_reducedVariables.clear();
+	_reducedIndex.assign(_numVariables, -1);
+	_reducedTypes.clear();
+	_reducedLower.clear();
+	_reducedUpper.clear();
+
+	for (unsigned int i = 0; i < _numVariables; i++) {
+
+		if (_fixed[i])
+			continue;
+
+		unsigned int j = _reducedVariables.size();
+
+		_reducedIndex[i] = j;
+		_reducedVariables.push_back(i);
+		_reducedLower.push_back(_lower[i]);
+		_reducedUpper.push_back(_upper[i]);
+
+		if (_types[i] != Continuous)
+			_reducedTypes[j] = _types[i];
+	}
+
+	// the objective, with the fixed variables substituted
+
+	unsigned int n = _reducedVariables.size();
+
+	_reducedObjective = QuadraticObjective(n);
+	_reducedObjective.setSense(objective.getSense());
+
+	double constant = objective.getConstant();
+
+	for (unsigned int i = 0; i < _numVariables; i++) {
+
+		double coef = objective.getCoefficients()[i];
+
+		if (_fixed[i])
+			constant += coef*_lower[i];
+		else
+			_reducedObjective.setCoefficient(_reducedIndex[i], coef);
+	}
+
+	std::vector<unsigned int> rows;
+	std::vector<unsigned int> cols;
+	std::vector<double>       vals;
+
+	for (size_t k = 0; k < objective.numQuadraticTerms(); k++) {
+
+		unsigned int i = objective.getQuadraticRows()[k];
+		unsigned int j = objective.getQuadraticColumns()[k];
+		double       q = objective.getQuadraticValues()[k];
+
+		if (_fixed[i] && _fixed[j]) {
+
+			constant += q*_lower[i]*_lower[j];
+
+		} else if (_fixed[i] || _fixed[j]) {
+
+			unsigned int free  = (_fixed[i] ? j : i);
+			unsigned int fixed = (_fixed[i] ? i : j);
+
+			unsigned int r = _reducedIndex[free];
+			_reducedObjective.setCoefficient(r, _reducedObjective.getCoefficients()[r] + q*_lower[fixed]);
+
+		} else {
+
+			rows.push_back(_reducedIndex[i]);
+			cols.push_back(_reducedIndex[j]);
+			vals.push_back(q);
+		}
+	}
+
+	_reducedObjective.addQuadraticTerms(rows, cols, vals);
+	_reducedObjective.setConstant(constant);
+
+	// the remaining rows, ranges are split into two inequalities
+
+	_reducedConstraints = LinearConstraintMatrix();
+
+	std::vector<unsigned int> columns;
+
+	for (const Row& row : _rows) {
+
+		if (row.removed)
+			continue;
+
+		columns.resize(row.columns.size());
+		for (size_t j = 0; j < row.columns.size(); j++)
+			columns[j] = _reducedIndex[row.columns[j]];
+
+		if (row.lower == row.upper) {
+
+			_reducedConstraints.addRow(columns.size(), columns.data(), row.coefs.data(), Equal, row.lower);
+			continue;
+		}
+
+		if (!std::isinf(row.lower))
+			_reducedConstraints.addRow(columns.size(), columns.data(), row.coefs.data(), GreaterEqual, row.lower);
+		if (!std::isinf(row.upper))
+			_reducedConstraints.addRow(columns.size(), columns.data(), row.coefs.data(), LessEqual, row.upper);
+	}
+
+	_rows.clear();
+}
+
+void
+Presolver::setUp(LinearSolverBackend& backend) const {
+
+	if (_reducedObjective.numQuadraticTerms() > 0)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"the objective is quadratic, use a QuadraticSolverBackend");
+
+	unsigned int n = getNumVariables();
+
+	LinearObjective objective(n);
+	objective.setSense(_reducedObjective.getSense());
+	objective.setConstant(_reducedObjective.getConstant());
+	for (unsigned int i = 0; i < n; i++)
+		objective.setCoefficient(i, _reducedObjective.getCoefficients()[i]);
+
+	backend.initialize(n, Continuous, _reducedTypes);
+	backend.setObjective(objective);
+
+	setUpConstraints(backend);
+}
+
+void
+Presolver::setUp(QuadraticSolverBackend& backend) const {
+
+	backend.initialize(getNumVariables(), Continuous, _reducedTypes);
+	backend.setObjective(_reducedObjective);
+
+	setUpConstraints(backend);
+}
+
+void
+Presolver::setUpConstraints(LinearSolverBackend& backend) const {
+
+	backend.setConstraints(_reducedConstraints);
+
+	// set bounds that differ from the defaults of the variable types
+	for (unsigned int i = 0; i < getNumVariables(); i++) {
+
+		VariableType type = _types[_reducedVariables[i]];
+
+		if (!hasDefaultBounds(type, _reducedLower[i], _reducedUpper[i]))
+			backend.setVariableBounds(i, _reducedLower[i], _reducedUpper[i]);
+	}
+}
+
+void
+Presolver::postsolve(const Solution& reduced, Solution& solution) const {
+
+	if (reduced.size() < getNumVariables())
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"solution has " << reduced.size() << " values, expected " << getNumVariables());
+
+	solution.resize(_numVariables);
+	for (unsigned int i = 0; i < _numVariables; i++)
+		solution[i] = (_reducedIndex[i] >= 0 ? reduced[_reducedIndex[i]] : _lower[i]);
+
+	solution.setValue(reduced.getValue());
+	solution.setTime(reduced.getTime());
+	solution.setStatistics(reduced.getStatistics());
+}
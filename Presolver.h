@@ -0,0 +1,214 @@
+#ifndef INFERENCE_PRESOLVER_H__
+#define INFERENCE_PRESOLVER_H__
+
+#include <map>
+#include <vector>
+
+#include "LinearConstraintMatrix.h"
+#include "LinearConstraints.h"
+#include "LinearSolverBackend.h"
+#include "QuadraticObjective.h"
+#include "QuadraticSolverBackend.h"
+#include "Solution.h"
+#include "VariableType.h"
+
+/**
+ * Reduces a problem before it is handed to a solver backend, and maps
+ * solutions of the reduced problem back to the original variables.
+ *
+ * The following reductions are applied until none of them changes the
+ * problem anymore:
+ *
+ *   - empty rows are checked for feasibility and removed,
+ *   - singleton rows become variable bounds,
+ *   - fixed variables are substituted into the rows and the objective,
+ *   - bounds are tightened with the minimal and maximal activity of the rows,
+ *     rows that can not be violated within the bounds are removed.
+ *
+ * Afterwards, duplicate rows (equal up to a scale) are merged, and variables
+ * that do not appear in any row or quadratic term are fixed to their best
+ * bound.
+ *
+ * Usage:
+ *
+ *   Presolver presolver(numVariables, Binary);
+ *   if (presolver.presolve(objective, constraints) == Presolver::Reduced) {
+ *
+ *     presolver.setUp(*backend);
+ *     backend->solve(reduced, message);
+ *     presolver.postsolve(reduced, solution);
+ *   }
+ */
+class Presolver {
+
+public:
+
+	enum Status {
+
+		// the problem was reduced, possibly to an empty problem
+		Reduced,
+
+		// the problem has no solution
+		Infeasible,
+
+		// the problem is unbounded or infeasible
+		Unbounded
+	};
+
+	/**
+	 * @param numVariables
+	 *             The number of variables in the original problem.
+	 *
+	 * @param defaultVariableType
+	 *             The type of the variables. Binary variables are bounded by
+	 *             [0,1], all others are unbounded.
+	 *
+	 * @param specialVariableTypes
+	 *             A map of variable numbers to variable types to override the
+	 *             default.
+	 */
+	Presolver(
+			unsigned int                                numVariables,
+			VariableType                                defaultVariableType,
+			const std::map<unsigned int, VariableType>& specialVariableTypes = std::map<unsigned int, VariableType>());
+
+	/**
+	 * Change the bounds of a variable of the original problem, before
+	 * presolve(). Use infinite values for unbounded variables.
+	 */
+	void setVariableBounds(unsigned int varNum, double lower, double upper);
+
+	/**
+	 * Reduce the given problem.
+	 */
+	Status presolve(const QuadraticObjective& objective, const LinearConstraintMatrix& constraints);
+
+	Status presolve(const QuadraticObjective& objective, const LinearConstraints& constraints) {
+
+		return presolve(objective, LinearConstraintMatrix(constraints));
+	}
+
+	/**
+	 * @return The number of variables of the reduced problem. If this is 0,
+	 *         all variables are fixed and postsolve() can be called with an
+	 *         empty solution.
+	 */
+	unsigned int getNumVariables() const { return _reducedVariables.size(); }
+
+	/**
+	 * @return The types of the variables of the reduced problem that are not
+	 *         continuous.
+	 */
+	const std::map<unsigned int, VariableType>& getVariableTypes() const { return _reducedTypes; }
+
+	/**
+	 * @return The bounds of the variables of the reduced problem.
+	 */
+	const std::vector<double>& getLower() const { return _reducedLower; }
+	const std::vector<double>& getUpper() const { return _reducedUpper; }
+
+	/**
+	 * @return The objective of the reduced problem. Its constant includes the
+	 *         contribution of the removed variables, such that the objective
+	 *         values of the reduced and original problem agree.
+	 */
+	const QuadraticObjective& getObjective() const { return _reducedObjective; }
+
+	/**
+	 * @return The constraints of the reduced problem.
+	 */
+	const LinearConstraintMatrix& getConstraints() const { return _reducedConstraints; }
+
+	/**
+	 * Initialize a backend with the reduced problem. The objective has to be
+	 * linear.
+	 */
+	void setUp(LinearSolverBackend& backend) const;
+
+	/**
+	 * Initialize a backend with the reduced problem.
+	 */
+	void setUp(QuadraticSolverBackend& backend) const;
+
+	/**
+	 * Expand a solution of the reduced problem to the variables of the
+	 * original problem.
+	 *
+	 * @param reduced
+	 *             A solution of the reduced problem.
+	 *
+	 * @param solution
+	 *             The solution of the original problem. Takes the objective
+	 *             value and time of reduced.
+	 */
+	void postsolve(const Solution& reduced, Solution& solution) const;
+
+private:
+
+	// a row lower <= <coefs,x> <= upper
+	struct Row {
+
+		std::vector<unsigned int> columns;
+		std::vector<double>       coefs;
+		double                    lower;
+		double                    upper;
+		bool                      removed;
+	};
+
+	// substitute fixed variables into the rows
+	void removeFixedColumns();
+
+	// handle empty and singleton rows, returns false if the problem is
+	// infeasible
+	bool removeSmallRows(bool& changed);
+
+	// tighten bounds and remove redundant rows with the activities of the
+	// rows, returns false if the problem is infeasible
+	bool propagateActivities(bool& changed);
+
+	// merge rows that are equal up to a scale, returns false if the problem
+	// is infeasible
+	bool mergeDuplicateRows();
+
+	// fix variables that appear in no row and no quadratic term, returns
+	// false if the problem is unbounded
+	bool fixEmptyColumns(const QuadraticObjective& objective);
+
+	// intersect the bounds of a variable with [lower, upper], returns false if
+	// they become empty
+	bool tightenBounds(unsigned int varNum, double lower, double upper, bool& changed);
+
+	// create the reduced problem
+	void buildReduced(const QuadraticObjective& objective);
+
+	// set the variables, bounds, and constraints of the reduced problem in a
+	// backend, after initialize() and setObjective()
+	void setUpConstraints(LinearSolverBackend& backend) const;
+
+	unsigned int _numVariables;
+
+	std::vector<VariableType> _types;
+
+	// the bounds of the original variables, tightened during presolve
+	std::vector<double> _lower;
+	std::vector<double> _upper;
+
+	// fixed variables, their value is their lower bound
+	std::vector<char> _fixed;
+
+	std::vector<Row> _rows;
+
+	// the variable of the original problem for each reduced variable, and
+	// the reduced variable for each original one, -1 for fixed variables
+	std::vector<unsigned int> _reducedVariables;
+	std::vector<int>          _reducedIndex;
+
+	std::map<unsigned int, VariableType> _reducedTypes;
+	std::vector<double>                  _reducedLower;
+	std::vector<double>                  _reducedUpper;
+	QuadraticObjective                   _reducedObjective;
+	LinearConstraintMatrix               _reducedConstraints;
+};
+
+#endif // INFERENCE_PRESOLVER_H__
+
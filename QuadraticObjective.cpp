@@ -1,8 +1,13 @@
+#include <algorithm>
+
+#include <util/exceptions.h>
 #include "QuadraticObjective.h"
+#include "Parallel.h"
 
 QuadraticObjective::QuadraticObjective(unsigned int size) :
 	_sense(Minimize),
-	_constant(0) {
+	_constant(0),
+	_numQuadraticVariables(0) {
 
 	resize(size);
 }
@@ -34,20 +39,306 @@ QuadraticObjective::getCoefficients() const {
 void
 QuadraticObjective::setQuadraticCoefficient(unsigned int varNum1, unsigned int varNum2, double coef) {
 
-	if (coef == 0) {
+	_pendingTerms.push_back(makeTerm(varNum1, varNum2, coef, false));
+}
+
+void
+QuadraticObjective::addQuadraticTerms(
+		const std::vector<unsigned int>& rows,
+		const std::vector<unsigned int>& cols,
+		const std::vector<double>&       vals) {
 
-		_quadraticCoefs.erase(_quadraticCoefs.find(std::make_pair(varNum1, varNum2)));
+	if (rows.size() != cols.size() || rows.size() != vals.size())
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"rows, cols, and vals have to have the same size, got "
+				<< rows.size() << ", " << cols.size() << ", and " << vals.size());
 
-	} else {
+	_pendingTerms.reserve(_pendingTerms.size() + vals.size());
 
-		_quadraticCoefs[std::make_pair(varNum1, varNum2)] = coef;
-	}
+	for (size_t k = 0; k < vals.size(); k++)
+		_pendingTerms.push_back(makeTerm(rows[k], cols[k], vals[k], true));
+}
+
+double
+QuadraticObjective::getQuadraticCoefficient(unsigned int varNum1, unsigned int varNum2) const {
+
+	canonicalize();
+
+	if (varNum1 <= varNum2)
+		return find(_upper, varNum1, varNum2);
+	else
+		return find(_lower, varNum2, varNum1);
 }
 
-const std::map<std::pair<unsigned int, unsigned int>, double>&
+std::map<std::pair<unsigned int, unsigned int>, double>
 QuadraticObjective::getQuadraticCoefficients() const {
 
-	return _quadraticCoefs;
+	canonicalize();
+
+	std::map<std::pair<unsigned int, unsigned int>, double> coefs;
+
+	for (size_t k = 0; k < _upper.values.size(); k++)
+		coefs[std::make_pair(_upper.rows[k], _upper.cols[k])] = _upper.values[k];
+	for (size_t k = 0; k < _lower.values.size(); k++)
+		coefs[std::make_pair(_lower.cols[k], _lower.rows[k])] = _lower.values[k];
+
+	return coefs;
+}
+
+QuadraticObjective::QuadraticTerm
+QuadraticObjective::makeTerm(unsigned int varNum1, unsigned int varNum2, double value, bool add) {
+
+	if (varNum1 <= varNum2)
+		return QuadraticTerm{varNum1, varNum2, value, false, add};
+	else
+		return QuadraticTerm{varNum2, varNum1, value, true, add};
+}
+
+void
+QuadraticObjective::merge(Triplets& triplets, const QuadraticTerm* begin, const QuadraticTerm* end) {
+
+	if (begin == end)
+		return;
+
+	size_t numPending = end - begin;
+
+	std::vector<unsigned int> rows;
+	std::vector<unsigned int> cols;
+	std::vector<double>       vals;
+	rows.reserve(triplets.rows.size() + numPending);
+	cols.reserve(triplets.rows.size() + numPending);
+	vals.reserve(triplets.rows.size() + numPending);
+
+	// merge the sorted triplets with the sorted pending changes
+	size_t i = 0;
+	const QuadraticTerm* p = begin;
+	while (i < triplets.rows.size() || p != end) {
+
+		unsigned int row, col;
+		double value = 0;
+
+		bool takeExisting =
+				p == end ||
+				(i < triplets.rows.size() &&
+				 (triplets.rows[i] < p->row ||
+				  (triplets.rows[i] == p->row && triplets.cols[i] <= p->col)));
+
+		if (takeExisting) {
+
+			row   = triplets.rows[i];
+			col   = triplets.cols[i];
+			value = triplets.values[i];
+			i++;
+
+		} else {
+
+			row = p->row;
+			col = p->col;
+		}
+
+		// apply all pending changes to this entry in order
+		for (; p != end && p->row == row && p->col == col; p++) {
+
+			if (p->add)
+				value += p->value;
+			else
+				value = p->value;
+		}
+
+		if (value == 0)
+			continue;
+
+		rows.push_back(row);
+		cols.push_back(col);
+		vals.push_back(value);
+	}
+
+	triplets.rows.swap(rows);
+	triplets.cols.swap(cols);
+	triplets.values.swap(vals);
+}
+
+double
+QuadraticObjective::find(const Triplets& triplets, unsigned int row, unsigned int col) {
+
+	// find the range of the row, then the column within it
+	auto rowRange = std::equal_range(triplets.rows.begin(), triplets.rows.end(), row);
+
+	auto colsBegin = triplets.cols.begin() + (rowRange.first  - triplets.rows.begin());
+	auto colsEnd   = triplets.cols.begin() + (rowRange.second - triplets.rows.begin());
+	auto it = std::lower_bound(colsBegin, colsEnd, col);
+
+	if (it == colsEnd || *it != col)
+		return 0;
+
+	return triplets.values[it - triplets.cols.begin()];
+}
+
+void
+QuadraticObjective::canonicalize() const {
+
+	if (_pendingTerms.empty())
+		return;
+
+	// sort pending changes by entry, keeping the order of changes to the
+	// same entry
+	std::stable_sort(
+			_pendingTerms.begin(),
+			_pendingTerms.end(),
+			[](const QuadraticTerm& a, const QuadraticTerm& b) {
+				if (a.transposed != b.transposed)
+					return b.transposed;
+				return a.row < b.row || (a.row == b.row && a.col < b.col);
+			});
+
+	const QuadraticTerm* begin = _pendingTerms.data();
+	const QuadraticTerm* end   = begin + _pendingTerms.size();
+	const QuadraticTerm* lower = std::find_if(
+			begin,
+			end,
+			[](const QuadraticTerm& term) { return term.transposed; });
+
+	merge(_upper, begin, lower);
+	merge(_lower, lower, end);
+
+	std::vector<QuadraticTerm>().swap(_pendingTerms);
+
+	_numQuadraticVariables = 0;
+
+	// without entries below the diagonal, which is the common case, the
+	// upper triangle is the sum and no second copy of Q is kept
+	if (_lower.values.empty()) {
+
+		_sum = Triplets();
+
+		// entries are stored with row <= col
+		for (unsigned int col : _upper.cols)
+			_numQuadraticVariables = std::max(_numQuadraticVariables, col + 1);
+
+		return;
+	}
+
+	// sum the entries (i,j) and (j,i)
+	_sum.rows.clear();
+	_sum.cols.clear();
+	_sum.values.clear();
+	_sum.rows.reserve(_upper.values.size() + _lower.values.size());
+	_sum.cols.reserve(_upper.values.size() + _lower.values.size());
+	_sum.values.reserve(_upper.values.size() + _lower.values.size());
+
+	size_t u = 0;
+	size_t l = 0;
+	while (u < _upper.values.size() || l < _lower.values.size()) {
+
+		bool takeUpper =
+				l == _lower.values.size() ||
+				(u < _upper.values.size() &&
+				 (_upper.rows[u] < _lower.rows[l] ||
+				  (_upper.rows[u] == _lower.rows[l] && _upper.cols[u] <= _lower.cols[l])));
+		bool takeLower =
+				u == _upper.values.size() ||
+				(l < _lower.values.size() &&
+				 (_lower.rows[l] < _upper.rows[u] ||
+				  (_lower.rows[l] == _upper.rows[u] && _lower.cols[l] <= _upper.cols[u])));
+
+		unsigned int row = takeUpper ? _upper.rows[u] : _lower.rows[l];
+		unsigned int col = takeUpper ? _upper.cols[u] : _lower.cols[l];
+		double value = 0;
+
+		if (takeUpper)
+			value += _upper.values[u++];
+		if (takeLower)
+			value += _lower.values[l++];
+
+		if (value == 0)
+			continue;
+
+		_sum.rows.push_back(row);
+		_sum.cols.push_back(col);
+		_sum.values.push_back(value);
+
+		// entries are stored with row <= col
+		_numQuadraticVariables = std::max(_numQuadraticVariables, col + 1);
+	}
+}
+
+double
+QuadraticObjective::evaluate(const Solution& solution) const {
+
+	canonicalize();
+
+	if (solution.size() < std::max(size(), _numQuadraticVariables))
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"solution has " << solution.size() << " values, expected "
+				<< std::max(size(), _numQuadraticVariables));
+
+	const double* x = solution.getVector().data();
+	const double* a = _coefs.data();
+	size_t n = _coefs.size();
+
+	// linear part, with independent partial sums to allow vectorization
+	double l0 = 0, l1 = 0, l2 = 0, l3 = 0;
+	size_t i = 0;
+	for (; i + 3 < n; i += 4) {
+
+		l0 += a[i]*x[i];
+		l1 += a[i+1]*x[i+1];
+		l2 += a[i+2]*x[i+2];
+		l3 += a[i+3]*x[i+3];
+	}
+	for (; i < n; i++)
+		l0 += a[i]*x[i];
+
+	// quadratic part, one block per row of Q: x_i*sum_j(q_ij*x_j)
+	const Triplets& q = terms();
+	const unsigned int* rows = q.rows.data();
+	const unsigned int* cols = q.cols.data();
+	const double*       vals = q.values.data();
+	size_t numTerms = q.values.size();
+
+	double quadratic = 0;
+	size_t k = 0;
+	while (k < numTerms) {
+
+		unsigned int row = rows[k];
+
+		double q0 = 0, q1 = 0;
+		for (; k + 1 < numTerms && rows[k+1] == row; k += 2) {
+
+			q0 += vals[k]*x[cols[k]];
+			q1 += vals[k+1]*x[cols[k+1]];
+		}
+		if (k < numTerms && rows[k] == row) {
+
+			q0 += vals[k]*x[cols[k]];
+			k++;
+		}
+
+		quadratic += x[row]*(q0 + q1);
+	}
+
+	return _constant + (l0 + l1) + (l2 + l3) + quadratic;
+}
+
+std::vector<double>
+QuadraticObjective::evaluate(
+		const std::vector<Solution>& solutions,
+		unsigned int                 numThreads) const {
+
+	// merge pending terms before the threads read them
+	canonicalize();
+
+	std::vector<double> values(solutions.size());
+
+	parallelForChunks(solutions.size(), numThreads, 1, [&](unsigned int, size_t begin, size_t end) {
+
+		for (size_t s = begin; s < end; s++)
+			values[s] = evaluate(solutions[s]);
+	});
+
+	return values;
 }
 
 void
@@ -73,9 +364,10 @@ std::ostream& operator<<(std::ostream& out, const QuadraticObjective& objective)
 	for (int i = 0; i < objective.size(); i++)
 		out << objective.getCoefficients()[i] << "*" << i << " ";
 
-	typedef std::map<std::pair<unsigned int, unsigned int>, double>::value_type pair_t;
-	for (pair_t p : objective.getQuadraticCoefficients())
-		out << p.second << "*" << p.first.first << "*" << p.first.second << " ";
+	for (size_t k = 0; k < objective.numQuadraticTerms(); k++)
+		out << objective.getQuadraticValues()[k] << "*"
+			<< objective.getQuadraticRows()[k] << "*"
+			<< objective.getQuadraticColumns()[k] << " ";
 
 	return out;
 }
@@ -7,6 +7,7 @@
 #include <ostream>
 
 #include "Sense.h"
+#include "Solution.h"
 
 class QuadraticObjective {
 
@@ -48,8 +49,11 @@ public:
 	const std::vector<double>& getCoefficients() const;
 
 	/**
-	 * Add a quadratic coefficient. Use this to fill the Q matrix in the
-	 * objective <a,x> + xQx.
+	 * Set a quadratic coefficient. Use this to fill the Q matrix in the
+	 * objective <a,x> + xQx. (i,j) and (j,i) are separate entries of Q that
+	 * both contribute to the term x_i*x_j, i.e., for a symmetric Q both have
+	 * to be set. Setting a coefficient replaces the previous value of this
+	 * entry, setting it to zero removes the entry.
 	 *
 	 * @param varNum1 The row of Q.
 	 * @param varNum2 The columnt of Q.
@@ -58,12 +62,85 @@ public:
 	void setQuadraticCoefficient(unsigned int varNum1, unsigned int varNum2, double coef);
 
 	/**
-	 * Get the quadratic coefficients of this objective as a map of pairs of variable
-	 * numbers to coefficient values.
+	 * Add a list of quadratic terms vals[k]*x_rows[k]*x_cols[k] to the
+	 * objective, i.e., add vals[k] to the entry (rows[k],cols[k]) of Q.
+	 *
+	 * @param rows The rows of Q.
+	 * @param cols The columns of Q.
+	 * @param vals The values to add to Q.
+	 */
+	void addQuadraticTerms(
+			const std::vector<unsigned int>& rows,
+			const std::vector<unsigned int>& cols,
+			const std::vector<double>&       vals);
+
+	/**
+	 * Get a quadratic coefficient.
+	 *
+	 * @return The entry (i,j) of Q, without the entry (j,i).
+	 */
+	double getQuadraticCoefficient(unsigned int varNum1, unsigned int varNum2) const;
+
+	/**
+	 * Get the entries of Q as a map from pairs of variable numbers to
+	 * coefficient values.
+	 *
+	 * @deprecated This copies all entries. Use getQuadraticRows(),
+	 *             getQuadraticColumns(), and getQuadraticValues() instead.
 	 *
 	 * @return A map from pairs of variable numbers to coefficient values.
 	 */
-	const std::map<std::pair<unsigned int, unsigned int>, double>& getQuadraticCoefficients() const;
+	std::map<std::pair<unsigned int, unsigned int>, double> getQuadraticCoefficients() const;
+
+	/**
+	 * @return The number of non-zero quadratic terms.
+	 */
+	size_t numQuadraticTerms() const { return terms().values.size(); }
+
+	/**
+	 * Get the rows of the quadratic terms. Together with getQuadraticColumns()
+	 * and getQuadraticValues(), these arrays describe xQx as a list of
+	 * triplets (i,j,q) with i <= j, sorted by i and j, without duplicates or
+	 * zeros. For i < j, q is the sum of the entries (i,j) and (j,i) of Q.
+	 *
+	 * Accessing the quadratic terms merges pending changes made through
+	 * setQuadraticCoefficient() and addQuadraticTerms(). Therefore, these
+	 * methods must not be called concurrently with each other unless the
+	 * objective was accessed once after the last change.
+	 */
+	const std::vector<unsigned int>& getQuadraticRows() const { return terms().rows; }
+
+	/**
+	 * @return The columns of the quadratic terms, see getQuadraticRows().
+	 */
+	const std::vector<unsigned int>& getQuadraticColumns() const { return terms().cols; }
+
+	/**
+	 * @return The values of the quadratic terms, see getQuadraticRows().
+	 */
+	const std::vector<double>& getQuadraticValues() const { return terms().values; }
+
+	/**
+	 * Compute the value of this objective for a solution, i.e., the constant
+	 * plus <a,x> + xQx.
+	 *
+	 * @param solution The solution x to evaluate, with a value for each
+	 *                 variable of this objective.
+	 * @return The value of the objective.
+	 */
+	double evaluate(const Solution& solution) const;
+
+	/**
+	 * Compute the values of this objective for several solutions in parallel.
+	 *
+	 * @param solutions The solutions to evaluate.
+	 * @param numThreads The number of threads to use, 0 for all hardware
+	 *                   threads.
+	 * @return The value of the objective for each solution.
+	 */
+	std::vector<double> evaluate(
+			const std::vector<Solution>& solutions,
+			unsigned int                 numThreads = 0) const;
 
 	/**
 	 * Set the sense of the objective.
@@ -102,7 +179,58 @@ private:
 	// linear coefficients are assumed to be dense, therefore we use a vector
 	std::vector<double> _coefs;
 
-	std::map<std::pair<unsigned int, unsigned int>, double> _quadraticCoefs;
+	// a pending change to the quadratic terms
+	struct QuadraticTerm {
+
+		unsigned int row;
+		unsigned int col;
+		double       value;
+
+		// the change is for the entry (col,row) of Q, with col > row
+		bool         transposed;
+
+		// add the value to the coefficient instead of replacing it
+		bool         add;
+	};
+
+	// sorted upper triangular triplets
+	struct Triplets {
+
+		std::vector<unsigned int> rows;
+		std::vector<unsigned int> cols;
+		std::vector<double>       values;
+	};
+
+	// create a pending change for the entry (varNum1,varNum2) of Q
+	static QuadraticTerm makeTerm(unsigned int varNum1, unsigned int varNum2, double value, bool add);
+
+	// apply sorted pending changes to triplets
+	static void merge(Triplets& triplets, const QuadraticTerm* begin, const QuadraticTerm* end);
+
+	// get the value of the triplet (row,col), or zero
+	static double find(const Triplets& triplets, unsigned int row, unsigned int col);
+
+	// merge pending changes into the sorted triplets
+	void canonicalize() const;
+
+	// the sum of the entries (i,j) and (j,i) of Q, after merging pending
+	// changes
+	const Triplets& terms() const { canonicalize(); return (_lower.values.empty() ? _upper : _sum); }
+
+	// the entries (i,j) of Q with i <= j, and the entries (j,i) with j > i
+	// transposed
+	mutable Triplets _upper;
+	mutable Triplets _lower;
+
+	// the sum of _upper and _lower, only used if _lower is not empty,
+	// otherwise _upper is the sum
+	mutable Triplets _sum;
+
+	// one more than the highest variable in the quadratic terms
+	mutable unsigned int _numQuadraticVariables;
+
+	// changes to the quadratic terms that have not been merged, yet
+	mutable std::vector<QuadraticTerm> _pendingTerms;
 };
 
 std::ostream& operator<<(std::ostream& out, const QuadraticObjective& objective);
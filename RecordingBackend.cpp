@@ -0,0 +1,363 @@
+#include <chrono>
+#include <future>
+
+#include "LinearConstraintMatrix.h"
+#include "LinearObjective.h"
+#include "RecordingBackend.h"
+#include "Timing.h"
+
+static_assert(sizeof(VariableType) == sizeof(int32_t), "variable types have to be 32 bit");
+static_assert(sizeof(Relation) == sizeof(int32_t), "relations have to be 32 bit");
+static_assert(sizeof(Sense) == sizeof(int32_t), "senses have to be 32 bit");
+
+static void
+recordObjective(TraceWriter::Record& record, const QuadraticObjective& objective) {
+
+	record.put<int32_t>(objective.getSense());
+	record.put<double>(objective.getConstant());
+	record.put<uint32_t>(objective.size());
+	record.putArray(objective.getCoefficients().data(), objective.size());
+}
+
+RecordingBackend::RecordingBackend(
+		std::shared_ptr<LinearSolverBackend> backend,
+		const std::string&                   filename) :
+	_backend(backend),
+	_quadraticBackend(std::dynamic_pointer_cast<QuadraticSolverBackend>(backend)),
+	_writer(filename) {
+
+	if (!_backend)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"no backend given to record");
+}
+
+void
+RecordingBackend::initialize(
+		unsigned int numVariables,
+		VariableType variableType) {
+
+	initialize(numVariables, variableType, std::map<unsigned int, VariableType>());
+}
+
+void
+RecordingBackend::initialize(
+		unsigned int                                numVariables,
+		VariableType                                defaultVariableType,
+		const std::map<unsigned int, VariableType>& specialVariableTypes) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->initialize(numVariables, defaultVariableType, specialVariableTypes);
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	record.put<uint32_t>(numVariables);
+	record.put<int32_t>(defaultVariableType);
+	record.put<uint32_t>(specialVariableTypes.size());
+	for (auto& p : specialVariableTypes) {
+
+		record.put<uint32_t>(p.first);
+		record.put<int32_t>(p.second);
+	}
+
+	_writer.write(TraceInitialize, seconds, record);
+}
+
+void
+RecordingBackend::setObjective(const LinearObjective& objective) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setObjective(objective);
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	recordObjective(record, objective);
+
+	_writer.write(TraceSetObjective, seconds, record);
+}
+
+void
+RecordingBackend::setObjective(const QuadraticObjective& objective) {
+
+	if (!_quadraticBackend)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"the recorded backend is not a QuadraticSolverBackend");
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_quadraticBackend->setObjective(objective);
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	recordObjective(record, objective);
+
+	size_t numTerms = objective.numQuadraticTerms();
+	record.put<uint64_t>(numTerms);
+	record.putArray(objective.getQuadraticRows().data(), numTerms);
+	record.putArray(objective.getQuadraticColumns().data(), numTerms);
+	record.putArray(objective.getQuadraticValues().data(), numTerms);
+
+	_writer.write(TraceSetQuadraticObjective, seconds, record);
+}
+
+void
+RecordingBackend::setConstraints(const LinearConstraints& constraints) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setConstraints(constraints);
+	double seconds = secondsSince(start);
+
+	LinearConstraintMatrix matrix(constraints);
+	recordConstraints(TraceLinearConstraints, matrix.view(), seconds);
+}
+
+void
+RecordingBackend::setConstraints(const LinearConstraintMatrix& constraints) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setConstraints(constraints);
+	double seconds = secondsSince(start);
+
+	recordConstraints(TraceLinearConstraintMatrix, constraints.view(), seconds);
+}
+
+void
+RecordingBackend::setConstraints(const LinearConstraintMatrixView& constraints) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setConstraints(constraints);
+	double seconds = secondsSince(start);
+
+	recordConstraints(TraceLinearConstraintMatrixView, constraints, seconds);
+}
+
+void
+RecordingBackend::recordConstraints(
+		TraceConstraintsType              type,
+		const LinearConstraintMatrixView& constraints,
+		double                            seconds) {
+
+	TraceWriter::Record record;
+	record.put<uint8_t>(type);
+	record.put<uint32_t>(constraints.numRows);
+	record.put<uint64_t>(constraints.numNonZeros);
+	for (unsigned int i = 0; i <= constraints.numRows; i++)
+		record.put<uint64_t>(constraints.rowOffsets[i]);
+	record.putArray(constraints.columns, constraints.numNonZeros);
+	record.putArray(constraints.coefficients, constraints.numNonZeros);
+	record.putArray(constraints.relations, constraints.numRows);
+	record.putArray(constraints.values, constraints.numRows);
+
+	_writer.write(TraceSetConstraints, seconds, record);
+}
+
+void
+RecordingBackend::addConstraint(const LinearConstraint& constraint) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->addConstraint(constraint);
+	double seconds = secondsSince(start);
+
+	const std::map<unsigned int, double>& coefs = constraint.getCoefficients();
+
+	TraceWriter::Record record;
+	record.put<uint32_t>(coefs.size());
+	for (auto& p : coefs)
+		record.put<uint32_t>(p.first);
+	for (auto& p : coefs)
+		record.put<double>(p.second);
+	record.put<int32_t>(constraint.getRelation());
+	record.put<double>(constraint.getValue());
+
+	_writer.write(TraceAddConstraint, seconds, record);
+}
+
+void
+RecordingBackend::setObjectiveCoefficient(unsigned int varNum, double coef) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setObjectiveCoefficient(varNum, coef);
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	record.put<uint32_t>(varNum);
+	record.put<double>(coef);
+
+	_writer.write(TraceSetObjectiveCoefficient, seconds, record);
+}
+
+void
+RecordingBackend::setVariableBounds(unsigned int varNum, double lower, double upper) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setVariableBounds(varNum, lower, upper);
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	record.put<uint32_t>(varNum);
+	record.put<double>(lower);
+	record.put<double>(upper);
+
+	_writer.write(TraceSetVariableBounds, seconds, record);
+}
+
+void
+RecordingBackend::setConstraintValue(unsigned int constraint, double value) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setConstraintValue(constraint, value);
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	record.put<uint32_t>(constraint);
+	record.put<double>(value);
+
+	_writer.write(TraceSetConstraintValue, seconds, record);
+}
+
+void
+RecordingBackend::removeConstraints(const std::vector<unsigned int>& constraints) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->removeConstraints(constraints);
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	record.put<uint32_t>(constraints.size());
+	record.putArray(constraints.data(), constraints.size());
+
+	_writer.write(TraceRemoveConstraints, seconds, record);
+}
+
+void
+RecordingBackend::setStartSolution(const Solution& solution) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setStartSolution(solution);
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	record.put<uint8_t>(1);
+	record.put<uint32_t>(solution.size());
+	for (unsigned int i = 0; i < solution.size(); i++)
+		record.put<uint32_t>(i);
+	record.putArray(solution.getVector().data(), solution.size());
+
+	_writer.write(TraceSetStartSolution, seconds, record);
+}
+
+void
+RecordingBackend::setStartSolution(const std::map<unsigned int, double>& values) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setStartSolution(values);
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	record.put<uint8_t>(0);
+	record.put<uint32_t>(values.size());
+	for (auto& p : values)
+		record.put<uint32_t>(p.first);
+	for (auto& p : values)
+		record.put<double>(p.second);
+
+	_writer.write(TraceSetStartSolution, seconds, record);
+}
+
+void
+RecordingBackend::setSeparator(const Separator& separator) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setSeparator(separator);
+	double seconds = secondsSince(start);
+
+	_writer.write(TraceSetSeparator, seconds, TraceWriter::Record());
+}
+
+void
+RecordingBackend::setTimeout(double timeout) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setTimeout(timeout);
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	record.put<double>(timeout);
+
+	_writer.write(TraceSetTimeout, seconds, record);
+}
+
+void
+RecordingBackend::setOptimalityGap(double gap, bool absolute) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setOptimalityGap(gap, absolute);
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	record.put<double>(gap);
+	record.put<uint8_t>(absolute);
+
+	_writer.write(TraceSetOptimalityGap, seconds, record);
+}
+
+void
+RecordingBackend::setNumThreads(unsigned int numThreads) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setNumThreads(numThreads);
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	record.put<uint32_t>(numThreads);
+
+	_writer.write(TraceSetNumThreads, seconds, record);
+}
+
+void
+RecordingBackend::setVerbose(bool verbose) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	_backend->setVerbose(verbose);
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	record.put<uint8_t>(verbose);
+
+	_writer.write(TraceSetVerbose, seconds, record);
+}
+
+bool
+RecordingBackend::solve(Solution& solution, std::string& message) {
+
+	SolveScope scope(*this);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// solve asynchronously, such that interrupts reach the backend before
+	// its solve() started
+	std::future<Result> future = _backend->solveAsync();
+	if (interruptRequested())
+		_backend->interrupt();
+
+	Result result = future.get();
+	solution = result.solution;
+	message  = result.message;
+	bool solved = result.solved;
+
+	double seconds = secondsSince(start);
+
+	TraceWriter::Record record;
+	record.put<uint8_t>(solved);
+	record.put<double>(solution.getValue());
+	record.put<uint32_t>(solution.size());
+	record.put<uint32_t>(message.size());
+	record.putArray(message.data(), message.size());
+
+	_writer.write(TraceSolve, seconds, record);
+
+	// keep the trace of sessions that do not end cleanly
+	_writer.flush();
+
+	return solved;
+}
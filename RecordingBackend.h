@@ -0,0 +1,113 @@
+#ifndef INFERENCE_RECORDING_BACKEND_H__
+#define INFERENCE_RECORDING_BACKEND_H__
+
+#include <memory>
+#include <string>
+
+#include "BackendTrace.h"
+#include "QuadraticSolverBackend.h"
+
+/**
+ * A backend that forwards all calls to another backend and records them,
+ * with their arguments and wall times, in a trace file. The trace can be
+ * replayed against any backend with TraceReplayer, or the solvers_replay
+ * tool, to reproduce a session offline, including incremental changes to
+ * the problem:
+ *
+ *   SolverFactory factory;
+ *   std::shared_ptr<LinearSolverBackend> backend =
+ *       std::make_shared<RecordingBackend>(
+ *           factory.createLinearSolverBackend(),
+ *           "session.trace");
+ *
+ * Calls are recorded after they returned. Calls that throw, interrupt(), and
+ * setProgressCallback() are forwarded but not recorded. Separators can not
+ * be recorded, only the call to setSeparator() is. The trace is flushed
+ * after each solve().
+ */
+class RecordingBackend : public QuadraticSolverBackend {
+
+public:
+
+	/**
+	 * @param backend
+	 *             The backend to forward the calls to. Quadratic objectives
+	 *             can only be set if it is a QuadraticSolverBackend.
+	 *
+	 * @param filename
+	 *             The trace file to write.
+	 */
+	RecordingBackend(
+			std::shared_ptr<LinearSolverBackend> backend,
+			const std::string&                   filename);
+
+	/**
+	 * @return The backend the calls are forwarded to.
+	 */
+	std::shared_ptr<LinearSolverBackend> getBackend() const { return _backend; }
+
+	///////////////////////////////////
+	// solver backend implementation //
+	///////////////////////////////////
+
+	void initialize(
+			unsigned int numVariables,
+			VariableType variableType);
+
+	void initialize(
+			unsigned int                                numVariables,
+			VariableType                                defaultVariableType,
+			const std::map<unsigned int, VariableType>& specialVariableTypes);
+
+	void setObjective(const LinearObjective& objective);
+
+	void setObjective(const QuadraticObjective& objective);
+
+	void setConstraints(const LinearConstraints& constraints);
+
+	void setConstraints(const LinearConstraintMatrix& constraints);
+
+	void setConstraints(const LinearConstraintMatrixView& constraints);
+
+	void addConstraint(const LinearConstraint& constraint);
+
+	void setObjectiveCoefficient(unsigned int varNum, double coef);
+
+	void setVariableBounds(unsigned int varNum, double lower, double upper);
+
+	void setConstraintValue(unsigned int constraint, double value);
+
+	void removeConstraints(const std::vector<unsigned int>& constraints);
+
+	void setStartSolution(const Solution& solution);
+
+	void setStartSolution(const std::map<unsigned int, double>& values);
+
+	void setSeparator(const Separator& separator);
+
+	void setTimeout(double timeout);
+
+	void setOptimalityGap(double gap, bool absolute=false);
+
+	void setNumThreads(unsigned int numThreads);
+
+	void setVerbose(bool verbose);
+
+	void setProgressCallback(const ProgressCallback& callback) { _backend->setProgressCallback(callback); }
+
+	bool solve(Solution& solution, std::string& message);
+
+private:
+
+	void interruptSolver() { _backend->interrupt(); }
+
+	void recordConstraints(TraceConstraintsType type, const LinearConstraintMatrixView& constraints, double seconds);
+
+	std::shared_ptr<LinearSolverBackend>    _backend;
+	std::shared_ptr<QuadraticSolverBackend> _quadraticBackend;
+
+	TraceWriter _writer;
+};
+
+#endif // INFERENCE_RECORDING_BACKEND_H__
+
@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <chrono>
+
+#include <util/Logger.h>
+#include "RowGenerationSolver.h"
+#include "Timing.h"
+
+using namespace logger;
+
+LogChannel rowgenlog("rowgenlog", "[RowGenerationSolver] ");
+
+RowGenerationSolver::RowGenerationSolver(
+		std::shared_ptr<LinearSolverBackend> backend,
+		const Parameter&                     parameter) :
+	_backend(backend),
+	_parameter(parameter),
+	_nextHandle(0),
+	_dirty(true) {}
+
+void
+RowGenerationSolver::setConstraints(const LinearConstraintMatrix& constraints) {
+
+	_constraints = constraints;
+	_dirty = true;
+}
+
+void
+RowGenerationSolver::setPool(const LinearConstraintMatrix& pool) {
+
+	_pool = pool;
+	_dirty = true;
+}
+
+std::vector<unsigned int>
+RowGenerationSolver::getActive() const {
+
+	std::vector<unsigned int> active;
+	for (unsigned int i = 0; i < _handles.size(); i++)
+		if (_handles[i] >= 0)
+			active.push_back(i);
+
+	return active;
+}
+
+// add the statistics of a round to those of the whole solve
+static void
+addRound(const SolveStatistics& round, SolveStatistics& statistics) {
+
+	for (int phase = 0; phase < SolveStatistics::NumPhases; phase++)
+		statistics.time[phase] += round.time[phase];
+
+	statistics.sense          = round.sense;
+	statistics.numNodes      += round.numNodes;
+	statistics.numIterations += round.numIterations;
+	statistics.primalBound    = round.primalBound;
+	statistics.dualBound      = round.dualBound;
+	statistics.status         = round.status;
+}
+
+bool
+RowGenerationSolver::solve(Solution& solution, std::string& message) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	if (_dirty)
+		reset();
+
+	_rounds.clear();
+
+	unsigned int numActive = 0;
+	for (int handle : _handles)
+		if (handle >= 0)
+			numActive++;
+
+	bool optimal = false;
+
+	// the statistics of the backend over all rounds, the times of the
+	// separation are in the rounds
+	SolveStatistics statistics;
+
+	while (true) {
+
+		Round round = Round();
+		round.numActive = numActive;
+
+		std::chrono::steady_clock::time_point solveStart = std::chrono::steady_clock::now();
+		bool solved = _backend->solve(solution, message);
+		round.solveTime = secondsSince(solveStart);
+		round.value = solution.getValue();
+
+		addRound(solution.getStatistics(), statistics);
+
+		if (!solved) {
+
+			_rounds.push_back(round);
+			break;
+		}
+
+		addViolated(solution, round);
+
+		if (round.numViolated == 0) {
+
+			_rounds.push_back(round);
+			optimal = true;
+			break;
+		}
+
+		if (_parameter.maxRounds > 0 && _rounds.size() + 1 >= _parameter.maxRounds) {
+
+			_rounds.push_back(round);
+			message = "Optimal solution *NOT* found (round limit reached)";
+
+			// the solution violates constraints of the pool, only the
+			// bound of the relaxation holds
+			statistics.status      = SolveStatistics::IterationLimit;
+			statistics.primalBound = SolveStatistics(statistics.sense).primalBound;
+			break;
+		}
+
+		removeSlack(solution, round);
+
+		numActive += round.numAdded;
+		numActive -= round.numRemoved;
+
+		LOG_DEBUG(rowgenlog)
+				<< "round " << _rounds.size() << ": value " << round.value
+				<< ", " << round.numViolated << " violated, "
+				<< round.numAdded << " added, "
+				<< round.numRemoved << " removed" << std::endl;
+
+		_rounds.push_back(round);
+	}
+
+	LOG_USER(rowgenlog)
+			<< _rounds.size() << " rounds, " << numActive << " of "
+			<< _pool.size() << " pool constraints active" << std::endl;
+
+	statistics.peakMemory = SolveStatistics::peakMemoryOfProcess();
+
+	solution.setStatistics(statistics);
+	solution.setTime(secondsSince(start));
+
+	return optimal;
+}
+
+void
+RowGenerationSolver::reset() {
+
+	_backend->setConstraints(_constraints);
+
+	_handles.assign(_pool.size(), -1);
+	_slackRounds.assign(_pool.size(), 0);
+	_nextHandle = _constraints.size();
+	_dirty = false;
+}
+
+void
+RowGenerationSolver::addViolated(const Solution& solution, Round& round) {
+
+	std::chrono::steady_clock::time_point separationStart = std::chrono::steady_clock::now();
+
+	std::vector<ConstraintViolation> violations =
+			_pool.findViolated(solution, _parameter.tolerance, _parameter.numThreads);
+
+	// active constraints can be violated within the tolerances of the
+	// backend, don't count them
+	violations.erase(
+			std::remove_if(
+					violations.begin(),
+					violations.end(),
+					[this](const ConstraintViolation& v) { return _handles[v.constraint] >= 0; }),
+			violations.end());
+
+	round.numViolated = violations.size();
+
+	unsigned int k = _parameter.maxRowsPerRound;
+	if (k > 0 && violations.size() > k) {
+
+		std::nth_element(
+				violations.begin(),
+				violations.begin() + k - 1,
+				violations.end(),
+				[](const ConstraintViolation& a, const ConstraintViolation& b) { return a.amount > b.amount; });
+		violations.resize(k);
+
+		// add in the order of the pool, independent of the selection
+		std::sort(
+				violations.begin(),
+				violations.end(),
+				[](const ConstraintViolation& a, const ConstraintViolation& b) { return a.constraint < b.constraint; });
+	}
+
+	round.separationTime = secondsSince(separationStart);
+
+	std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
+
+	for (const ConstraintViolation& v : violations) {
+
+		_backend->addConstraint(_pool.getConstraint(v.constraint));
+		_handles[v.constraint] = _nextHandle++;
+		_slackRounds[v.constraint] = 0;
+	}
+
+	round.numAdded = violations.size();
+	round.updateTime = secondsSince(updateStart);
+}
+
+void
+RowGenerationSolver::removeSlack(const Solution& solution, Round& round) {
+
+	if (_parameter.dropAfter == 0)
+		return;
+
+	std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
+
+	const std::vector<size_t>&       offsets   = _pool.getRowOffsets();
+	const std::vector<unsigned int>& columns   = _pool.getColumns();
+	const std::vector<double>&       coefs     = _pool.getCoefficients();
+	const std::vector<Relation>&     relations = _pool.getRelations();
+	const std::vector<double>&       values    = _pool.getValues();
+
+	std::vector<unsigned int> remove;
+
+	for (unsigned int i = 0; i < _handles.size(); i++) {
+
+		if (_handles[i] < 0)
+			continue;
+
+		double lhs = 0;
+		for (size_t j = offsets[i]; j < offsets[i + 1]; j++)
+			lhs += coefs[j]*solution[columns[j]];
+
+		bool slack =
+				(relations[i] == LessEqual    && lhs < values[i] - _parameter.tolerance) ||
+				(relations[i] == GreaterEqual && lhs > values[i] + _parameter.tolerance);
+
+		if (!slack) {
+
+			_slackRounds[i] = 0;
+			continue;
+		}
+
+		if (++_slackRounds[i] < _parameter.dropAfter)
+			continue;
+
+		remove.push_back(_handles[i]);
+		_handles[i] = -1;
+		_slackRounds[i] = 0;
+	}
+
+	if (!remove.empty())
+		_backend->removeConstraints(remove);
+
+	round.numRemoved = remove.size();
+	round.updateTime += secondsSince(updateStart);
+}
@@ -0,0 +1,158 @@
+#ifndef INFERENCE_ROW_GENERATION_SOLVER_H__
+#define INFERENCE_ROW_GENERATION_SOLVER_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "LinearConstraintMatrix.h"
+#include "LinearSolverBackend.h"
+#include "Solution.h"
+
+/**
+ * Solves problems with a large pool of constraints, of which only few are
+ * expected to be active at the optimum, by row generation: the problem is
+ * solved with a small active set of constraints, the pool is checked for
+ * constraints violated by the solution, the most violated ones are added to
+ * the active set, and the problem is solved again, until no constraint of the
+ * pool is violated.
+ *
+ * Rows are added to and removed from the backend incrementally, the pool is
+ * never loaded into the backend as a whole.
+ */
+class RowGenerationSolver {
+
+public:
+
+	struct Parameter {
+
+		Parameter() :
+			maxRowsPerRound(100),
+			dropAfter(0),
+			tolerance(1e-6),
+			maxRounds(0),
+			numThreads(0) {}
+
+		// the number of most violated constraints to add per round, 0 to
+		// add all violated constraints
+		unsigned int maxRowsPerRound;
+
+		// remove active constraints that were not tight for this many rounds
+		// in a row, 0 to keep all active constraints
+		unsigned int dropAfter;
+
+		// violations up to this amount are tolerated
+		double tolerance;
+
+		// stop after this many rounds, 0 for no limit
+		unsigned int maxRounds;
+
+		// the number of threads to search the pool for violated constraints,
+		// 0 for all hardware threads
+		unsigned int numThreads;
+	};
+
+	/**
+	 * Statistics of a single round.
+	 */
+	struct Round {
+
+		// wall-clock seconds to solve, to search the pool for violated
+		// constraints, and to add and remove constraints in the backend
+		double solveTime;
+		double separationTime;
+		double updateTime;
+
+		// the objective value of the solution of this round
+		double value;
+
+		// the number of pool constraints active during the solve
+		unsigned int numActive;
+
+		// the number of pool constraints violated by the solution
+		unsigned int numViolated;
+
+		// the number of pool constraints added and removed after the solve
+		unsigned int numAdded;
+		unsigned int numRemoved;
+	};
+
+	/**
+	 * @param backend
+	 *             The solver backend to use. It has to be initialized and
+	 *             have the objective set.
+	 */
+	RowGenerationSolver(
+			std::shared_ptr<LinearSolverBackend> backend,
+			const Parameter&                     parameter = Parameter());
+
+	/**
+	 * Set the constraints that are part of the problem in every round.
+	 */
+	void setConstraints(const LinearConstraintMatrix& constraints);
+
+	/**
+	 * Set the pool of constraints to add on demand.
+	 */
+	void setPool(const LinearConstraintMatrix& pool);
+
+	void setPool(const LinearConstraints& pool) { setPool(LinearConstraintMatrix(pool)); }
+
+	/**
+	 * Solve the problem with the constraints and all constraints of the pool.
+	 * Subsequent calls start from the active set of the previous call.
+	 *
+	 * @param solution A solution object to write the solution to.
+	 * @param message A status message.
+	 * @return true, if an optimal solution was found that satisfies all
+	 *         constraints of the pool.
+	 */
+	bool solve(Solution& solution, std::string& message);
+
+	/**
+	 * @return The statistics of each round of the last call to solve().
+	 */
+	const std::vector<Round>& getRounds() const { return _rounds; }
+
+	/**
+	 * @return The numbers of the pool constraints in the active set.
+	 */
+	std::vector<unsigned int> getActive() const;
+
+private:
+
+	// set the constraints in the backend, with an empty active set
+	void reset();
+
+	// add the most violated inactive constraints of the pool to the backend
+	void addViolated(const Solution& solution, Round& round);
+
+	// remove active constraints that were not tight for dropAfter rounds
+	void removeSlack(const Solution& solution, Round& round);
+
+	std::shared_ptr<LinearSolverBackend> _backend;
+
+	Parameter _parameter;
+
+	LinearConstraintMatrix _constraints;
+
+	LinearConstraintMatrix _pool;
+
+	// the constraint number of each pool constraint in the backend, -1 for
+	// inactive constraints
+	std::vector<int> _handles;
+
+	// the number of rounds each active constraint was not tight in a row
+	std::vector<unsigned int> _slackRounds;
+
+	// the number of the next constraint added to the backend
+	unsigned int _nextHandle;
+
+	// do the constraints have to be set in the backend again?
+	bool _dirty;
+
+	std::vector<Round> _rounds;
+};
+
+#endif // INFERENCE_ROW_GENERATION_SOLVER_H__
+
@@ -5,9 +5,17 @@
 #ifdef HAVE_SCIP
 
 #include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include <scip/scipdefplugins.h>
 #include <scip/cons_linear.h>
+#if SCIP_VERSION >= 800
+#include <scip/cons_nonlinear.h>
+#else
+#include <scip/cons_quadratic.h>
+#endif
 
 #include <util/Logger.h>
 #include "ScipBackend.h"
@@ -16,11 +24,56 @@ using namespace logger;
 
 LogChannel sciplog("sciplog", "[ScipBackend] ");
 
+// the name of the constraint handler for lazy constraints
+static const char* LazyConshdlrName = "lazy";
+
+// the name of the event handler that reports the progress
+static const char* ProgressEventhdlrName = "progress";
+
+// the events after which the progress is reported and interrupts are checked
+static const SCIP_EVENTTYPE ProgressEvents = SCIP_EVENTTYPE_BESTSOLFOUND | SCIP_EVENTTYPE_NODESOLVED | SCIP_EVENTTYPE_LPSOLVED;
+
 ScipBackend::ScipBackend() :
-		_scip(0) {
+		_scip(0),
+		_objectiveVariable(0),
+		_objectiveConstraint(0),
+		_lazyConstraint(0),
+		_lastIncumbent(0),
+		_lastBound(0),
+		_partialStart(false) {
 
 	SCIP_CALL_ABORT(SCIPcreate(&_scip));
 	SCIP_CALL_ABORT(SCIPincludeDefaultPlugins(_scip));
+
+	// enforce lazy constraints after all other constraints, including
+	// integrality
+	SCIP_CONSHDLR* conshdlr;
+	SCIP_CALL_ABORT(SCIPincludeConshdlrBasic(
+			_scip,
+			&conshdlr,
+			LazyConshdlrName,
+			"lazy constraints found by a separator",
+			-9999999 /* enforcement priority */,
+			-9999999 /* check priority */,
+			-1 /* never check eagerly */,
+			TRUE /* only active if the problem has its constraint */,
+			lazyEnfolp,
+			lazyEnfops,
+			lazyCheck,
+			lazyLock,
+			reinterpret_cast<SCIP_CONSHDLRDATA*>(this)));
+
+	SCIP_EVENTHDLR* eventhdlr;
+	SCIP_CALL_ABORT(SCIPincludeEventhdlrBasic(
+			_scip,
+			&eventhdlr,
+			ProgressEventhdlrName,
+			"reports the progress to the progress callback and stops interrupted solves",
+			progressExec,
+			reinterpret_cast<SCIP_EVENTHDLRDATA*>(this)));
+	SCIP_CALL_ABORT(SCIPsetEventhdlrInit(_scip, eventhdlr, progressInit));
+	SCIP_CALL_ABORT(SCIPsetEventhdlrExit(_scip, eventhdlr, progressExit));
+
 	SCIP_CALL_ABORT(SCIPcreateProbBasic(_scip, "problem"));
 }
 
@@ -30,6 +83,10 @@ ScipBackend::~ScipBackend() {
 
 	freeVariables();
 	freeConstraints();
+	freeQuadraticObjective();
+
+	if (_lazyConstraint != 0)
+		SCIP_CALL_ABORT(SCIPreleaseCons(_scip, &_lazyConstraint));
 
 	if (_scip != 0)
 		SCIP_CALL_ABORT(SCIPfree(&_scip));
@@ -49,6 +106,8 @@ ScipBackend::initialize(
 		VariableType                                defaultVariableType,
 		const std::map<unsigned int, VariableType>& specialVariableTypes) {
 
+	SolveStatistics::Timer timer(_buildTime);
+
 	if (sciplog.getLogLevel() >= Debug)
 		setVerbose(true);
 	else
@@ -56,8 +115,21 @@ ScipBackend::initialize(
 
 	_numVariables = numVariables;
 
-	// delete previous variables
+	// start from an empty problem, to reuse the SCIP instance with its
+	// plugins for a new problem
 	freeVariables();
+	freeConstraints();
+	freeQuadraticObjective();
+	if (_lazyConstraint != 0)
+		SCIP_CALL_ABORT(SCIPreleaseCons(_scip, &_lazyConstraint));
+	_startVariables.clear();
+	_startValues.clear();
+
+	SCIP_CALL_ABORT(SCIPfreeProb(_scip));
+	SCIP_CALL_ABORT(SCIPcreateProbBasic(_scip, "problem"));
+
+	// the new problem needs its own lazy constraint
+	setSeparator(_separator);
 
 	LOG_DEBUG(sciplog) << "creating " << _numVariables << " variables" << std::endl;
 
@@ -85,12 +157,16 @@ ScipBackend::initialize(
 void
 ScipBackend::setObjective(const LinearObjective& objective) {
 
+	SolveStatistics::Timer timer(_buildTime);
+
 	setObjective((QuadraticObjective)objective);
 }
 
 void
 ScipBackend::setObjective(const QuadraticObjective& objective) {
 
+	SolveStatistics::Timer timer(_buildTime);
+
 	LOG_ALL(sciplog) << "setting objective sense" << std::endl;
 
 	// set sense of objective
@@ -110,21 +186,122 @@ ScipBackend::setObjective(const QuadraticObjective& objective) {
 
 	for (unsigned int i = 0; i < _numVariables; i++) {
 
+		// change only coefficients that differ from the previous objective
+		if (SCIPvarGetObj(_variables[i]) == objective.getCoefficients()[i])
+			continue;
+
 		LOG_ALL(sciplog) << "setting objective value of var " << i << " to " << objective.getCoefficients()[i] << std::endl;
 		SCIP_CALL_ABORT(SCIPchgVarObj(_scip, _variables[i], objective.getCoefficients()[i]));
 	}
 
-	if (objective.getQuadraticCoefficients().size() > 0)
-		UTIL_THROW_EXCEPTION(
-				NotYetImplemented,
-				"Quadratic objectives are not yet implemented for SCIP. "
-				"You can do so by converting min xQx into min z s.t. z >= xQx");
+	setQuadraticObjective(objective);
+}
+
+void
+ScipBackend::setQuadraticObjective(const QuadraticObjective& objective) {
+
+	// remove the quadratic part of a previous objective
+	if (_objectiveConstraint != 0) {
+
+		SCIP_CALL_ABORT(SCIPdelCons(_scip, _objectiveConstraint));
+		SCIP_CALL_ABORT(SCIPreleaseCons(_scip, &_objectiveConstraint));
+		_objectiveConstraint = 0;
+	}
+
+	_quadraticRows   = objective.getQuadraticRows();
+	_quadraticCols   = objective.getQuadraticColumns();
+	_quadraticValues = objective.getQuadraticValues();
+
+	if (objective.numQuadraticTerms() == 0) {
+
+		if (_objectiveVariable != 0)
+			SCIP_CALL_ABORT(SCIPchgVarObj(_scip, _objectiveVariable, 0));
+
+		return;
+	}
+
+	LOG_DEBUG(sciplog) << "setting " << objective.numQuadraticTerms() << " quadratic coefficients" << std::endl;
+
+	// SCIP supports only linear objectives: min <a,x> + xQx becomes
+	// min <a,x> + z s.t. xQx - z <= 0 (>= 0 for maximization)
+
+	if (_objectiveVariable == 0) {
+
+		SCIP_CALL_ABORT(SCIPcreateVarBasic(
+				_scip,
+				&_objectiveVariable,
+				"quadratic_objective",
+				-SCIPinfinity(_scip),
+				SCIPinfinity(_scip),
+				1 /* obj */,
+				SCIP_VARTYPE_CONTINUOUS));
+		SCIP_CALL_ABORT(SCIPaddVar(_scip, _objectiveVariable));
+
+	} else {
+
+		SCIP_CALL_ABORT(SCIPchgVarObj(_scip, _objectiveVariable, 1));
+	}
+
+	std::vector<SCIP_VAR*> quadVars1(_quadraticRows.size());
+	std::vector<SCIP_VAR*> quadVars2(_quadraticRows.size());
+	for (size_t k = 0; k < _quadraticRows.size(); k++) {
+
+		quadVars1[k] = _variables[_quadraticRows[k]];
+		quadVars2[k] = _variables[_quadraticCols[k]];
+	}
+
+	SCIP_Real linCoef = -1;
+	SCIP_Real lhs = (objective.getSense() == Minimize ? -SCIPinfinity(_scip) : 0);
+	SCIP_Real rhs = (objective.getSense() == Minimize ?  0 : SCIPinfinity(_scip));
+
+#if SCIP_VERSION >= 800
+	SCIP_CALL_ABORT(SCIPcreateConsBasicQuadraticNonlinear(
+#else
+	SCIP_CALL_ABORT(SCIPcreateConsBasicQuadratic(
+#endif
+			_scip,
+			&_objectiveConstraint,
+			"quadratic_objective",
+			1,
+			&_objectiveVariable,
+			&linCoef,
+			_quadraticRows.size(),
+			quadVars1.data(),
+			quadVars2.data(),
+			_quadraticValues.data(),
+			lhs,
+			rhs));
+
+	// keep our reference, to be able to delete the constraint later
+	SCIP_CALL_ABORT(SCIPaddCons(_scip, _objectiveConstraint));
 }
 
 void
 ScipBackend::setConstraints(const LinearConstraints& constraints) {
 
+	SolveStatistics::Timer timer(_buildTime);
+
+	// convert into a CSR matrix first, to avoid per-constraint allocations
+	setConstraints(LinearConstraintMatrix(constraints));
+}
+
+void
+ScipBackend::setConstraints(const LinearConstraintMatrix& constraints) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	setConstraints(constraints.view());
+}
+
+void
+ScipBackend::setConstraints(const LinearConstraintMatrixView& constraints) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
 	// remove previous constraints
+	for (SCIP_CONS* c : _constraints)
+		if (c != 0)
+			SCIP_CALL_ABORT(SCIPdelCons(_scip, c));
 	freeConstraints();
 
 	// allocate memory for new constraints
@@ -132,50 +309,69 @@ ScipBackend::setConstraints(const LinearConstraints& constraints) {
 
 	LOG_DEBUG(sciplog) << "setting " << constraints.size() << " constraints" << std::endl;
 
-	unsigned int j = 0;
-	for (const LinearConstraint& constraint : constraints) {
+	const size_t* offsets = constraints.rowOffsets;
 
-		if (j > 0)
-			if (j % 1000 == 0)
-				LOG_ALL(sciplog) << "" << j << " constraints set so far" << std::endl;
+	// allocate the variable buffer once for the longest constraint
+	size_t maxNonZeros = 0;
+	for (unsigned int i = 0; i < constraints.size(); i++)
+		maxNonZeros = std::max(maxNonZeros, offsets[i+1] - offsets[i]);
+	_consVars.resize(maxNonZeros);
 
-		addConstraint(constraint);
+	for (unsigned int i = 0; i < constraints.size(); i++) {
 
-		j++;
+		// translate variable numbers into SCIP variables
+		for (size_t j = offsets[i]; j < offsets[i+1]; j++)
+			_consVars[j - offsets[i]] = _variables[constraints.columns[j]];
+
+		addConstraint(
+				offsets[i+1] - offsets[i],
+				constraints.coefficients + offsets[i],
+				constraints.relations[i],
+				constraints.values[i]);
 	}
 }
 
 void
 ScipBackend::addConstraint(const LinearConstraint& constraint) {
 
+	SolveStatistics::Timer timer(_buildTime);
+
 	// create a list of variables and their coefficients
-	std::vector<SCIP_VAR*> vars;
-	std::vector<SCIP_Real> coefs;
+	_consVars.clear();
+	_consCoefs.clear();
 	for (auto& p : constraint.getCoefficients()) {
-		vars.push_back(_variables[p.first]);
-		coefs.push_back(p.second);
+		_consVars.push_back(_variables[p.first]);
+		_consCoefs.push_back(p.second);
 	}
 
+	addConstraint(_consVars.size(), _consCoefs.data(), constraint.getRelation(), constraint.getValue());
+}
+
+void
+ScipBackend::addConstraint(
+		size_t        numNonZeros,
+		const double* coefs,
+		Relation      relation,
+		double        value) {
+
 	// create the SCIP constraint lhs <= linear expr <= rhs
 	SCIP_CONS* c;
-	std::string name("c");
-	name += boost::lexical_cast<std::string>(_constraints.size());
 
 	// set lhs and rhs according to constraint relation
-	SCIP_Real lhs = constraint.getValue();
-	SCIP_Real rhs = constraint.getValue();
-	if (constraint.getRelation() == LessEqual)
+	SCIP_Real lhs = value;
+	SCIP_Real rhs = value;
+	if (relation == LessEqual)
 		lhs = -SCIPinfinity(_scip);
-	if (constraint.getRelation() == GreaterEqual)
+	if (relation == GreaterEqual)
 		rhs = SCIPinfinity(_scip);
 
 	SCIP_CALL_ABORT(SCIPcreateConsBasicLinear(
 			_scip,
 			&c,
-			name.c_str(),
-			vars.size(),
-			&vars[0],
-			&coefs[0],
+			"" /* no name, avoids the name hash table */,
+			numNonZeros,
+			&_consVars[0],
+			const_cast<SCIP_Real*>(coefs),
 			lhs,
 			rhs));
 
@@ -185,6 +381,298 @@ ScipBackend::addConstraint(const LinearConstraint& constraint) {
 	SCIP_CALL_ABORT(SCIPreleaseCons(_scip, &c));
 }
 
+void
+ScipBackend::setObjectiveCoefficient(unsigned int varNum, double coef) {
+
+	SCIP_CALL_ABORT(SCIPchgVarObj(_scip, _variables[varNum], coef));
+}
+
+void
+ScipBackend::setVariableBounds(unsigned int varNum, double lower, double upper) {
+
+	SCIP_CALL_ABORT(SCIPchgVarLb(_scip, _variables[varNum], std::max(lower, -SCIPinfinity(_scip))));
+	SCIP_CALL_ABORT(SCIPchgVarUb(_scip, _variables[varNum], std::min(upper,  SCIPinfinity(_scip))));
+}
+
+void
+ScipBackend::setConstraintValue(unsigned int num, double value) {
+
+	SCIP_CONS* c = constraint(num);
+
+	// keep the relation of the constraint
+	if (!SCIPisInfinity(_scip, -SCIPgetLhsLinear(_scip, c)))
+		SCIP_CALL_ABORT(SCIPchgLhsLinear(_scip, c, value));
+	if (!SCIPisInfinity(_scip, SCIPgetRhsLinear(_scip, c)))
+		SCIP_CALL_ABORT(SCIPchgRhsLinear(_scip, c, value));
+}
+
+void
+ScipBackend::removeConstraints(const std::vector<unsigned int>& constraints) {
+
+	SolveStatistics::Timer timer(_buildTime);
+
+	LOG_DEBUG(sciplog) << "removing " << constraints.size() << " constraints" << std::endl;
+
+	for (unsigned int num : constraints) {
+
+		// the problem holds the only reference, the constraint is freed
+		SCIP_CALL_ABORT(SCIPdelCons(_scip, constraint(num)));
+		_constraints[num] = 0;
+	}
+}
+
+SCIP_CONS*
+ScipBackend::constraint(unsigned int num) {
+
+	if (num >= _constraints.size() || _constraints[num] == 0)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"constraint " << num << " does not exist");
+
+	return _constraints[num];
+}
+
+void
+ScipBackend::setStartSolution(const Solution& solution) {
+
+	unsigned int size = std::min(solution.size(), _numVariables);
+
+	_startVariables.resize(size);
+	for (unsigned int i = 0; i < size; i++)
+		_startVariables[i] = i;
+	_startValues.assign(solution.getVector().begin(), solution.getVector().begin() + size);
+	_partialStart = (size < _numVariables);
+}
+
+void
+ScipBackend::setStartSolution(const std::map<unsigned int, double>& values) {
+
+	// the map is sorted, the last variable has the largest number
+	if (!values.empty() && values.rbegin()->first >= _numVariables)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"variable " << values.rbegin()->first << " does not exist");
+
+	_startVariables.clear();
+	_startValues.clear();
+	for (auto& p : values) {
+
+		_startVariables.push_back(p.first);
+		_startValues.push_back(p.second);
+	}
+	_partialStart = (values.size() < _numVariables);
+}
+
+void
+ScipBackend::addStartSolution() {
+
+	LOG_DEBUG(sciplog) << "adding start solution for " << _startVariables.size() << " variables" << std::endl;
+
+	// values of a partial solution that are not given are completed by SCIP
+	SCIP_SOL* sol;
+	if (_partialStart)
+		SCIP_CALL_ABORT(SCIPcreatePartialSol(_scip, &sol, NULL));
+	else
+		SCIP_CALL_ABORT(SCIPcreateSol(_scip, &sol, NULL));
+
+	for (size_t i = 0; i < _startVariables.size(); i++)
+		SCIP_CALL_ABORT(SCIPsetSolVal(_scip, sol, _variables[_startVariables[i]], _startValues[i]));
+
+	// the epigraph variable of a complete solution is z = xQx
+	if (!_partialStart && _objectiveConstraint != 0) {
+
+		double z = 0;
+		for (size_t k = 0; k < _quadraticRows.size(); k++)
+			z += _quadraticValues[k]*_startValues[_quadraticRows[k]]*_startValues[_quadraticCols[k]];
+
+		SCIP_CALL_ABORT(SCIPsetSolVal(_scip, sol, _objectiveVariable, z));
+	}
+
+	SCIP_Bool stored;
+	SCIP_CALL_ABORT(SCIPaddSolFree(_scip, &sol, &stored));
+
+	if (!stored)
+		LOG_DEBUG(sciplog) << "start solution was rejected" << std::endl;
+
+	// the start is used for this solve only
+	_startVariables.clear();
+	_startValues.clear();
+}
+
+void
+ScipBackend::setSeparator(const Separator& separator) {
+
+	_separator = separator;
+
+	if (_separator && _lazyConstraint == 0) {
+
+		// a single constraint of the lazy handler, which activates the
+		// handler and locks all variables, since the lazy constraints are
+		// not known to presolving
+		SCIP_CALL_ABORT(SCIPcreateCons(
+				_scip,
+				&_lazyConstraint,
+				"lazy",
+				SCIPfindConshdlr(_scip, LazyConshdlrName),
+				0 /* no constraint data */,
+				FALSE /* initial */,
+				FALSE /* separate */,
+				TRUE  /* enforce */,
+				TRUE  /* check */,
+				FALSE /* propagate */,
+				FALSE /* local */,
+				FALSE /* modifiable */,
+				FALSE /* dynamic */,
+				FALSE /* removable */,
+				FALSE /* stickingatnode */));
+		SCIP_CALL_ABORT(SCIPaddCons(_scip, _lazyConstraint));
+	}
+
+	if (!_separator && _lazyConstraint != 0) {
+
+		SCIP_CALL_ABORT(SCIPdelCons(_scip, _lazyConstraint));
+		SCIP_CALL_ABORT(SCIPreleaseCons(_scip, &_lazyConstraint));
+	}
+}
+
+SCIP_DECL_CONSENFOLP(ScipBackend::lazyEnfolp) {
+
+	ScipBackend* backend = reinterpret_cast<ScipBackend*>(SCIPconshdlrGetData(conshdlr));
+	return backend->separate(0, true, result);
+}
+
+SCIP_DECL_CONSENFOPS(ScipBackend::lazyEnfops) {
+
+	ScipBackend* backend = reinterpret_cast<ScipBackend*>(SCIPconshdlrGetData(conshdlr));
+	return backend->separate(0, true, result);
+}
+
+SCIP_DECL_CONSCHECK(ScipBackend::lazyCheck) {
+
+	ScipBackend* backend = reinterpret_cast<ScipBackend*>(SCIPconshdlrGetData(conshdlr));
+	return backend->separate(sol, false, result);
+}
+
+SCIP_DECL_CONSLOCK(ScipBackend::lazyLock) {
+
+	ScipBackend* backend = reinterpret_cast<ScipBackend*>(SCIPconshdlrGetData(conshdlr));
+
+	// lazy constraints can involve any variable in any direction
+	for (SCIP_VAR* var : backend->_variables)
+#if SCIP_VERSION >= 600
+		SCIP_CALL(SCIPaddVarLocksType(scip, var, locktype, nlockspos + nlocksneg, nlockspos + nlocksneg));
+#else
+		SCIP_CALL(SCIPaddVarLocks(scip, var, nlockspos + nlocksneg, nlockspos + nlocksneg));
+#endif
+
+	return SCIP_OKAY;
+}
+
+SCIP_DECL_EVENTINIT(ScipBackend::progressInit) {
+
+	SCIP_CALL(SCIPcatchEvent(scip, ProgressEvents, eventhdlr, 0, 0));
+
+	return SCIP_OKAY;
+}
+
+SCIP_DECL_EVENTEXIT(ScipBackend::progressExit) {
+
+	SCIP_CALL(SCIPdropEvent(scip, ProgressEvents, eventhdlr, 0, -1));
+
+	return SCIP_OKAY;
+}
+
+SCIP_DECL_EVENTEXEC(ScipBackend::progressExec) {
+
+	ScipBackend* backend = reinterpret_cast<ScipBackend*>(SCIPeventhdlrGetData(eventhdlr));
+
+	// SCIP drops interrupts that arrive before SCIPsolve(), repeat them from
+	// the solving thread
+	if (backend->interruptRequested())
+		SCIP_CALL(SCIPinterruptSolve(scip));
+
+	if (!backend->_progressCallback)
+		return SCIP_OKAY;
+
+	double incumbent = SCIPgetPrimalbound(scip);
+	double bound     = SCIPgetDualbound(scip);
+
+	if (incumbent == backend->_lastIncumbent && bound == backend->_lastBound)
+		return SCIP_OKAY;
+
+	backend->_lastIncumbent = incumbent;
+	backend->_lastBound     = bound;
+
+	const double infinity = std::numeric_limits<double>::infinity();
+	if (SCIPisInfinity(scip, std::fabs(incumbent)))
+		incumbent = (incumbent > 0 ? infinity : -infinity);
+	if (SCIPisInfinity(scip, std::fabs(bound)))
+		bound = (bound > 0 ? infinity : -infinity);
+
+	backend->_progressCallback(Progress(incumbent, bound, SCIPgetSolvingTime(scip)));
+
+	return SCIP_OKAY;
+}
+
+SCIP_RETCODE
+ScipBackend::separate(SCIP_SOL* sol, bool enforce, SCIP_RESULT* result) {
+
+	*result = SCIP_FEASIBLE;
+
+	if (!_separator)
+		return SCIP_OKAY;
+
+	Solution candidate(_numVariables);
+	for (unsigned int i = 0; i < _numVariables; i++)
+		candidate[i] = SCIPgetSolVal(_scip, sol, _variables[i]);
+
+	LinearConstraints violated;
+	_separator(candidate, violated);
+
+	std::vector<SCIP_VAR*> vars;
+	std::vector<SCIP_Real> coefs;
+
+	for (const LinearConstraint& constraint : violated) {
+
+		if (!constraint.isViolated(candidate, SCIPfeastol(_scip)))
+			continue;
+
+		*result = SCIP_INFEASIBLE;
+
+		if (!enforce)
+			return SCIP_OKAY;
+
+		// the problem is transformed while solving, add the constraint on the
+		// transformed variables
+		vars.clear();
+		coefs.clear();
+		for (auto& p : constraint.getCoefficients()) {
+
+			SCIP_VAR* var;
+			SCIP_CALL(SCIPgetTransformedVar(_scip, _variables[p.first], &var));
+
+			vars.push_back(var);
+			coefs.push_back(p.second);
+		}
+
+		SCIP_Real lhs = constraint.getValue();
+		SCIP_Real rhs = constraint.getValue();
+		if (constraint.getRelation() == LessEqual)
+			lhs = -SCIPinfinity(_scip);
+		if (constraint.getRelation() == GreaterEqual)
+			rhs = SCIPinfinity(_scip);
+
+		SCIP_CONS* c;
+		SCIP_CALL(SCIPcreateConsBasicLinear(_scip, &c, "lazy", vars.size(), vars.data(), coefs.data(), lhs, rhs));
+		SCIP_CALL(SCIPaddCons(_scip, c));
+		SCIP_CALL(SCIPreleaseCons(_scip, &c));
+
+		*result = SCIP_CONSADDED;
+	}
+
+	return SCIP_OKAY;
+}
+
 void
 ScipBackend::setTimeout(double timeout) {
 
@@ -206,27 +694,101 @@ ScipBackend::setNumThreads(unsigned int numThreads) {
 	SCIP_CALL_ABORT(SCIPsetIntParam(_scip, "lp/threads", numThreads));
 }
 
+void
+ScipBackend::interruptSolver() {
+
+	// SCIP can only be interrupted after the problem was transformed for
+	// solving. The solve can leave these stages before SCIPinterruptSolve()
+	// is called, which then fails harmlessly. Interrupts that arrive before
+	// are repeated by the event handler.
+	SCIP_STAGE stage = SCIPgetStage(_scip);
+
+	if (stage >= SCIP_STAGE_TRANSFORMED && stage <= SCIP_STAGE_SOLVING)
+		SCIPinterruptSolve(_scip);
+}
+
 bool
 ScipBackend::solve(Solution& x, std::string& msg) {
 
+	SolveScope scope(*this);
+
 	LOG_ALL(sciplog) << "solving model" << std::endl;
 
+	SolveStatistics& statistics = x.getStatistics();
+	statistics = SolveStatistics(SCIPgetObjsense(_scip) == SCIP_OBJSENSE_MINIMIZE ? Minimize : Maximize);
+	statistics.time[SolveStatistics::Build] = _buildTime;
+	_buildTime = SolveStatistics::Time();
+
+	SolveStatistics::Timer updateTimer(statistics.time[SolveStatistics::Update]);
+
+	if (!_startVariables.empty())
+		addStartSolution();
+
+	updateTimer.stop();
+
+	_lastIncumbent = std::numeric_limits<double>::quiet_NaN();
+	_lastBound     = std::numeric_limits<double>::quiet_NaN();
+
 	boost::timer::cpu_timer timer;
 	timer.start();
 
+	SolveStatistics::Timer presolveTimer(statistics.time[SolveStatistics::Presolve]);
 	SCIP_CALL_ABORT(SCIPpresolve(_scip));
+	presolveTimer.stop();
+
+	SolveStatistics::Timer solveTimer(statistics.time[SolveStatistics::Solve]);
 	SCIP_CALL_ABORT(SCIPsolve(_scip));
+	solveTimer.stop();
 
 	boost::chrono::nanoseconds ns(timer.elapsed().system + timer.elapsed().user);
 	double seconds = boost::chrono::duration<double>(ns).count();
 	x.setTime(seconds);
 
+	readStatistics(statistics);
+
+	SCIP_STATUS status = SCIPgetStatus(_scip);
+
+	std::string reason;
+	switch (status) {
+
+		case SCIP_STATUS_OPTIMAL:
+		case SCIP_STATUS_GAPLIMIT:
+			break;
+		case SCIP_STATUS_INFEASIBLE:
+			reason = "problem is infeasible";
+			break;
+		case SCIP_STATUS_UNBOUNDED:
+			reason = "problem is unbounded";
+			break;
+		case SCIP_STATUS_TIMELIMIT:
+			reason = "timeout";
+			break;
+		case SCIP_STATUS_USERINTERRUPT:
+			reason = "interrupted";
+			break;
+		default:
+			reason = "limit reached";
+	}
+
 	if (SCIPgetNSols(_scip) == 0) {
 
 		msg = "Optimal solution *NOT* found";
+		if (!reason.empty())
+			msg += " (" + reason + ")";
+
+		// go back to the problem stage, to allow changes to the model
+		SCIP_CALL_ABORT(SCIPfreeTransform(_scip));
+
 		return false;
 	}
 
+	if (reason.empty())
+		msg = "Optimal solution found";
+	else
+		msg = "Optimal solution *NOT* found (" + reason + ", feasible solution found)";
+
+	SolveStatistics::Timer extractionTimer(statistics.time[SolveStatistics::Extraction]);
+
 	// extract solution
 	SCIP_SOL* sol = SCIPgetBestSol(_scip);
 
@@ -237,11 +799,59 @@ ScipBackend::solve(Solution& x, std::string& msg) {
 	// get current value of the objective
 	x.setValue(SCIPgetSolOrigObj(_scip, sol));
 
+	extractionTimer.stop();
+
 	SCIP_CALL_ABORT(SCIPfreeTransform(_scip));
 
 	return true;
 }
 
+void
+ScipBackend::readStatistics(SolveStatistics& statistics) {
+
+	switch (SCIPgetStatus(_scip)) {
+
+		case SCIP_STATUS_OPTIMAL:
+		case SCIP_STATUS_GAPLIMIT:
+			statistics.status = SolveStatistics::Optimal;
+			break;
+		case SCIP_STATUS_INFEASIBLE:
+			statistics.status = SolveStatistics::Infeasible;
+			break;
+		case SCIP_STATUS_UNBOUNDED:
+		case SCIP_STATUS_INFORUNBD:
+			statistics.status = SolveStatistics::Unbounded;
+			break;
+		case SCIP_STATUS_TIMELIMIT:
+			statistics.status = SolveStatistics::TimeLimit;
+			break;
+		case SCIP_STATUS_NODELIMIT:
+			statistics.status = SolveStatistics::IterationLimit;
+			break;
+		case SCIP_STATUS_USERINTERRUPT:
+			statistics.status = SolveStatistics::Interrupted;
+			break;
+		default:
+			statistics.status = SolveStatistics::Unknown;
+	}
+
+	statistics.numNodes      = SCIPgetNNodes(_scip);
+	statistics.numIterations = SCIPgetNLPIterations(_scip);
+
+	// SCIP reports infinite bounds as +-SCIPinfinity()
+	double primal = SCIPgetPrimalbound(_scip);
+	double dual   = SCIPgetDualbound(_scip);
+
+	if (SCIPisInfinity(_scip, std::fabs(primal)))
+		primal = (primal > 0 ? 1 : -1)*std::numeric_limits<double>::infinity();
+	if (SCIPisInfinity(_scip, std::fabs(dual)))
+		dual = (dual > 0 ? 1 : -1)*std::numeric_limits<double>::infinity();
+
+	statistics.primalBound = primal;
+	statistics.dualBound   = dual;
+	statistics.peakMemory  = SolveStatistics::peakMemoryOfProcess();
+}
+
 void
 ScipBackend::setVerbose(bool verbose) {
 
@@ -266,6 +876,19 @@ ScipBackend::freeConstraints() {
 	_constraints.clear();
 }
 
+void
+ScipBackend::freeQuadraticObjective() {
+
+	if (_objectiveConstraint != 0)
+		SCIP_CALL_ABORT(SCIPreleaseCons(_scip, &_objectiveConstraint));
+
+	if (_objectiveVariable != 0)
+		SCIP_CALL_ABORT(SCIPreleaseVar(_scip, &_objectiveVariable));
+
+	_objectiveConstraint = 0;
+	_objectiveVariable   = 0;
+}
+
 SCIP_VARTYPE
 ScipBackend::scipVarType(VariableType type, double& lb, double& ub) {
 
@@ -26,6 +26,15 @@
  * inequality constraints and x is the solution vector. a is a real-valued
  * vector denoting the coefficients of the objective and Q a PSD matrix giving
  * the quadratic coefficients of the objective.
+ *
+ * Since SCIP supports linear objectives only, the quadratic part is moved into
+ * a constraint z >= xQx (z <= xQx for maximization) on an auxiliary variable
+ * z, which is added to the objective.
+ *
+ * Lazy constraints are enforced by a constraint handler, which calls the
+ * separator with LP solutions that satisfy all other constraints and with
+ * solutions found by heuristics. Violated constraints are added to the
+ * transformed problem for the rest of the solve.
  */
 class ScipBackend : public QuadraticSolverBackend {
 
@@ -54,14 +63,34 @@ public:
 
 	void setConstraints(const LinearConstraints& constraints);
 
+	void setConstraints(const LinearConstraintMatrix& constraints);
+
+	void setConstraints(const LinearConstraintMatrixView& constraints);
+
 	void addConstraint(const LinearConstraint& constraint);
 
+	void setObjectiveCoefficient(unsigned int varNum, double coef);
+
+	void setVariableBounds(unsigned int varNum, double lower, double upper);
+
+	void setConstraintValue(unsigned int constraint, double value);
+
+	void removeConstraints(const std::vector<unsigned int>& constraints);
+
+	void setStartSolution(const Solution& solution);
+
+	void setStartSolution(const std::map<unsigned int, double>& values);
+
+	void setSeparator(const Separator& separator);
+
 	void setTimeout(double timeout);
 
 	void setOptimalityGap(double gap, bool absolute=false);
 
 	void setNumThreads(unsigned int numThreads);
 
+	void setProgressCallback(const ProgressCallback& callback) { _progressCallback = callback; }
+
 	bool solve(Solution& solution, std::string& message);
 
 	std::string solve(Solution& solution) {
@@ -82,10 +111,53 @@ private:
 	 */
 	void setVerbose(bool verbose);
 
+	// add a constraint on the variables in _consVars with the given
+	// coefficients
+	void addConstraint(
+			size_t        numNonZeros,
+			const double* coefs,
+			Relation      relation,
+			double        value);
+
+	// add the quadratic part of the objective as a constraint on an
+	// auxiliary objective variable
+	void setQuadraticObjective(const QuadraticObjective& objective);
+
+	// hand the start values to SCIP as a (partial) solution
+	void addStartSolution();
+
+	// the SCIP constraint of a constraint number
+	SCIP_CONS* constraint(unsigned int constraint);
+
+	// callbacks of the constraint handler for lazy constraints
+	static SCIP_DECL_CONSENFOLP(lazyEnfolp);
+	static SCIP_DECL_CONSENFOPS(lazyEnfops);
+	static SCIP_DECL_CONSCHECK(lazyCheck);
+	static SCIP_DECL_CONSLOCK(lazyLock);
+
+	void interruptSolver();
+
+	// callbacks of the event handler that reports the progress and stops
+	// interrupted solves
+	static SCIP_DECL_EVENTINIT(progressInit);
+	static SCIP_DECL_EVENTEXIT(progressExit);
+	static SCIP_DECL_EVENTEXEC(progressExec);
+
+	// call the separator with a solution (0 for the current LP or pseudo
+	// solution), and add the violated constraints to the problem if enforce
+	// is set
+	SCIP_RETCODE separate(SCIP_SOL* sol, bool enforce, SCIP_RESULT* result);
+
+	// fill the status, nodes, iterations, bounds, and memory of the
+	// statistics from the solved problem
+	void readStatistics(SolveStatistics& statistics);
+
 	void freeVariables();
 
 	void freeConstraints();
 
+	void freeQuadraticObjective();
+
 	SCIP_VARTYPE scipVarType(VariableType type, double& lb, double& ub);
 
 	// size of a and x
@@ -95,7 +167,43 @@ private:
 
 	std::vector<SCIP_VAR*> _variables;
 
+	// the constraints by their number, 0 for removed constraints
 	std::vector<SCIP_CONS*> _constraints;
+
+	// the epigraph variable z and constraint xQx - z <= 0 of a quadratic
+	// objective
+	SCIP_VAR*  _objectiveVariable;
+	SCIP_CONS* _objectiveConstraint;
+
+	// the quadratic terms of the objective, to compute z for start solutions
+	std::vector<unsigned int> _quadraticRows;
+	std::vector<unsigned int> _quadraticCols;
+	std::vector<double>       _quadraticValues;
+
+	// the separator for lazy constraints, and the constraint of the lazy
+	// constraint handler that is in the problem while a separator is set
+	Separator  _separator;
+	SCIP_CONS* _lazyConstraint;
+
+	ProgressCallback _progressCallback;
+
+	// the incumbent and bound of the last progress report
+	double _lastIncumbent;
+	double _lastBound;
+
+	// the start values for the next solve, and whether they are given for
+	// a subset of the variables only
+	std::vector<unsigned int> _startVariables;
+	std::vector<double>       _startValues;
+	bool                      _partialStart;
+
+	// buffers for the variables and coefficients of a constraint, reused
+	// between calls to addConstraint
+	std::vector<SCIP_VAR*> _consVars;
+	std::vector<SCIP_Real> _consCoefs;
+
+	// time spent in the calls that build the model since the last solve()
+	SolveStatistics::Time _buildTime;
 };
 
 #endif // HAVE_SCIP
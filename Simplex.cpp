@@ -0,0 +1,660 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "Simplex.h"
+
+static const double Infinity = std::numeric_limits<double>::infinity();
+
+// violations of bounds up to this value are tolerated
+static const double PrimalTolerance = 1e-7;
+
+// reduced costs up to this value are considered zero
+static const double DualTolerance = 1e-7;
+
+// smallest absolute value of a pivot element
+static const double PivotTolerance = 1e-9;
+
+// number of pivots after which the basis matrix is factorized again, earlier
+// if the updates have more non-zeros than the factorization
+static const unsigned int RefactorInterval = 100;
+
+// number of consecutive degenerate pivots after which Bland's rule is used
+static const unsigned int MaxDegenerate = 50;
+
+Simplex::Simplex() :
+	_numVariables(0),
+	_numRows(0),
+	_factorized(false),
+	_numUpdates(0),
+	_numDegenerate(0),
+	_iterations(0),
+	_timeout(0),
+	_interrupt(nullptr) {}
+
+void
+Simplex::tightenBounds(
+		double   coef,
+		Relation relation,
+		double   value,
+		double&  lower,
+		double&  upper) {
+
+	double bound = value/coef;
+
+	if (coef < 0) {
+
+		if (relation == LessEqual)
+			relation = GreaterEqual;
+		else if (relation == GreaterEqual)
+			relation = LessEqual;
+	}
+
+	if (relation != GreaterEqual)
+		upper = std::min(upper, bound);
+	if (relation != LessEqual)
+		lower = std::max(lower, bound);
+}
+
+void
+Simplex::load(
+		const std::vector<double>&    costs,
+		const std::vector<double>&    lower,
+		const std::vector<double>&    upper,
+		const LinearConstraintMatrix& constraints) {
+
+	_numVariables = costs.size();
+	_numRows      = constraints.size();
+
+	unsigned int n = _numVariables;
+	unsigned int m = _numRows;
+
+	// store the constraint matrix column-wise
+	_columns.assign(n, std::vector<Entry>());
+	const std::vector<size_t>& offsets = constraints.getRowOffsets();
+	for (unsigned int i = 0; i < m; i++)
+		for (size_t k = offsets[i]; k < offsets[i+1]; k++)
+			_columns[constraints.getColumns()[k]].push_back(Entry{i, constraints.getCoefficients()[k]});
+
+	_rhs = constraints.getValues();
+
+	_costs = costs;
+	_lower = lower;
+	_upper = upper;
+	_costs.resize(n + m, 0.0);
+	_lower.resize(n + m);
+	_upper.resize(n + m);
+
+	// a_i x + s_i = b_i, bound s_i according to the relation
+	for (unsigned int i = 0; i < m; i++) {
+
+		Relation relation = constraints.getRelations()[i];
+		_lower[n + i] = (relation == GreaterEqual ? -Infinity : 0.0);
+		_upper[n + i] = (relation == LessEqual    ?  Infinity : 0.0);
+	}
+
+	_x.assign(n + m, 0.0);
+
+	slackBasis();
+}
+
+void
+Simplex::setCost(unsigned int varNum, double cost) {
+
+	_costs[varNum] = cost;
+}
+
+void
+Simplex::setBounds(unsigned int varNum, double lower, double upper) {
+
+	_lower[varNum] = lower;
+	_upper[varNum] = upper;
+
+	// basic variables might become infeasible, phase 1 will take care of
+	// them
+	if (!isBasic(varNum))
+		placeNonbasic(varNum);
+}
+
+void
+Simplex::setRowValue(unsigned int row, double value) {
+
+	_rhs[row] = value;
+}
+
+void
+Simplex::relaxRow(unsigned int row) {
+
+	unsigned int slack = _numVariables + row;
+
+	_lower[slack] = -Infinity;
+	_upper[slack] =  Infinity;
+
+	if (!isBasic(slack))
+		placeNonbasic(slack);
+}
+
+void
+Simplex::addRow(
+		size_t              numNonZeros,
+		const unsigned int* varNums,
+		const double*       coefs,
+		Relation            relation,
+		double              value) {
+
+	unsigned int m = _numRows;
+	unsigned int slack = _numVariables + m;
+
+	for (size_t k = 0; k < numNonZeros; k++)
+		if (coefs[k] != 0)
+			_columns[varNums[k]].push_back(Entry{m, coefs[k]});
+
+	_rhs.push_back(value);
+	_costs.push_back(0.0);
+	_lower.push_back(relation == GreaterEqual ? -Infinity : 0.0);
+	_upper.push_back(relation == LessEqual    ?  Infinity : 0.0);
+	_x.push_back(0.0);
+	_status.push_back(Basic);
+
+	// the basis matrix gets a row and the column of the slack, it is
+	// factorized again at the next solve
+	_factorized = false;
+
+	_basis.push_back(slack);
+	_numRows++;
+}
+
+Simplex::Status
+Simplex::solve() {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	_iterations = 0;
+
+	if (!_factorized) {
+
+		if (!refactor()) {
+
+			slackBasis();
+			refactor();
+		}
+
+	} else {
+
+		computeBasicValues();
+	}
+
+	size_t maxIterations = 50*(static_cast<size_t>(_numVariables) + _numRows) + 10000;
+
+	while (true) {
+
+		if (_timeout > 0 && _iterations % 64 == 0) {
+
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			if (elapsed.count() > _timeout)
+				return TimeLimit;
+		}
+
+		if (_interrupt && *_interrupt)
+			return Interrupted;
+
+		if (_iterations >= maxIterations)
+			return IterationLimit;
+
+		int phase = (infeasibility() > 0 ? 1 : 2);
+
+		Status status = Optimal;
+		if (iterate(phase, status))
+			continue;
+
+		if (status != Optimal)
+			return status;
+
+		// no improving variable, make sure this is not an artifact of
+		// accumulated rounding errors in the updates of the factorization
+		if (_numUpdates > 0) {
+
+			if (!refactor()) {
+
+				slackBasis();
+				refactor();
+			}
+			continue;
+		}
+
+		return (phase == 1 ? Infeasible : Optimal);
+	}
+}
+
+double
+Simplex::getObjectiveValue() const {
+
+	double value = 0;
+	for (unsigned int j = 0; j < _numVariables; j++)
+		value += _costs[j]*_x[j];
+
+	return value;
+}
+
+void
+Simplex::getBasis(Basis& basis) const {
+
+	basis.basic  = _basis;
+	basis.status = _status;
+}
+
+void
+Simplex::setBasis(const Basis& basis) {
+
+	if (basis.basic == _basis && basis.status == _status)
+		return;
+
+	_basis  = basis.basic;
+	_status = basis.status;
+
+	// rows added after the basis was stored keep their slacks basic
+	for (unsigned int i = _basis.size(); i < _numRows; i++)
+		_basis.push_back(_numVariables + i);
+	_status.resize(_numVariables + _numRows, Basic);
+
+	for (unsigned int j = 0; j < _status.size(); j++)
+		if (!isBasic(j))
+			placeNonbasic(j);
+
+	_factorized = false;
+}
+
+void
+Simplex::slackBasis() {
+
+	unsigned int n = _numVariables;
+	unsigned int m = _numRows;
+
+	_status.assign(n + m, AtLower);
+	for (unsigned int j = 0; j < n; j++)
+		placeNonbasic(j);
+
+	_basis.resize(m);
+	for (unsigned int i = 0; i < m; i++) {
+
+		_basis[i] = n + i;
+		_status[n + i] = Basic;
+	}
+
+	_factorized = false;
+}
+
+void
+Simplex::placeNonbasic(unsigned int j) {
+
+	if (_status[j] == AtUpper && _upper[j] < Infinity) {
+
+		_x[j] = _upper[j];
+
+	} else if (_status[j] == AtLower && _lower[j] > -Infinity) {
+
+		_x[j] = _lower[j];
+
+	} else if (_lower[j] > -Infinity) {
+
+		_status[j] = AtLower;
+		_x[j] = _lower[j];
+
+	} else if (_upper[j] < Infinity) {
+
+		_status[j] = AtUpper;
+		_x[j] = _upper[j];
+
+	} else {
+
+		_status[j] = AtZero;
+		_x[j] = 0;
+	}
+}
+
+bool
+Simplex::refactor() {
+
+	unsigned int n = _numVariables;
+	unsigned int m = _numRows;
+
+	// the columns of the basis matrix
+	std::vector<size_t>       offsets(m + 1, 0);
+	std::vector<unsigned int> rows;
+	std::vector<double>       values;
+
+	for (unsigned int p = 0; p < m; p++) {
+
+		unsigned int j = _basis[p];
+		if (j < n) {
+
+			for (const Entry& e : _columns[j]) {
+
+				rows.push_back(e.row);
+				values.push_back(e.value);
+			}
+
+		} else {
+
+			rows.push_back(j - n);
+			values.push_back(1.0);
+		}
+
+		offsets[p + 1] = rows.size();
+	}
+
+	if (!_lu.factorize(m, offsets, rows, values)) {
+
+		_factorized = false;
+		return false;
+	}
+
+	_factorized = true;
+	_numUpdates = 0;
+
+	computeBasicValues();
+
+	return true;
+}
+
+void
+Simplex::computeBasicValues() {
+
+	unsigned int n = _numVariables;
+	unsigned int m = _numRows;
+
+	// b - N*x_N
+	std::vector<double> rhs(_rhs);
+	for (unsigned int j = 0; j < n + m; j++) {
+
+		if (isBasic(j) || _x[j] == 0)
+			continue;
+
+		if (j < n)
+			for (const Entry& e : _columns[j])
+				rhs[e.row] -= e.value*_x[j];
+		else
+			rhs[j - n] -= _x[j];
+	}
+
+	_lu.solve(rhs);
+
+	for (unsigned int p = 0; p < m; p++)
+		_x[_basis[p]] = rhs[p];
+}
+
+double
+Simplex::infeasibility() const {
+
+	double sum = 0;
+	for (unsigned int j : _basis) {
+
+		if (_x[j] < _lower[j] - PrimalTolerance)
+			sum += _lower[j] - _x[j];
+		else if (_x[j] > _upper[j] + PrimalTolerance)
+			sum += _x[j] - _upper[j];
+	}
+
+	return sum;
+}
+
+bool
+Simplex::iterate(int phase, Status& status) {
+
+	unsigned int n = _numVariables;
+	unsigned int m = _numRows;
+
+	// costs of the basic variables, in phase 1 the gradient of the sum of
+	// bound violations
+	_y.resize(m);
+	for (unsigned int p = 0; p < m; p++) {
+
+		unsigned int j = _basis[p];
+
+		if (phase == 2)
+			_y[p] = _costs[j];
+		else if (_x[j] < _lower[j] - PrimalTolerance)
+			_y[p] = -1;
+		else if (_x[j] > _upper[j] + PrimalTolerance)
+			_y[p] = 1;
+		else
+			_y[p] = 0;
+	}
+
+	// simplex multipliers y = cB*Binv
+	_lu.solveTransposed(_y);
+
+	// pricing, Dantzig's rule or Bland's rule if we are stalling
+	bool bland = (_numDegenerate > MaxDegenerate);
+
+	int    entering  = -1;
+	int    direction = 0;
+	double bestScore = 0;
+
+	for (unsigned int j = 0; j < n + m; j++) {
+
+		if (isBasic(j) || _lower[j] == _upper[j])
+			continue;
+
+		double d = (phase == 2 ? _costs[j] : 0.0);
+		if (j < n)
+			for (const Entry& e : _columns[j])
+				d -= _y[e.row]*e.value;
+		else
+			d -= _y[j - n];
+
+		int dir = 0;
+		if (_status[j] == AtLower && d < -DualTolerance)
+			dir = 1;
+		else if (_status[j] == AtUpper && d > DualTolerance)
+			dir = -1;
+		else if (_status[j] == AtZero && std::abs(d) > DualTolerance)
+			dir = (d < 0 ? 1 : -1);
+
+		if (dir == 0)
+			continue;
+
+		if (bland) {
+
+			entering  = j;
+			direction = dir;
+			break;
+		}
+
+		if (std::abs(d) > bestScore) {
+
+			bestScore = std::abs(d);
+			entering  = j;
+			direction = dir;
+		}
+	}
+
+	if (entering < 0) {
+
+		status = Optimal;
+		return false;
+	}
+
+	computeColumn(entering, _alpha);
+
+	// Harris ratio test, first pass: the largest step with relaxed bounds
+	double maxStep = Infinity;
+	for (unsigned int p = 0; p < m; p++) {
+
+		double a = _alpha[p];
+		if (std::abs(a) < PivotTolerance)
+			continue;
+
+		unsigned int j = _basis[p];
+		double rate = -direction*a;
+		double x = _x[j];
+
+		if (rate < 0) {
+
+			if (phase == 1 && x < _lower[j] - PrimalTolerance)
+				continue;
+
+			double bound = (phase == 1 && x > _upper[j] + PrimalTolerance ? _upper[j] : _lower[j]);
+			if (bound == -Infinity)
+				continue;
+
+			maxStep = std::min(maxStep, (x - bound + PrimalTolerance)/(-rate));
+
+		} else {
+
+			if (phase == 1 && x > _upper[j] + PrimalTolerance)
+				continue;
+
+			double bound = (phase == 1 && x < _lower[j] - PrimalTolerance ? _lower[j] : _upper[j]);
+			if (bound == Infinity)
+				continue;
+
+			maxStep = std::min(maxStep, (bound - x + PrimalTolerance)/rate);
+		}
+	}
+
+	double range = _upper[entering] - _lower[entering];
+
+	if (maxStep == Infinity && range == Infinity) {
+
+		status = (phase == 2 ? Unbounded : NumericalFailure);
+		return false;
+	}
+
+	double step;
+	int leaving = -1;
+	unsigned char leavingStatus = AtLower;
+
+	if (range <= maxStep) {
+
+		// the entering variable reaches its other bound first
+		step = range;
+
+	} else {
+
+		// second pass: among the candidates within the relaxed step, take the
+		// one with the largest pivot element
+		double bestPivot = 0;
+		step = 0;
+
+		for (unsigned int p = 0; p < m; p++) {
+
+			double a = _alpha[p];
+			if (std::abs(a) < PivotTolerance)
+				continue;
+
+			unsigned int j = _basis[p];
+			double rate = -direction*a;
+			double x = _x[j];
+			double ratio;
+			unsigned char boundStatus;
+
+			if (rate < 0) {
+
+				if (phase == 1 && x < _lower[j] - PrimalTolerance)
+					continue;
+
+				bool upper = (phase == 1 && x > _upper[j] + PrimalTolerance);
+				double bound = (upper ? _upper[j] : _lower[j]);
+				if (bound == -Infinity)
+					continue;
+
+				ratio = (x - bound)/(-rate);
+				boundStatus = (upper ? AtUpper : AtLower);
+
+			} else {
+
+				if (phase == 1 && x > _upper[j] + PrimalTolerance)
+					continue;
+
+				bool lower = (phase == 1 && x < _lower[j] - PrimalTolerance);
+				double bound = (lower ? _lower[j] : _upper[j]);
+				if (bound == Infinity)
+					continue;
+
+				ratio = (bound - x)/rate;
+				boundStatus = (lower ? AtLower : AtUpper);
+			}
+
+			if (ratio > maxStep)
+				continue;
+
+			bool better =
+					(leaving < 0) ||
+					(bland ? j < _basis[leaving] : std::abs(a) > bestPivot);
+
+			if (better) {
+
+				leaving       = p;
+				bestPivot     = std::abs(a);
+				step          = std::max(0.0, ratio);
+				leavingStatus = boundStatus;
+			}
+		}
+
+		if (leaving < 0) {
+
+			status = NumericalFailure;
+			return false;
+		}
+	}
+
+	// update the primal values
+	if (step > 0)
+		for (unsigned int p = 0; p < m; p++)
+			_x[_basis[p]] -= direction*step*_alpha[p];
+
+	_x[entering] += direction*step;
+
+	if (leaving < 0) {
+
+		_status[entering] = (direction > 0 ? AtUpper : AtLower);
+		placeNonbasic(entering);
+
+	} else {
+
+		unsigned int j = _basis[leaving];
+		_status[j] = leavingStatus;
+		placeNonbasic(j);
+
+		pivot(leaving, entering, _alpha);
+	}
+
+	_numDegenerate = (step < 1e-12 ? _numDegenerate + 1 : 0);
+	_iterations++;
+
+	if (_numUpdates >= RefactorInterval || _lu.numUpdateNonZeros() > _lu.numFactorNonZeros())
+		if (!refactor()) {
+
+			slackBasis();
+			refactor();
+		}
+
+	return true;
+}
+
+void
+Simplex::computeColumn(unsigned int j, std::vector<double>& alpha) const {
+
+	alpha.assign(_numRows, 0.0);
+
+	if (j >= _numVariables)
+		alpha[j - _numVariables] = 1.0;
+	else
+		for (const Entry& e : _columns[j])
+			alpha[e.row] = e.value;
+
+	_lu.solve(alpha);
+}
+
+void
+Simplex::pivot(unsigned int r, unsigned int j, const std::vector<double>& alpha) {
+
+	_lu.update(r, alpha);
+
+	_status[j] = Basic;
+	_basis[r]  = j;
+
+	_numUpdates++;
+}
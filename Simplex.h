@@ -0,0 +1,261 @@
+#ifndef INFERENCE_SIMPLEX_H__
+#define INFERENCE_SIMPLEX_H__
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+#include "LinearConstraintMatrix.h"
+#include "Relation.h"
+#include "SparseLu.h"
+
+/**
+ * A bounded primal revised simplex for sparse linear programs
+ *
+ * min  <c,x>
+ * s.t. Ax (<=|==|>=) b
+ *      l <= x <= u
+ *
+ * with possibly infinite bounds l and u. Every row i gets a slack variable s_i
+ * with a_i x + s_i = b_i, bounded according to the relation of the row. The
+ * constraint matrix is stored column-wise and sparse, the basis matrix as a
+ * sparse LU factorization with product form updates (see SparseLu). Phase 1 minimizes the sum of bound violations of the basic
+ * variables, starting from any basis. This allows to warm start from the
+ * basis of a previous solve after changes to costs, bounds, or added rows.
+ */
+class Simplex {
+
+public:
+
+	enum Status {
+
+		Optimal,
+		Infeasible,
+		Unbounded,
+		IterationLimit,
+		TimeLimit,
+		Interrupted,
+		NumericalFailure
+	};
+
+	/**
+	 * The status of a variable with respect to the current basis.
+	 */
+	enum VariableStatus {
+
+		Basic,
+		AtLower,
+		AtUpper,
+		AtZero // nonbasic free variable
+	};
+
+	/**
+	 * A basis that can be stored and restored later to warm start.
+	 */
+	struct Basis {
+
+		// the variable for each position in the basis
+		std::vector<unsigned int>  basic;
+
+		// the status of each variable (structural variables first, then
+		// slacks)
+		std::vector<unsigned char> status;
+	};
+
+	Simplex();
+
+	/**
+	 * Tighten the bounds of a variable x according to the constraint
+	 * coef*x (relation) value.
+	 */
+	static void tightenBounds(
+			double   coef,
+			Relation relation,
+			double   value,
+			double&  lower,
+			double&  upper);
+
+	/**
+	 * Load a linear program. This resets the basis.
+	 *
+	 * @param costs The cost of each variable.
+	 * @param lower The lower bound of each variable.
+	 * @param upper The upper bound of each variable.
+	 * @param constraints The linear constraints.
+	 */
+	void load(
+			const std::vector<double>&    costs,
+			const std::vector<double>&    lower,
+			const std::vector<double>&    upper,
+			const LinearConstraintMatrix& constraints);
+
+	/**
+	 * Change the cost of a variable. Keeps the basis.
+	 */
+	void setCost(unsigned int varNum, double cost);
+
+	/**
+	 * Change the bounds of a variable. Keeps the basis.
+	 */
+	void setBounds(unsigned int varNum, double lower, double upper);
+
+	double getLower(unsigned int varNum) const { return _lower[varNum]; }
+
+	double getUpper(unsigned int varNum) const { return _upper[varNum]; }
+
+	/**
+	 * Change the right hand side of a row. Keeps the basis.
+	 */
+	void setRowValue(unsigned int row, double value);
+
+	/**
+	 * Make a row redundant by removing the bounds of its slack. The row stays
+	 * in the basis matrix, but does not constrain the variables anymore. Keeps
+	 * the basis.
+	 */
+	void relaxRow(unsigned int row);
+
+	/**
+	 * Add a row. The slack of the new row becomes basic, such that the basis
+	 * of the previous solve stays valid.
+	 */
+	void addRow(
+			size_t              numNonZeros,
+			const unsigned int* varNums,
+			const double*       coefs,
+			Relation            relation,
+			double              value);
+
+	/**
+	 * Limit the time of subsequent calls to solve(), in seconds. 0 disables
+	 * the limit.
+	 */
+	void setTimeout(double timeout) { _timeout = timeout; }
+
+	/**
+	 * Stop subsequent calls to solve() with Interrupted as soon as the given
+	 * flag is set, e.g., by another thread. nullptr to not check a flag.
+	 */
+	void setInterrupt(const std::atomic<bool>* interrupt) { _interrupt = interrupt; }
+
+	/**
+	 * Solve the linear program, starting from the current basis.
+	 */
+	Status solve();
+
+	/**
+	 * @return The number of structural variables.
+	 */
+	unsigned int numVariables() const { return _numVariables; }
+
+	/**
+	 * @return The number of rows.
+	 */
+	unsigned int numRows() const { return _numRows; }
+
+	/**
+	 * @return The value of a structural variable after solve().
+	 */
+	double getValue(unsigned int varNum) const { return _x[varNum]; }
+
+	/**
+	 * @return The value of the objective after solve().
+	 */
+	double getObjectiveValue() const;
+
+	/**
+	 * @return The number of simplex iterations of the last call to solve().
+	 */
+	size_t getIterations() const { return _iterations; }
+
+	/**
+	 * Store the current basis.
+	 */
+	void getBasis(Basis& basis) const;
+
+	/**
+	 * Restore a basis. Does nothing if the given basis is the current one.
+	 * The basis can be one stored before rows were added, the slacks of the
+	 * added rows become basic.
+	 */
+	void setBasis(const Basis& basis);
+
+private:
+
+	struct Entry {
+
+		unsigned int row;
+		double       value;
+	};
+
+	// reset to the basis of all slack variables
+	void slackBasis();
+
+	// set a nonbasic variable to the bound given by its status
+	void placeNonbasic(unsigned int j);
+
+	// factorize the basis matrix and compute the basic variables
+	bool refactor();
+
+	// compute the values of the basic variables from the nonbasic ones
+	void computeBasicValues();
+
+	// the sum of bound violations of the basic variables
+	double infeasibility() const;
+
+	// one iteration of phase 1 (phase == 1) or phase 2 (phase == 2), returns
+	// false if no improving variable was found
+	bool iterate(int phase, Status& status);
+
+	// alpha = Binv*A_j
+	void computeColumn(unsigned int j, std::vector<double>& alpha) const;
+
+	// pivot variable j into basis position r
+	void pivot(unsigned int r, unsigned int j, const std::vector<double>& alpha);
+
+	bool isBasic(unsigned int j) const { return _status[j] == Basic; }
+
+	unsigned int _numVariables;
+
+	unsigned int _numRows;
+
+	// the columns of the structural variables
+	std::vector<std::vector<Entry>> _columns;
+
+	std::vector<double> _rhs;
+
+	// costs, bounds, values, and status of structural variables and slacks
+	std::vector<double>        _costs;
+	std::vector<double>        _lower;
+	std::vector<double>        _upper;
+	std::vector<double>        _x;
+	std::vector<unsigned char> _status;
+
+	// the variable at each basis position
+	std::vector<unsigned int> _basis;
+
+	// the factorization of the basis matrix
+	SparseLu _lu;
+
+	// is _lu the factorization of the current basis?
+	bool _factorized;
+
+	// number of pivots since the last refactorization
+	unsigned int _numUpdates;
+
+	// consecutive degenerate iterations, to detect stalling
+	unsigned int _numDegenerate;
+
+	size_t _iterations;
+
+	double _timeout;
+
+	const std::atomic<bool>* _interrupt;
+
+	// work vectors
+	std::vector<double> _y;
+	std::vector<double> _alpha;
+};
+
+#endif // INFERENCE_SIMPLEX_H__
+
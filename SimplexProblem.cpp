@@ -0,0 +1,242 @@
+#include <algorithm>
+
+#include <util/exceptions.h>
+#include "SimplexProblem.h"
+
+// tolerance for detecting contradicting bounds
+static const double BoundTolerance = 1e-9;
+
+SimplexProblem::SimplexProblem() :
+	_dirty(true) {}
+
+void
+SimplexProblem::initialize(const std::vector<double>& lower, const std::vector<double>& upper) {
+
+	_costs.assign(lower.size(), 0.0);
+	_lower = lower;
+	_upper = upper;
+
+	_constraints.clear();
+	_removed.clear();
+	_dirty = true;
+}
+
+void
+SimplexProblem::setCost(unsigned int varNum, double cost) {
+
+	_costs[varNum] = cost;
+
+	// keep the current basis, if the problem is loaded already
+	if (!_dirty)
+		_simplex.setCost(varNum, cost);
+}
+
+void
+SimplexProblem::setBounds(unsigned int varNum, double lower, double upper) {
+
+	_lower[varNum] = lower;
+	_upper[varNum] = upper;
+
+	if (!_dirty)
+		updateBounds(varNum);
+}
+
+void
+SimplexProblem::setConstraints(const LinearConstraintMatrix& constraints) {
+
+	_constraints = constraints;
+	_removed.assign(_constraints.size(), 0);
+	_dirty = true;
+}
+
+void
+SimplexProblem::addConstraint(const LinearConstraint& constraint) {
+
+	_constraints.add(constraint);
+	_removed.push_back(0);
+
+	if (_dirty)
+		return;
+
+	// add the row to the loaded problem, to keep the current basis
+
+	unsigned int i = _constraints.size() - 1;
+	size_t offset = _constraints.getRowOffsets()[i];
+
+	if (_constraints.numNonZeros(i) == 1) {
+
+		unsigned int varNum = _constraints.getColumns()[offset];
+		double lower = _simplex.getLower(varNum);
+		double upper = _simplex.getUpper(varNum);
+
+		Simplex::tightenBounds(
+				_constraints.getCoefficients()[offset],
+				constraint.getRelation(),
+				constraint.getValue(),
+				lower,
+				upper);
+
+		_simplex.setBounds(varNum, lower, upper);
+
+		_variableConstraints[varNum].push_back(i);
+		_rows.push_back(-1);
+
+	} else {
+
+		_rows.push_back(_simplex.numRows());
+
+		_simplex.addRow(
+				_constraints.numNonZeros(i),
+				_constraints.getColumns().data() + offset,
+				_constraints.getCoefficients().data() + offset,
+				constraint.getRelation(),
+				constraint.getValue());
+	}
+}
+
+void
+SimplexProblem::setConstraintValue(unsigned int constraint, double value) {
+
+	checkConstraint(constraint);
+
+	_constraints.setValue(constraint, value);
+
+	if (_dirty)
+		return;
+
+	if (_rows[constraint] >= 0)
+		_simplex.setRowValue(_rows[constraint], value);
+	else
+		updateBounds(_constraints.getColumns()[_constraints.getRowOffsets()[constraint]]);
+}
+
+void
+SimplexProblem::removeConstraint(unsigned int constraint) {
+
+	checkConstraint(constraint);
+
+	_removed[constraint] = 1;
+
+	if (_dirty)
+		return;
+
+	if (_rows[constraint] >= 0) {
+
+		_simplex.relaxRow(_rows[constraint]);
+
+	} else {
+
+		unsigned int varNum = _constraints.getColumns()[_constraints.getRowOffsets()[constraint]];
+
+		std::vector<unsigned int>& constraints = _variableConstraints[varNum];
+		constraints.erase(std::find(constraints.begin(), constraints.end(), constraint));
+
+		updateBounds(varNum);
+	}
+
+	_rows[constraint] = -1;
+}
+
+Simplex&
+SimplexProblem::getSimplex() {
+
+	load();
+
+	return _simplex;
+}
+
+bool
+SimplexProblem::hasEmptyBounds() {
+
+	load();
+
+	for (unsigned int i = 0; i < numVariables(); i++)
+		if (_simplex.getLower(i) > _simplex.getUpper(i) + BoundTolerance)
+			return true;
+
+	return false;
+}
+
+void
+SimplexProblem::load() {
+
+	if (!_dirty)
+		return;
+
+	// turn constraints on single variables into bounds, skip removed
+	// constraints
+
+	std::vector<double> lower = _lower;
+	std::vector<double> upper = _upper;
+	LinearConstraintMatrix rows;
+	rows.reserve(_constraints.size(), _constraints.numNonZeros());
+
+	_rows.assign(_constraints.size(), -1);
+	_variableConstraints.assign(numVariables(), std::vector<unsigned int>());
+
+	for (unsigned int i = 0; i < _constraints.size(); i++) {
+
+		if (_removed[i])
+			continue;
+
+		size_t offset = _constraints.getRowOffsets()[i];
+
+		if (_constraints.numNonZeros(i) == 1) {
+
+			unsigned int varNum = _constraints.getColumns()[offset];
+
+			Simplex::tightenBounds(
+					_constraints.getCoefficients()[offset],
+					_constraints.getRelations()[i],
+					_constraints.getValues()[i],
+					lower[varNum],
+					upper[varNum]);
+
+			_variableConstraints[varNum].push_back(i);
+
+		} else {
+
+			_rows[i] = rows.size();
+
+			rows.addRow(
+					_constraints.numNonZeros(i),
+					_constraints.getColumns().data() + offset,
+					_constraints.getCoefficients().data() + offset,
+					_constraints.getRelations()[i],
+					_constraints.getValues()[i]);
+		}
+	}
+
+	_simplex.load(_costs, lower, upper, rows);
+	_dirty = false;
+}
+
+void
+SimplexProblem::updateBounds(unsigned int varNum) {
+
+	double lower = _lower[varNum];
+	double upper = _upper[varNum];
+
+	for (unsigned int i : _variableConstraints[varNum]) {
+
+		size_t offset = _constraints.getRowOffsets()[i];
+
+		Simplex::tightenBounds(
+				_constraints.getCoefficients()[offset],
+				_constraints.getRelations()[i],
+				_constraints.getValues()[i],
+				lower,
+				upper);
+	}
+
+	_simplex.setBounds(varNum, lower, upper);
+}
+
+void
+SimplexProblem::checkConstraint(unsigned int constraint) const {
+
+	if (constraint >= _constraints.size() || _removed[constraint])
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"constraint " << constraint << " does not exist");
+}
@@ -0,0 +1,112 @@
+#ifndef INFERENCE_SIMPLEX_PROBLEM_H__
+#define INFERENCE_SIMPLEX_PROBLEM_H__
+
+#include <vector>
+
+#include "LinearConstraint.h"
+#include "LinearConstraintMatrix.h"
+#include "Simplex.h"
+
+/**
+ * A linear program
+ *
+ * min  <c,x>
+ * s.t. Ax (<=|==|>=) b
+ *      l <= x <= u
+ *
+ * that is loaded into a Simplex on demand and kept in sync with changes
+ * afterwards. Constraints on single variables become bounds of the simplex.
+ *
+ * Changes of costs, bounds, and right hand sides, as well as added and removed
+ * constraints, are applied to the loaded simplex in place, which keeps its
+ * basis. Removed rows stay in the simplex as redundant rows until the problem
+ * is loaded again after setConstraints().
+ *
+ * Constraints are numbered in the order they were set and added. Numbers stay
+ * valid when other constraints are removed.
+ */
+class SimplexProblem {
+
+public:
+
+	SimplexProblem();
+
+	/**
+	 * Start a new problem with the given bounds, zero costs, and no
+	 * constraints.
+	 */
+	void initialize(const std::vector<double>& lower, const std::vector<double>& upper);
+
+	void setCost(unsigned int varNum, double cost);
+
+	void setBounds(unsigned int varNum, double lower, double upper);
+
+	/**
+	 * Replace all constraints. The problem is loaded again on the next call
+	 * to getSimplex().
+	 */
+	void setConstraints(const LinearConstraintMatrix& constraints);
+
+	void addConstraint(const LinearConstraint& constraint);
+
+	void setConstraintValue(unsigned int constraint, double value);
+
+	void removeConstraint(unsigned int constraint);
+
+	/**
+	 * Drop rows that were added to the simplex directly, by loading the
+	 * problem again on the next call to getSimplex().
+	 */
+	void reload() { _dirty = true; }
+
+	unsigned int numVariables() const { return _costs.size(); }
+
+	/**
+	 * @return The simplex with the current problem loaded.
+	 */
+	Simplex& getSimplex();
+
+	/**
+	 * @return True, if the bounds of a variable in the loaded simplex
+	 *         contradict each other, i.e., the problem is trivially
+	 *         infeasible.
+	 */
+	bool hasEmptyBounds();
+
+private:
+
+	// load the problem into the simplex, if it changed since the last load
+	void load();
+
+	// recompute the bounds of a variable in the loaded simplex from its
+	// bounds and the constraints on it alone
+	void updateBounds(unsigned int varNum);
+
+	void checkConstraint(unsigned int constraint) const;
+
+	std::vector<double> _costs;
+
+	std::vector<double> _lower;
+
+	std::vector<double> _upper;
+
+	// all constraints since the last setConstraints(), including removed ones
+	LinearConstraintMatrix _constraints;
+
+	std::vector<char> _removed;
+
+	// the row of each constraint in the loaded simplex, -1 for constraints on
+	// a single variable and constraints that were not loaded
+	std::vector<int> _rows;
+
+	// the constraints on each single variable, in the loaded simplex
+	std::vector<std::vector<unsigned int>> _variableConstraints;
+
+	Simplex _simplex;
+
+	// do we have to load the problem into the simplex again?
+	bool _dirty;
+};
+
+#endif // INFERENCE_SIMPLEX_PROBLEM_H__
+
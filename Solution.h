@@ -3,6 +3,8 @@
 
 #include <vector>
 
+#include "SolveStatistics.h"
+
 class Solution {
 
 public:
@@ -23,10 +25,23 @@ public:
 
 	double getValue() const { return _value; }
 
+	/**
+	 * The user and system CPU time of the solver, see getStatistics() for
+	 * wall-clock times.
+	 */
 	void setTime(double time) { _time = time; }
 
 	double getTime() const { return _time; }
 
+	/**
+	 * Statistics of the solve() that found this solution.
+	 */
+	void setStatistics(const SolveStatistics& statistics) { _statistics = statistics; }
+
+	const SolveStatistics& getStatistics() const { return _statistics; }
+
+	SolveStatistics& getStatistics() { return _statistics; }
+
 private:
 
 	std::vector<double> _solution;
@@ -34,6 +49,8 @@ private:
 	double _value;
 
 	double _time;
+
+	SolveStatistics _statistics;
 };
 
 #endif // INFERENCE_SOLUTION_H__
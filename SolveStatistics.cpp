@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "SolveStatistics.h"
+
+// the times measured by running timers of this thread
+static thread_local std::vector<const SolveStatistics::Time*> runningTimers;
+
+SolveStatistics::Timer::Timer(Time& time) :
+	_time(&time) {
+
+	if (std::find(runningTimers.begin(), runningTimers.end(), _time) != runningTimers.end())
+		_time = nullptr;
+	else
+		runningTimers.push_back(_time);
+
+	_timer.start();
+}
+
+void
+SolveStatistics::Timer::stop() {
+
+	if (!_time)
+		return;
+
+	boost::timer::cpu_times elapsed = _timer.elapsed();
+
+	_time->wall += elapsed.wall*1e-9;
+	_time->cpu  += (elapsed.user + elapsed.system)*1e-9;
+
+	runningTimers.erase(std::find(runningTimers.begin(), runningTimers.end(), _time));
+	_time = nullptr;
+}
+
+SolveStatistics::SolveStatistics(Sense objectiveSense) :
+	sense(objectiveSense),
+	numNodes(0),
+	numIterations(0),
+	primalBound((objectiveSense == Minimize ? 1 : -1)*std::numeric_limits<double>::infinity()),
+	dualBound((objectiveSense == Minimize ? -1 : 1)*std::numeric_limits<double>::infinity()),
+	status(Unknown),
+	peakMemory(0) {}
+
+SolveStatistics::Time
+SolveStatistics::total() const {
+
+	Time sum;
+	for (int phase = 0; phase < NumPhases; phase++)
+		sum += time[phase];
+
+	return sum;
+}
+
+bool
+SolveStatistics::hasSolution() const {
+
+	return std::isfinite(primalBound);
+}
+
+double
+SolveStatistics::gap() const {
+
+	if (std::isinf(primalBound) || std::isinf(dualBound))
+		return std::numeric_limits<double>::infinity();
+
+	double difference = std::fabs(primalBound - dualBound);
+
+	if (difference == 0)
+		return 0;
+
+	return difference/std::fabs(primalBound);
+}
+
+size_t
+SolveStatistics::peakMemoryOfProcess() {
+
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+#ifdef __APPLE__
+	// bytes on macOS
+	return usage.ru_maxrss;
+#else
+	// kilobytes on Linux
+	return static_cast<size_t>(usage.ru_maxrss)*1024;
+#endif
+}
+
+const char*
+solveStatusName(SolveStatistics::Status status) {
+
+	switch (status) {
+
+		case SolveStatistics::Optimal:          return "optimal";
+		case SolveStatistics::Infeasible:       return "infeasible";
+		case SolveStatistics::Unbounded:        return "unbounded";
+		case SolveStatistics::TimeLimit:        return "time limit";
+		case SolveStatistics::IterationLimit:   return "iteration limit";
+		case SolveStatistics::Interrupted:      return "interrupted";
+		case SolveStatistics::NumericalFailure: return "numerical failure";
+		default:                                return "unknown";
+	}
+}
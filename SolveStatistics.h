@@ -0,0 +1,169 @@
+#ifndef INFERENCE_SOLVE_STATISTICS_H__
+#define INFERENCE_SOLVE_STATISTICS_H__
+
+#include <cstddef>
+
+#include <boost/timer/timer.hpp>
+
+#include "Sense.h"
+
+/**
+ * Statistics of a call to solve(), stored with the solution it returned:
+ *
+ *   backend->solve(solution, message);
+ *
+ *   const SolveStatistics& statistics = solution.getStatistics();
+ *   std::cout << statistics.total().wall << "s wall-clock, "
+ *             << statistics.time[SolveStatistics::Solve].cpu << "s CPU in the solver, "
+ *             << statistics.numNodes << " nodes" << std::endl;
+ *
+ * CPU times are user and system times of all threads of the process, and
+ * can exceed the wall-clock times for multithreaded solvers.
+ */
+struct SolveStatistics {
+
+	/**
+	 * The phases the times are broken down into. Backends report a phase
+	 * only if it is separate from the others in the underlying solver, e.g.,
+	 * the presolve of most solvers is part of Solve.
+	 */
+	enum Phase {
+
+		// the calls that set up the model since the previous solve(), i.e.,
+		// initialize(), setObjective(), setConstraints(), addConstraint(),
+		// and removeConstraints(). Changes of single coefficients, bounds,
+		// and values are too cheap to be timed each.
+		Build,
+
+		// passing pending changes of the model to the solver at the beginning
+		// of solve()
+		Update,
+
+		Presolve,
+
+		Solve,
+
+		// reading the solution from the solver
+		Extraction,
+
+		NumPhases
+	};
+
+	/**
+	 * Why the solver stopped.
+	 */
+	enum Status {
+
+		// solved to optimality, within the optimality gap
+		Optimal,
+
+		Infeasible,
+
+		Unbounded,
+
+		TimeLimit,
+
+		IterationLimit,
+
+		Interrupted,
+
+		NumericalFailure,
+
+		// any other reason, see the message of solve()
+		Unknown
+	};
+
+	struct Time {
+
+		Time() : wall(0), cpu(0) {}
+
+		double wall;
+		double cpu;
+
+		Time& operator+=(const Time& other) { wall += other.wall; cpu += other.cpu; return *this; }
+	};
+
+	/**
+	 * Adds the wall-clock and CPU time from its construction to stop() or its
+	 * destruction to a Time. Timers for the same Time nest within a thread,
+	 * only the outermost one measures, such that calls that forward to other
+	 * calls of the same backend are not counted twice.
+	 */
+	class Timer {
+
+	public:
+
+		explicit Timer(Time& time);
+
+		~Timer() { stop(); }
+
+		void stop();
+
+	private:
+
+		Time* _time;
+
+		boost::timer::cpu_timer _timer;
+	};
+
+	/**
+	 * Create statistics without times and iterations, and without bounds,
+	 * i.e., infinite bounds for an objective of the given sense.
+	 */
+	explicit SolveStatistics(Sense sense = Minimize);
+
+	/**
+	 * @return The sum of the times of all phases.
+	 */
+	Time total() const;
+
+	/**
+	 * @return True, if a feasible solution was found.
+	 */
+	bool hasSolution() const;
+
+	/**
+	 * @return The relative gap |primalBound - dualBound|/|primalBound|,
+	 *         infinite if one of the bounds is.
+	 */
+	double gap() const;
+
+	/**
+	 * @return The highest resident memory of this process so far in bytes,
+	 *         or 0 if it can not be determined.
+	 */
+	static size_t peakMemoryOfProcess();
+
+	// the sense of the objective the bounds are for
+	Sense sense;
+
+	Time time[NumPhases];
+
+	// processed branch-and-bound nodes
+	size_t numNodes;
+
+	// simplex iterations, or iterations of the solver if it is not a simplex
+	size_t numIterations;
+
+	// the objective value of the best solution found, infinite (in the
+	// direction of the sense of the objective) if there is none
+	double primalBound;
+
+	// the best known bound on the optimal objective value, infinite (in the
+	// opposite direction) if there is none
+	double dualBound;
+
+	Status status;
+
+	// the highest resident memory of the process after the solve in bytes,
+	// see peakMemoryOfProcess()
+	size_t peakMemory;
+};
+
+/**
+ * @return A human readable name for a solve status.
+ */
+const char* solveStatusName(SolveStatistics::Status status);
+
+#endif // INFERENCE_SOLVE_STATISTICS_H__
+
@@ -14,9 +14,16 @@
 #include "ScipBackend.h"
 #endif
 
+#include "AdmmBackend.h"
+#include "BranchAndBoundBackend.h"
+
 std::shared_ptr<LinearSolverBackend>
 SolverFactory::createLinearSolverBackend(Preference preference) const {
 
+// the built-in backend, if asked for explicitly
+	if (preference == Native)
+		return std::make_shared<BranchAndBoundBackend>();
+
 // by default, create a gurobi backend
 #ifdef HAVE_GUROBI
 
@@ -41,7 +48,12 @@ SolverFactory::createLinearSolverBackend(Preference preference) const {
 
 #endif
 
-// if this is not available as well, throw an exception
+// if this is not available as well, use the built-in branch-and-bound
+
+	if (preference == Any)
+		return std::make_shared<BranchAndBoundBackend>();
+
+// the requested solver is not available
 
 	BOOST_THROW_EXCEPTION(NoSolverException() << error_message("No linear solver available."));
 }
@@ -49,6 +61,10 @@ SolverFactory::createLinearSolverBackend(Preference preference) const {
 std::shared_ptr<QuadraticSolverBackend>
 SolverFactory::createQuadraticSolverBackend(Preference preference) const {
 
+// the built-in backend has to be asked for explicitly
+	if (preference == Native)
+		return std::make_shared<AdmmBackend>();
+
 // by default, create a gurobi backend
 #ifdef HAVE_GUROBI
 
@@ -65,6 +81,14 @@ SolverFactory::createQuadraticSolverBackend(Preference preference) const {
 
 #endif
 
+// if this is not available, create a SCIP backend
+#ifdef HAVE_SCIP
+
+	if (preference == Any || preference == Scip)
+		return std::make_shared<ScipBackend>();
+
+#endif
+
 // if this is not available as well, throw an exception
 
 	BOOST_THROW_EXCEPTION(NoSolverException() << error_message("No quadratic solver available."));
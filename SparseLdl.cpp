@@ -0,0 +1,391 @@
+#include <algorithm>
+
+#include <util/exceptions.h>
+#include "SparseLdl.h"
+
+SparseLdl::SparseLdl() :
+	_n(0),
+	_numPositive(0) {}
+
+void
+SparseLdl::analyze(
+		unsigned int                     n,
+		const std::vector<size_t>&       colOffsets,
+		const std::vector<unsigned int>& rows) {
+
+	if (colOffsets.size() != n + 1 || colOffsets.back() != rows.size())
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"pattern does not describe a " << n << "x" << n << " matrix");
+
+	_n          = n;
+	_colOffsets = colOffsets;
+	_rows       = rows;
+
+	orderMinimumDegree();
+
+	// permute the upper triangle
+
+	std::vector<size_t> counts(_n + 1, 0);
+	for (unsigned int j = 0; j < _n; j++)
+		for (size_t k = _colOffsets[j]; k < _colOffsets[j+1]; k++) {
+
+			if (_rows[k] > j)
+				UTIL_THROW_EXCEPTION(
+						UsageError,
+						"pattern contains entry (" << _rows[k] << ", " << j << ") below the diagonal");
+
+			counts[std::max(_iperm[_rows[k]], _iperm[j]) + 1]++;
+		}
+
+	_permColOffsets.resize(_n + 1);
+	_permColOffsets[0] = 0;
+	for (unsigned int j = 0; j < _n; j++)
+		_permColOffsets[j+1] = _permColOffsets[j] + counts[j+1];
+
+	_permRows.resize(_rows.size());
+	_permValues.resize(_rows.size());
+	_permPositions.resize(_rows.size());
+
+	std::vector<size_t> next(_permColOffsets.begin(), _permColOffsets.end() - 1);
+	for (unsigned int j = 0; j < _n; j++)
+		for (size_t k = _colOffsets[j]; k < _colOffsets[j+1]; k++) {
+
+			unsigned int pi = _iperm[_rows[k]];
+			unsigned int pj = _iperm[j];
+			size_t pos = next[std::max(pi, pj)]++;
+
+			_permRows[pos]     = std::min(pi, pj);
+			_permPositions[k]  = pos;
+		}
+
+	// elimination tree and column counts of L
+
+	_etree.assign(_n, -1);
+	std::vector<unsigned int> lnz(_n, 0);
+	std::vector<unsigned int> flag(_n);
+
+	for (unsigned int j = 0; j < _n; j++) {
+
+		flag[j] = j;
+
+		for (size_t k = _permColOffsets[j]; k < _permColOffsets[j+1]; k++) {
+
+			unsigned int i = _permRows[k];
+
+			while (flag[i] != j) {
+
+				if (_etree[i] == -1)
+					_etree[i] = j;
+
+				lnz[i]++;
+				flag[i] = j;
+				i = _etree[i];
+			}
+		}
+	}
+
+	_lColOffsets.resize(_n + 1);
+	_lColOffsets[0] = 0;
+	for (unsigned int j = 0; j < _n; j++)
+		_lColOffsets[j+1] = _lColOffsets[j] + lnz[j];
+
+	_lRows.resize(_lColOffsets[_n]);
+	_lValues.resize(_lColOffsets[_n]);
+
+	_d.resize(_n);
+	_dInv.resize(_n);
+	_work.resize(_n);
+	_yValues.assign(_n, 0);
+	_yPattern.resize(_n);
+	_elimBuffer.resize(_n);
+	_nextInColumn.resize(_n);
+	_marked.assign(_n, 0);
+}
+
+bool
+SparseLdl::hasPattern(
+		const std::vector<size_t>&       colOffsets,
+		const std::vector<unsigned int>& rows) const {
+
+	return colOffsets == _colOffsets && rows == _rows;
+}
+
+bool
+SparseLdl::factorize(const std::vector<double>& values) {
+
+	if (values.size() != _rows.size())
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"got " << values.size() << " values for a pattern of " << _rows.size() << " entries");
+
+	for (size_t k = 0; k < values.size(); k++)
+		_permValues[_permPositions[k]] = values[k];
+
+	_numPositive = 0;
+
+	for (unsigned int j = 0; j < _n; j++)
+		_nextInColumn[j] = _lColOffsets[j];
+
+	// up-looking factorization: row k of L is found by a sparse triangular
+	// solve, with its pattern given by the elimination tree
+	for (unsigned int k = 0; k < _n; k++) {
+
+		size_t numY = 0;
+		_d[k] = 0;
+
+		for (size_t p = _permColOffsets[k]; p < _permColOffsets[k+1]; p++) {
+
+			unsigned int i = _permRows[p];
+
+			if (i == k) {
+
+				_d[k] += _permValues[p];
+				continue;
+			}
+
+			_yValues[i] += _permValues[p];
+
+			if (_marked[i])
+				continue;
+
+			// walk up the elimination tree until a marked node, the walk is
+			// reversed to get a topological order
+			size_t numElim = 0;
+			int next = i;
+			while (next != -1 && (unsigned int)next < k && !_marked[next]) {
+
+				_marked[next] = 1;
+				_elimBuffer[numElim++] = next;
+				next = _etree[next];
+			}
+
+			while (numElim > 0)
+				_yPattern[numY++] = _elimBuffer[--numElim];
+		}
+
+		for (size_t y = numY; y > 0; y--) {
+
+			unsigned int c = _yPattern[y-1];
+			double yc = _yValues[c];
+
+			size_t end = _nextInColumn[c];
+			for (size_t p = _lColOffsets[c]; p < end; p++)
+				_yValues[_lRows[p]] -= _lValues[p]*yc;
+
+			_lRows[end]   = k;
+			_lValues[end] = yc*_dInv[c];
+			_d[k] -= yc*_lValues[end];
+			_nextInColumn[c]++;
+
+			_yValues[c] = 0;
+			_marked[c]  = 0;
+		}
+
+		if (_d[k] == 0)
+			return false;
+
+		if (_d[k] > 0)
+			_numPositive++;
+
+		_dInv[k] = 1.0/_d[k];
+	}
+
+	return true;
+}
+
+void
+SparseLdl::solve(std::vector<double>& x) {
+
+	for (unsigned int i = 0; i < _n; i++)
+		_work[i] = x[_perm[i]];
+
+	// L
+	for (unsigned int j = 0; j < _n; j++) {
+
+		double w = _work[j];
+		for (size_t p = _lColOffsets[j]; p < _lColOffsets[j+1]; p++)
+			_work[_lRows[p]] -= _lValues[p]*w;
+	}
+
+	// D
+	for (unsigned int i = 0; i < _n; i++)
+		_work[i] *= _dInv[i];
+
+	// L^T
+	for (unsigned int j = _n; j > 0; j--) {
+
+		double w = _work[j-1];
+		for (size_t p = _lColOffsets[j-1]; p < _lColOffsets[j]; p++)
+			w -= _lValues[p]*_work[_lRows[p]];
+		_work[j-1] = w;
+	}
+
+	for (unsigned int i = 0; i < _n; i++)
+		x[_perm[i]] = _work[i];
+}
+
+void
+SparseLdl::orderMinimumDegree() {
+
+	// Approximate minimum degree on the quotient graph: eliminated nodes
+	// become elements, which represent the cliques formed by their
+	// elimination. This keeps the memory in the order of the non-zeros of the
+	// pattern, instead of the non-zeros of the factor.
+
+	// variables adjacent to each variable, without self loops
+	std::vector<std::vector<unsigned int>> variables(_n);
+	for (unsigned int j = 0; j < _n; j++)
+		for (size_t k = _colOffsets[j]; k < _colOffsets[j+1]; k++)
+			if (_rows[k] != j) {
+
+				variables[j].push_back(_rows[k]);
+				variables[_rows[k]].push_back(j);
+			}
+
+	// elements adjacent to each variable
+	std::vector<std::vector<unsigned int>> elements(_n);
+
+	// the variables of each element
+	std::vector<std::vector<unsigned int>> cliques(_n);
+
+	std::vector<unsigned int> degree(_n);
+	std::vector<char>         eliminated(_n, 0);
+	std::vector<unsigned int> mark(_n, 0);
+	std::vector<int>          external(_n, -1);
+	unsigned int              stamp = 0;
+
+	// variables in doubly linked lists by degree
+	std::vector<int> head(_n, -1);
+	std::vector<int> next(_n, -1);
+	std::vector<int> prev(_n, -1);
+
+	auto insert = [&](unsigned int i) {
+
+		next[i] = head[degree[i]];
+		prev[i] = -1;
+		if (head[degree[i]] != -1)
+			prev[head[degree[i]]] = i;
+		head[degree[i]] = i;
+	};
+
+	auto remove = [&](unsigned int i) {
+
+		if (prev[i] != -1)
+			next[prev[i]] = next[i];
+		else
+			head[degree[i]] = next[i];
+		if (next[i] != -1)
+			prev[next[i]] = prev[i];
+	};
+
+	for (unsigned int i = 0; i < _n; i++) {
+
+		std::sort(variables[i].begin(), variables[i].end());
+		variables[i].erase(std::unique(variables[i].begin(), variables[i].end()), variables[i].end());
+		degree[i] = variables[i].size();
+		insert(i);
+	}
+
+	_perm.resize(_n);
+	_iperm.resize(_n);
+
+	std::vector<unsigned int> touched;
+	unsigned int minDegree = 0;
+
+	for (unsigned int k = 0; k < _n; k++) {
+
+		while (head[minDegree] == -1)
+			minDegree++;
+
+		unsigned int p = head[minDegree];
+		remove(p);
+
+		_perm[k]  = p;
+		_iperm[p] = k;
+		eliminated[p] = 1;
+
+		// the clique of p: its variables and the variables of its elements,
+		// which are absorbed by p
+
+		std::vector<unsigned int>& clique = cliques[p];
+		clique.clear();
+		mark[p] = ++stamp;
+
+		for (unsigned int i : variables[p])
+			if (!eliminated[i] && mark[i] != stamp) {
+
+				mark[i] = stamp;
+				clique.push_back(i);
+			}
+
+		for (unsigned int e : elements[p]) {
+
+			for (unsigned int i : cliques[e])
+				if (!eliminated[i] && mark[i] != stamp) {
+
+					mark[i] = stamp;
+					clique.push_back(i);
+				}
+
+			std::vector<unsigned int>().swap(cliques[e]);
+		}
+
+		std::vector<unsigned int>().swap(variables[p]);
+		std::vector<unsigned int>().swap(elements[p]);
+
+		// replace absorbed elements by p, and count for each other element
+		// its variables outside of the clique of p
+
+		for (unsigned int i : clique) {
+
+			remove(i);
+
+			std::vector<unsigned int>& adjacent = elements[i];
+			size_t kept = 0;
+			for (unsigned int e : adjacent) {
+
+				if (eliminated[e] && cliques[e].empty())
+					continue;
+
+				adjacent[kept++] = e;
+
+				if (external[e] < 0) {
+
+					external[e] = cliques[e].size();
+					touched.push_back(e);
+				}
+				external[e]--;
+			}
+			adjacent.resize(kept);
+			adjacent.push_back(p);
+		}
+
+		// approximate degrees of the variables in the clique
+
+		for (unsigned int i : clique) {
+
+			// variables in the clique are covered by p now
+			std::vector<unsigned int>& adjacent = variables[i];
+			size_t kept = 0;
+			for (unsigned int j : adjacent)
+				if (!eliminated[j] && mark[j] != stamp)
+					adjacent[kept++] = j;
+			adjacent.resize(kept);
+
+			size_t d = adjacent.size() + clique.size() - 1;
+			for (unsigned int e : elements[i])
+				if (e != p)
+					d += external[e];
+
+			degree[i] = std::min<size_t>(d, _n - k - 1);
+			insert(i);
+
+			minDegree = std::min(minDegree, degree[i]);
+		}
+
+		for (unsigned int e : touched)
+			external[e] = -1;
+		touched.clear();
+	}
+}
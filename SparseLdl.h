@@ -0,0 +1,126 @@
+#ifndef INFERENCE_SPARSE_LDL_H__
+#define INFERENCE_SPARSE_LDL_H__
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * Sparse LDL^T factorization of symmetric quasi-definite matrices, i.e.,
+ * matrices that can be factorized without pivoting.
+ *
+ * The factorization is split into a symbolic analysis of the sparsity pattern
+ * (fill-reducing approximate minimum degree ordering, elimination tree, and
+ * non-zeros of L) and a numeric factorization. The analysis is done once for a
+ * pattern, the numeric factorization can be repeated for new values with the
+ * same pattern.
+ *
+ * Matrices are given as the upper triangle in compressed sparse column
+ * format, including all diagonal entries.
+ */
+class SparseLdl {
+
+public:
+
+	SparseLdl();
+
+	/**
+	 * Analyze the sparsity pattern of a matrix.
+	 *
+	 * @param n
+	 *             The number of rows and columns.
+	 *
+	 * @param colOffsets
+	 *             The entries of column j are at positions
+	 *             [colOffsets[j], colOffsets[j+1]). Size n+1.
+	 *
+	 * @param rows
+	 *             The row of each entry, not larger than its column.
+	 */
+	void analyze(
+			unsigned int                     n,
+			const std::vector<size_t>&       colOffsets,
+			const std::vector<unsigned int>& rows);
+
+	/**
+	 * @return True, if analyze() has been called with the given pattern.
+	 */
+	bool hasPattern(
+			const std::vector<size_t>&       colOffsets,
+			const std::vector<unsigned int>& rows) const;
+
+	/**
+	 * Compute the numeric factorization for the values of the analyzed
+	 * pattern.
+	 *
+	 * @param values
+	 *             The value of each entry, in the order of the pattern.
+	 *
+	 * @return False, if a zero pivot was encountered.
+	 */
+	bool factorize(const std::vector<double>& values);
+
+	/**
+	 * @return The number of positive entries in D of the last factorization.
+	 */
+	unsigned int numPositivePivots() const { return _numPositive; }
+
+	/**
+	 * Solve Kx = b in place.
+	 *
+	 * @param x
+	 *             b on entry, x on exit.
+	 */
+	void solve(std::vector<double>& x);
+
+	/**
+	 * @return The number of non-zeros in L.
+	 */
+	size_t numFactorNonZeros() const { return _lRows.size(); }
+
+private:
+
+	// a fill-reducing ordering of the symmetric pattern, by approximate
+	// minimum degree
+	void orderMinimumDegree();
+
+	unsigned int _n;
+
+	// the analyzed pattern
+	std::vector<size_t>       _colOffsets;
+	std::vector<unsigned int> _rows;
+
+	// the permutation: _perm[new] = old, _iperm[old] = new
+	std::vector<unsigned int> _perm;
+	std::vector<unsigned int> _iperm;
+
+	// the permuted upper triangle, and for each entry of the analyzed
+	// pattern its position in it
+	std::vector<size_t>       _permColOffsets;
+	std::vector<unsigned int> _permRows;
+	std::vector<double>       _permValues;
+	std::vector<size_t>       _permPositions;
+
+	// the elimination tree, -1 for roots
+	std::vector<int> _etree;
+
+	// L, strictly lower triangular, column-wise
+	std::vector<size_t>       _lColOffsets;
+	std::vector<unsigned int> _lRows;
+	std::vector<double>       _lValues;
+
+	std::vector<double> _d;
+	std::vector<double> _dInv;
+
+	unsigned int _numPositive;
+
+	// work vectors
+	std::vector<double>       _work;
+	std::vector<double>       _yValues;
+	std::vector<unsigned int> _yPattern;
+	std::vector<unsigned int> _elimBuffer;
+	std::vector<size_t>       _nextInColumn;
+	std::vector<char>         _marked;
+};
+
+#endif // INFERENCE_SPARSE_LDL_H__
+
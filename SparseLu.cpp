@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <util/exceptions.h>
+#include "SparseLu.h"
+
+// a column is singular if its largest candidate pivot is smaller than this
+static const double SingularTolerance = 1e-11;
+
+// candidate pivots have to be at least this fraction of the largest one
+static const double PivotThreshold = 0.1;
+
+SparseLu::SparseLu() :
+	_m(0),
+	_lOffsets(1, 0),
+	_uOffsets(1, 0),
+	_etaOffsets(1, 0) {}
+
+bool
+SparseLu::factorize(
+		unsigned int                     m,
+		const std::vector<size_t>&       colOffsets,
+		const std::vector<unsigned int>& rows,
+		const std::vector<double>&       values) {
+
+	if (colOffsets.size() != m + 1 || colOffsets.back() != rows.size() || rows.size() != values.size())
+		UTIL_THROW_EXCEPTION(
+				SizeMismatchError,
+				"pattern does not describe a " << m << "x" << m << " matrix");
+
+	_m = m;
+
+	_etaPositions.clear();
+	_etaPivots.clear();
+	_etaOffsets.assign(1, 0);
+	_etaRows.clear();
+	_etaValues.clear();
+
+	// eliminate sparse columns first
+	_colOrder.resize(m);
+	std::iota(_colOrder.begin(), _colOrder.end(), 0);
+	std::stable_sort(
+			_colOrder.begin(),
+			_colOrder.end(),
+			[&colOffsets](unsigned int a, unsigned int b) {
+				return colOffsets[a+1] - colOffsets[a] < colOffsets[b+1] - colOffsets[b];
+			});
+
+	std::vector<unsigned int> rowCounts(m, 0);
+	for (unsigned int row : rows)
+		rowCounts[row]++;
+
+	_pivotRows.resize(m);
+	_rowPivots.assign(m, None);
+
+	_lOffsets.assign(1, 0);
+	_lRows.clear();
+	_lValues.clear();
+	_uOffsets.assign(1, 0);
+	_uRows.clear();
+	_uValues.clear();
+	_uDiagonal.resize(m);
+
+	// the column being eliminated, scattered over the rows
+	std::vector<double>       w(m, 0.0);
+	std::vector<unsigned int> touched;
+	std::vector<unsigned int> rowMarks(m, None);
+
+	// depth-first search over the columns of L reached from the column, the
+	// reached columns in reverse topological order
+	std::vector<unsigned int> colMarks(m, None);
+	std::vector<unsigned int> reached;
+	std::vector<std::pair<unsigned int, size_t>> stack;
+
+	for (unsigned int k = 0; k < m; k++) {
+
+		unsigned int p = _colOrder[k];
+
+		touched.clear();
+		reached.clear();
+
+		for (size_t e = colOffsets[p]; e < colOffsets[p+1]; e++) {
+
+			unsigned int i = rows[e];
+
+			w[i] = values[e];
+			touched.push_back(i);
+			rowMarks[i] = k;
+		}
+
+		for (size_t e = colOffsets[p]; e < colOffsets[p+1]; e++) {
+
+			unsigned int start = _rowPivots[rows[e]];
+			if (start == None || colMarks[start] == k)
+				continue;
+
+			colMarks[start] = k;
+			stack.push_back(std::make_pair(start, _lOffsets[start]));
+
+			while (!stack.empty()) {
+
+				unsigned int j    = stack.back().first;
+				size_t&      next = stack.back().second;
+
+				bool descended = false;
+				for (; next < _lOffsets[j+1]; next++) {
+
+					unsigned int child = _rowPivots[_lRows[next]];
+					if (child == None || colMarks[child] == k)
+						continue;
+
+					colMarks[child] = k;
+					next++;
+					stack.push_back(std::make_pair(child, _lOffsets[child]));
+					descended = true;
+					break;
+				}
+
+				if (!descended) {
+
+					reached.push_back(j);
+					stack.pop_back();
+				}
+			}
+		}
+
+		// sparse triangular solve with the reached columns of L
+		for (auto it = reached.rbegin(); it != reached.rend(); it++) {
+
+			unsigned int j = *it;
+			double xj = w[_pivotRows[j]];
+			if (xj == 0)
+				continue;
+
+			for (size_t l = _lOffsets[j]; l < _lOffsets[j+1]; l++) {
+
+				unsigned int i = _lRows[l];
+				if (rowMarks[i] != k) {
+
+					rowMarks[i] = k;
+					touched.push_back(i);
+				}
+				w[i] -= _lValues[l]*xj;
+			}
+		}
+
+		// the entries in pivot rows are the column of U, the others are
+		// candidates for the pivot
+		double largest = 0;
+		for (unsigned int i : touched)
+			if (_rowPivots[i] == None)
+				largest = std::max(largest, std::abs(w[i]));
+
+		if (largest < SingularTolerance) {
+
+			for (unsigned int i : touched)
+				w[i] = 0;
+			return false;
+		}
+
+		unsigned int pivotRow = None;
+		for (unsigned int i : touched) {
+
+			if (_rowPivots[i] != None || std::abs(w[i]) < PivotThreshold*largest)
+				continue;
+
+			if (pivotRow == None ||
+			    rowCounts[i] < rowCounts[pivotRow] ||
+			    (rowCounts[i] == rowCounts[pivotRow] && std::abs(w[i]) > std::abs(w[pivotRow])))
+				pivotRow = i;
+		}
+
+		double pivot = w[pivotRow];
+
+		for (unsigned int i : touched) {
+
+			if (w[i] != 0 && i != pivotRow) {
+
+				if (_rowPivots[i] != None) {
+
+					_uRows.push_back(_rowPivots[i]);
+					_uValues.push_back(w[i]);
+
+				} else {
+
+					_lRows.push_back(i);
+					_lValues.push_back(w[i]/pivot);
+				}
+			}
+
+			w[i] = 0;
+		}
+
+		_uOffsets.push_back(_uRows.size());
+		_lOffsets.push_back(_lRows.size());
+		_uDiagonal[k]       = pivot;
+		_pivotRows[k]       = pivotRow;
+		_rowPivots[pivotRow] = k;
+	}
+
+	return true;
+}
+
+void
+SparseLu::solve(std::vector<double>& x) const {
+
+	unsigned int m = _m;
+
+	// Lz = b, z by pivot index
+	_work.assign(m, 0.0);
+	for (unsigned int k = 0; k < m; k++) {
+
+		double z = x[_pivotRows[k]];
+		if (z == 0)
+			continue;
+
+		_work[k] = z;
+		for (size_t l = _lOffsets[k]; l < _lOffsets[k+1]; l++)
+			x[_lRows[l]] -= _lValues[l]*z;
+	}
+
+	// Uy = z
+	for (unsigned int k = m; k-- > 0;) {
+
+		if (_work[k] == 0)
+			continue;
+
+		double y = _work[k]/_uDiagonal[k];
+		_work[k] = y;
+		for (size_t u = _uOffsets[k]; u < _uOffsets[k+1]; u++)
+			_work[_uRows[u]] -= _uValues[u]*y;
+	}
+
+	for (unsigned int k = 0; k < m; k++)
+		x[_colOrder[k]] = _work[k];
+
+	// the updates, in the order they were applied
+	for (size_t t = 0; t < _etaPositions.size(); t++) {
+
+		unsigned int p = _etaPositions[t];
+
+		double xp = x[p]/_etaPivots[t];
+		x[p] = xp;
+		if (xp == 0)
+			continue;
+
+		for (size_t e = _etaOffsets[t]; e < _etaOffsets[t+1]; e++)
+			x[_etaRows[e]] -= _etaValues[e]*xp;
+	}
+}
+
+void
+SparseLu::solveTransposed(std::vector<double>& x) const {
+
+	unsigned int m = _m;
+
+	// the updates in reverse order, each changes the entry at its position
+	for (size_t t = _etaPositions.size(); t-- > 0;) {
+
+		unsigned int p = _etaPositions[t];
+
+		double s = x[p];
+		for (size_t e = _etaOffsets[t]; e < _etaOffsets[t+1]; e++)
+			s -= _etaValues[e]*x[_etaRows[e]];
+		x[p] = s/_etaPivots[t];
+	}
+
+	// U'v = c, v by pivot index
+	_work.resize(m);
+	for (unsigned int k = 0; k < m; k++) {
+
+		double s = x[_colOrder[k]];
+		for (size_t u = _uOffsets[k]; u < _uOffsets[k+1]; u++)
+			s -= _uValues[u]*_work[_uRows[u]];
+		_work[k] = s/_uDiagonal[k];
+	}
+
+	// L'x = v, the rows of column k of L have later pivots and are already
+	// computed
+	for (unsigned int k = m; k-- > 0;) {
+
+		double s = _work[k];
+		for (size_t l = _lOffsets[k]; l < _lOffsets[k+1]; l++)
+			s -= _lValues[l]*x[_lRows[l]];
+		x[_pivotRows[k]] = s;
+	}
+}
+
+void
+SparseLu::update(unsigned int p, const std::vector<double>& alpha) {
+
+	_etaPositions.push_back(p);
+	_etaPivots.push_back(alpha[p]);
+
+	for (unsigned int i = 0; i < _m; i++) {
+
+		if (i == p || alpha[i] == 0)
+			continue;
+
+		_etaRows.push_back(i);
+		_etaValues.push_back(alpha[i]);
+	}
+
+	_etaOffsets.push_back(_etaRows.size());
+}
@@ -0,0 +1,136 @@
+#ifndef INFERENCE_SPARSE_LU_H__
+#define INFERENCE_SPARSE_LU_H__
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * Sparse LU factorization of the basis matrix of a simplex, with product form
+ * updates for basis changes.
+ *
+ * The factorization is left-looking (Gilbert-Peierls): each column is solved
+ * against the columns of L computed so far, visiting only the columns its
+ * non-zeros reach. Columns are eliminated in the order of their number of
+ * non-zeros, such that slack columns come first and cause no fill. The pivot
+ * of a column is chosen among the entries within a threshold of the largest
+ * one, preferring rows with few non-zeros.
+ *
+ * Replacing a column of the basis matrix appends an eta column to the
+ * factorization instead of recomputing it. Solves get slower with each
+ * update, the factorization should be recomputed after a number of updates.
+ *
+ * Vectors are indexed by the rows of the matrix on the side of the right hand
+ * side of Bx = b, and by the positions of the columns (the basis positions) on
+ * the side of x.
+ */
+class SparseLu {
+
+public:
+
+	SparseLu();
+
+	/**
+	 * Factorize a square matrix. Discards all updates.
+	 *
+	 * @param m
+	 *             The number of rows and columns.
+	 *
+	 * @param colOffsets
+	 *             The entries of column p are at positions
+	 *             [colOffsets[p], colOffsets[p+1]). Size m+1.
+	 *
+	 * @param rows
+	 *             The row of each entry, distinct within a column.
+	 *
+	 * @param values
+	 *             The value of each entry.
+	 *
+	 * @return False, if the matrix is numerically singular.
+	 */
+	bool factorize(
+			unsigned int                     m,
+			const std::vector<size_t>&       colOffsets,
+			const std::vector<unsigned int>& rows,
+			const std::vector<double>&       values);
+
+	/**
+	 * Solve Bx = b in place.
+	 *
+	 * @param x
+	 *             b, indexed by rows, on entry, x, indexed by positions, on
+	 *             exit.
+	 */
+	void solve(std::vector<double>& x) const;
+
+	/**
+	 * Solve B'x = b in place.
+	 *
+	 * @param x
+	 *             b, indexed by positions, on entry, x, indexed by rows, on
+	 *             exit.
+	 */
+	void solveTransposed(std::vector<double>& x) const;
+
+	/**
+	 * Replace the column at position p by a column a.
+	 *
+	 * @param p
+	 *             The position of the column to replace.
+	 *
+	 * @param alpha
+	 *             The solution of Bx = a for the matrix before the update,
+	 *             with a non-zero entry at position p.
+	 */
+	void update(unsigned int p, const std::vector<double>& alpha);
+
+	/**
+	 * @return The number of updates since the last factorization.
+	 */
+	size_t numUpdates() const { return _etaPositions.size(); }
+
+	/**
+	 * @return The number of non-zeros in L and U.
+	 */
+	size_t numFactorNonZeros() const { return _lRows.size() + _uRows.size() + _m; }
+
+	/**
+	 * @return The number of non-zeros in the eta columns of the updates.
+	 */
+	size_t numUpdateNonZeros() const { return _etaRows.size() + _etaPositions.size(); }
+
+private:
+
+	static const unsigned int None = static_cast<unsigned int>(-1);
+
+	unsigned int _m;
+
+	// the position of the k-th eliminated column and its pivot row, and the
+	// pivot index of each row
+	std::vector<unsigned int> _colOrder;
+	std::vector<unsigned int> _pivotRows;
+	std::vector<unsigned int> _rowPivots;
+
+	// L, column k has a unit entry in _pivotRows[k] and the entries below in
+	// rows with later pivots
+	std::vector<size_t>       _lOffsets;
+	std::vector<unsigned int> _lRows;
+	std::vector<double>       _lValues;
+
+	// U, column-wise by pivot index, without the diagonal
+	std::vector<size_t>       _uOffsets;
+	std::vector<unsigned int> _uRows;
+	std::vector<double>       _uValues;
+	std::vector<double>       _uDiagonal;
+
+	// the eta columns of the updates, in the order they were applied
+	std::vector<unsigned int> _etaPositions;
+	std::vector<double>       _etaPivots;
+	std::vector<size_t>       _etaOffsets;
+	std::vector<unsigned int> _etaRows;
+	std::vector<double>       _etaValues;
+
+	// work vector for the solves
+	mutable std::vector<double> _work;
+};
+
+#endif // INFERENCE_SPARSE_LU_H__
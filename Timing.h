@@ -0,0 +1,15 @@
+#ifndef INFERENCE_TIMING_H__
+#define INFERENCE_TIMING_H__
+
+#include <chrono>
+
+/**
+ * @return The wall-clock seconds since start.
+ */
+inline double
+secondsSince(const std::chrono::steady_clock::time_point& start) {
+
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif // INFERENCE_TIMING_H__
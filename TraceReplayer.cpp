@@ -0,0 +1,360 @@
+#include <chrono>
+
+#include <util/Logger.h>
+#include "LinearConstraintMatrix.h"
+#include "LinearConstraints.h"
+#include "LinearObjective.h"
+#include "QuadraticSolverBackend.h"
+#include "Timing.h"
+#include "TraceReplayer.h"
+
+using namespace logger;
+
+LogChannel tracereplayerlog("tracereplayerlog", "[TraceReplayer] ");
+
+// read the sense, constant, and coefficients of an objective
+static void
+readObjective(TraceReader& reader, QuadraticObjective& objective) {
+
+	Sense    sense    = static_cast<Sense>(reader.get<int32_t>());
+	double   constant = reader.get<double>();
+	uint32_t size     = reader.get<uint32_t>();
+
+	std::vector<double> coefs = reader.getVector<double>(size);
+
+	objective.resize(size);
+	objective.setSense(sense);
+	objective.setConstant(constant);
+	for (unsigned int i = 0; i < size; i++)
+		objective.setCoefficient(i, coefs[i]);
+}
+
+TraceReplayer::TraceReplayer(const std::string& filename) :
+	_filename(filename) {
+
+	// check the header
+	TraceReader reader(filename);
+}
+
+bool
+TraceReplayer::isQuadratic() const {
+
+	TraceReader reader(_filename);
+
+	while (reader.next(false))
+		if (reader.getCall() == TraceSetQuadraticObjective)
+			return true;
+
+	return false;
+}
+
+void
+TraceReplayer::replay(LinearSolverBackend& backend, const Callback& callback) const {
+
+	TraceReader reader(_filename);
+
+	while (reader.next()) {
+
+		Call call;
+		call.number          = reader.getNumber();
+		call.call            = reader.getCall();
+		call.skipped         = false;
+		call.recordedSeconds = reader.getSeconds();
+		call.replayedSeconds = 0;
+		call.recordedSolved  = false;
+		call.replayedSolved  = false;
+		call.recordedValue   = 0;
+		call.replayedValue   = 0;
+
+		std::chrono::steady_clock::time_point start;
+
+		switch (call.call) {
+
+			case TraceInitialize: {
+
+				uint32_t     numVariables = reader.get<uint32_t>();
+				VariableType defaultType  = static_cast<VariableType>(reader.get<int32_t>());
+				uint32_t     numSpecial   = reader.get<uint32_t>();
+
+				std::map<unsigned int, VariableType> specialTypes;
+				for (unsigned int i = 0; i < numSpecial; i++) {
+
+					uint32_t variable = reader.get<uint32_t>();
+					specialTypes[variable] = static_cast<VariableType>(reader.get<int32_t>());
+				}
+
+				start = std::chrono::steady_clock::now();
+				backend.initialize(numVariables, defaultType, specialTypes);
+				break;
+			}
+
+			case TraceSetObjective: {
+
+				LinearObjective objective;
+				readObjective(reader, objective);
+
+				start = std::chrono::steady_clock::now();
+				backend.setObjective(objective);
+				break;
+			}
+
+			case TraceSetQuadraticObjective: {
+
+				QuadraticSolverBackend* quadraticBackend = dynamic_cast<QuadraticSolverBackend*>(&backend);
+				if (!quadraticBackend)
+					UTIL_THROW_EXCEPTION(
+							UsageError,
+							"the trace sets a quadratic objective, which needs a QuadraticSolverBackend");
+
+				QuadraticObjective objective;
+				readObjective(reader, objective);
+
+				uint64_t numTerms = reader.get<uint64_t>();
+				std::vector<unsigned int> rows   = reader.getVector<unsigned int>(numTerms);
+				std::vector<unsigned int> cols   = reader.getVector<unsigned int>(numTerms);
+				std::vector<double>       values = reader.getVector<double>(numTerms);
+
+				for (uint64_t k = 0; k < numTerms; k++)
+					if (rows[k] >= objective.size() || cols[k] >= objective.size())
+						UTIL_THROW_EXCEPTION(
+								IOError,
+								_filename << ": record " << call.number << " has a quadratic term out of range");
+
+				objective.addQuadraticTerms(rows, cols, values);
+
+				start = std::chrono::steady_clock::now();
+				quadraticBackend->setObjective(objective);
+				break;
+			}
+
+			case TraceSetConstraints: {
+
+				TraceConstraintsType type = static_cast<TraceConstraintsType>(reader.get<uint8_t>());
+				uint32_t numRows     = reader.get<uint32_t>();
+				uint64_t numNonZeros = reader.get<uint64_t>();
+
+				std::vector<uint64_t>     offsets   = reader.getVector<uint64_t>(static_cast<size_t>(numRows) + 1);
+				std::vector<unsigned int> columns   = reader.getVector<unsigned int>(numNonZeros);
+				std::vector<double>       coefs     = reader.getVector<double>(numNonZeros);
+				std::vector<int32_t>      relations = reader.getVector<int32_t>(numRows);
+				std::vector<double>       values    = reader.getVector<double>(numRows);
+
+				if (offsets[0] != 0 || offsets[numRows] != numNonZeros)
+					UTIL_THROW_EXCEPTION(
+							IOError,
+							_filename << ": record " << call.number << " has invalid row offsets");
+
+				LinearConstraintMatrix matrix;
+				matrix.reserve(numRows, numNonZeros);
+				for (unsigned int i = 0; i < numRows; i++) {
+
+					if (offsets[i] > offsets[i + 1])
+						UTIL_THROW_EXCEPTION(
+								IOError,
+								_filename << ": record " << call.number << " has invalid row offsets");
+
+					matrix.addRow(
+							offsets[i + 1] - offsets[i],
+							columns.data() + offsets[i],
+							coefs.data() + offsets[i],
+							static_cast<Relation>(relations[i]),
+							values[i]);
+				}
+
+				// call the recorded overload
+				if (type == TraceLinearConstraints) {
+
+					LinearConstraints constraints;
+					for (unsigned int i = 0; i < numRows; i++) {
+
+						LinearConstraint constraint;
+						for (uint64_t k = offsets[i]; k < offsets[i + 1]; k++)
+							constraint.setCoefficient(columns[k], coefs[k]);
+						constraint.setRelation(static_cast<Relation>(relations[i]));
+						constraint.setValue(values[i]);
+						constraints.add(constraint);
+					}
+
+					start = std::chrono::steady_clock::now();
+					backend.setConstraints(constraints);
+
+				} else if (type == TraceLinearConstraintMatrix) {
+
+					start = std::chrono::steady_clock::now();
+					backend.setConstraints(matrix);
+
+				} else {
+
+					LinearConstraintMatrixView view = matrix.view();
+
+					start = std::chrono::steady_clock::now();
+					backend.setConstraints(view);
+				}
+
+				break;
+			}
+
+			case TraceAddConstraint: {
+
+				uint32_t size = reader.get<uint32_t>();
+				std::vector<unsigned int> variables = reader.getVector<unsigned int>(size);
+				std::vector<double>       coefs     = reader.getVector<double>(size);
+
+				LinearConstraint constraint;
+				for (unsigned int k = 0; k < size; k++)
+					constraint.setCoefficient(variables[k], coefs[k]);
+				constraint.setRelation(static_cast<Relation>(reader.get<int32_t>()));
+				constraint.setValue(reader.get<double>());
+
+				start = std::chrono::steady_clock::now();
+				backend.addConstraint(constraint);
+				break;
+			}
+
+			case TraceSetObjectiveCoefficient: {
+
+				uint32_t variable = reader.get<uint32_t>();
+				double   coef     = reader.get<double>();
+
+				start = std::chrono::steady_clock::now();
+				backend.setObjectiveCoefficient(variable, coef);
+				break;
+			}
+
+			case TraceSetVariableBounds: {
+
+				uint32_t variable = reader.get<uint32_t>();
+				double   lower    = reader.get<double>();
+				double   upper    = reader.get<double>();
+
+				start = std::chrono::steady_clock::now();
+				backend.setVariableBounds(variable, lower, upper);
+				break;
+			}
+
+			case TraceSetConstraintValue: {
+
+				uint32_t constraint = reader.get<uint32_t>();
+				double   value      = reader.get<double>();
+
+				start = std::chrono::steady_clock::now();
+				backend.setConstraintValue(constraint, value);
+				break;
+			}
+
+			case TraceRemoveConstraints: {
+
+				uint32_t size = reader.get<uint32_t>();
+				std::vector<unsigned int> constraints = reader.getVector<unsigned int>(size);
+
+				start = std::chrono::steady_clock::now();
+				backend.removeConstraints(constraints);
+				break;
+			}
+
+			case TraceSetStartSolution: {
+
+				bool     isSolution = reader.get<uint8_t>();
+				uint32_t size       = reader.get<uint32_t>();
+				std::vector<unsigned int> variables = reader.getVector<unsigned int>(size);
+				std::vector<double>       values    = reader.getVector<double>(size);
+
+				if (isSolution) {
+
+					Solution solution(size);
+					for (unsigned int k = 0; k < size; k++)
+						solution[k] = values[k];
+
+					start = std::chrono::steady_clock::now();
+					backend.setStartSolution(solution);
+
+				} else {
+
+					std::map<unsigned int, double> startValues;
+					for (unsigned int k = 0; k < size; k++)
+						startValues[variables[k]] = values[k];
+
+					start = std::chrono::steady_clock::now();
+					backend.setStartSolution(startValues);
+				}
+
+				break;
+			}
+
+			case TraceSetSeparator: {
+
+				LOG_USER(tracereplayerlog)
+						<< "call " << call.number << " set a separator, which can not be replayed, "
+						<< "solve() will not see its constraints" << std::endl;
+
+				call.skipped = true;
+				break;
+			}
+
+			case TraceSetTimeout: {
+
+				double timeout = reader.get<double>();
+
+				start = std::chrono::steady_clock::now();
+				backend.setTimeout(timeout);
+				break;
+			}
+
+			case TraceSetOptimalityGap: {
+
+				double gap      = reader.get<double>();
+				bool   absolute = reader.get<uint8_t>();
+
+				start = std::chrono::steady_clock::now();
+				backend.setOptimalityGap(gap, absolute);
+				break;
+			}
+
+			case TraceSetNumThreads: {
+
+				uint32_t numThreads = reader.get<uint32_t>();
+
+				start = std::chrono::steady_clock::now();
+				backend.setNumThreads(numThreads);
+				break;
+			}
+
+			case TraceSetVerbose: {
+
+				bool verbose = reader.get<uint8_t>();
+
+				start = std::chrono::steady_clock::now();
+				backend.setVerbose(verbose);
+				break;
+			}
+
+			case TraceSolve: {
+
+				call.recordedSolved = reader.get<uint8_t>();
+				call.recordedValue  = reader.get<double>();
+				reader.get<uint32_t>();
+
+				uint32_t length = reader.get<uint32_t>();
+				std::vector<char> message = reader.getVector<char>(length);
+				call.recordedMessage.assign(message.begin(), message.end());
+
+				Solution solution;
+
+				start = std::chrono::steady_clock::now();
+				call.replayedSolved = backend.solve(solution, call.replayedMessage);
+				call.replayedValue  = solution.getValue();
+				break;
+			}
+
+			default:
+
+				break;
+		}
+
+		if (!call.skipped)
+			call.replayedSeconds = secondsSince(start);
+
+		if (callback)
+			callback(call);
+	}
+}
@@ -0,0 +1,83 @@
+#ifndef INFERENCE_TRACE_REPLAYER_H__
+#define INFERENCE_TRACE_REPLAYER_H__
+
+#include <functional>
+#include <string>
+
+#include "BackendTrace.h"
+#include "LinearSolverBackend.h"
+
+/**
+ * Replays a trace written by RecordingBackend against a backend, and times
+ * each call:
+ *
+ *   TraceReplayer replayer("session.trace");
+ *   replayer.replay(*backend, [](const TraceReplayer::Call& call) {
+ *       std::cout << traceCallName(call.call) << " " << call.replayedSeconds << std::endl;
+ *   });
+ *
+ * The arguments of a call are decoded before it is timed, so that only the
+ * time spent in the backend is measured.
+ */
+class TraceReplayer {
+
+public:
+
+	/**
+	 * A replayed call.
+	 */
+	struct Call {
+
+		// the number of the call in the trace
+		size_t number;
+
+		TraceCall call;
+
+		// whether the call was skipped, see replay()
+		bool skipped;
+
+		// the wall times when the call was recorded and replayed
+		double recordedSeconds;
+		double replayedSeconds;
+
+		// for solve(), the recorded and replayed results
+		bool   recordedSolved;
+		bool   replayedSolved;
+		double recordedValue;
+		double replayedValue;
+		std::string recordedMessage;
+		std::string replayedMessage;
+	};
+
+	typedef std::function<void(const Call& call)> Callback;
+
+	/**
+	 * Open a trace. Throws an IOError if it is not a trace of this version.
+	 */
+	explicit TraceReplayer(const std::string& filename);
+
+	/**
+	 * @return Whether the trace sets a quadratic objective, which needs a
+	 *         QuadraticSolverBackend to replay.
+	 */
+	bool isQuadratic() const;
+
+	/**
+	 * Replay all calls of the trace. Calls to setSeparator() are skipped,
+	 * since separators can not be recorded.
+	 *
+	 * @param backend
+	 *             The backend to replay the calls on.
+	 *
+	 * @param callback
+	 *             Called after each replayed call.
+	 */
+	void replay(LinearSolverBackend& backend, const Callback& callback = Callback()) const;
+
+private:
+
+	std::string _filename;
+};
+
+#endif // INFERENCE_TRACE_REPLAYER_H__
+
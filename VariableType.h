@@ -1,6 +1,8 @@
 #ifndef INFERENCE_VARIABLE_TYPE_H__
 #define INFERENCE_VARIABLE_TYPE_H__
 
+#include <limits>
+
 enum VariableType {
 
 	Continuous,
@@ -8,5 +10,30 @@ enum VariableType {
 	Binary
 };
 
-#endif // INFERENCE_VARIABLE_TYPE_H__
+/**
+ * @return The bounds a variable of the given type has unless set otherwise,
+ *         i.e., [0,1] for binary and unbounded for other variables.
+ */
+inline double
+defaultLowerBound(VariableType type) {
+
+	return (type == Binary ? 0 : -std::numeric_limits<double>::infinity());
+}
+
+inline double
+defaultUpperBound(VariableType type) {
 
+	return (type == Binary ? 1 : std::numeric_limits<double>::infinity());
+}
+
+/**
+ * @return True, if the bounds are the defaults of the given type, and thus
+ *         do not have to be passed to a backend.
+ */
+inline bool
+hasDefaultBounds(VariableType type, double lower, double upper) {
+
+	return lower == defaultLowerBound(type) && upper == defaultUpperBound(type);
+}
+
+#endif // INFERENCE_VARIABLE_TYPE_H__
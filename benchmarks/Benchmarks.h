@@ -0,0 +1,95 @@
+#ifndef SOLVERS_BENCHMARKS_H__
+#define SOLVERS_BENCHMARKS_H__
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <boost/timer/timer.hpp>
+
+#include "../BackendPreference.h"
+
+/**
+ * Measures elapsed wall-clock time in seconds.
+ */
+class WallTimer {
+
+public:
+
+	WallTimer() { _timer.start(); }
+
+	/**
+	 * @return The wall-clock seconds since construction or the last call to
+	 * restart().
+	 */
+	double seconds() const { return _timer.elapsed().wall*1e-9; }
+
+	void restart() { _timer.start(); }
+
+private:
+
+	boost::timer::cpu_timer _timer;
+};
+
+/**
+ * @return The backends that can be created by the SolverFactory in this build,
+ * excluding Any.
+ */
+std::vector<Preference> availableBackends();
+
+/**
+ * @return The backends that can be created by the SolverFactory as quadratic
+ * solver backends in this build, excluding Any.
+ */
+std::vector<Preference> availableQuadraticBackends();
+
+/**
+ * @return A human readable name for a backend preference.
+ */
+std::string backendName(Preference preference);
+
+/**
+ * Time the construction of LinearConstraints and LinearConstraintMatrix, and
+ * the setConstraints() calls of all available backends, for the given numbers
+ * of rows.
+ */
+void benchmarkConstraintLoading(const std::vector<size_t>& numRows);
+
+/**
+ * Time the construction of QuadraticObjective and the setObjective() calls of
+ * all available quadratic backends, for the given numbers of quadratic terms.
+ */
+void benchmarkObjectiveLoading(const std::vector<size_t>& numTerms);
+
+/**
+ * Time setup and solve of random continuous LPs with all available backends,
+ * for the given numbers of variables. Small sizes are repeated over several
+ * instances, to measure the per-call overhead of the backends.
+ */
+void benchmarkLpSolving(const std::vector<size_t>& numVariables);
+
+/**
+ * Time setup and solve of random convex QPs with all available quadratic
+ * backends, for the given numbers of variables.
+ */
+void benchmarkQpSolving(const std::vector<size_t>& numVariables);
+
+/**
+ * Time model build, backend initialization, setObjective(), setConstraints(),
+ * solve, and solution extraction of all available backends on synthetic
+ * instance families (assignment, set cover, multicut, sparse QP, and a
+ * block-diagonal mix), for the given numbers of non-zeros. Writes one CSV row
+ * per family, size, and backend to 'out'.
+ */
+void benchmarkInstanceFamilies(const std::vector<size_t>& numNonZeros, std::ostream& out);
+
+/**
+ * Time writing and reading back random mixed-integer QPs in LP and MPS
+ * format, for the given numbers of variables, and check that the model that
+ * was read is the one that was written.
+ *
+ * @return True, if all round trips gave the same model.
+ */
+bool benchmarkModelIo(const std::vector<size_t>& numVariables);
+
+#endif // SOLVERS_BENCHMARKS_H__
+
@@ -0,0 +1,108 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <algorithm>
+
+#include "../LinearConstraints.h"
+#include "../LinearConstraintMatrix.h"
+#include "../LinearSolverBackend.h"
+#include "../SolverFactory.h"
+#include "Benchmarks.h"
+
+// number of non-zeros per generated constraint
+static const unsigned int NonZerosPerRow = 4;
+
+// the map-based LinearConstraints get too large beyond this number of rows
+static const size_t MaxMapRows = 1000000;
+
+static void
+generateConstraints(size_t numRows, unsigned int numVariables, LinearConstraintMatrix& matrix) {
+
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<unsigned int> variable(0, numVariables - NonZerosPerRow);
+	std::uniform_real_distribution<double> coefficient(-1.0, 1.0);
+
+	matrix.clear();
+	matrix.reserve(numRows, numRows*NonZerosPerRow);
+
+	unsigned int varNums[NonZerosPerRow];
+	double       coefs[NonZerosPerRow];
+
+	for (size_t i = 0; i < numRows; i++) {
+
+		// consecutive variables starting at a random offset, to keep them
+		// distinct within a row
+		unsigned int first = variable(generator);
+		for (unsigned int j = 0; j < NonZerosPerRow; j++) {
+
+			varNums[j] = first + j;
+			coefs[j]   = coefficient(generator);
+		}
+
+		matrix.addRow(NonZerosPerRow, varNums, coefs, LessEqual, 1.0);
+	}
+}
+
+void
+benchmarkConstraintLoading(const std::vector<size_t>& sizes) {
+
+	SolverFactory factory;
+	std::vector<Preference> backends = availableBackends();
+
+	std::cout << std::setw(10) << "rows" << std::setw(10) << "backend"
+			  << std::setw(14) << "build [s]" << std::setw(14) << "load [s]"
+			  << "  input" << std::endl;
+
+	for (size_t numRows : sizes) {
+
+		unsigned int numVariables = std::max<size_t>(numRows/2, 2*NonZerosPerRow);
+
+		WallTimer timer;
+		LinearConstraintMatrix matrix;
+		generateConstraints(numRows, numVariables, matrix);
+		double matrixBuild = timer.seconds();
+
+		std::cout << std::setw(10) << numRows << std::setw(10) << "-"
+				  << std::setw(14) << matrixBuild << std::setw(14) << "-"
+				  << "  LinearConstraintMatrix" << std::endl;
+
+		LinearConstraints constraints;
+		double mapBuild = 0;
+		if (numRows <= MaxMapRows) {
+
+			timer.restart();
+			constraints = matrix.toLinearConstraints();
+			mapBuild = timer.seconds();
+
+			std::cout << std::setw(10) << numRows << std::setw(10) << "-"
+					  << std::setw(14) << mapBuild << std::setw(14) << "-"
+					  << "  LinearConstraints" << std::endl;
+		}
+
+		for (Preference preference : backends) {
+
+			std::shared_ptr<LinearSolverBackend> backend = factory.createLinearSolverBackend(preference);
+			backend->initialize(numVariables, Continuous);
+
+			timer.restart();
+			backend->setConstraints(matrix);
+			double matrixLoad = timer.seconds();
+
+			std::cout << std::setw(10) << numRows << std::setw(10) << backendName(preference)
+					  << std::setw(14) << matrixBuild << std::setw(14) << matrixLoad
+					  << "  LinearConstraintMatrix" << std::endl;
+
+			if (numRows > MaxMapRows)
+				continue;
+
+			timer.restart();
+			backend->setConstraints(constraints);
+			double mapLoad = timer.seconds();
+
+			std::cout << std::setw(10) << numRows << std::setw(10) << backendName(preference)
+					  << std::setw(14) << mapBuild << std::setw(14) << mapLoad
+					  << "  LinearConstraints" << std::endl;
+		}
+	}
+}
+
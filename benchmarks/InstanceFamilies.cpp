@@ -0,0 +1,471 @@
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+#include "../LinearConstraintMatrix.h"
+#include "../LinearConstraints.h"
+#include "../LinearObjective.h"
+#include "../QuadraticObjective.h"
+#include "../QuadraticSolverBackend.h"
+#include "../SolveStatistics.h"
+#include "../SolverFactory.h"
+#include "Benchmarks.h"
+
+// number of candidate tasks per worker in the assignment family
+static const unsigned int CandidatesPerWorker = 10;
+
+// number of elements covered by each set in the set cover family
+static const unsigned int SetSize = 10;
+
+// number of non-zeros per generated constraint in the sparse QP family
+static const unsigned int NonZerosPerRow = 5;
+
+// number of non-zeros of each block in the block-diagonal family
+static const size_t BlockNonZeros = 1000;
+
+// the map-based LinearConstraints get too large beyond this number of
+// non-zeros, larger instances are built as LinearConstraintMatrix
+static const size_t MaxMapNonZeros = 4000000;
+
+// the native QP backend factorizes the KKT matrix before it checks the
+// timeout, which fills in on the random sparse QPs, solve only instances up
+// to this number of non-zeros with it
+static const size_t MaxNativeQuadraticNonZeros = 10000;
+
+// timeout for each solve in seconds
+static const double SolveTimeout = 60;
+
+/**
+ * A generated instance, in a raw form that is converted to LinearConstraints
+ * and objectives in the timed build phase.
+ */
+struct Instance {
+
+	Instance() :
+		numVariables(0),
+		type(Binary),
+		hasBounds(false),
+		lowerBound(0),
+		upperBound(0),
+		rowOffsets(1, 0) {}
+
+	void addRow(const std::vector<unsigned int>& varNums, const std::vector<double>& coefs, Relation relation, double value) {
+
+		columns.insert(columns.end(), varNums.begin(), varNums.end());
+		coefficients.insert(coefficients.end(), coefs.begin(), coefs.end());
+		relations.push_back(relation);
+		values.push_back(value);
+		rowOffsets.push_back(columns.size());
+	}
+
+	size_t numRows() const { return relations.size(); }
+
+	// non-zeros of the constraints and quadratic terms of the objective
+	size_t numNonZeros() const { return columns.size() + quadraticValues.size(); }
+
+	bool isQuadratic() const { return !quadraticValues.empty(); }
+
+	unsigned int numVariables;
+	VariableType type;
+
+	// bounds of all variables, if hasBounds
+	bool   hasBounds;
+	double lowerBound;
+	double upperBound;
+
+	std::vector<double> linear;
+
+	std::vector<unsigned int> quadraticRows;
+	std::vector<unsigned int> quadraticCols;
+	std::vector<double>       quadraticValues;
+
+	std::vector<size_t>       rowOffsets;
+	std::vector<unsigned int> columns;
+	std::vector<double>       coefficients;
+	std::vector<Relation>     relations;
+	std::vector<double>       values;
+};
+
+// add 'size' distinct numbers in [begin, end) to 'numbers', keeping the ones
+// already in there
+static void
+drawDistinct(
+		unsigned int               size,
+		unsigned int               begin,
+		unsigned int               end,
+		std::mt19937&              generator,
+		std::vector<unsigned int>& numbers) {
+
+	std::uniform_int_distribution<unsigned int> number(begin, end - 1);
+
+	while (numbers.size() < size) {
+
+		unsigned int n = number(generator);
+		if (std::find(numbers.begin(), numbers.end(), n) == numbers.end())
+			numbers.push_back(n);
+	}
+}
+
+// a sparse assignment problem: each worker is assigned to exactly one of its
+// candidate tasks, and each task to exactly one worker, at minimal cost. Task
+// i is always a candidate of worker i, which keeps the instance feasible.
+static void
+appendAssignment(size_t numNonZeros, std::mt19937& generator, Instance& instance) {
+
+	unsigned int numWorkers = std::max<size_t>(numNonZeros/(2*CandidatesPerWorker), CandidatesPerWorker);
+	unsigned int offset     = instance.numVariables;
+
+	std::uniform_real_distribution<double> cost(0.0, 1.0);
+
+	std::vector<std::vector<unsigned int>> taskVariables(numWorkers);
+	std::vector<unsigned int> tasks;
+	std::vector<unsigned int> varNums(CandidatesPerWorker);
+	std::vector<double>       ones(CandidatesPerWorker, 1.0);
+
+	for (unsigned int i = 0; i < numWorkers; i++) {
+
+		tasks.assign(1, i);
+		drawDistinct(CandidatesPerWorker, 0, numWorkers, generator, tasks);
+
+		for (unsigned int j = 0; j < CandidatesPerWorker; j++) {
+
+			varNums[j] = offset + i*CandidatesPerWorker + j;
+			taskVariables[tasks[j]].push_back(varNums[j]);
+			instance.linear.push_back(cost(generator));
+		}
+
+		instance.addRow(varNums, ones, Equal, 1.0);
+	}
+
+	for (unsigned int t = 0; t < numWorkers; t++) {
+
+		ones.resize(taskVariables[t].size(), 1.0);
+		instance.addRow(taskVariables[t], ones, Equal, 1.0);
+	}
+
+	instance.numVariables += numWorkers*CandidatesPerWorker;
+}
+
+// a weighted set cover problem over twice as many elements as sets. Set s
+// always covers the elements 2s and 2s+1, which keeps the instance feasible.
+static void
+appendSetCover(size_t numNonZeros, std::mt19937& generator, Instance& instance) {
+
+	unsigned int numSets     = std::max<size_t>(numNonZeros/SetSize, SetSize);
+	unsigned int numElements = 2*numSets;
+	unsigned int offset      = instance.numVariables;
+
+	std::uniform_real_distribution<double> cost(1.0, 2.0);
+
+	std::vector<std::vector<unsigned int>> elementSets(numElements);
+	std::vector<unsigned int> elements;
+
+	for (unsigned int s = 0; s < numSets; s++) {
+
+		elements.assign({ 2*s, 2*s + 1 });
+		drawDistinct(SetSize, 0, numElements, generator, elements);
+
+		for (unsigned int e : elements)
+			elementSets[e].push_back(offset + s);
+
+		instance.linear.push_back(cost(generator));
+	}
+
+	std::vector<double> ones;
+	for (unsigned int e = 0; e < numElements; e++) {
+
+		ones.resize(elementSets[e].size(), 1.0);
+		instance.addRow(elementSets[e], ones, GreaterEqual, 1.0);
+	}
+
+	instance.numVariables += numSets;
+}
+
+// a multicut problem on a grid graph with attractive and repulsive edges, with
+// the cycle constraints of the faces of the grid, as they are used as initial
+// constraints before further cycles are separated
+static void
+appendMulticut(size_t numNonZeros, std::mt19937& generator, Instance& instance) {
+
+	// each face contributes four constraints with four non-zeros
+	unsigned int width  = std::max<unsigned int>(std::sqrt(numNonZeros/16.0) + 1, 2);
+	unsigned int offset = instance.numVariables;
+
+	// horizontal edges first, then vertical ones
+	unsigned int numHorizontal = (width - 1)*width;
+	auto horizontal = [&](unsigned int x, unsigned int y) { return offset + y*(width - 1) + x; };
+	auto vertical   = [&](unsigned int x, unsigned int y) { return offset + numHorizontal + y*width + x; };
+
+	std::uniform_real_distribution<double> weight(-1.0, 1.0);
+	for (unsigned int e = 0; e < 2*numHorizontal; e++)
+		instance.linear.push_back(weight(generator));
+
+	std::vector<unsigned int> cycle(4);
+	std::vector<double>       coefs(4);
+
+	for (unsigned int y = 0; y + 1 < width; y++)
+		for (unsigned int x = 0; x + 1 < width; x++) {
+
+			cycle[0] = horizontal(x, y);
+			cycle[1] = vertical(x + 1, y);
+			cycle[2] = horizontal(x, y + 1);
+			cycle[3] = vertical(x, y);
+
+			// an edge can only be cut if another edge of the cycle is
+			for (unsigned int i = 0; i < 4; i++) {
+
+				for (unsigned int j = 0; j < 4; j++)
+					coefs[j] = (i == j ? 1.0 : -1.0);
+
+				instance.addRow(cycle, coefs, LessEqual, 0.0);
+			}
+		}
+
+	instance.numVariables += 2*numHorizontal;
+}
+
+// a convex QP min xQx + <c,x> s.t. Ax <= b, -10 <= x <= 10, with a diagonally
+// dominant tridiagonal Q
+static void
+appendSparseQp(size_t numNonZeros, std::mt19937& generator, Instance& instance) {
+
+	// two quadratic terms per variable, and half a row
+	unsigned int numVariables = std::max<size_t>(2*numNonZeros/(4 + NonZerosPerRow), NonZerosPerRow);
+	unsigned int offset       = instance.numVariables;
+
+	std::uniform_real_distribution<double> coefficient(-1.0, 1.0);
+
+	for (unsigned int i = 0; i < numVariables; i++) {
+
+		instance.linear.push_back(coefficient(generator));
+
+		instance.quadraticRows.push_back(offset + i);
+		instance.quadraticCols.push_back(offset + i);
+		instance.quadraticValues.push_back(1.0 + 0.5*coefficient(generator));
+
+		if (i + 1 < numVariables) {
+
+			instance.quadraticRows.push_back(offset + i);
+			instance.quadraticCols.push_back(offset + i + 1);
+			instance.quadraticValues.push_back(0.5*coefficient(generator));
+		}
+	}
+
+	std::vector<unsigned int> varNums;
+	std::vector<double>       coefs(NonZerosPerRow);
+
+	for (unsigned int i = 0; i < numVariables/2; i++) {
+
+		varNums.clear();
+		drawDistinct(NonZerosPerRow, offset, offset + numVariables, generator, varNums);
+		for (unsigned int j = 0; j < NonZerosPerRow; j++)
+			coefs[j] = coefficient(generator);
+
+		instance.addRow(varNums, coefs, LessEqual, 1.0);
+	}
+
+	instance.numVariables += numVariables;
+	instance.type       = Continuous;
+	instance.hasBounds  = true;
+	instance.lowerBound = -10.0;
+	instance.upperBound =  10.0;
+}
+
+// independent blocks of the assignment, set cover, and multicut families, as
+// they appear when many small problems are solved jointly
+static void
+appendBlockDiagonal(size_t numNonZeros, std::mt19937& generator, Instance& instance) {
+
+	size_t numBlocks = std::max<size_t>(numNonZeros/BlockNonZeros, 3);
+
+	for (size_t b = 0; b < numBlocks; b++) {
+
+		switch (b%3) {
+
+			case 0: appendAssignment(numNonZeros/numBlocks, generator, instance); break;
+			case 1: appendSetCover(numNonZeros/numBlocks, generator, instance); break;
+			case 2: appendMulticut(numNonZeros/numBlocks, generator, instance); break;
+		}
+	}
+}
+
+struct Family {
+
+	const char* name;
+	void (*append)(size_t numNonZeros, std::mt19937& generator, Instance& instance);
+};
+
+static const Family Families[] = {
+
+	{ "assignment",     appendAssignment },
+	{ "setcover",       appendSetCover },
+	{ "multicut",       appendMulticut },
+	{ "sparseqp",       appendSparseQp },
+	{ "blockdiagonal",  appendBlockDiagonal }
+};
+
+static void
+buildConstraints(const Instance& instance, LinearConstraints& constraints) {
+
+	constraints.clear();
+
+	for (size_t i = 0; i < instance.numRows(); i++) {
+
+		LinearConstraint constraint;
+		for (size_t k = instance.rowOffsets[i]; k < instance.rowOffsets[i + 1]; k++)
+			constraint.setCoefficient(instance.columns[k], instance.coefficients[k]);
+		constraint.setRelation(instance.relations[i]);
+		constraint.setValue(instance.values[i]);
+
+		constraints.add(constraint);
+	}
+}
+
+static void
+buildConstraints(const Instance& instance, LinearConstraintMatrix& matrix) {
+
+	matrix.clear();
+	matrix.reserve(instance.numRows(), instance.columns.size());
+
+	for (size_t i = 0; i < instance.numRows(); i++)
+		matrix.addRow(
+				instance.rowOffsets[i + 1] - instance.rowOffsets[i],
+				instance.columns.data() + instance.rowOffsets[i],
+				instance.coefficients.data() + instance.rowOffsets[i],
+				instance.relations[i],
+				instance.values[i]);
+}
+
+static void
+buildObjective(const Instance& instance, QuadraticObjective& objective) {
+
+	objective.resize(instance.numVariables);
+	objective.setSense(Minimize);
+	for (unsigned int i = 0; i < instance.numVariables; i++)
+		objective.setCoefficient(i, instance.linear[i]);
+
+	if (instance.isQuadratic()) {
+
+		objective.addQuadraticTerms(instance.quadraticRows, instance.quadraticCols, instance.quadraticValues);
+
+		// the terms are merged lazily, include this in the build
+		objective.numQuadraticTerms();
+	}
+}
+
+void
+benchmarkInstanceFamilies(const std::vector<size_t>& sizes, std::ostream& out) {
+
+	SolverFactory factory;
+	std::vector<Preference> linearBackends    = availableBackends();
+	std::vector<Preference> quadraticBackends = availableQuadraticBackends();
+
+	out << "family,target_nonzeros,nonzeros,variables,rows,constraints,backend,"
+		<< "build_s,initialize_s,objective_s,constraints_s,solve_s,extract_s,status,value,selected"
+		<< std::endl;
+
+	for (size_t numNonZeros : sizes) {
+
+		for (const Family& family : Families) {
+
+			std::mt19937 generator(42);
+			Instance instance;
+			family.append(numNonZeros, generator, instance);
+
+			bool useMap = (instance.columns.size() <= MaxMapNonZeros);
+
+			WallTimer timer;
+			LinearConstraints      constraints;
+			LinearConstraintMatrix matrix;
+			if (useMap)
+				buildConstraints(instance, constraints);
+			else
+				buildConstraints(instance, matrix);
+			LinearObjective    linearObjective;
+			QuadraticObjective quadraticObjective;
+			if (instance.isQuadratic())
+				buildObjective(instance, quadraticObjective);
+			else
+				buildObjective(instance, linearObjective);
+			double build = timer.seconds();
+
+			const std::vector<Preference>& backends = (instance.isQuadratic() ? quadraticBackends : linearBackends);
+
+			for (Preference preference : backends) {
+
+				// creating the backend is part of the initialization, this is
+				// where the external solvers load their environment
+				timer.restart();
+				std::shared_ptr<LinearSolverBackend>    backend;
+				std::shared_ptr<QuadraticSolverBackend> quadraticBackend;
+				if (instance.isQuadratic())
+					backend = quadraticBackend = factory.createQuadraticSolverBackend(preference);
+				else
+					backend = factory.createLinearSolverBackend(preference);
+				backend->initialize(instance.numVariables, instance.type);
+				if (instance.hasBounds)
+					for (unsigned int i = 0; i < instance.numVariables; i++)
+						backend->setVariableBounds(i, instance.lowerBound, instance.upperBound);
+				backend->setTimeout(SolveTimeout);
+				double initialize = timer.seconds();
+
+				timer.restart();
+				if (instance.isQuadratic())
+					quadraticBackend->setObjective(quadraticObjective);
+				else
+					backend->setObjective(linearObjective);
+				double objective = timer.seconds();
+
+				timer.restart();
+				if (useMap)
+					backend->setConstraints(constraints);
+				else
+					backend->setConstraints(matrix);
+				double loading = timer.seconds();
+
+				double      solve       = 0;
+				double      extract     = 0;
+				bool        solved      = false;
+				double      value       = 0;
+				size_t      numSelected = 0;
+				std::string status      = "skipped";
+
+				if (preference != Native || !instance.isQuadratic() || instance.numNonZeros() <= MaxNativeQuadraticNonZeros) {
+
+					timer.restart();
+					Solution solution;
+					std::string message;
+					solved = backend->solve(solution, message);
+					solve = timer.seconds();
+
+					// read the solution the way a caller would, into the
+					// selected variables for the binary families
+					timer.restart();
+					std::vector<double> x(solution.getVector());
+					if (instance.type == Binary)
+						numSelected = std::count_if(x.begin(), x.end(), [](double v) { return v > 0.5; });
+					extract = timer.seconds();
+
+					// the status tells optimal solves from timeouts
+					status = solveStatusName(solution.getStatistics().status);
+					value  = solution.getValue();
+				}
+
+				out << family.name << "," << numNonZeros << "," << instance.numNonZeros() << ","
+					<< instance.numVariables << "," << instance.numRows() << ","
+					<< (useMap ? "LinearConstraints" : "LinearConstraintMatrix") << ","
+					<< backendName(preference) << "," << build << "," << initialize << ","
+					<< objective << "," << loading << "," << solve << "," << extract << ","
+					<< status << ",";
+				// the value of failed solves is undefined
+				if (solved)
+					out << value;
+				out << ",";
+				if (instance.type == Binary && status != "skipped")
+					out << numSelected;
+				out << std::endl;
+			}
+		}
+	}
+}
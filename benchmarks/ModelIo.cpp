@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+
+#include "../LinearConstraintMatrix.h"
+#include "../ModelReader.h"
+#include "../ModelWriter.h"
+#include "../QuadraticObjective.h"
+#include "../Solution.h"
+#include "Benchmarks.h"
+
+// number of non-zeros per generated constraint
+static const unsigned int NonZerosPerRow = 5;
+
+// relative difference of values that are considered equal after a round trip
+static const double Tolerance = 1e-9;
+
+struct GeneratedModel {
+
+	unsigned int                         numVariables;
+	std::map<unsigned int, VariableType> types;
+	QuadraticObjective                   objective;
+	LinearConstraintMatrix               constraints;
+	ModelWriter::Bounds                  bounds;
+};
+
+// generate a mixed-integer QP whose variables do not appear in the order of
+// their numbers, with zero costs, variables that appear in no constraint,
+// and bounds that are the defaults of the file formats
+static void
+generateModel(unsigned int numVariables, GeneratedModel& model) {
+
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<double> coefficient(-1.0, 1.0);
+
+	model.numVariables = numVariables;
+
+	model.types.clear();
+	for (unsigned int i = 0; i < numVariables; i++)
+		if (i%5 == 0)
+			model.types[i] = Binary;
+		else if (i%5 == 1)
+			model.types[i] = Integer;
+
+	model.objective = QuadraticObjective(numVariables);
+	for (unsigned int i = 0; i < numVariables; i++)
+		if (i%3 != 0)
+			model.objective.setCoefficient(i, coefficient(generator));
+
+	// quadratic terms from the last to the first variables
+	for (unsigned int i = 0; i + 1 < numVariables; i += 2)
+		model.objective.setQuadraticCoefficient(numVariables - 1 - i, i, coefficient(generator));
+
+	// rows over the first three quarters of the variables only
+	unsigned int numCovered = std::max(3*numVariables/4, 1u);
+	unsigned int rowSize    = std::min(NonZerosPerRow, numCovered);
+	std::uniform_int_distribution<unsigned int> variable(0, numCovered - 1);
+
+	std::vector<unsigned int> varNums(rowSize);
+	std::vector<double>       coefs(rowSize);
+
+	model.constraints.clear();
+	for (unsigned int r = 0; r < numVariables/2; r++) {
+
+		for (unsigned int j = 0; j < rowSize; j++) {
+
+			do {
+				varNums[j] = variable(generator);
+			} while (std::find(varNums.begin(), varNums.begin() + j, varNums[j]) != varNums.begin() + j);
+
+			coefs[j] = coefficient(generator);
+		}
+
+		Relation relation = (r%3 == 0 ? LessEqual : (r%3 == 1 ? GreaterEqual : Equal));
+		model.constraints.addRow(rowSize, varNums.data(), coefs.data(), relation, coefficient(generator));
+	}
+
+	model.bounds.clear();
+	for (unsigned int i = 0; i < numVariables; i++)
+		if (i%5 != 0 && i%4 == 2)
+			model.bounds[i] = std::make_pair(0.0, std::numeric_limits<double>::infinity());
+		else if (i%5 != 0 && i%4 == 3)
+			model.bounds[i] = std::make_pair(-1.0, 5.0);
+}
+
+static bool
+equal(double a, double b) {
+
+	if (a == b)
+		return true;
+
+	return std::fabs(a - b) <= Tolerance*std::max(1.0, std::max(std::fabs(a), std::fabs(b)));
+}
+
+// compare a model that was read with the model that was written, on the
+// values of the objective and the constraints at a random point
+static bool
+sameModel(const GeneratedModel& model, const ModelReader& reader) {
+
+	unsigned int n = model.numVariables;
+
+	if (reader.getNumVariables() != n || reader.getConstraints().size() != model.constraints.size())
+		return false;
+
+	for (unsigned int i = 0; i < n; i++) {
+
+		auto type   = model.types.find(i);
+		auto bounds = model.bounds.find(i);
+
+		VariableType t = (type == model.types.end() ? Continuous : type->second);
+
+		double lower = (bounds == model.bounds.end() ? defaultLowerBound(t) : bounds->second.first);
+		double upper = (bounds == model.bounds.end() ? defaultUpperBound(t) : bounds->second.second);
+
+		if (reader.getVariableTypes()[i] != t ||
+		    reader.getLowerBounds()[i] != lower ||
+		    reader.getUpperBounds()[i] != upper)
+			return false;
+	}
+
+	std::mt19937 generator(23);
+	std::uniform_real_distribution<double> value(-10.0, 10.0);
+
+	Solution x(n);
+	for (unsigned int i = 0; i < n; i++)
+		x[i] = value(generator);
+
+	if (reader.getObjective().getSense() != model.objective.getSense() ||
+	    !equal(reader.getObjective().evaluate(x), model.objective.evaluate(x)))
+		return false;
+
+	std::vector<double> expected;
+	std::vector<double> read;
+	model.constraints.multiply(x, expected);
+	reader.getConstraints().multiply(x, read);
+
+	for (unsigned int r = 0; r < model.constraints.size(); r++)
+		if (!equal(read[r], expected[r]) ||
+		    reader.getConstraints().getRelations()[r] != model.constraints.getRelations()[r] ||
+		    reader.getConstraints().getValues()[r] != model.constraints.getValues()[r])
+			return false;
+
+	return true;
+}
+
+bool
+benchmarkModelIo(const std::vector<size_t>& sizes) {
+
+	std::cout << std::setw(10) << "variables" << std::setw(10) << "format"
+			  << std::setw(14) << "write [s]" << std::setw(14) << "read [s]"
+			  << "  round trip" << std::endl;
+
+	bool allSame = true;
+
+	for (size_t numVariables : sizes) {
+
+		GeneratedModel model;
+		generateModel(numVariables, model);
+
+		for (ModelFormat format : { Lp, Mps }) {
+
+			std::stringstream stream;
+
+			WallTimer timer;
+			ModelWriter::write(
+					stream,
+					format,
+					model.numVariables,
+					Continuous,
+					model.types,
+					model.objective,
+					model.constraints,
+					model.bounds);
+			double write = timer.seconds();
+
+			timer.restart();
+			ModelReader reader;
+			reader.read(stream, format);
+			double read = timer.seconds();
+
+			bool same = sameModel(model, reader);
+			allSame = allSame && same;
+
+			std::cout << std::setw(10) << numVariables << std::setw(10) << (format == Lp ? "lp" : "mps")
+					  << std::setw(14) << write << std::setw(14) << read
+					  << "  " << (same ? "ok" : "FAILED") << std::endl;
+		}
+	}
+
+	return allSame;
+}
@@ -0,0 +1,78 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <algorithm>
+
+#include "../QuadraticObjective.h"
+#include "../QuadraticSolverBackend.h"
+#include "../SolverFactory.h"
+#include "Benchmarks.h"
+
+// average number of quadratic terms per variable
+static const size_t TermsPerVariable = 100;
+
+static void
+generateObjective(size_t numTerms, unsigned int numVariables, QuadraticObjective& objective) {
+
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<unsigned int> variable(0, numVariables - 1);
+	std::uniform_real_distribution<double> coefficient(0.0, 1.0);
+
+	std::vector<unsigned int> rows(numTerms);
+	std::vector<unsigned int> cols(numTerms);
+	std::vector<double>       vals(numTerms);
+
+	for (size_t k = 0; k < numTerms; k++) {
+
+		rows[k] = variable(generator);
+		cols[k] = variable(generator);
+		vals[k] = coefficient(generator);
+	}
+
+	objective.resize(numVariables);
+	for (unsigned int i = 0; i < numVariables; i++)
+		objective.setCoefficient(i, coefficient(generator));
+
+	objective.addQuadraticTerms(rows, cols, vals);
+}
+
+void
+benchmarkObjectiveLoading(const std::vector<size_t>& sizes) {
+
+	SolverFactory factory;
+	std::vector<Preference> backends = availableQuadraticBackends();
+
+	std::cout << std::setw(10) << "terms" << std::setw(10) << "backend"
+			  << std::setw(14) << "build [s]" << std::setw(14) << "load [s]"
+			  << std::endl;
+
+	for (size_t numTerms : sizes) {
+
+		unsigned int numVariables = std::max<size_t>(numTerms/TermsPerVariable, 10);
+
+		WallTimer timer;
+		QuadraticObjective objective;
+		generateObjective(numTerms, numVariables, objective);
+		// merge duplicates and symmetric pairs as part of the build
+		objective.numQuadraticTerms();
+		double build = timer.seconds();
+
+		std::cout << std::setw(10) << numTerms << std::setw(10) << "-"
+				  << std::setw(14) << build << std::setw(14) << "-"
+				  << std::endl;
+
+		for (Preference preference : backends) {
+
+			std::shared_ptr<QuadraticSolverBackend> backend = factory.createQuadraticSolverBackend(preference);
+			backend->initialize(numVariables, Continuous);
+
+			timer.restart();
+			backend->setObjective(objective);
+			double load = timer.seconds();
+
+			std::cout << std::setw(10) << numTerms << std::setw(10) << backendName(preference)
+					  << std::setw(14) << build << std::setw(14) << load
+					  << std::endl;
+		}
+	}
+}
@@ -0,0 +1,137 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <algorithm>
+
+#include "../LinearConstraintMatrix.h"
+#include "../QuadraticObjective.h"
+#include "../QuadraticSolverBackend.h"
+#include "../SolverFactory.h"
+#include "Benchmarks.h"
+
+// number of non-zeros per generated constraint
+static const unsigned int NonZerosPerRow = 5;
+
+// total number of variables over all instances of one size, to get stable
+// timings for small problems
+static const size_t VariablesPerSize = 100000;
+
+// generate a random convex QP min xQx + <c,x> s.t. Ax <= b, -10 <= x <= 10,
+// with a diagonally dominant tridiagonal Q
+static void
+generateQp(
+		unsigned int            numVariables,
+		unsigned int            seed,
+		QuadraticObjective&     objective,
+		LinearConstraintMatrix& matrix) {
+
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<unsigned int> variable(0, numVariables - 1);
+	std::uniform_real_distribution<double> coefficient(-1.0, 1.0);
+
+	objective.resize(numVariables);
+	objective.setSense(Minimize);
+
+	std::vector<unsigned int> rows, cols;
+	std::vector<double>       values;
+
+	for (unsigned int i = 0; i < numVariables; i++) {
+
+		objective.setCoefficient(i, coefficient(generator));
+
+		rows.push_back(i);
+		cols.push_back(i);
+		values.push_back(1.0 + 0.5*coefficient(generator));
+
+		if (i + 1 < numVariables) {
+
+			rows.push_back(i);
+			cols.push_back(i + 1);
+			values.push_back(0.5*coefficient(generator));
+		}
+	}
+
+	objective.addQuadraticTerms(rows, cols, values);
+
+	unsigned int numRows = std::max(numVariables/2, 1u);
+	unsigned int rowSize = std::min(NonZerosPerRow, numVariables);
+
+	matrix.clear();
+	matrix.reserve(numRows + 2*numVariables, numRows*rowSize + 2*numVariables);
+
+	std::vector<unsigned int> varNums(rowSize);
+	std::vector<double>       coefs(rowSize);
+
+	for (unsigned int i = 0; i < numRows; i++) {
+
+		// distinct variables for each row
+		for (unsigned int j = 0; j < rowSize; j++) {
+
+			do {
+				varNums[j] = variable(generator);
+			} while (std::find(varNums.begin(), varNums.begin() + j, varNums[j]) != varNums.begin() + j);
+
+			coefs[j] = coefficient(generator);
+		}
+
+		matrix.addRow(rowSize, varNums.data(), coefs.data(), LessEqual, 1.0);
+	}
+
+	double one = 1.0;
+	for (unsigned int i = 0; i < numVariables; i++) {
+
+		matrix.addRow(1, &i, &one, GreaterEqual, -10.0);
+		matrix.addRow(1, &i, &one, LessEqual, 10.0);
+	}
+}
+
+void
+benchmarkQpSolving(const std::vector<size_t>& sizes) {
+
+	SolverFactory factory;
+	std::vector<Preference> backends = availableQuadraticBackends();
+
+	std::cout << std::setw(10) << "variables" << std::setw(10) << "instances"
+			  << std::setw(10) << "backend" << std::setw(14) << "setup [s]"
+			  << std::setw(14) << "solve [s]" << std::setw(14) << "total [s]"
+			  << "  failures" << std::endl;
+
+	for (size_t numVariables : sizes) {
+
+		size_t numInstances = std::max<size_t>(VariablesPerSize/numVariables, 1);
+
+		std::vector<QuadraticObjective>     objectives(numInstances);
+		std::vector<LinearConstraintMatrix> matrices(numInstances);
+		for (size_t i = 0; i < numInstances; i++)
+			generateQp(numVariables, i, objectives[i], matrices[i]);
+
+		for (Preference preference : backends) {
+
+			double setup = 0;
+			double solve = 0;
+			size_t failures = 0;
+
+			for (size_t i = 0; i < numInstances; i++) {
+
+				WallTimer timer;
+				std::shared_ptr<QuadraticSolverBackend> backend = factory.createQuadraticSolverBackend(preference);
+				backend->initialize(numVariables, Continuous);
+				backend->setObjective(objectives[i]);
+				backend->setConstraints(matrices[i]);
+				setup += timer.seconds();
+
+				timer.restart();
+				Solution solution;
+				std::string message;
+				if (!backend->solve(solution, message))
+					failures++;
+				solve += timer.seconds();
+			}
+
+			std::cout << std::setw(10) << numVariables << std::setw(10) << numInstances
+					  << std::setw(10) << backendName(preference) << std::setw(14) << setup
+					  << std::setw(14) << solve << std::setw(14) << (setup + solve)
+					  << "  " << failures << std::endl;
+		}
+	}
+}
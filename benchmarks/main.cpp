@@ -0,0 +1,177 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/lexical_cast.hpp>
+
+#include "../SolverFactory.h"
+#include "../LinearSolverBackend.h"
+#include "Benchmarks.h"
+
+std::vector<Preference>
+availableBackends() {
+
+	SolverFactory factory;
+	std::vector<Preference> backends;
+
+	for (Preference preference : { Gurobi, Cplex, Scip, Native }) {
+
+		try {
+
+			factory.createLinearSolverBackend(preference);
+			backends.push_back(preference);
+
+		} catch (NoSolverException& e) {}
+	}
+
+	return backends;
+}
+
+std::vector<Preference>
+availableQuadraticBackends() {
+
+	SolverFactory factory;
+	std::vector<Preference> backends;
+
+	for (Preference preference : { Gurobi, Cplex, Scip, Native }) {
+
+		try {
+
+			factory.createQuadraticSolverBackend(preference);
+			backends.push_back(preference);
+
+		} catch (NoSolverException& e) {}
+	}
+
+	return backends;
+}
+
+std::string
+backendName(Preference preference) {
+
+	switch (preference) {
+
+		case Gurobi: return "gurobi";
+		case Cplex:  return "cplex";
+		case Scip:   return "scip";
+		case Native: return "native";
+		default:     return "any";
+	}
+}
+
+void
+usage(const char* program) {
+
+	std::cerr
+			<< "usage: " << program << " <benchmark> [--output <file>] [size...]" << std::endl
+			<< std::endl
+			<< "benchmarks:" << std::endl
+			<< "  constraints   time model build for the given numbers of rows" << std::endl
+			<< "                (default 100000 1000000 10000000)" << std::endl
+			<< "  objective     time quadratic objective setup for the given numbers" << std::endl
+			<< "                of quadratic terms (default 100000 1000000 10000000)" << std::endl
+			<< "  lp            time setup and solve of random LPs for the given numbers" << std::endl
+			<< "                of variables (default 10 100 1000)" << std::endl
+			<< "  qp            time setup and solve of random QPs for the given numbers" << std::endl
+			<< "                of variables (default 10 100 1000)" << std::endl
+			<< "  io            time writing and reading back random models in LP and" << std::endl
+			<< "                MPS format for the given numbers of variables, and check" << std::endl
+			<< "                the round trip (default 1000 100000 1000000)" << std::endl
+			<< "  families      time build, setup, solve, and extraction on synthetic" << std::endl
+			<< "                instance families for the given numbers of non-zeros" << std::endl
+			<< "                (default 1000 10000 100000 1000000 10000000), as CSV" << std::endl
+			<< std::endl
+			<< "options:" << std::endl
+			<< "  --output <file>   write the CSV of the families benchmark to a file" << std::endl
+			<< "                    instead of the standard output" << std::endl;
+}
+
+int main(int argc, char** argv) {
+
+	if (argc < 2) {
+
+		usage(argv[0]);
+		return 1;
+	}
+
+	std::string benchmark(argv[1]);
+
+	std::vector<size_t> sizes;
+	std::string output;
+	for (int i = 2; i < argc; i++) {
+
+		std::string arg(argv[i]);
+
+		if (arg == "--output" && i + 1 < argc)
+			output = argv[++i];
+		else
+			sizes.push_back(boost::lexical_cast<size_t>(arg));
+	}
+
+	if (benchmark == "constraints") {
+
+		if (sizes.empty())
+			sizes = { 100000, 1000000, 10000000 };
+
+		benchmarkConstraintLoading(sizes);
+
+	} else if (benchmark == "objective") {
+
+		if (sizes.empty())
+			sizes = { 100000, 1000000, 10000000 };
+
+		benchmarkObjectiveLoading(sizes);
+
+	} else if (benchmark == "lp") {
+
+		if (sizes.empty())
+			sizes = { 10, 100, 1000 };
+
+		benchmarkLpSolving(sizes);
+
+	} else if (benchmark == "qp") {
+
+		if (sizes.empty())
+			sizes = { 10, 100, 1000 };
+
+		benchmarkQpSolving(sizes);
+
+	} else if (benchmark == "io") {
+
+		if (sizes.empty())
+			sizes = { 1000, 100000, 1000000 };
+
+		if (!benchmarkModelIo(sizes))
+			return 1;
+
+	} else if (benchmark == "families") {
+
+		if (sizes.empty())
+			sizes = { 1000, 10000, 100000, 1000000, 10000000 };
+
+		if (output.empty()) {
+
+			benchmarkInstanceFamilies(sizes, std::cout);
+
+		} else {
+
+			std::ofstream out(output);
+			if (!out) {
+
+				std::cerr << "can not open " << output << std::endl;
+				return 1;
+			}
+
+			benchmarkInstanceFamilies(sizes, out);
+		}
+
+	} else {
+
+		usage(argv[0]);
+		return 1;
+	}
+
+	return 0;
+}
+
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../SolverFactory.h"
+#include "../TraceReplayer.h"
+
+void
+usage(const char* program) {
+
+	std::cerr
+			<< "usage: " << program << " <trace> [backend] [--calls]" << std::endl
+			<< std::endl
+			<< "Replays a trace written by RecordingBackend and reports the" << std::endl
+			<< "recorded and replayed wall times of the calls." << std::endl
+			<< std::endl
+			<< "backends: any (default), gurobi, cplex, scip, native" << std::endl
+			<< std::endl
+			<< "options:" << std::endl
+			<< "  --calls   report every call, not only the totals per method" << std::endl;
+}
+
+bool
+parseBackend(const std::string& name, Preference& preference) {
+
+	if (name == "any")         preference = Any;
+	else if (name == "gurobi") preference = Gurobi;
+	else if (name == "cplex")  preference = Cplex;
+	else if (name == "scip")   preference = Scip;
+	else if (name == "native") preference = Native;
+	else return false;
+
+	return true;
+}
+
+// whether two results of solve() differ
+bool
+differ(const TraceReplayer::Call& call) {
+
+	if (call.recordedSolved != call.replayedSolved)
+		return true;
+
+	return
+			call.recordedSolved &&
+			std::fabs(call.recordedValue - call.replayedValue) > 1e-6*std::max(1.0, std::fabs(call.recordedValue));
+}
+
+int main(int argc, char** argv) {
+
+	std::string trace;
+	Preference  preference = Any;
+	bool        calls      = false;
+
+	for (int i = 1; i < argc; i++) {
+
+		std::string arg(argv[i]);
+
+		if (arg == "--calls")
+			calls = true;
+		else if (trace.empty())
+			trace = arg;
+		else if (!parseBackend(arg, preference)) {
+
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (trace.empty()) {
+
+		usage(argv[0]);
+		return 1;
+	}
+
+	TraceReplayer replayer(trace);
+
+	SolverFactory factory;
+	std::shared_ptr<LinearSolverBackend> backend;
+	if (replayer.isQuadratic())
+		backend = factory.createQuadraticSolverBackend(preference);
+	else
+		backend = factory.createLinearSolverBackend(preference);
+
+	std::vector<size_t> numCalls(NumTraceCalls, 0);
+	std::vector<double> recorded(NumTraceCalls, 0);
+	std::vector<double> replayed(NumTraceCalls, 0);
+	size_t numDifferent = 0;
+
+	if (calls)
+		std::cout << std::setw(8) << "call" << "  " << std::left << std::setw(26) << "method" << std::right
+				  << std::setw(14) << "recorded [s]" << std::setw(14) << "replayed [s]" << std::endl;
+
+	replayer.replay(*backend, [&](const TraceReplayer::Call& call) {
+
+		numCalls[call.call]++;
+		recorded[call.call] += call.recordedSeconds;
+		replayed[call.call] += call.replayedSeconds;
+
+		if (calls)
+			std::cout << std::setw(8) << call.number << "  " << std::left << std::setw(26) << traceCallName(call.call) << std::right
+					  << std::setw(14) << call.recordedSeconds << std::setw(14) << call.replayedSeconds
+					  << (call.skipped ? "  skipped" : "") << std::endl;
+
+		if (call.call == TraceSolve && differ(call)) {
+
+			numDifferent++;
+			std::cout
+					<< "call " << call.number << ": solve() recorded "
+					<< (call.recordedSolved ? "solved" : "not solved") << " with value " << call.recordedValue
+					<< " (" << call.recordedMessage << "), replayed "
+					<< (call.replayedSolved ? "solved" : "not solved") << " with value " << call.replayedValue
+					<< " (" << call.replayedMessage << ")" << std::endl;
+		}
+	});
+
+	if (calls)
+		std::cout << std::endl;
+
+	std::cout << std::left << std::setw(26) << "method" << std::right << std::setw(10) << "calls"
+			  << std::setw(14) << "recorded [s]" << std::setw(14) << "replayed [s]" << std::endl;
+
+	double totalRecorded = 0;
+	double totalReplayed = 0;
+
+	for (int c = 0; c < NumTraceCalls; c++) {
+
+		if (numCalls[c] == 0)
+			continue;
+
+		std::cout << std::left << std::setw(26) << traceCallName(static_cast<TraceCall>(c)) << std::right
+				  << std::setw(10) << numCalls[c] << std::setw(14) << recorded[c] << std::setw(14) << replayed[c] << std::endl;
+
+		totalRecorded += recorded[c];
+		totalReplayed += replayed[c];
+	}
+
+	std::cout << std::left << std::setw(26) << "total" << std::right << std::setw(10) << ""
+			  << std::setw(14) << totalRecorded << std::setw(14) << totalReplayed << std::endl;
+
+	if (numDifferent > 0) {
+
+		std::cout << numDifferent << " solve() calls had different results" << std::endl;
+		return 2;
+	}
+
+	return 0;
+}